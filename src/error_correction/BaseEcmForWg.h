@@ -107,6 +107,19 @@ class BaseEcmForWg
 
   virtual void removeLastPosFromEsi(EcmScoreInfo& esi)=0;
       // Removes last position from the EcmScoreInfo object "esi".
+
+  virtual void moveLastPosFromEsi(EcmScoreInfo& esi,
+                                  EcmScoreInfo& posStackEsi)=0;
+      // Removes last position from the EcmScoreInfo object "esi" and
+      // pushes it into "posStackEsi", which is used as a stack of
+      // positions.
+
+  virtual void restoreLastPosOfEsi(EcmScoreInfo& posStackEsi,
+                                   EcmScoreInfo& esi)=0;
+      // Pops the last position pushed into "posStackEsi" and appends it
+      // to "esi". Positions should be restored in the reverse order in
+      // which they were moved by means of the moveLastPosFromEsi()
+      // function.
   
       // Destructor
   virtual ~BaseEcmForWg(){};
@@ -25,6 +25,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "EditDistForStr.h"
+#include <stdint.h>
+#include <algorithm>
 
 //--------------- Classes --------------------------------------------
 
@@ -92,6 +94,138 @@ Score EditDistForStr::calculateEditDistPrefixOpsAux(const std::string& x,
   return dm[x.size()][y.size()];	
 }
 
+//---------------------------------------
+Score EditDistForStr::calculateEditDistOpCost(const std::string& x,
+                                              const std::string& y)
+{
+  return calculateEditDistOpCostAux(x,y,DONT_USE_PREF_DEL_OP);
+}
+
+//---------------------------------------
+Score EditDistForStr::calculateEditDistPrefixOpCost(const std::string& x,
+                                                    const std::string& y)
+{
+  return calculateEditDistOpCostAux(x,y,USE_PREF_DEL_OP);
+}
+
+//---------------------------------------
+Score EditDistForStr::calculateEditDistOpCostAux(const std::string& x,
+                                                 const std::string& y,
+                                                 bool usePrefDelOp)
+{
+      // Use bit-vector algorithm if possible
+  if(hitCost==0 && insCost==substCost && substCost==delCost &&
+     y.size()>0 && y.size()<=EDIT_DIST_BIT_PARALLEL_MAX_LEN)
+  {
+    return substCost*bitParallelEditDist(x,y,usePrefDelOp);
+  }
+
+      // Fill distance matrix keeping only the previous row. Since the
+      // costs of the operations do not depend on the characters, the
+      // cost of the operations of the best path to the last cell is
+      // equal to its distance
+  Score smallRows[2*(EDIT_DIST_BIT_PARALLEL_MAX_LEN+1)];
+  std::vector<Score> largeRows;
+  Score* prevRow=smallRows;
+  Score* currRow=smallRows+EDIT_DIST_BIT_PARALLEL_MAX_LEN+1;
+  if(y.size()>EDIT_DIST_BIT_PARALLEL_MAX_LEN)
+  {
+    largeRows.resize(2*(y.size()+1));
+    prevRow=&largeRows[0];
+    currRow=&largeRows[y.size()+1];
+  }
+
+  currRow[0]=0;
+  for (unsigned int j=1; j<=y.size(); j++)
+    currRow[j]=currRow[j-1]+insertionCost(y[j-1]);
+  for (unsigned int i=1; i<=x.size(); i++)
+  {
+    std::swap(prevRow,currRow);
+    currRow[0]=prevRow[0]+deletionCost(x[i-1]);
+    for (unsigned int j=1; j<=y.size(); j++) 
+    {
+          // Treat substitution operation
+      Score dist;
+      if(x[i-1]==y[j-1])
+        dist=prevRow[j-1]+hitCost;
+      else
+        dist=prevRow[j-1]+substitutionCost(x[i-1],y[j-1]);
+
+          // Treat deletion operation
+      Score del_cost;
+      if(usePrefDelOp && j==y.size())
+        del_cost=0;
+      else
+        del_cost=deletionCost(x[i-1]);
+      if(prevRow[j]+del_cost < dist)
+        dist=prevRow[j]+del_cost;
+
+          // Treat insertion operation
+      Score ins_cost=insertionCost(y[j-1]);
+      if(currRow[j-1]+ins_cost < dist)
+        dist=currRow[j-1]+ins_cost;
+
+      currRow[j]=dist;
+    }
+  }
+
+  return currRow[y.size()];
+}
+
+//---------------------------------------
+unsigned int EditDistForStr::bitParallelEditDist(const std::string& x,
+                                                 const std::string& y,
+                                                 bool usePrefDelOp)
+{
+      // Obtain match vectors for the characters of y
+  uint64_t peq[256];
+  memset(peq,0,sizeof(peq));
+  for(unsigned int j=0;j<y.size();++j)
+    peq[(unsigned char)y[j]]|=((uint64_t)1)<<j;
+
+      // Initialize vertical deltas of the first column (i.e. distance
+      // matrix cells dm[0][j]=j)
+  uint64_t lastBit=((uint64_t)1)<<(y.size()-1);
+  uint64_t mask=lastBit|(lastBit-1);
+  uint64_t pv=mask;
+  uint64_t mv=0;
+  unsigned int dist=y.size();
+  unsigned int minDist=dist;
+
+      // Process the characters of x, obtaining the deltas of each new
+      // column from the deltas of the previous one
+  for(unsigned int i=0;i<x.size();++i)
+  {
+    uint64_t eq=peq[(unsigned char)x[i]];
+    uint64_t xv=eq|mv;
+    uint64_t xh=(((eq&pv)+pv)^pv)|eq;
+    uint64_t ph=mv|~(xh|pv);
+    uint64_t mh=pv&xh;
+    if(ph&lastBit)
+      ++dist;
+    else
+    {
+      if(mh&lastBit)
+        --dist;
+    }
+        // The first row of the distance matrix grows by one in each
+        // column (dm[i][0]=i)
+    ph=(ph<<1)|1;
+    mh=mh<<1;
+    pv=(mh|~(xv|ph))&mask;
+    mv=ph&xv&mask;
+    if(dist<minDist)
+      minDist=dist;
+  }
+
+      // When usePrefDelOp is true, the characters of x after the best
+      // alignment with y are deleted with no cost
+  if(usePrefDelOp)
+    return minDist;
+  else
+    return dist;
+}
+
 //---------------------------------------
 Score EditDistForStr::processMatrixCell(const std::string& x,
                                         const std::string& y,
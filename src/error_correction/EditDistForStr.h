@@ -38,6 +38,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+#define EDIT_DIST_BIT_PARALLEL_MAX_LEN 64
 
 //--------------- Type definitions -----------------------------------
 
@@ -70,6 +71,16 @@ class EditDistForStr: public _editDist<std::string>
                                               int verbose=0);
         // The same as the previous function, but the special PREF_DEL_OP
         // operation is not allowed    
+
+    Score calculateEditDistOpCost(const std::string& x,
+                                  const std::string& y);
+        // Returns the cost of the operations obtained by
+        // calculateEditDistOps() (hitCost*hCount+insCost*iCount+...)
+        // without storing the distance matrix
+    Score calculateEditDistPrefixOpCost(const std::string& x,
+                                        const std::string& y);
+        // The same as the previous function for the operations
+        // obtained by calculateEditDistPrefixOps()
 	  
 	~EditDistForStr(void);
     
@@ -113,6 +124,32 @@ class EditDistForStr: public _editDist<std::string>
                                         int verbose);
         // Auxiliary function for calculateEditDistPrefixOps()
 
+    Score calculateEditDistOpCostAux(const std::string& x,
+                                     const std::string& y,
+                                     bool usePrefDelOp);
+        // Auxiliary function for calculateEditDistOpCost() and
+        // calculateEditDistPrefixOpCost(), if the error model has unit
+        // costs and y has no more than EDIT_DIST_BIT_PARALLEL_MAX_LEN
+        // characters, the distance is obtained by means of the
+        // bit-vector algorithm of Myers (as reformulated by Hyyro),
+        // otherwise only two rows of the distance matrix are kept.
+        // NOTE: the bit-vector algorithm requires a zero hit cost. With
+        // a constant hit cost h and an error cost c, the distance is
+        // equal to h(|x|+|y|)/2 plus a distance with substitution cost
+        // c-h and insertion/deletion cost c-h/2, which does not have
+        // unit costs. Thus, the error models used in interactive
+        // translation (whose hit cost is -log(hit probability)) use
+        // the row-based computation
+
+    unsigned int bitParallelEditDist(const std::string& x,
+                                     const std::string& y,
+                                     bool usePrefDelOp);
+        // Returns the number of edit operations between x and y using
+        // the bit-vector algorithm, y cannot have more than
+        // EDIT_DIST_BIT_PARALLEL_MAX_LEN characters. If usePrefDelOp
+        // is true, the deletions after the last character of y have no
+        // cost
+
     inline Score insertionCost(char /*c*/)
       {
         return insCost;
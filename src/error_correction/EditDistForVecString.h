@@ -193,13 +193,7 @@ class EditDistForVecString: public EditDistForVec<std::string>
       if(x==y) return hitCost;
       else return substCost;
 #else
-      unsigned int hCount;
-      unsigned int iCount;
-      unsigned int sCount;
-      unsigned int dCount;
-
-      editDistForStr.calculateEditDistOps(x,y,hCount,iCount,sCount,dCount);
-      return hitCost*hCount+insCost*iCount+substCost*sCount+delCost*dCount;
+      return editDistForStr.calculateEditDistOpCost(x,y);
 #endif
     }
 
@@ -214,23 +208,7 @@ class EditDistForVecString: public EditDistForVec<std::string>
       if(StrProcUtils::isPrefix(y,x)) return hitCost;
       else return substCost;
 #else
-          // Obtain edit distance for prefix
-      std::vector<unsigned int> ops;
-      editDistForStr.calculateEditDistPrefixOps(x,y,ops);
-
-          // Obtain operation counts
-      std::vector<unsigned int> opsPerType;
-      countOpsGivenOpVec(ops,opsPerType);
-      unsigned int hCount=opsPerType[HIT_OP];
-      unsigned int iCount=opsPerType[INS_OP];
-      unsigned int sCount=opsPerType[SUBST_OP];
-      unsigned int dCount=opsPerType[DEL_OP];
-
-          // Return substitution cost
-      return hitCost*hCount+
-        insCost*iCount+
-        substCost*sCount+
-        delCost*dCount;
+      return editDistForStr.calculateEditDistPrefixOpCost(x,y);
 #endif
     }
 
@@ -192,6 +192,40 @@ void PfsmEcmForWg::removeLastPosFromEsi(EcmScoreInfo& esi)
   }
 }
 
+//---------------------------------------
+void PfsmEcmForWg::moveLastPosFromEsi(EcmScoreInfo& esi,
+                                      EcmScoreInfo& posStackEsi)
+{
+      // The first position is never removed (see
+      // removeLastPosFromEsi() function)
+  if(esi.scrVec.size()>1)
+  {
+        // The operation identifier is only moved if the esi stores one
+        // identifier for each position (the esi of the initial state
+        // does not store them)
+    if(esi.opIdVec.size()==esi.scrVec.size())
+    {
+      posStackEsi.opIdVec.push_back(esi.opIdVec.back());
+      esi.opIdVec.pop_back();
+    }
+    posStackEsi.scrVec.push_back(esi.scrVec.back());
+    esi.scrVec.pop_back();
+  }
+}
+
+//---------------------------------------
+void PfsmEcmForWg::restoreLastPosOfEsi(EcmScoreInfo& posStackEsi,
+                                       EcmScoreInfo& esi)
+{
+  if(esi.opIdVec.size()==esi.scrVec.size())
+  {
+    esi.opIdVec.push_back(posStackEsi.opIdVec.back());
+    posStackEsi.opIdVec.pop_back();
+  }
+  esi.scrVec.push_back(posStackEsi.scrVec.back());
+  posStackEsi.scrVec.pop_back();
+}
+
 //---------------------------------------
 PfsmEcmForWg::~PfsmEcmForWg()
 {
@@ -98,6 +98,16 @@ class PfsmEcmForWg: public PfsmEcm, public BaseEcmForWg<PfsmEcmForWgEsi>
   void removeLastPosFromEsi(EcmScoreInfo& esi);
       // Removes last position from the EcmScoreInfo object "esi".
 
+  void moveLastPosFromEsi(EcmScoreInfo& esi,
+                          EcmScoreInfo& posStackEsi);
+      // Removes last position from the EcmScoreInfo object "esi" and
+      // pushes it into "posStackEsi".
+
+  void restoreLastPosOfEsi(EcmScoreInfo& posStackEsi,
+                           EcmScoreInfo& esi);
+      // Pops the last position pushed into "posStackEsi" and appends it
+      // to "esi".
+
       // Destructor
   ~PfsmEcmForWg();
 
@@ -31,6 +31,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //---------------------------------------
 WgHandler::WgHandler(void)
 {
+  pthread_mutex_init(&mut,NULL);
 }
 
 //---------------------------------------
@@ -47,8 +48,9 @@ bool WgHandler::load(const char * filename)
   {
     std::cerr<<"Reading word graph handler file: "<<filename<<"\n";
 
+    pthread_mutex_lock(&mut);
         // Clear word graph
-    clear();
+    sentToWgInfoMap.clear();
         // Read file entries
     while(awk.getln())
     {
@@ -63,6 +65,7 @@ bool WgHandler::load(const char * filename)
         sentToWgInfoMap[strVec]=wgi;
       }
     }
+    pthread_mutex_unlock(&mut);
     return THOT_OK;
   }
 }
@@ -72,19 +75,35 @@ std::string WgHandler::pathAssociatedToSentence(const std::vector<std::string>&
                                                 bool& found)const
 {
   found=false;
+  std::string result;
   SentToWgInfoMap::const_iterator citer;
-  
+
+  pthread_mutex_lock(&mut);
   citer=sentToWgInfoMap.find(strVec);
-  if(citer==sentToWgInfoMap.end())
-  {
-    std::string result;
-    return result;
-  }
-  else
+  if(citer!=sentToWgInfoMap.end())
   {
     found=true;
-    return citer->second;
+    result=citer->second;
   }
+  pthread_mutex_unlock(&mut);
+  return result;
+}
+
+//---------------------------------------
+void WgHandler::addEntry(const std::vector<std::string>& strVec,
+                         const std::string& wgPath)
+{
+  pthread_mutex_lock(&mut);
+  sentToWgInfoMap[strVec]=wgPath;
+  pthread_mutex_unlock(&mut);
+}
+
+//---------------------------------------
+void WgHandler::removeEntry(const std::vector<std::string>& strVec)
+{
+  pthread_mutex_lock(&mut);
+  sentToWgInfoMap.erase(strVec);
+  pthread_mutex_unlock(&mut);
 }
 
 //---------------------------------------
@@ -96,7 +115,10 @@ bool WgHandler::empty(void)const
 //---------------------------------------
 size_t WgHandler::size(void)const
 {
-  return sentToWgInfoMap.size();
+  pthread_mutex_lock(&mut);
+  size_t result=sentToWgInfoMap.size();
+  pthread_mutex_unlock(&mut);
+  return result;
 }
 
 //---------------------------------------
@@ -121,6 +143,7 @@ bool WgHandler::print(const char* filename)const
 //---------------------------------------
 void WgHandler::print(std::ostream &outS)const
 {
+  pthread_mutex_lock(&mut);
   for(SentToWgInfoMap::const_iterator citer=sentToWgInfoMap.begin();citer!=sentToWgInfoMap.end();++citer)
   {
     for(unsigned int i=0;i<citer->first.size();++i)
@@ -129,15 +152,19 @@ void WgHandler::print(std::ostream &outS)const
     }
     outS<<"||| "<<citer->second<<std::endl;
   }
+  pthread_mutex_unlock(&mut);
 }
 
 //---------------------------------------
 void WgHandler::clear(void)
 {
+  pthread_mutex_lock(&mut);
   sentToWgInfoMap.clear();
+  pthread_mutex_unlock(&mut);
 }
 
 //---------------------------------------
 WgHandler::~WgHandler()
 {
+  pthread_mutex_destroy(&mut);
 }
@@ -34,6 +34,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <WordGraph.h>
 #include "AwkInputStream.h"
+#include <pthread.h>
 
 //--------------- Constants ------------------------------------------
 
@@ -44,7 +45,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 /**
  * @brief The WgHandler class implements a word graph for being
- * used in stack decoding.
+ * used in stack decoding. Entries can be added while the handler is
+ * being queried from other threads.
  */
 
 class WgHandler
@@ -57,6 +59,13 @@ class WgHandler
       // Basic functions
   std::string pathAssociatedToSentence(const std::vector<std::string>& strVec,
                                        bool& found)const;
+  void addEntry(const std::vector<std::string>& strVec,
+                const std::string& wgPath);
+      // Associates the word graph stored in wgPath to the given
+      // sentence
+  void removeEntry(const std::vector<std::string>& strVec);
+      // Removes the word graph associated to the given sentence (the
+      // file storing it is not removed)
 
       // size related functions
   bool empty(void)const;
@@ -79,6 +88,11 @@ class WgHandler
   typedef std::map<std::vector<std::string>,WgInfo> SentToWgInfoMap;
   
   SentToWgInfoMap sentToWgInfoMap;
+  mutable pthread_mutex_t mut;
+
+      // Forbid copies
+  WgHandler(const WgHandler&);
+  WgHandler& operator=(const WgHandler&);
 };
 
 #endif
@@ -35,13 +35,18 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <ctimer.h>
 #include <StrProcUtils.h>
+#include <pthread.h>
 #include <map>
 #include <set>
+#include <list>
 #include <vector>
 #include "BaseWgProcessorForAnlp.h"
 
 //--------------- Constants ------------------------------------------
 
+#define WGP_DEFAULT_MAX_CHECKPOINTS 16
+#define WGP_MIN_ARCS_FOR_PARALLEL_SWEEP 2000
+#define WGP_MIN_ARCS_FOR_PARALLEL_LEVEL 64
 
 //--------------- Functions ------------------------------------------
 
@@ -62,6 +67,9 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
 
       // Constructor
   WgProcessorForAnlp();
+
+      // Destructor
+  ~WgProcessorForAnlp();
     
       // Link word-graph with word-graph processor
   void link_wg(const WordGraph* _wg_ptr);
@@ -75,6 +83,25 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
 
   void set_ecmw(float _ecmWeight);
       // Set error correcting model weight
+
+  void setMaxCheckpoints(unsigned int _maxCheckpoints);
+      // Set maximum number of prefix positions stored as
+      // checkpoints. When the prefix is edited, the positions of the
+      // processed prefix after the longest common prefix are moved to
+      // checkpoints, so they can be restored instead of recomputed if
+      // the same words are typed again. Each checkpoint stores the
+      // score information of one prefix position for every arc and
+      // state of the word-graph. A value of zero disables checkpoints
+
+  void setNumThreads(unsigned int _numThreads);
+      // Set number of threads used to extend the ecm score info of the
+      // arcs when processing a prefix. Arcs are grouped in levels
+      // (given by the longest path from the initial state to their
+      // predecessor states), the arcs of each level are processed in
+      // parallel once the best scores of the states of the level have
+      // been obtained. The worker threads are created the first time
+      // they are needed and are kept until the word-graph processor is
+      // destroyed (or the number of threads changes)
   
   NbestCorrections correct(std::string prefix,
                            unsigned int n,
@@ -101,8 +128,30 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   typedef std::pair<WordGraphArcId,unsigned int> HypSubStateIdx;
   typedef std::multimap<float,HypSubStateIdx,std::greater<float> > NbestHypSubStates;
   typedef std::set<HypStateIndex> StatesInvolvedInArcs;
+
+  struct PrefPosCheckpoint
+  {
+    std::vector<std::string> prefixVec;  // Prefix ending at the position
+    bool lastWordIsIncomplete;           // Last word of prefixVec was
+                                         // processed as an incomplete word
+    EcmScoreInfo arcEsiPositions;        // Stacks of positions removed
+    EcmScoreInfo stateEsiPositions;      // from the ecm score info of
+                                         // arcs and states
+    std::vector<Score> bestScores;
+    std::vector<WordGraphArcId> bestPreds;
+  };
     
   std::vector<std::string> previousPrefixVec;
+
+  std::vector<bool> incompleteWordForPos;
+      // Stores, for each position of previousPrefixVec, whether the
+      // word was processed as an incomplete word (the last word of a
+      // prefix difference without a trailing blank)
+
+  std::list<PrefPosCheckpoint> checkpoints;
+      // Checkpoints of prefix positions, from the oldest to the newest
+
+  unsigned int maxCheckpoints;
   
   const WordGraph* wg_ptr;
   
@@ -135,6 +184,48 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                                      // for each state
 
   StatesInvolvedInArcs statesInvolvedInArcs; // List of states involved in arcs
+
+  unsigned int numThreads;
+
+  std::vector<WordGraphArcId> arcsForPredLevel;
+  std::vector<unsigned int> predLevelStart;
+      // Non-pruned arcs grouped by level of their predecessor states,
+      // the arcs of level l are stored in arcsForPredLevel from
+      // predLevelStart[l] to predLevelStart[l+1]
+
+  std::vector<WordGraphArcId> arcsForSuccLevel;
+  std::vector<unsigned int> succLevelStart;
+      // The same for the level of the successor states
+
+      // Data shared by the threads processing the arcs of the
+      // word-graph. Each job is the extension of the ecm score info
+      // for the arcs of one level
+  struct ArcSweepData
+  {
+    const std::vector<std::string>* prefixDiffVecPtr;
+    unsigned int level;
+    unsigned int numChunks;
+    unsigned int jobId;
+    unsigned int numPendingWorkers;
+    bool exitRequested;
+    pthread_mutex_t mutex;
+    pthread_cond_t readyCond;
+    pthread_cond_t doneCond;
+  };
+  
+  struct ArcSweepThreadData
+  {
+    WgProcessorForAnlp<ECM_FOR_WG>* wgpPtr;
+    unsigned int chunkIdx;
+    unsigned int lastJobId;  // Last job processed by the thread
+  };
+
+  ArcSweepData arcSweepData;
+  bool arcSweepWorkersStarted;
+  std::vector<ArcSweepThreadData> arcSweepThreadDataVec;
+  std::vector<pthread_t> arcSweepThreadIds;
+      // Worker threads processing the arcs of the word-graph, the
+      // calling thread processes the first chunk of each level
   
   // Auxiliary functions
 
@@ -155,6 +246,37 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                             const std::vector<std::string>& prefixVec);
   void procWgGivenPrefDiff(std::vector<std::string> prefixDiffVec,
                            unsigned int verbose=0);
+
+  // Functions to process the arcs of the word-graph in parallel
+  void genArcLevels(void);
+  void procArcsGivenPrefDiffParallel(const std::vector<std::string>& prefixDiffVec,
+                                     unsigned int verbose=0);
+  void updateEcmScoreInfoForArcChunk(const std::vector<std::string>& prefixDiffVec,
+                                     unsigned int level,
+                                     unsigned int chunkIdx,
+                                     unsigned int numChunks);
+  bool levelIsProcessedInParallel(unsigned int level)const;
+      // Levels with few arcs are processed by the calling thread only
+  void startArcSweepWorkers(unsigned int verbose=0);
+  void stopArcSweepWorkers(void);
+  static void* arcSweepThread(void* threadDataPtr);
+
+  // Functions to handle checkpoints of prefix positions
+  void removePrefPos(unsigned int pos,
+                     PrefPosCheckpoint* checkpointPtr);
+      // Removes position pos from the score information of arcs and
+      // states, storing it in *checkpointPtr if it is not NULL
+  void restorePrefPos(unsigned int pos,
+                      PrefPosCheckpoint& checkpoint);
+      // Appends position pos stored in checkpoint to the score
+      // information of arcs and states
+  unsigned int restorePrefPosCheckpoints(const std::vector<std::string>& prefixVec,
+                                         std::vector<std::string>& validProcPrefixVec,
+                                         std::vector<std::string>& prefixDiffVec);
+      // Restores the positions of prefixDiffVec that are stored in
+      // checkpoints, moving the corresponding words from prefixDiffVec
+      // to validProcPrefixVec. Returns the number of restored
+      // positions
   NbestHypStates obtainNbestHypStates(unsigned int n,
                                       const RejectedWordsSet& rejectedWords,
                                       unsigned int verbose=0);
@@ -237,7 +359,31 @@ WgProcessorForAnlp<ECM_FOR_WG>::WgProcessorForAnlp()
 {
   wg_ptr=NULL;
   ecm_wg_ptr=NULL;
+  wgWeight=0;
+  ecmWeight=0;
   initVarsExecuted=false;
+  maxCheckpoints=WGP_DEFAULT_MAX_CHECKPOINTS;
+  numThreads=1;
+  arcSweepData.prefixDiffVecPtr=NULL;
+  arcSweepData.level=0;
+  arcSweepData.numChunks=1;
+  arcSweepData.jobId=0;
+  arcSweepData.numPendingWorkers=0;
+  arcSweepData.exitRequested=false;
+  pthread_mutex_init(&arcSweepData.mutex,NULL);
+  pthread_cond_init(&arcSweepData.readyCond,NULL);
+  pthread_cond_init(&arcSweepData.doneCond,NULL);
+  arcSweepWorkersStarted=false;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+WgProcessorForAnlp<ECM_FOR_WG>::~WgProcessorForAnlp()
+{
+  stopArcSweepWorkers();
+  pthread_cond_destroy(&arcSweepData.doneCond);
+  pthread_cond_destroy(&arcSweepData.readyCond);
+  pthread_mutex_destroy(&arcSweepData.mutex);
 }
 
 //---------------------------------------
@@ -267,6 +413,9 @@ bool WgProcessorForAnlp<ECM_FOR_WG>::link_ecm_wg(BaseErrorCorrectionModel* _ecm_
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::set_wgw(float _wgWeight)
 {
+      // Stored checkpoints depend on the weights
+  if(wgWeight!=_wgWeight)
+    checkpoints.clear();
   wgWeight=_wgWeight;
 }
 
@@ -274,9 +423,34 @@ void WgProcessorForAnlp<ECM_FOR_WG>::set_wgw(float _wgWeight)
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::set_ecmw(float _ecmWeight)
 {
+      // Stored checkpoints depend on the weights
+  if(ecmWeight!=_ecmWeight)
+    checkpoints.clear();
   ecmWeight=_ecmWeight;  
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::setMaxCheckpoints(unsigned int _maxCheckpoints)
+{
+  maxCheckpoints=_maxCheckpoints;
+  while(checkpoints.size()>maxCheckpoints)
+    checkpoints.pop_front();
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::setNumThreads(unsigned int _numThreads)
+{
+  if(_numThreads==0)
+    _numThreads=1;
+
+      // Worker threads are created again for the new number of threads
+  if(numThreads!=_numThreads)
+    stopArcSweepWorkers();
+  numThreads=_numThreads;
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 NbestCorrections
@@ -360,6 +534,14 @@ WgProcessorForAnlp<ECM_FOR_WG>::correct(std::string prefix,
       std::cerr<<"|"<<std::endl;
     }
 
+        // Restore positions of the prefix difference stored in
+        // checkpoints
+    unsigned int numRestoredPos=restorePrefPosCheckpoints(prefixVec,
+                                                          validProcPrefixVec,
+                                                          prefixDiffVec);
+    if(verbose)
+      std::cerr<<" - Number of positions restored from checkpoints: "<<numRestoredPos<<std::endl;
+
         // Process word-graph given prefix difference
         // Get initial time
     if(verbose) std::cerr<<"Processing word-graph given prefix difference..."<<std::endl;
@@ -473,11 +655,14 @@ WgProcessorForAnlp<ECM_FOR_WG>::getValidProcPrefixVec(const std::vector<std::str
 {
   std::vector<std::string> result;
 
+      // Obtain longest common prefix
   for(unsigned int i=0;i<previousPrefixVec.size();++i)
   {
     if(i>=prefixVec.size()) break;
     if(previousPrefixVec[i]==prefixVec[i])
       result.push_back(previousPrefixVec[i]);
+    else
+      break;
   }
   return result;
 }
@@ -527,17 +712,393 @@ void WgProcessorForAnlp<ECM_FOR_WG>::procWgGivenPrefDiff(std::vector<std::string
   
   if(prefixDiffVec.size()!=0)
   {
-    for(unsigned int aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
-    {    
-          // Update info for arcs
-      if(!wg_ptr->arcPruned(aIdx))
-        updateWgpInfoForArc(prefixDiffVec,
-                            aIdx,
-                            verbose);
+    if(numThreads>1 && wg_ptr->numArcs()>=WGP_MIN_ARCS_FOR_PARALLEL_SWEEP)
+    {
+      procArcsGivenPrefDiffParallel(prefixDiffVec,
+                                    verbose);
+    }
+    else
+    {
+      for(unsigned int aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
+      {    
+            // Update info for arcs
+        if(!wg_ptr->arcPruned(aIdx))
+          updateWgpInfoForArc(prefixDiffVec,
+                              aIdx,
+                              verbose);
+      }
     }
+
+        // Only the last word of the prefix difference is processed as
+        // an incomplete word (if it has no trailing blank)
+    for(unsigned int i=0;i<prefixDiffVec.size()-1;++i)
+      incompleteWordForPos.push_back(false);
+    incompleteWordForPos.push_back(!StrProcUtils::lastCharIsBlank(prefixDiffVec.back()));
   }
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::genArcLevels(void)
+{
+  arcsForPredLevel.clear();
+  predLevelStart.clear();
+  arcsForSuccLevel.clear();
+  succLevelStart.clear();
+
+      // Obtain level of each state, that is, the length of the longest
+      // path from the initial state (it is assumed that the arcs of the
+      // word-graph are topologically ordered)
+  std::pair<WordGraphArcId,WordGraphArcId> arcIdxRange=wg_ptr->getArcIndexRange();
+  std::vector<unsigned int> levelForState(wg_ptr->numStates(),0);
+  unsigned int numLevels=1;
+  for(WordGraphArcId aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
+  {
+    if(!wg_ptr->arcPruned(aIdx))
+    {
+      WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(aIdx);
+      if(levelForState[wgArc.succStateIndex]<levelForState[wgArc.predStateIndex]+1)
+        levelForState[wgArc.succStateIndex]=levelForState[wgArc.predStateIndex]+1;
+      if(numLevels<levelForState[wgArc.succStateIndex]+1)
+        numLevels=levelForState[wgArc.succStateIndex]+1;
+    }
+  }
+
+      // Group arcs by level, keeping the order of the arcs within each
+      // level
+  predLevelStart.resize(numLevels+1,0);
+  succLevelStart.resize(numLevels+1,0);
+  for(WordGraphArcId aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
+  {
+    if(!wg_ptr->arcPruned(aIdx))
+    {
+      WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(aIdx);
+      ++predLevelStart[levelForState[wgArc.predStateIndex]+1];
+      ++succLevelStart[levelForState[wgArc.succStateIndex]+1];
+    }
+  }
+  for(unsigned int l=0;l<numLevels;++l)
+  {
+    predLevelStart[l+1]+=predLevelStart[l];
+    succLevelStart[l+1]+=succLevelStart[l];
+  }
+  arcsForPredLevel.resize(predLevelStart[numLevels]);
+  arcsForSuccLevel.resize(succLevelStart[numLevels]);
+  std::vector<unsigned int> predLevelPos(predLevelStart.begin(),predLevelStart.end()-1);
+  std::vector<unsigned int> succLevelPos(succLevelStart.begin(),succLevelStart.end()-1);
+  for(WordGraphArcId aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
+  {
+    if(!wg_ptr->arcPruned(aIdx))
+    {
+      WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(aIdx);
+      arcsForPredLevel[predLevelPos[levelForState[wgArc.predStateIndex]]++]=aIdx;
+      arcsForSuccLevel[succLevelPos[levelForState[wgArc.succStateIndex]]++]=aIdx;
+    }
+  }
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::procArcsGivenPrefDiffParallel(const std::vector<std::string>& prefixDiffVec,
+                                                                   unsigned int verbose/*=0*/)
+{
+      // The ecm score info of an arc only depends on the ecm score
+      // info of its predecessor state, which is final once the best
+      // scores for the states of its level have been updated. For
+      // each level, the best scores of its states are updated by this
+      // thread (keeping the order of the arcs arriving to each state),
+      // then the ecm score info of the arcs leaving from them is
+      // extended in parallel
+  startArcSweepWorkers(verbose);
+  unsigned int numWorkers=arcSweepThreadIds.size();
+  unsigned int numLevels=predLevelStart.size()-1;
+  if(verbose)
+    std::cerr<<"Processing arcs in "<<numLevels<<" levels using "<<numWorkers+1<<" threads"<<std::endl;
+  
+  for(unsigned int l=0;l<numLevels;++l)
+  {
+        // Update best scores for the states of the level
+    for(unsigned int i=succLevelStart[l];i<succLevelStart[l+1];++i)
+      updateBestScoresForState(arcsForSuccLevel[i],
+                               prefixDiffVec.size(),
+                               verbose);
+
+        // Extend ecm score info for the arcs leaving from the states
+        // of the level
+    if(numWorkers==0 || !levelIsProcessedInParallel(l))
+    {
+      updateEcmScoreInfoForArcChunk(prefixDiffVec,l,0,1);
+      continue;
+    }
+
+        // Dispatch level to the workers
+    pthread_mutex_lock(&arcSweepData.mutex);
+    arcSweepData.prefixDiffVecPtr=&prefixDiffVec;
+    arcSweepData.level=l;
+    arcSweepData.numChunks=numThreads;
+    arcSweepData.numPendingWorkers=numWorkers;
+    ++arcSweepData.jobId;
+    pthread_cond_broadcast(&arcSweepData.readyCond);
+    pthread_mutex_unlock(&arcSweepData.mutex);
+
+        // The chunks of the workers that could not be created are
+        // processed by this thread
+    updateEcmScoreInfoForArcChunk(prefixDiffVec,l,0,numThreads);
+    for(unsigned int k=numWorkers+1;k<numThreads;++k)
+      updateEcmScoreInfoForArcChunk(prefixDiffVec,l,k,numThreads);
+
+        // Wait for workers
+    pthread_mutex_lock(&arcSweepData.mutex);
+    while(arcSweepData.numPendingWorkers>0)
+      pthread_cond_wait(&arcSweepData.doneCond,&arcSweepData.mutex);
+    pthread_mutex_unlock(&arcSweepData.mutex);
+  }
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::updateEcmScoreInfoForArcChunk(const std::vector<std::string>& prefixDiffVec,
+                                                                   unsigned int level,
+                                                                   unsigned int chunkIdx,
+                                                                   unsigned int numChunks)
+{
+  unsigned int numArcsInLevel=predLevelStart[level+1]-predLevelStart[level];
+  unsigned int start=predLevelStart[level]+(numArcsInLevel*chunkIdx)/numChunks;
+  unsigned int end=predLevelStart[level]+(numArcsInLevel*(chunkIdx+1))/numChunks;
+  for(unsigned int i=start;i<end;++i)
+    updateEcmScoreInfoForArc(prefixDiffVec,arcsForPredLevel[i]);
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+bool WgProcessorForAnlp<ECM_FOR_WG>::levelIsProcessedInParallel(unsigned int level)const
+{
+  return predLevelStart[level+1]-predLevelStart[level]>=WGP_MIN_ARCS_FOR_PARALLEL_LEVEL;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::startArcSweepWorkers(unsigned int verbose/*=0*/)
+{
+  if(arcSweepWorkersStarted)
+    return;
+  arcSweepWorkersStarted=true;
+
+      // Thread data is allocated before creating the threads so that
+      // its address does not change
+  arcSweepThreadDataVec.resize(numThreads);
+  arcSweepThreadIds.reserve(numThreads);
+  arcSweepData.exitRequested=false;
+  for(unsigned int k=1;k<numThreads;++k)
+  {
+    pthread_t threadId;
+    arcSweepThreadDataVec[k].wgpPtr=this;
+    arcSweepThreadDataVec[k].chunkIdx=k;
+    arcSweepThreadDataVec[k].lastJobId=arcSweepData.jobId;
+    if(pthread_create(&threadId,NULL,arcSweepThread,&arcSweepThreadDataVec[k])!=0)
+    {
+      std::cerr<<"Error while creating arc sweep thread "<<k<<", its arcs will be processed by the calling thread"<<std::endl;
+      break;
+    }
+    arcSweepThreadIds.push_back(threadId);
+  }
+  if(verbose)
+    std::cerr<<"Created "<<arcSweepThreadIds.size()<<" arc sweep worker threads"<<std::endl;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::stopArcSweepWorkers(void)
+{
+  if(!arcSweepWorkersStarted)
+    return;
+
+  pthread_mutex_lock(&arcSweepData.mutex);
+  arcSweepData.exitRequested=true;
+  pthread_cond_broadcast(&arcSweepData.readyCond);
+  pthread_mutex_unlock(&arcSweepData.mutex);
+
+  for(unsigned int k=0;k<arcSweepThreadIds.size();++k)
+    pthread_join(arcSweepThreadIds[k],NULL);
+
+  arcSweepThreadIds.clear();
+  arcSweepThreadDataVec.clear();
+  arcSweepData.exitRequested=false;
+  arcSweepWorkersStarted=false;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void* WgProcessorForAnlp<ECM_FOR_WG>::arcSweepThread(void* threadDataPtr)
+{
+  ArcSweepThreadData* tdPtr=(ArcSweepThreadData*) threadDataPtr;
+  WgProcessorForAnlp<ECM_FOR_WG>* wgpPtr=tdPtr->wgpPtr;
+  ArcSweepData* sdPtr=&wgpPtr->arcSweepData;
+
+  pthread_mutex_lock(&sdPtr->mutex);
+  while(true)
+  {
+        // Wait until a level is dispatched or the thread is asked to
+        // finish
+    while(sdPtr->jobId==tdPtr->lastJobId && !sdPtr->exitRequested)
+      pthread_cond_wait(&sdPtr->readyCond,&sdPtr->mutex);
+    if(sdPtr->exitRequested)
+      break;
+    tdPtr->lastJobId=sdPtr->jobId;
+    const std::vector<std::string>* prefixDiffVecPtr=sdPtr->prefixDiffVecPtr;
+    unsigned int level=sdPtr->level;
+    unsigned int numChunks=sdPtr->numChunks;
+    pthread_mutex_unlock(&sdPtr->mutex);
+
+    wgpPtr->updateEcmScoreInfoForArcChunk(*prefixDiffVecPtr,
+                                          level,
+                                          tdPtr->chunkIdx,
+                                          numChunks);
+
+        // Notify that the chunk has been processed
+    pthread_mutex_lock(&sdPtr->mutex);
+    --sdPtr->numPendingWorkers;
+    if(sdPtr->numPendingWorkers==0)
+      pthread_cond_signal(&sdPtr->doneCond);
+  }
+  pthread_mutex_unlock(&sdPtr->mutex);
+  return NULL;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::removePrefPos(unsigned int pos,
+                                                   PrefPosCheckpoint* checkpointPtr)
+{
+      // Remove position from ecm score info for arcs (positions are
+      // only removed if pos is the last one, see restorePrefPos())
+  for(unsigned int aIdx=0;aIdx<ecmScrInfoForArcVec.size();++aIdx)
+  {
+    for(unsigned int j=0;j<ecmScrInfoForArcVec[aIdx].size();++j)
+    {
+      if(ecm_wg_ptr->numberOfPosInEsi(ecmScrInfoForArcVec[aIdx][j])==pos+1)
+      {
+        if(checkpointPtr)
+          ecm_wg_ptr->moveLastPosFromEsi(ecmScrInfoForArcVec[aIdx][j],checkpointPtr->arcEsiPositions);
+        else
+          ecm_wg_ptr->removeLastPosFromEsi(ecmScrInfoForArcVec[aIdx][j]);
+      }
+    }
+  }
+
+      // Iterate over states involved in arcs
+  StatesInvolvedInArcs::iterator iter;
+  for(iter=statesInvolvedInArcs.begin();iter!=statesInvolvedInArcs.end();++iter)
+  {
+    HypStateIndex idx=*iter;
+
+        // Remove position from ecm score info for state
+    if(ecm_wg_ptr->numberOfPosInEsi(ecmScrInfoForState[idx])==pos+1)
+    {
+      if(checkpointPtr)
+        ecm_wg_ptr->moveLastPosFromEsi(ecmScrInfoForState[idx],checkpointPtr->stateEsiPositions);
+      else
+        ecm_wg_ptr->removeLastPosFromEsi(ecmScrInfoForState[idx]);
+    }
+
+        // Remove position from best score and predecessors vectors
+    if(bestScoresForState[idx].size()==pos+1)
+    {
+      if(checkpointPtr)
+        checkpointPtr->bestScores.push_back(bestScoresForState[idx].back());
+      bestScoresForState[idx].pop_back();
+    }
+    if(bestPredsForState[idx].size()==pos+1)
+    {
+      if(checkpointPtr)
+        checkpointPtr->bestPreds.push_back(bestPredsForState[idx].back());
+      bestPredsForState[idx].pop_back();
+    }
+  }
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::restorePrefPos(unsigned int pos,
+                                                    PrefPosCheckpoint& checkpoint)
+{
+      // Positions are restored in the reverse order in which they were
+      // removed by removePrefPos()
+  StatesInvolvedInArcs::reverse_iterator riter;
+  for(riter=statesInvolvedInArcs.rbegin();riter!=statesInvolvedInArcs.rend();++riter)
+  {
+    HypStateIndex idx=*riter;
+
+    if(bestPredsForState[idx].size()==pos)
+    {
+      bestPredsForState[idx].push_back(checkpoint.bestPreds.back());
+      checkpoint.bestPreds.pop_back();
+    }
+    if(bestScoresForState[idx].size()==pos)
+    {
+      bestScoresForState[idx].push_back(checkpoint.bestScores.back());
+      checkpoint.bestScores.pop_back();
+    }
+    if(ecm_wg_ptr->numberOfPosInEsi(ecmScrInfoForState[idx])==pos)
+      ecm_wg_ptr->restoreLastPosOfEsi(checkpoint.stateEsiPositions,ecmScrInfoForState[idx]);
+  }
+
+  for(unsigned int aIdx=ecmScrInfoForArcVec.size();aIdx>0;--aIdx)
+  {
+    for(unsigned int j=ecmScrInfoForArcVec[aIdx-1].size();j>0;--j)
+    {
+      if(ecm_wg_ptr->numberOfPosInEsi(ecmScrInfoForArcVec[aIdx-1][j-1])==pos)
+        ecm_wg_ptr->restoreLastPosOfEsi(checkpoint.arcEsiPositions,ecmScrInfoForArcVec[aIdx-1][j-1]);
+    }
+  }
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+unsigned int
+WgProcessorForAnlp<ECM_FOR_WG>::restorePrefPosCheckpoints(const std::vector<std::string>& prefixVec,
+                                                          std::vector<std::string>& validProcPrefixVec,
+                                                          std::vector<std::string>& prefixDiffVec)
+{
+  unsigned int numRestoredPos=0;
+  std::vector<std::string> restoredPrefixVec=validProcPrefixVec;
+  
+  while(numRestoredPos<prefixDiffVec.size())
+  {
+    restoredPrefixVec.push_back(prefixDiffVec[numRestoredPos]);
+
+        // A checkpoint can be used only if its last word was processed
+        // in the same way as it would be processed now, that is, as an
+        // incomplete word only if it is the last word of the prefix
+    bool lastWordIsIncomplete=(restoredPrefixVec.size()==prefixVec.size() &&
+                               !StrProcUtils::lastCharIsBlank(restoredPrefixVec.back()));
+
+        // Search the newest checkpoint for the position
+    typename std::list<PrefPosCheckpoint>::iterator listIter;
+    typename std::list<PrefPosCheckpoint>::iterator foundIter=checkpoints.end();
+    for(listIter=checkpoints.begin();listIter!=checkpoints.end();++listIter)
+    {
+      if(listIter->lastWordIsIncomplete==lastWordIsIncomplete && listIter->prefixVec==restoredPrefixVec)
+        foundIter=listIter;
+    }
+    if(foundIter==checkpoints.end())
+      break;
+
+        // Restore position
+    restorePrefPos(restoredPrefixVec.size(),*foundIter);
+    incompleteWordForPos.push_back(lastWordIsIncomplete);
+    checkpoints.erase(foundIter);
+    ++numRestoredPos;
+  }
+
+      // Update prefix vectors
+  for(unsigned int i=0;i<numRestoredPos;++i)
+    validProcPrefixVec.push_back(prefixDiffVec[i]);
+  prefixDiffVec.erase(prefixDiffVec.begin(),prefixDiffVec.begin()+numRestoredPos);
+  
+  return numRestoredPos;
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 typename WgProcessorForAnlp<ECM_FOR_WG>::NbestHypStates
@@ -1266,12 +1827,18 @@ void WgProcessorForAnlp<ECM_FOR_WG>::clear(void)
 {
   initVarsExecuted=false;
   previousPrefixVec.clear();
+  incompleteWordForPos.clear();
+  checkpoints.clear();
   restScores.clear();
   ecmScrInfoForState.clear();
   ecmScrInfoForArcVec.clear();
   wgScoreForState.clear();
   bestScoresForState.clear();
   bestPredsForState.clear();
+  arcsForPredLevel.clear();
+  predLevelStart.clear();
+  arcsForSuccLevel.clear();
+  succLevelStart.clear();
 }
 
 //---------------------------------------
@@ -1284,8 +1851,10 @@ void WgProcessorForAnlp<ECM_FOR_WG>::clearTempVars(void)
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose/*=0*/)
 {
-      // Clear previous prefix vector
+      // Clear previous prefix vector and checkpoints
   previousPrefixVec.clear();
+  incompleteWordForPos.clear();
+  checkpoints.clear();
 
       // Generate rest scores for word-graph
   restScores.clear();
@@ -1336,6 +1905,9 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose/*=0*/)
       //Generate list of states involved in arcs
   genListOfStatesInvolvedInArcs(statesInvolvedInArcs);
 
+      // Group arcs by level to process them in parallel
+  genArcLevels();
+
       // Update initVarsExecuted variable
   initVarsExecuted=true;
 }
@@ -1362,38 +1934,27 @@ void WgProcessorForAnlp<ECM_FOR_WG>::genListOfStatesInvolvedInArcs(StatesInvolve
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::updateSizeOfVars(const std::vector<std::string>& validProcPrefixVec)
 {
-      // Obtain diff size
-  unsigned int diffSize=previousPrefixVec.size()-validProcPrefixVec.size();
-    
-      // Adjust size of ecm score info for arcs
-  for(unsigned int aIdx=0;aIdx<ecmScrInfoForArcVec.size();++aIdx)
+      // Remove the positions of the processed prefix that are not
+      // valid, from the last one to the first one. Removed positions
+      // are stored as checkpoints if they are enabled
+  for(unsigned int pos=previousPrefixVec.size();pos>validProcPrefixVec.size();--pos)
   {
-        // Adjust size of ecm score info for the j'th word
-    for(unsigned int j=0;j<ecmScrInfoForArcVec[aIdx].size();++j)
+    if(maxCheckpoints>0)
     {
-      for(unsigned int k=0;k<diffSize;++k)
-        ecm_wg_ptr->removeLastPosFromEsi(ecmScrInfoForArcVec[aIdx][j]);
+      checkpoints.push_back(PrefPosCheckpoint());
+      PrefPosCheckpoint& checkpoint=checkpoints.back();
+      checkpoint.prefixVec.assign(previousPrefixVec.begin(),previousPrefixVec.begin()+pos);
+      checkpoint.lastWordIsIncomplete=incompleteWordForPos[pos-1];
+      removePrefPos(pos,&checkpoint);
+      
+          // Discard oldest checkpoint if necessary
+      if(checkpoints.size()>maxCheckpoints)
+        checkpoints.pop_front();
     }
+    else
+      removePrefPos(pos,NULL);
   }
-    
-      // Iterate over states involved in arcs
-  StatesInvolvedInArcs::iterator iter;
-  for(iter=statesInvolvedInArcs.begin();iter!=statesInvolvedInArcs.end();++iter)
-  {
-    HypStateIndex idx=*iter;
-
-        // Adjust size of ecm score info for state
-    for(unsigned int i=0;i<diffSize;++i)
-      ecm_wg_ptr->removeLastPosFromEsi(ecmScrInfoForState[idx]);
-        
-        // Adjust size of best score vector
-    for(unsigned int i=0;i<diffSize;++i)
-      bestScoresForState[idx].pop_back();
-
-        // Adjust size of predecessors vector
-    for(unsigned int i=0;i<diffSize;++i)
-      bestPredsForState[idx].pop_back();
-  }
+  incompleteWordForPos.resize(validProcPrefixVec.size());
 }
 
 //---------------------------------------
@@ -27,12 +27,28 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "WgProcessorForAnlp.h"
 #include "PfsmEcmForWg.h"
 #include <string>
+#include <sstream>
 
 //--------------- Function definitions
 
-extern "C" BaseWgProcessorForAnlp* create(const char* /*str*/)
+extern "C" BaseWgProcessorForAnlp* create(const char* str)
 {
-  return new WgProcessorForAnlp<PfsmEcmForWg>;
+  WgProcessorForAnlp<PfsmEcmForWg>* wgpPtr=new WgProcessorForAnlp<PfsmEcmForWg>;
+
+      // The initialization string, if given, contains the maximum
+      // number of checkpoints of prefix positions, optionally followed
+      // by the number of threads used to process the arcs
+  std::istringstream iss(str);
+  unsigned int maxCheckpoints;
+  if(iss>>maxCheckpoints)
+  {
+    wgpPtr->setMaxCheckpoints(maxCheckpoints);
+    unsigned int numThreads;
+    if(iss>>numThreads)
+      wgpPtr->setNumThreads(numThreads);
+  }
+  
+  return wgpPtr;
 }
 
 //---------------
@@ -25,6 +25,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "WordGraph.h"
+#include "MathFuncs.h"
+#include <queue>
 
 //--------------- WordGraph class function definitions
 
@@ -350,6 +352,118 @@ unsigned int WordGraph::prune(float threshold)
   }
 }
 
+//---------------------------------------
+unsigned int WordGraph::pruneGivenDensity(float density,
+                                          unsigned int numSrcWords)
+{
+      // Reset pruning
+  for(unsigned int i=0;i<arcsPruned.size();++i)
+    arcsPruned[i]=false;
+  if(density==UNLIMITED_DENSITY)
+    return 0;
+
+      // Calculate arc posteriors
+  std::vector<Score> arcLogPosteriors;
+  calcArcLogPosteriors(arcLogPosteriors);
+  std::vector<std::pair<Score,WordGraphArcId> > scoreArcIdVec;
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    if(arcLogPosteriors[wgArcId]!=SMALL_SCORE)
+      scoreArcIdVec.push_back(std::make_pair(arcLogPosteriors[wgArcId],wgArcId));
+  }
+  if(scoreArcIdVec.empty())
+  {
+        // There are no complete paths, the word graph is not pruned
+    return 0;
+  }
+  std::sort(scoreArcIdVec.begin(),scoreArcIdVec.end(),std::greater<std::pair<Score,WordGraphArcId> >());
+
+      // Obtain best arc arriving to each state and best arc leaving
+      // from each state (INVALID_ARCID if it is better to end the path)
+  std::vector<Score> prevScores(wordGraphStates.size(),SMALL_SCORE);
+  std::vector<WordGraphArcId> bestPredArcs(wordGraphStates.size(),INVALID_ARCID);
+  prevScores[INITIAL_STATE]=initialStateScore;
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+    if(prevScores[wgArc.predStateIndex]!=SMALL_SCORE)
+    {
+      Score scr=prevScores[wgArc.predStateIndex]+wgArc.arcScore;
+      if(bestPredArcs[wgArc.succStateIndex]==INVALID_ARCID || scr>prevScores[wgArc.succStateIndex])
+      {
+        prevScores[wgArc.succStateIndex]=scr;
+        bestPredArcs[wgArc.succStateIndex]=wgArcId;
+      }
+    }
+  }
+  std::vector<Score> restScores(wordGraphStates.size(),SMALL_SCORE);
+  std::vector<WordGraphArcId> bestSuccArcs(wordGraphStates.size(),INVALID_ARCID);
+  FinalStateSet::const_iterator iter;
+  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
+    restScores[*iter]=0;
+  for(unsigned int i=0;i<wordGraphArcs.size();++i)
+  {
+    WordGraphArcId wgArcId=wordGraphArcs.size()-i-1;
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+    if(restScores[wgArc.succStateIndex]!=SMALL_SCORE)
+    {
+      Score scr=wgArc.arcScore+restScores[wgArc.succStateIndex];
+      if(restScores[wgArc.predStateIndex]==SMALL_SCORE || scr>restScores[wgArc.predStateIndex])
+      {
+        restScores[wgArc.predStateIndex]=scr;
+        bestSuccArcs[wgArc.predStateIndex]=wgArcId;
+      }
+    }
+  }
+
+      // Retain arcs in decreasing order of posterior probability
+  unsigned int maxArcs=(unsigned int)ceil(density*numSrcWords);
+  if(maxArcs==0)
+    maxArcs=1;
+  std::vector<bool> arcRetained(wordGraphArcs.size(),false);
+  unsigned int numRetainedArcs=0;
+  for(unsigned int i=0;i<scoreArcIdVec.size() && numRetainedArcs<maxArcs;++i)
+  {
+    WordGraphArcId wgArcId=scoreArcIdVec[i].second;
+    if(arcRetained[wgArcId])
+      continue;
+    arcRetained[wgArcId]=true;
+    ++numRetainedArcs;
+
+        // Retain best path from the initial state to the arc. A
+        // retained arc always belongs to a complete path of retained
+        // arcs, so the search stops when one of them is found
+    HypStateIndex idx=wordGraphArcs[wgArcId].predStateIndex;
+    while(idx!=INITIAL_STATE && !arcRetained[bestPredArcs[idx]])
+    {
+      arcRetained[bestPredArcs[idx]]=true;
+      ++numRetainedArcs;
+      idx=wordGraphArcs[bestPredArcs[idx]].predStateIndex;
+    }
+
+        // Retain best path from the arc to a final state
+    idx=wordGraphArcs[wgArcId].succStateIndex;
+    while(bestSuccArcs[idx]!=INVALID_ARCID && !arcRetained[bestSuccArcs[idx]])
+    {
+      arcRetained[bestSuccArcs[idx]]=true;
+      ++numRetainedArcs;
+      idx=wordGraphArcs[bestSuccArcs[idx]].succStateIndex;
+    }
+  }
+
+      // Prune the remaining arcs
+  unsigned int numPrunedArcs=0;
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    if(!arcRetained[wgArcId])
+    {
+      arcsPruned[wgArcId]=true;
+      ++numPrunedArcs;
+    }
+  }
+  return numPrunedArcs;
+}
+
 //---------------------------------------
 bool WordGraph::arcPruned(WordGraphArcId wordGraphArcId)const
 {
@@ -373,14 +487,9 @@ void WordGraph::obtainNbestList(unsigned int len,
   }
   else
   {
-        // Word-graph is not empty
-        // Obtain heuristic values
-    std::vector<Score> heurForEachState;
-    obtainNbSearchHeurInfo(heurForEachState);
-  
-        // Execute A-star search
+        // Word-graph is not empty, obtain n-best list
     std::vector<NbSearchHyp> hypList;
-    nbSearch(len,heurForEachState,nblist,hypList,scoreCompsVec,verbosity);
+    nbSearch(len,nblist,hypList,scoreCompsVec,verbosity);
 
         // Obtain high level hypothesis list
     highLevelHypList.clear();
@@ -402,210 +511,235 @@ NbSearchHighLevelHyp WordGraph::hypToHighLevelHyp(const NbSearchHyp& hyp)
   return result;
 }
 
-//---------------------------------------
-void WordGraph::obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState)
-{
-      // Clear vector
-  heurForEachState.clear();
-      // Initialize costs
-  heurForEachState.insert(heurForEachState.begin(),wordGraphStates.size(),SMALL_SCORE);
-      // Set zero cost for final states
-  FinalStateSet::const_iterator iter;
-  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
-    heurForEachState[*iter]=0;
-      
-      // Explore arcs in reverse order
-      // WARNING: arcs must be topologically ordered
-  if(!wordGraphArcs.empty())
-  {
-    for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
-    {
-      WordGraphArcId reverseWgArcId=wordGraphArcs.size()-wgArcId-1;
-      if(!arcPruned(reverseWgArcId))
-      {
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(reverseWgArcId);
-        Score scr=wgArc.arcScore+heurForEachState[wgArc.succStateIndex];
-        if(heurForEachState[wgArc.predStateIndex]<scr)
-          heurForEachState[wgArc.predStateIndex]=scr;
-      }
-    }
-  }
-}
-
 //---------------------------------------
 void WordGraph::nbSearch(unsigned int len,
-                         const std::vector<Score>& heurForEachState,
                          std::vector<std::pair<Score,std::string> >& nblist,
                          std::vector<NbSearchHyp>& hypList,
                          std::vector<std::vector<Score> >& scoreCompsVec,
                          int verbosity/*=false*/)
 {
-  // Perform A-star search
-
-      // Create null hypothesis
-  NbSearchHyp nbSearchHyp;
+  nblist.clear();
+  hypList.clear();
+  scoreCompsVec.clear();
 
-      // Declare stack and set maximum size
-  NbSearchStack nbSearchStack;
-  nbSearchStack.setMaxStackSize(NBEST_MAX_STACK_SIZE);
+      // Obtain final states
+  std::vector<bool> stateIsFinalVec(wordGraphStates.size(),false);
+  FinalStateSet::const_iterator iter;
+  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
+  {
+    if(*iter<stateIsFinalVec.size())
+      stateIsFinalVec[*iter]=true;
+  }
 
-      // Push null hypothesis
-  nbSearchStack.push(initialStateScore+heurForEachState[INITIAL_STATE],nbSearchHyp);
+      // Obtain best path for each state
+  std::vector<NbSearchStateInfo> stateInfoVec;
+  initNbSearchStateInfo(stateIsFinalVec,stateInfoVec);
 
-      // Declare stack to store complete hyps
-  NbSearchStack completeHypStack;
+      // Merge the paths arriving to the final states (the empty path is
+      // not a complete hypothesis)
+  typedef std::pair<Score,std::pair<HypStateIndex,unsigned int> > ScoredFinalPath;
+  std::priority_queue<ScoredFinalPath> finalPathQueue;
+  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
+  {
+    if(*iter<stateIsFinalVec.size() && *iter!=INITIAL_STATE && !stateInfoVec[*iter].paths.empty())
+      finalPathQueue.push(std::make_pair(stateInfoVec[*iter].paths[0].score,std::make_pair(*iter,0)));
+  }
   
-      // Iterate
-  unsigned int numIters=0;
-  bool end=false;
-  while(!end)
+  if(verbosity>=1)
   {
-    if(verbosity>=1)
-      std::cerr<<"* Iteration "<<numIters<<std::endl;
+    std::cerr<<"* Verbose info about complete hypotheses..."<<std::endl;
+  }
+
+  while(nblist.size()<len && !finalPathQueue.empty())
+  {
+    ScoredFinalPath scoredFinalPath=finalPathQueue.top();
+    finalPathQueue.pop();
+    HypStateIndex finalStateIdx=scoredFinalPath.second.first;
+    unsigned int pathIdx=scoredFinalPath.second.second;
     
-        // Check if there are "len" complete hypotheses
-    if(completeHypStack.size()>=len)
+        // Add hypothesis to list
+    NbSearchHyp hyp=nbSearchPathToHyp(finalStateIdx,pathIdx,stateInfoVec);
+    hypList.push_back(hyp);
+
+        // Obtain string from hyp
+    std::vector<Score> scoreComps;
+    std::string translation=stringAssociatedToHyp(hyp,scoreComps);
+    if(!scoreComps.empty()) scoreCompsVec.push_back(scoreComps);
+      
+        // Add to vector
+    nblist.push_back(make_pair(scoredFinalPath.first,translation));
+
+        // Print verbose information
+    if(verbosity>=1)
     {
-      end=true;
+      std::cerr<<scoredFinalPath.first<<" ||| "<<translation<<" |||";
+      for(unsigned int j=0;j<hyp.size();++j)
+        std::cerr<<" "<<wordGraphArcs[hyp[j]].succStateIndex;
+      std::cerr<<std::endl;
     }
-    else
+    
+        // Obtain next path arriving to the final state
+    if(obtainNthPathForState(finalStateIdx,pathIdx+1,stateIsFinalVec,stateInfoVec))
+      finalPathQueue.push(std::make_pair(stateInfoVec[finalStateIdx].paths[pathIdx+1].score,std::make_pair(finalStateIdx,pathIdx+1)));
+  }
+}
+
+//---------------------------------------
+void WordGraph::initNbSearchStateInfo(const std::vector<bool>& stateIsFinalVec,
+                                      std::vector<NbSearchStateInfo>& stateInfoVec)const
+{
+  NbSearchStateInfo emptyStateInfo;
+  emptyStateInfo.candidatesInitialized=false;
+  emptyStateInfo.lastPathExtended=false;
+  emptyStateInfo.exhausted=false;
+  stateInfoVec.clear();
+  stateInfoVec.resize(wordGraphStates.size(),emptyStateInfo);
+
+      // The initial state has only the empty path
+  NbSearchPath initPath;
+  initPath.score=initialStateScore;
+  initPath.arcId=INVALID_ARCID;
+  initPath.predPathIdx=0;
+  stateInfoVec[INITIAL_STATE].paths.push_back(initPath);
+
+      // Explore arcs in topological order
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    if(!arcPruned(wgArcId))
     {
-          // Check if stack is empty
-      if(!nbSearchStack.empty())
+      const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+      const NbSearchStateInfo& predInfo=stateInfoVec[wgArc.predStateIndex];
+      if(wgArc.succStateIndex!=INITIAL_STATE && !predInfo.paths.empty() &&
+         (wgArc.predStateIndex==INITIAL_STATE || !stateIsFinalVec[wgArc.predStateIndex]))
       {
-            // Pop top of the stack
-        std::pair<Score,NbSearchHyp> scrHypPair=nbSearchStack.top();
-        nbSearchStack.pop();
-
-            // Obtain index of last state
-        HypStateIndex lastHypStateIndex;
-        if(scrHypPair.second.empty())
-          lastHypStateIndex=INITIAL_STATE;
+        NbSearchPath path;
+        path.score=predInfo.paths[0].score+wgArc.arcScore;
+        path.arcId=wgArcId;
+        path.predPathIdx=0;
+        NbSearchStateInfo& succInfo=stateInfoVec[wgArc.succStateIndex];
+        if(succInfo.paths.empty())
+          succInfo.paths.push_back(path);
         else
         {
-          WordGraphArc wgArc=wordGraphArcId2WordGraphArc(scrHypPair.second.back());
-          lastHypStateIndex=wgArc.succStateIndex;
-        }
-        
-            // Subtract heuristic
-        scrHypPair.first-=heurForEachState[lastHypStateIndex];
-
-        if(verbosity>=1)
-        {
-          std::cerr<<"- Top of the stack: "<<scrHypPair.first<<" ;";
-          for(unsigned int j=0;j<scrHypPair.second.size();++j)
-            std::cerr<<" "<<scrHypPair.second[j];
-          std::cerr<<std::endl;
+          if(succInfo.paths[0].score<path.score)
+            succInfo.paths[0]=path;
         }
+      }
+    }
+  }
 
-            // Check if hyp is complete
-        if(hypIsComplete(scrHypPair.second))
-        {
-          completeHypStack.push(scrHypPair.first,scrHypPair.second);
-        }
-        else
-        {
-          if(verbosity>=1)
-            std::cerr<<"- Expanding top of the stack..."<<std::endl;
+      // Unreachable states have no paths
+  stateInfoVec[INITIAL_STATE].exhausted=true;
+  for(unsigned int i=0;i<stateInfoVec.size();++i)
+  {
+    if(stateInfoVec[i].paths.empty())
+      stateInfoVec[i].exhausted=true;
+  }
+}
 
-            // Expand hypothesis
-          std::vector<WordGraphArcId> wgArcIds;
-          getArcIdsToSuccStates(lastHypStateIndex,wgArcIds);
+//---------------------------------------
+bool WordGraph::obtainNthPathForState(HypStateIndex hypStateIndex,
+                                      unsigned int n,
+                                      const std::vector<bool>& stateIsFinalVec,
+                                      std::vector<NbSearchStateInfo>& stateInfoVec)const
+{
+      // Obtaining the next path of a state may require the next path of
+      // a predecessor state, the pending requests are kept in a stack
+      // to avoid deep recursions
+  std::vector<std::pair<HypStateIndex,unsigned int> > requestStack;
+  requestStack.push_back(std::make_pair(hypStateIndex,n));
+  while(!requestStack.empty())
+  {
+    HypStateIndex idx=requestStack.back().first;
+    unsigned int pathIdx=requestStack.back().second;
+    NbSearchStateInfo& stateInfo=stateInfoVec[idx];
+    if(stateInfo.paths.size()>pathIdx || stateInfo.exhausted)
+    {
+      requestStack.pop_back();
+      continue;
+    }
 
-          std::vector<std::pair<Score,NbSearchHyp> > scrHypPairVec;
-          for(unsigned int i=0;i<wgArcIds.size();++i)
-          {
-            if(!arcPruned(wgArcIds[i]))
-            {
-              WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcIds[i]);
-              std::pair<Score,NbSearchHyp> newScrHypPair;
-              newScrHypPair=scrHypPair;
-                  // Obtain new score
-              newScrHypPair.first+=wgArc.arcScore;
-                  // Add heuristic
-              newScrHypPair.first+=heurForEachState[wgArc.succStateIndex];   
-                  // Add new arc
-              newScrHypPair.second.push_back(wgArcIds[i]);
-                  // Push into vector
-              scrHypPairVec.push_back(newScrHypPair);
-
-              if(verbosity>=1)
-              {
-                std::cerr<<"  Adding extension, score contribution: "<<wgArc.arcScore<<" ; successor state: "<<wgArc.succStateIndex<<std::endl;
-              }
-            }
-          }
-          
-            // Push results into the stack
-          for(unsigned int i=0;i<scrHypPairVec.size();++i)
+        // The candidates of a state are initialized with the best paths
+        // arriving through each incoming arc
+    if(!stateInfo.candidatesInitialized)
+    {
+      const std::vector<WordGraphArcId>& arcIds=wordGraphStates[idx].arcsToPredStates;
+      for(unsigned int i=0;i<arcIds.size();++i)
+      {
+        if(!arcPruned(arcIds[i]) && arcIds[i]!=stateInfo.paths[0].arcId)
+        {
+          const WordGraphArc& wgArc=wordGraphArcs[arcIds[i]];
+          const NbSearchStateInfo& predInfo=stateInfoVec[wgArc.predStateIndex];
+          if(!predInfo.paths.empty() &&
+             (wgArc.predStateIndex==INITIAL_STATE || !stateIsFinalVec[wgArc.predStateIndex]))
           {
-            nbSearchStack.push(scrHypPairVec[i].first,scrHypPairVec[i].second);
+            NbSearchPath path;
+            path.score=predInfo.paths[0].score+wgArc.arcScore;
+            path.arcId=arcIds[i];
+            path.predPathIdx=0;
+            stateInfo.candidates.push_back(path);
+            std::push_heap(stateInfo.candidates.begin(),stateInfo.candidates.end());
           }
         }
       }
-      else
-      {
-            // Stack is empty
-        end=true;
-      }
+      stateInfo.candidatesInitialized=true;
     }
-    ++numIters;
-    if(verbosity>=1) std::cerr<<std::endl;
-  }          
-      // Obtain result
-  nblist.clear();
-  hypList.clear();
-  scoreCompsVec.clear();
-  if(verbosity>=1)
-  {
-    std::cerr<<"* Verbose info about complete hypotheses..."<<std::endl;
-  }
-  
-  while(!completeHypStack.empty())
-  {
-        // Pop top of the stack
-    std::pair<Score,NbSearchHyp> scrHypPair=completeHypStack.top();
-    completeHypStack.pop();
 
-        // Add hypothesis to list
-    hypList.push_back(scrHypPair.second);
-    
-        // Obtain string from hyp
-    std::vector<Score> scoreComps;
-    std::string translation=stringAssociatedToHyp(scrHypPair.second,scoreComps);
-    if(!scoreComps.empty()) scoreCompsVec.push_back(scoreComps);
-      
-        // Add to vector
-    nblist.push_back(make_pair(scrHypPair.first,translation));
-
-        // Print verbose information
-    if(verbosity>=1)
+        // The last path of the state is extended with the next path of
+        // the predecessor state of its last arc
+    if(!stateInfo.lastPathExtended)
     {
-      std::cerr<<scrHypPair.first<<" ||| "<<translation<<" |||";
-      for(unsigned int j=0;j<scrHypPair.second.size();++j)
+      NbSearchPath lastPath=stateInfo.paths.back();
+      const WordGraphArc& wgArc=wordGraphArcs[lastPath.arcId];
+      const NbSearchStateInfo& predInfo=stateInfoVec[wgArc.predStateIndex];
+      unsigned int nextPredPathIdx=lastPath.predPathIdx+1;
+      if(predInfo.paths.size()<=nextPredPathIdx && !predInfo.exhausted)
       {
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(scrHypPair.second[j]);
-        HypStateIndex hidx=wgArc.succStateIndex;
-        std::cerr<<" "<<hidx;
+        requestStack.push_back(std::make_pair(wgArc.predStateIndex,nextPredPathIdx));
+        continue;
       }
-      std::cerr<<std::endl;
+      if(predInfo.paths.size()>nextPredPathIdx)
+      {
+        NbSearchPath path;
+        path.score=predInfo.paths[nextPredPathIdx].score+wgArc.arcScore;
+        path.arcId=lastPath.arcId;
+        path.predPathIdx=nextPredPathIdx;
+        stateInfo.candidates.push_back(path);
+        std::push_heap(stateInfo.candidates.begin(),stateInfo.candidates.end());
+      }
+      stateInfo.lastPathExtended=true;
+    }
+
+        // The next path of the state is the best candidate
+    if(stateInfo.candidates.empty())
+      stateInfo.exhausted=true;
+    else
+    {
+      std::pop_heap(stateInfo.candidates.begin(),stateInfo.candidates.end());
+      stateInfo.paths.push_back(stateInfo.candidates.back());
+      stateInfo.candidates.pop_back();
+      stateInfo.lastPathExtended=false;
     }
   }
+  
+  return stateInfoVec[hypStateIndex].paths.size()>n;
 }
 
 //---------------------------------------
-bool WordGraph::hypIsComplete(const NbSearchHyp& nbSearchHyp)
+NbSearchHyp WordGraph::nbSearchPathToHyp(HypStateIndex hypStateIndex,
+                                         unsigned int pathIdx,
+                                         const std::vector<NbSearchStateInfo>& stateInfoVec)const
 {
-  if(nbSearchHyp.empty()) return false;
-  else
+  NbSearchHyp hyp;
+  while(hypStateIndex!=INITIAL_STATE)
   {
-    WordGraphArc wgArc=wordGraphArcId2WordGraphArc(nbSearchHyp.back());
-    HypStateIndex hidx=wgArc.succStateIndex;
-    if(stateIsFinal(hidx))
-      return true;
-    else
-      return false;
+    const NbSearchPath& path=stateInfoVec[hypStateIndex].paths[pathIdx];
+    hyp.push_back(path.arcId);
+    hypStateIndex=wordGraphArcs[path.arcId].predStateIndex;
+    pathIdx=path.predPathIdx;
   }
+  std::reverse(hyp.begin(),hyp.end());
+  return hyp;
 }
 
 //---------------------------------------
@@ -616,17 +750,17 @@ std::string WordGraph::stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp,
   for(unsigned int i=0;i<nbSearchHyp.size();++i)
   {
     WordGraphArcId wgArcId=nbSearchHyp[i];
-    WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcId);
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
 
         // Add words to str
     if(i!=0)
-      str=str+" ";
+      str+=" ";
     
     for(unsigned int k=0;k<wgArc.words.size();++k)
     {
-      str=str+wgArc.words[k];
+      str+=wgArc.words[k];
       if(k!=wgArc.words.size()-1)
-        str=str+" ";
+        str+=" ";
     }
 
         // Sum score components
@@ -971,6 +1105,61 @@ void WordGraph::calcRestScores(std::vector<Score>& restScores)const
   }  
 }
 
+//---------------------------------------
+void WordGraph::calcArcLogPosteriors(std::vector<Score>& arcLogPosteriors)const
+{
+  arcLogPosteriors.clear();
+  arcLogPosteriors.insert(arcLogPosteriors.begin(),wordGraphArcs.size(),SMALL_SCORE);
+  
+      // Forward pass (arcs are assumed to be topologically ordered)
+  std::vector<Score> forwardScores(wordGraphStates.size(),SMALL_SCORE);
+  forwardScores[INITIAL_STATE]=initialStateScore;
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+    if(!arcPruned(wgArcId) && forwardScores[wgArc.predStateIndex]!=SMALL_SCORE)
+    {
+      Score scr=forwardScores[wgArc.predStateIndex]+wgArc.arcScore;
+      if(forwardScores[wgArc.succStateIndex]==SMALL_SCORE)
+        forwardScores[wgArc.succStateIndex]=scr;
+      else
+        forwardScores[wgArc.succStateIndex]=MathFuncs::lns_sumlog(forwardScores[wgArc.succStateIndex],scr);
+    }
+  }
+
+      // Backward pass
+  std::vector<Score> backwardScores(wordGraphStates.size(),SMALL_SCORE);
+  FinalStateSet::const_iterator iter;
+  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
+    backwardScores[*iter]=0;
+  for(unsigned int i=0;i<wordGraphArcs.size();++i)
+  {
+    WordGraphArcId wgArcId=wordGraphArcs.size()-i-1;
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+    if(!arcPruned(wgArcId) && backwardScores[wgArc.succStateIndex]!=SMALL_SCORE)
+    {
+      Score scr=wgArc.arcScore+backwardScores[wgArc.succStateIndex];
+      if(backwardScores[wgArc.predStateIndex]==SMALL_SCORE)
+        backwardScores[wgArc.predStateIndex]=scr;
+      else
+        backwardScores[wgArc.predStateIndex]=MathFuncs::lns_sumlog(backwardScores[wgArc.predStateIndex],scr);
+    }
+  }
+
+      // Obtain posteriors
+  if(backwardScores[INITIAL_STATE]==SMALL_SCORE)
+    return;
+  Score logTotal=initialStateScore+backwardScores[INITIAL_STATE];
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+    if(!arcPruned(wgArcId) && forwardScores[wgArc.predStateIndex]!=SMALL_SCORE && backwardScores[wgArc.succStateIndex]!=SMALL_SCORE)
+    {
+      arcLogPosteriors[wgArcId]=forwardScores[wgArc.predStateIndex]+wgArc.arcScore+backwardScores[wgArc.succStateIndex]-logTotal;
+    }
+  }
+}
+
 //---------------------------------------
 Score WordGraph::bestPathFromFinalStateToIdx(HypStateIndex hypStateIndex,
                                              const std::set<WordGraphArcId>& excludedArcs,
@@ -1235,6 +1424,9 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
 //---------------------------------------
 bool WordGraph::load(const char * filename)
 {
+  if(WordGraphBinReader::isBinWordGraph(filename))
+    return loadBin(filename);
+
   AwkInputStream awk;
   
   if(awk.open(filename)==THOT_ERROR)
@@ -1415,6 +1607,209 @@ void WordGraph::print(std::ostream &outS,
   }
 }
 
+//---------------------------------------
+bool WordGraph::loadBin(const char * filename)
+{
+  WordGraphBinReader reader;
+
+  if(reader.open(filename)==THOT_ERROR)
+    return THOT_ERROR;
+
+  std::cerr<<"Reading word graph from file: "<<filename<<"\n";
+    
+      // Clear word graph
+  clear();
+
+      // Read component weights, initial state score and final states
+  for(unsigned int i=0;i<reader.numCompWeights();++i)
+  {
+    compWeights.push_back(std::make_pair(reader.compWeightName(i),reader.compWeightValue(i)));
+  }
+  initialStateScore=reader.initialStateScore();
+  for(unsigned int i=0;i<reader.numFinalStates();++i)
+  {
+    finalStateSet.insert(reader.finalStates()[i]);
+  }
+
+      // Obtain interned strings
+  std::vector<std::string> strVec(reader.numStrings());
+  for(unsigned int i=0;i<strVec.size();++i)
+    strVec[i]=reader.str(i);
+
+      // Read arcs. The arrays of the word graph are filled directly,
+      // arcs are registered in their states in the same order as
+      // addArc() does
+  wordGraphArcs.resize(reader.numArcs());
+  arcsPruned.resize(reader.numArcs(),false);
+  scrCompsVec.resize(reader.numArcs());
+  wordGraphStates.resize(reader.numStates());
+  for(WordGraphArcId wgArcId=0;wgArcId<reader.numArcs();++wgArcId)
+  {
+    const WgBinArc& binArc=reader.arc(wgArcId);
+    WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+    wgArc.predStateIndex=binArc.predStateIndex;
+    wgArc.succStateIndex=binArc.succStateIndex;
+    wgArc.arcScore=binArc.arcScore;
+    const uint32_t* wordIds=reader.arcWordIds(wgArcId);
+    wgArc.words.resize(binArc.numWords);
+    for(unsigned int i=0;i<binArc.numWords;++i)
+      wgArc.words[i]=strVec[wordIds[i]];
+    const float* scrComps=reader.arcScrComps(wgArcId);
+    scrCompsVec[wgArcId].assign(scrComps,scrComps+binArc.numScrComps);
+
+    wordGraphStates[binArc.predStateIndex].arcsToSuccStates.push_back(wgArcId);
+    wordGraphStates[binArc.succStateIndex].arcsToPredStates.push_back(wgArcId);
+  }
+
+  return THOT_OK;
+}
+
+//---------------------------------------
+bool WordGraph::printBin(const char* filename,
+                         bool printOnlyUsefulStates/*=false*/)const
+{
+  std::ofstream outS;
+
+  outS.open(filename,std::ios::out | std::ios::trunc | std::ios::binary);
+  if(!outS)
+  {
+    std::cerr<<"Error while printing recombination graph to file."<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+  {
+    bool ret=printBin(outS,printOnlyUsefulStates);
+    outS.close();
+    return ret;
+  }
+}
+
+//---------------------------------------
+bool WordGraph::printBin(std::ostream &outS,
+                         bool printOnlyUsefulStates/*=false*/)const
+{
+  WordGraphBinWriter writer;
+
+  if(writer.open(outS)==THOT_ERROR)
+    return THOT_ERROR;
+  
+  writer.setCompWeights(compWeights);
+  writer.setInitialStateScore(initialStateScore);
+
+      // Add final states
+  FinalStateSet::const_iterator finalStateSetIter;
+  for(finalStateSetIter=finalStateSet.begin();finalStateSetIter!=finalStateSet.end();++finalStateSetIter)
+  {
+    if(!finalStatePruned(*finalStateSetIter))
+      writer.addFinalState(*finalStateSetIter);
+  }
+
+      // Add arcs in topological order
+  std::vector<WordGraphArcId> arcIds;
+  obtainArcsToPrint(printOnlyUsefulStates,arcIds);
+  std::vector<WordGraphArcId> topolArcIds;
+  if(obtainTopolOrderOfArcs(arcIds,topolArcIds)==THOT_ERROR)
+    return THOT_ERROR;
+  for(unsigned int i=0;i<topolArcIds.size();++i)
+  {
+    const WordGraphArc& wgArc=wordGraphArcs[topolArcIds[i]];
+    if(writer.addArc(wgArc.predStateIndex,
+                     wgArc.succStateIndex,
+                     wgArc.words,
+                     wgArc.arcScore,
+                     scrCompsVec[topolArcIds[i]])==THOT_ERROR)
+      return THOT_ERROR;
+  }
+  
+  return writer.close();
+}
+
+//---------------------------------------
+void WordGraph::obtainArcsToPrint(bool printOnlyUsefulStates,
+                                  std::vector<WordGraphArcId>& arcIds)const
+{
+  arcIds.clear();
+  
+      // Obtain useful states
+  std::vector<bool> stateIsUsefulVec;
+  std::map<HypStateIndex,HypStateIndex> remappedStates;
+  if(printOnlyUsefulStates)
+    obtainUsefulStates(stateIsUsefulVec,remappedStates);
+
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  {
+    bool arcIsUseful=false;
+    if(printOnlyUsefulStates)
+      arcIsUseful=stateIsUsefulVec[wordGraphArcs[wgArcId].predStateIndex] && stateIsUsefulVec[wordGraphArcs[wgArcId].succStateIndex];
+    
+    if( (!printOnlyUsefulStates || arcIsUseful) && !arcsPruned[wgArcId])
+      arcIds.push_back(wgArcId);
+  }
+}
+
+//---------------------------------------
+bool WordGraph::obtainTopolOrderOfArcs(const std::vector<WordGraphArcId>& arcIds,
+                                       std::vector<WordGraphArcId>& topolArcIds)const
+{
+  topolArcIds.clear();
+
+      // Check if the current order is topological, that is, no arc
+      // arrives to a state after an arc leaving from it
+  std::vector<bool> stateHasSuccArcs(wordGraphStates.size(),false);
+  bool ordered=true;
+  for(unsigned int i=0;i<arcIds.size();++i)
+  {
+    const WordGraphArc& wgArc=wordGraphArcs[arcIds[i]];
+    if(stateHasSuccArcs[wgArc.succStateIndex])
+    {
+      ordered=false;
+      break;
+    }
+    stateHasSuccArcs[wgArc.predStateIndex]=true;
+  }
+  if(ordered)
+  {
+    topolArcIds=arcIds;
+    return THOT_OK;
+  }
+
+      // Sort arcs by means of a topological sort of the states, the
+      // arcs leaving from a state are added when all the arcs arriving
+      // to it have been added
+  std::vector<unsigned int> numPendingPredArcs(wordGraphStates.size(),0);
+  std::vector<std::vector<WordGraphArcId> > succArcIds(wordGraphStates.size());
+  for(unsigned int i=0;i<arcIds.size();++i)
+  {
+    const WordGraphArc& wgArc=wordGraphArcs[arcIds[i]];
+    ++numPendingPredArcs[wgArc.succStateIndex];
+    succArcIds[wgArc.predStateIndex].push_back(arcIds[i]);
+  }
+  std::vector<HypStateIndex> stateQueue;
+  for(HypStateIndex idx=0;idx<wordGraphStates.size();++idx)
+  {
+    if(numPendingPredArcs[idx]==0 && !succArcIds[idx].empty())
+      stateQueue.push_back(idx);
+  }
+  for(unsigned int q=0;q<stateQueue.size();++q)
+  {
+    HypStateIndex idx=stateQueue[q];
+    for(unsigned int i=0;i<succArcIds[idx].size();++i)
+    {
+      HypStateIndex succIdx=wordGraphArcs[succArcIds[idx][i]].succStateIndex;
+      topolArcIds.push_back(succArcIds[idx][i]);
+      --numPendingPredArcs[succIdx];
+      if(numPendingPredArcs[succIdx]==0 && !succArcIds[succIdx].empty())
+        stateQueue.push_back(succIdx);
+    }
+  }
+  if(topolArcIds.size()!=arcIds.size())
+  {
+    std::cerr<<"Error while sorting arcs of word graph in topological order, anomalous word-graph"<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
 //---------------------------------------
 bool WordGraph::empty(void)const
 {
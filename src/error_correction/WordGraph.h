@@ -40,12 +40,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <map>
 #include "ErrorDefs.h"
 #include "AwkInputStream.h"
+#include "WordGraphBinReader.h"
+#include "WordGraphBinWriter.h"
 #include "WordGraphArc.h"
 #include "WordGraphArcId.h"
 #include "WordGraphStateData.h"
 #include "NbSearchHighLevelHyp.h"
 #include "NbSearchHyp.h"
-#include "NbSearchStack.h"
 #include <algorithm>
 #include <limits.h>
 
@@ -57,7 +58,6 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define UNLIMITED_DENSITY   -1
 #define DISABLE_WORDGRAPH    2
 #define SMALL_SCORE          -999999999
-#define NBEST_MAX_STACK_SIZE 10000
 
 //--------------- Classes --------------------------------------------
 
@@ -141,6 +141,12 @@ class WordGraph
       // score component weights can be given
   void calcRestScores(std::vector<Score>& restScores)const;
       // Calculate rest scores from each node
+  void calcArcLogPosteriors(std::vector<Score>& arcLogPosteriors)const;
+      // Calculate the logarithm of the posterior probability of each
+      // arc by means of the forward-backward algorithm, the scores of
+      // the arcs are interpreted as log-probabilities. Pruned arcs and
+      // arcs that do not belong to complete paths are given
+      // SMALL_SCORE
   
       // IMPORTANT NOTE: these functions work correctly if and only if
       // whenever an arc is added with the addArc() function, the
@@ -183,6 +189,17 @@ class WordGraph
       // predStateIndex state is not used as the succStateIndex argument
       // by subsequent calls to addArc(). If the previous condition is
       // true, then the arcs are topologically ordered.
+  unsigned int pruneGivenDensity(float density,
+                                 unsigned int numSrcWords);
+      // Prune the word graph so as to retain about density*numSrcWords
+      // arcs. Arcs are added in decreasing order of posterior
+      // probability together with the best path going through them, so
+      // the remaining arcs always form complete paths. If
+      // density=UNLIMITED_DENSITY, then no pruning is performed. The
+      // function returns the number of pruned arcs.
+      //
+      // IMPORTANT NOTE: as in the prune() function, arcs are assumed to
+      // be topologically ordered.
   bool arcPruned(WordGraphArcId wordGraphArcId)const;
       // Return true if a given arc was pruned
 
@@ -204,6 +221,8 @@ class WordGraph
 
       // Functions to load word graphs
   bool load(const char * filename);
+      // Word graphs can be given in text or binary format (see
+      // WordGraphBinDefs.h), the format is detected automatically
 
       // Functions to print word graphs
       //
@@ -215,6 +234,13 @@ class WordGraph
              bool printOnlyUsefulStates=false)const;
   void print(std::ostream &outS,
              bool printOnlyUsefulStates=false)const;
+  bool printBin(const char* filename,
+                bool printOnlyUsefulStates=false)const;
+  bool printBin(std::ostream &outS,
+                bool printOnlyUsefulStates=false)const;
+      // Print word graph in binary format. Arcs are written in
+      // topological order (the current order is kept if it is already
+      // topological)
   
       // size related functions
   bool empty(void)const;
@@ -236,6 +262,18 @@ class WordGraph
   std::vector<std::pair<std::string,float> > compWeights;
   std::vector<std::vector<Score> > scrCompsVec;
 
+      // Auxiliary functions to load and print word graphs
+  bool loadBin(const char * filename);
+  void obtainArcsToPrint(bool printOnlyUsefulStates,
+                         std::vector<WordGraphArcId>& arcIds)const;
+      // Obtains the arcs that are printed, that is, non-pruned arcs
+      // (connecting useful states if printOnlyUsefulStates is true)
+  bool obtainTopolOrderOfArcs(const std::vector<WordGraphArcId>& arcIds,
+                              std::vector<WordGraphArcId>& topolArcIds)const;
+      // Sorts the given arcs in topological order, keeping the
+      // current order if it is already topological. Returns THOT_ERROR
+      // if the arcs contain a cycle
+
       // Auxiliary functions for pruning
   unsigned int pruneArcsToPredStates(float threshold);
   bool finalStatePruned(HypStateIndex hypStateIndex)const;
@@ -243,15 +281,62 @@ class WordGraph
       // Miscelaneous functions
   void rescoreArcsGivenWeights(const std::vector<std::pair<std::string,float> >& _compWeights);
   bool checkIfAltWeightsAppliable(const std::vector<float>& altCompWeights)const;
-  void obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState);
   NbSearchHighLevelHyp hypToHighLevelHyp(const NbSearchHyp& hyp);
+
+      // Data structures for the n-best search. The k-th best path
+      // arriving to a state is represented by its last arc and the
+      // position of the rest of the path in the list of paths of the
+      // predecessor state of the arc
+  struct NbSearchPath
+  {
+    Score score;
+    WordGraphArcId arcId;
+    unsigned int predPathIdx;
+    bool operator<(const NbSearchPath& right)const
+      {
+        if(score!=right.score)
+          return score<right.score;
+        if(arcId!=right.arcId)
+          return arcId>right.arcId;
+        return predPathIdx>right.predPathIdx;
+      }
+  };
+  struct NbSearchStateInfo
+  {
+    std::vector<NbSearchPath> paths;
+        // Best paths found so far in decreasing order of score
+    std::vector<NbSearchPath> candidates;
+        // Heap of candidate paths that can be the next best path
+    bool candidatesInitialized;
+    bool lastPathExtended;
+    bool exhausted;
+  };
+
   void nbSearch(unsigned int len,
-                const std::vector<Score>& heurForEachState,
                 std::vector<std::pair<Score,std::string> >& nblist,
                 std::vector<NbSearchHyp>& hypList,
                 std::vector<std::vector<Score> >& scoreCompsVec,
                 int verbosity=false);
-  bool hypIsComplete(const NbSearchHyp& nbSearchHyp);
+      // Obtains the len best paths from the initial state to final
+      // states by means of the recursive enumeration algorithm of
+      // Jimenez and Marzal. Paths are extended lazily, only the paths
+      // required to obtain the n-best list are generated.
+      // WARNING: arcs must be topologically ordered
+  void initNbSearchStateInfo(const std::vector<bool>& stateIsFinalVec,
+                             std::vector<NbSearchStateInfo>& stateInfoVec)const;
+      // Obtains the best path arriving to each state. Arcs leaving from
+      // final states (other than the initial state) are not taken into
+      // account, so that paths end at the first final state reached
+  bool obtainNthPathForState(HypStateIndex hypStateIndex,
+                             unsigned int n,
+                             const std::vector<bool>& stateIsFinalVec,
+                             std::vector<NbSearchStateInfo>& stateInfoVec)const;
+      // Generates the paths arriving to a state until its n-th path
+      // (starting from zero) is available, returns false if the state
+      // has no more than n paths
+  NbSearchHyp nbSearchPathToHyp(HypStateIndex hypStateIndex,
+                                unsigned int pathIdx,
+                                const std::vector<NbSearchStateInfo>& stateInfoVec)const;
   std::string stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp,
                                     std::vector<Score>& scoreComps);
   Score bestPathFromFinalStateToIdxAux(HypStateIndex hypStateIndex,
@@ -0,0 +1,88 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphBinDefs.h
+ *
+ * @brief Constants and types of the binary format for word graphs. A
+ * word graph in this format is composed of a header (magic string and
+ * version), the array of arcs in topological order, the array of word
+ * ids of the arcs, the array of score components of the arcs (packed
+ * as floats), the array of final states, the names (as string ids) and
+ * values of the component weights, the string table of the graph
+ * (offsets and characters of each interned string) and a trailer with
+ * the size of each array. Keeping the sizes in the trailer allows the
+ * arcs to be written as they are generated. All arrays are aligned to
+ * 8 bytes, so the file can be memory-mapped.
+ */
+
+#ifndef _WordGraphBinDefs_h
+#define _WordGraphBinDefs_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stddef.h>
+#include <stdint.h>
+
+//--------------- Constants ------------------------------------------
+
+#define WORD_GRAPH_BIN_MAGIC         "thot_wgraph_bin"
+#define WORD_GRAPH_BIN_MAGIC_LEN     16
+#define WORD_GRAPH_BIN_VERSION       1
+#define WORD_GRAPH_BIN_HEADER_LEN    (WORD_GRAPH_BIN_MAGIC_LEN+2*sizeof(uint32_t))
+#define WORD_GRAPH_BIN_TRAILER_LEN   (9*sizeof(uint64_t))
+
+//--------------- Type definitions -----------------------------------
+
+struct WgBinArc
+{
+  uint32_t predStateIndex;
+  uint32_t succStateIndex;
+  float arcScore;
+  uint32_t firstWord;
+  uint32_t numWords;
+  uint32_t firstScrComp;
+  uint32_t numScrComps;
+};
+
+struct WgBinTrailer
+{
+  uint64_t numStates;
+  uint64_t numArcs;
+  uint64_t numWordIds;
+  uint64_t numScrComps;
+  uint64_t numFinalStates;
+  uint64_t numCompWeights;
+  uint64_t numStrings;
+  uint64_t numStrChars;
+  float initialStateScore;
+  uint32_t reserved;
+};
+
+//--------------- Function definitions -------------------------------
+
+inline size_t wordGraphBinAlignedSize(size_t bytes)
+{
+  return (bytes+7) & ~((size_t)7);
+}
+
+#endif
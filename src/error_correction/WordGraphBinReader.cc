@@ -0,0 +1,298 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphBinReader.cc
+ *
+ * @brief Definitions file for WordGraphBinReader.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WordGraphBinReader.h"
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//--------------- WordGraphBinReader class function definitions
+
+//-------------------------
+WordGraphBinReader::WordGraphBinReader(void)
+{
+  mapAddr=NULL;
+  mapLength=0;
+  close();
+}
+
+//-------------------------
+bool WordGraphBinReader::isBinWordGraph(const char* fileName)
+{
+  FILE* file=fopen(fileName,"rb");
+  if(file==NULL)
+    return false;
+  char magic[WORD_GRAPH_BIN_MAGIC_LEN];
+  bool result=(fread(magic,1,WORD_GRAPH_BIN_MAGIC_LEN,file)==WORD_GRAPH_BIN_MAGIC_LEN
+               && strncmp(magic,WORD_GRAPH_BIN_MAGIC,WORD_GRAPH_BIN_MAGIC_LEN)==0);
+  fclose(file);
+  return result;
+}
+
+//-------------------------
+bool WordGraphBinReader::open(const char* fileName)
+{
+  close();
+
+  int fd=::open(fileName,O_RDONLY);
+  if(fd<0)
+  {
+    std::cerr<<"Error while opening word graph file: "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)!=0)
+  {
+    std::cerr<<"Error while obtaining size of word graph file: "<<fileName<<std::endl;
+    ::close(fd);
+    return THOT_ERROR;
+  }
+  size_t length=fileStat.st_size;
+  if(length<WORD_GRAPH_BIN_HEADER_LEN+WORD_GRAPH_BIN_TRAILER_LEN)
+  {
+    std::cerr<<"Error, word graph file "<<fileName<<" is truncated"<<std::endl;
+    ::close(fd);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,length,PROT_READ,MAP_SHARED,fd,0);
+  ::close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping word graph file: "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  mapAddr=addr;
+  mapLength=length;
+
+      // Read header and trailer
+  const char* base=(const char*) addr;
+  uint32_t version;
+  memcpy(&version,base+WORD_GRAPH_BIN_MAGIC_LEN,sizeof(uint32_t));
+  if(version!=WORD_GRAPH_BIN_VERSION)
+  {
+    std::cerr<<"Error, word graph file "<<fileName<<" has version "<<version<<" (expected "<<WORD_GRAPH_BIN_VERSION<<")"<<std::endl;
+    close();
+    return THOT_ERROR;
+  }
+  memcpy(&trailer,base+length-WORD_GRAPH_BIN_TRAILER_LEN,sizeof(WgBinTrailer));
+
+      // Set pointers to the arrays
+  size_t offset=WORD_GRAPH_BIN_HEADER_LEN;
+  size_t requiredLength=offset+wordGraphBinAlignedSize(trailer.numArcs*sizeof(WgBinArc))
+    +wordGraphBinAlignedSize(trailer.numWordIds*sizeof(uint32_t))
+    +wordGraphBinAlignedSize(trailer.numScrComps*sizeof(float))
+    +wordGraphBinAlignedSize(trailer.numFinalStates*sizeof(uint32_t))
+    +wordGraphBinAlignedSize(trailer.numCompWeights*sizeof(uint32_t))
+    +wordGraphBinAlignedSize(trailer.numCompWeights*sizeof(float))
+    +(trailer.numStrings+1)*sizeof(uint64_t)
+    +wordGraphBinAlignedSize(trailer.numStrChars)+WORD_GRAPH_BIN_TRAILER_LEN;
+  if(length!=requiredLength)
+  {
+    std::cerr<<"Error, word graph file "<<fileName<<" is truncated"<<std::endl;
+    close();
+    return THOT_ERROR;
+  }
+  arcs=(const WgBinArc*)(base+offset);
+  offset+=wordGraphBinAlignedSize(trailer.numArcs*sizeof(WgBinArc));
+  wordIds=(const uint32_t*)(base+offset);
+  offset+=wordGraphBinAlignedSize(trailer.numWordIds*sizeof(uint32_t));
+  scrComps=(const float*)(base+offset);
+  offset+=wordGraphBinAlignedSize(trailer.numScrComps*sizeof(float));
+  finalStatesPtr=(const uint32_t*)(base+offset);
+  offset+=wordGraphBinAlignedSize(trailer.numFinalStates*sizeof(uint32_t));
+  compWeightNameIds=(const uint32_t*)(base+offset);
+  offset+=wordGraphBinAlignedSize(trailer.numCompWeights*sizeof(uint32_t));
+  compWeightValues=(const float*)(base+offset);
+  offset+=wordGraphBinAlignedSize(trailer.numCompWeights*sizeof(float));
+  strOffsets=(const uint64_t*)(base+offset);
+  offset+=(trailer.numStrings+1)*sizeof(uint64_t);
+  strChars=base+offset;
+
+      // Check that the indices stored in the arrays are within range
+  if(!indicesAreValid())
+  {
+    std::cerr<<"Error, word graph file "<<fileName<<" is corrupted"<<std::endl;
+    close();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool WordGraphBinReader::indicesAreValid(void)const
+{
+  for(uint64_t i=0;i<trailer.numArcs;++i)
+  {
+    if(arcs[i].predStateIndex>=trailer.numStates || arcs[i].succStateIndex>=trailer.numStates)
+      return false;
+    if((uint64_t)arcs[i].firstWord+arcs[i].numWords>trailer.numWordIds)
+      return false;
+    if((uint64_t)arcs[i].firstScrComp+arcs[i].numScrComps>trailer.numScrComps)
+      return false;
+  }
+  for(uint64_t i=0;i<trailer.numWordIds;++i)
+  {
+    if(wordIds[i]>=trailer.numStrings)
+      return false;
+  }
+  for(uint64_t i=0;i<trailer.numFinalStates;++i)
+  {
+    if(finalStatesPtr[i]>=trailer.numStates)
+      return false;
+  }
+  for(uint64_t i=0;i<trailer.numCompWeights;++i)
+  {
+    if(compWeightNameIds[i]>=trailer.numStrings)
+      return false;
+  }
+  for(uint64_t i=0;i<trailer.numStrings;++i)
+  {
+    if(strOffsets[i]>strOffsets[i+1])
+      return false;
+  }
+  return strOffsets[trailer.numStrings]==trailer.numStrChars;
+}
+
+//-------------------------
+uint64_t WordGraphBinReader::numStates(void)const
+{
+  return trailer.numStates;
+}
+
+//-------------------------
+uint64_t WordGraphBinReader::numArcs(void)const
+{
+  return trailer.numArcs;
+}
+
+//-------------------------
+const WgBinArc& WordGraphBinReader::arc(uint64_t arcId)const
+{
+  return arcs[arcId];
+}
+
+//-------------------------
+const uint32_t* WordGraphBinReader::arcWordIds(uint64_t arcId)const
+{
+  return wordIds+arcs[arcId].firstWord;
+}
+
+//-------------------------
+const float* WordGraphBinReader::arcScrComps(uint64_t arcId)const
+{
+  return scrComps+arcs[arcId].firstScrComp;
+}
+
+//-------------------------
+uint64_t WordGraphBinReader::numFinalStates(void)const
+{
+  return trailer.numFinalStates;
+}
+
+//-------------------------
+const uint32_t* WordGraphBinReader::finalStates(void)const
+{
+  return finalStatesPtr;
+}
+
+//-------------------------
+uint64_t WordGraphBinReader::numCompWeights(void)const
+{
+  return trailer.numCompWeights;
+}
+
+//-------------------------
+std::string WordGraphBinReader::compWeightName(uint64_t i)const
+{
+  return str(compWeightNameIds[i]);
+}
+
+//-------------------------
+float WordGraphBinReader::compWeightValue(uint64_t i)const
+{
+  return compWeightValues[i];
+}
+
+//-------------------------
+float WordGraphBinReader::initialStateScore(void)const
+{
+  return trailer.initialStateScore;
+}
+
+//-------------------------
+uint64_t WordGraphBinReader::numStrings(void)const
+{
+  return trailer.numStrings;
+}
+
+//-------------------------
+const char* WordGraphBinReader::strBegin(uint32_t strId)const
+{
+  return strChars+strOffsets[strId];
+}
+
+//-------------------------
+size_t WordGraphBinReader::strLen(uint32_t strId)const
+{
+  return strOffsets[strId+1]-strOffsets[strId];
+}
+
+//-------------------------
+std::string WordGraphBinReader::str(uint32_t strId)const
+{
+  return std::string(strBegin(strId),strLen(strId));
+}
+
+//-------------------------
+void WordGraphBinReader::close(void)
+{
+  if(mapAddr!=NULL)
+  {
+    munmap(mapAddr,mapLength);
+    mapAddr=NULL;
+    mapLength=0;
+  }
+  memset(&trailer,0,sizeof(WgBinTrailer));
+  arcs=NULL;
+  wordIds=NULL;
+  scrComps=NULL;
+  finalStatesPtr=NULL;
+  compWeightNameIds=NULL;
+  compWeightValues=NULL;
+  strOffsets=NULL;
+  strChars=NULL;
+}
+
+//-------------------------
+WordGraphBinReader::~WordGraphBinReader()
+{
+  close();
+}
@@ -0,0 +1,103 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphBinReader.h
+ *
+ * @brief Defines the WordGraphBinReader class, which gives read-only
+ * access to a word graph stored in the binary format described in
+ * WordGraphBinDefs.h. The file is memory-mapped, opening it only
+ * requires setting the pointers to its arrays and checking that the
+ * indices they contain are within range.
+ */
+
+#ifndef _WordGraphBinReader_h
+#define _WordGraphBinReader_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordGraphBinDefs.h"
+#include "ErrorDefs.h"
+#include <string>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WordGraphBinReader class
+
+class WordGraphBinReader
+{
+ public:
+
+      // Constructor
+  WordGraphBinReader(void);
+
+  bool open(const char* fileName);
+  static bool isBinWordGraph(const char* fileName);
+      // Returns true if the given file contains a binary word graph
+
+      // Functions to access the word graph
+  uint64_t numStates(void)const;
+  uint64_t numArcs(void)const;
+  const WgBinArc& arc(uint64_t arcId)const;
+  const uint32_t* arcWordIds(uint64_t arcId)const;
+  const float* arcScrComps(uint64_t arcId)const;
+  uint64_t numFinalStates(void)const;
+  const uint32_t* finalStates(void)const;
+  uint64_t numCompWeights(void)const;
+  std::string compWeightName(uint64_t i)const;
+  float compWeightValue(uint64_t i)const;
+  float initialStateScore(void)const;
+  uint64_t numStrings(void)const;
+  const char* strBegin(uint32_t strId)const;
+  size_t strLen(uint32_t strId)const;
+      // Return the characters of the given interned string, they are
+      // not terminated by '\0'
+  std::string str(uint32_t strId)const;
+
+      // close function
+  void close(void);
+
+      // Destructor
+  ~WordGraphBinReader();
+
+ protected:
+
+  void* mapAddr;
+  size_t mapLength;
+  WgBinTrailer trailer;
+  const WgBinArc* arcs;
+  const uint32_t* wordIds;
+  const float* scrComps;
+  const uint32_t* finalStatesPtr;
+  const uint32_t* compWeightNameIds;
+  const float* compWeightValues;
+  const uint64_t* strOffsets;
+  const char* strChars;
+
+  bool indicesAreValid(void)const;
+
+      // Forbid copies
+  WordGraphBinReader(const WordGraphBinReader&);
+  WordGraphBinReader& operator=(const WordGraphBinReader&);
+};
+
+#endif
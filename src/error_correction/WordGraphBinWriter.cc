@@ -0,0 +1,206 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphBinWriter.cc
+ *
+ * @brief Definitions file for WordGraphBinWriter.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WordGraphBinWriter.h"
+#include <string.h>
+
+//--------------- WordGraphBinWriter class function definitions
+
+//-------------------------
+WordGraphBinWriter::WordGraphBinWriter(void)
+{
+  outS=NULL;
+  memset(&trailer,0,sizeof(WgBinTrailer));
+}
+
+//-------------------------
+bool WordGraphBinWriter::open(std::ostream& outStream)
+{
+  outS=&outStream;
+  memset(&trailer,0,sizeof(WgBinTrailer));
+  wordIds.clear();
+  scrComps.clear();
+  finalStates.clear();
+  compWeightNameIds.clear();
+  compWeightValues.clear();
+  strIdMap.clear();
+  strOffsets.clear();
+  strOffsets.push_back(0);
+  strChars.clear();
+  stateHasSuccArcs.clear();
+
+  char magic[WORD_GRAPH_BIN_MAGIC_LEN];
+  memset(magic,0,WORD_GRAPH_BIN_MAGIC_LEN);
+  memcpy(magic,WORD_GRAPH_BIN_MAGIC,strlen(WORD_GRAPH_BIN_MAGIC));
+  uint32_t version=WORD_GRAPH_BIN_VERSION;
+  uint32_t reserved=0;
+  outS->write(magic,WORD_GRAPH_BIN_MAGIC_LEN);
+  outS->write((char*)&version,sizeof(uint32_t));
+  outS->write((char*)&reserved,sizeof(uint32_t));
+
+  if(outS->good())
+    return THOT_OK;
+  else
+  {
+    std::cerr<<"Error while writing header of word graph"<<std::endl;
+    return THOT_ERROR;
+  }
+}
+
+//-------------------------
+void WordGraphBinWriter::setCompWeights(const std::vector<std::pair<std::string,float> >& compWeights)
+{
+  compWeightNameIds.clear();
+  compWeightValues.clear();
+  for(unsigned int i=0;i<compWeights.size();++i)
+  {
+    compWeightNameIds.push_back(internString(compWeights[i].first));
+    compWeightValues.push_back(compWeights[i].second);
+  }
+}
+
+//-------------------------
+void WordGraphBinWriter::setInitialStateScore(Score initialStateScore)
+{
+  trailer.initialStateScore=initialStateScore;
+}
+
+//-------------------------
+void WordGraphBinWriter::addFinalState(HypStateIndex finalStateIndex)
+{
+  finalStates.push_back(finalStateIndex);
+}
+
+//-------------------------
+bool WordGraphBinWriter::addArc(HypStateIndex predStateIndex,
+                                HypStateIndex succStateIndex,
+                                const std::vector<std::string>& words,
+                                Score arcScore,
+                                const std::vector<Score>& scrVec)
+{
+      // Check order of arcs
+  if(succStateIndex<stateHasSuccArcs.size() && stateHasSuccArcs[succStateIndex])
+  {
+    std::cerr<<"Error, arcs of word graph are not topologically ordered (arc "<<predStateIndex<<" -> "<<succStateIndex<<" given after an arc leaving "<<succStateIndex<<")"<<std::endl;
+    return THOT_ERROR;
+  }
+  if(predStateIndex>=stateHasSuccArcs.size())
+    stateHasSuccArcs.resize(predStateIndex+1,false);
+  stateHasSuccArcs[predStateIndex]=true;
+
+      // Update number of states
+  if(predStateIndex>=trailer.numStates)
+    trailer.numStates=predStateIndex+1;
+  if(succStateIndex>=trailer.numStates)
+    trailer.numStates=succStateIndex+1;
+
+  WgBinArc arc;
+  memset(&arc,0,sizeof(WgBinArc));
+  arc.predStateIndex=predStateIndex;
+  arc.succStateIndex=succStateIndex;
+  arc.arcScore=arcScore;
+  arc.firstWord=wordIds.size();
+  arc.numWords=words.size();
+  arc.firstScrComp=scrComps.size();
+  arc.numScrComps=scrVec.size();
+  for(unsigned int i=0;i<words.size();++i)
+    wordIds.push_back(internString(words[i]));
+  for(unsigned int i=0;i<scrVec.size();++i)
+    scrComps.push_back(scrVec[i]);
+  outS->write((char*)&arc,sizeof(WgBinArc));
+  ++trailer.numArcs;
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool WordGraphBinWriter::close(void)
+{
+  trailer.numWordIds=wordIds.size();
+  trailer.numScrComps=scrComps.size();
+  trailer.numFinalStates=finalStates.size();
+  trailer.numCompWeights=compWeightNameIds.size();
+  trailer.numStrings=strOffsets.size()-1;
+  trailer.numStrChars=strChars.size();
+
+      // Write arrays
+  writePadded(NULL,trailer.numArcs*sizeof(WgBinArc));
+  writePadded(wordIds.empty()?NULL:&wordIds[0],wordIds.size()*sizeof(uint32_t));
+  writePadded(scrComps.empty()?NULL:&scrComps[0],scrComps.size()*sizeof(float));
+  writePadded(finalStates.empty()?NULL:&finalStates[0],finalStates.size()*sizeof(uint32_t));
+  writePadded(compWeightNameIds.empty()?NULL:&compWeightNameIds[0],compWeightNameIds.size()*sizeof(uint32_t));
+  writePadded(compWeightValues.empty()?NULL:&compWeightValues[0],compWeightValues.size()*sizeof(float));
+  writePadded(&strOffsets[0],strOffsets.size()*sizeof(uint64_t));
+  writePadded(strChars.data(),strChars.size());
+
+      // Write trailer
+  outS->write((char*)&trailer,sizeof(WgBinTrailer));
+  outS->flush();
+
+  if(outS->good())
+    return THOT_OK;
+  else
+  {
+    std::cerr<<"Error while writing word graph"<<std::endl;
+    return THOT_ERROR;
+  }
+}
+
+//-------------------------
+uint64_t WordGraphBinWriter::numArcs(void)const
+{
+  return trailer.numArcs;
+}
+
+//-------------------------
+uint32_t WordGraphBinWriter::internString(const std::string& str)
+{
+  std::map<std::string,uint32_t>::iterator iter=strIdMap.find(str);
+  if(iter!=strIdMap.end())
+    return iter->second;
+
+  uint32_t id=strOffsets.size()-1;
+  strIdMap[str]=id;
+  strChars.append(str);
+  strOffsets.push_back(strChars.size());
+  return id;
+}
+
+//-------------------------
+bool WordGraphBinWriter::writePadded(const void* data,
+                                     size_t bytes)
+{
+      // data is NULL when only the padding of an array that has
+      // already been written is required
+  const char padding[8]={0,0,0,0,0,0,0,0};
+
+  if(data!=NULL && bytes>0)
+    outS->write((const char*)data,bytes);
+  size_t padLen=wordGraphBinAlignedSize(bytes)-bytes;
+  if(padLen>0)
+    outS->write(padding,padLen);
+  return outS->good()?THOT_OK:THOT_ERROR;
+}
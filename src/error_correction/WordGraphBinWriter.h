@@ -0,0 +1,95 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphBinWriter.h
+ *
+ * @brief Defines the WordGraphBinWriter class, which writes word graphs
+ * in the binary format described in WordGraphBinDefs.h. Arcs are
+ * written to the output stream as they are added, only the word ids,
+ * the score components, the final states and the string table are
+ * kept in memory until the writer is closed.
+ */
+
+#ifndef _WordGraphBinWriter_h
+#define _WordGraphBinWriter_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordGraphBinDefs.h"
+#include "HypStateIndex.h"
+#include "Score.h"
+#include "ErrorDefs.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WordGraphBinWriter class
+
+class WordGraphBinWriter
+{
+ public:
+
+      // Constructor
+  WordGraphBinWriter(void);
+
+  bool open(std::ostream& outStream);
+      // Writes the header of the word graph to outStream
+  void setCompWeights(const std::vector<std::pair<std::string,float> >& compWeights);
+  void setInitialStateScore(Score initialStateScore);
+  void addFinalState(HypStateIndex finalStateIndex);
+  bool addArc(HypStateIndex predStateIndex,
+              HypStateIndex succStateIndex,
+              const std::vector<std::string>& words,
+              Score arcScore,
+              const std::vector<Score>& scrVec);
+      // Appends an arc. Arcs must be added in topological order, that
+      // is, no arc can arrive to a state after an arc leaving from it
+      // has been added
+  bool close(void);
+      // Writes the remaining arrays and the trailer
+
+  uint64_t numArcs(void)const;
+
+ protected:
+
+  std::ostream* outS;
+  WgBinTrailer trailer;
+  std::vector<uint32_t> wordIds;
+  std::vector<float> scrComps;
+  std::vector<uint32_t> finalStates;
+  std::vector<uint32_t> compWeightNameIds;
+  std::vector<float> compWeightValues;
+  std::map<std::string,uint32_t> strIdMap;
+  std::vector<uint64_t> strOffsets;
+  std::string strChars;
+  std::vector<bool> stateHasSuccArcs;
+
+  uint32_t internString(const std::string& str);
+  bool writePadded(const void* data,
+                   size_t bytes);
+};
+
+#endif
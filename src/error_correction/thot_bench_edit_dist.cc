@@ -0,0 +1,223 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_edit_dist.cc
+ *
+ * @brief Micro-benchmark for the edit distance between strings used by
+ * the error correcting models. For pairs of random words of different
+ * lengths (the second one obtained by editing the first one), the edit
+ * distance is obtained both by filling the whole distance matrix and by
+ * means of the calculateEditDistOpCost() function of the EditDistForStr
+ * class. The latter uses the bit-vector algorithm for words with no
+ * more than EDIT_DIST_BIT_PARALLEL_MAX_LEN characters when the hit cost
+ * is zero, and keeps only two rows of the distance matrix otherwise.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "EditDistForStr.h"
+#include "ErrorDefs.h"
+#include "ctimer.h"
+#include "options.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//--------------- Function Declarations ------------------------------
+
+std::string genRandomWord(unsigned int len);
+std::string editWord(const std::string& word);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Global variables -----------------------------------
+
+unsigned int maxLen=128;
+unsigned int alphabetSize=26;
+unsigned int numPairs=10000;
+unsigned int seed=31415;
+bool prefixDist=false;
+float hitCost=0;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_ERROR)
+    return THOT_ERROR;
+
+  srand(seed);
+
+  EditDistForStr editDist;
+  editDist.setErrorModel(hitCost,1,1,1);
+  double elapsed_ant,elapsed,ucpu,scpu;
+
+  printf("Len\tPairs\tAvgDist\tMismatches\tMatrix(us)\tOpCost(us)\n");
+  for(unsigned int len=1;len<=maxLen;len*=2)
+  {
+        // Obtain word pairs
+    std::vector<std::string> xVec;
+    std::vector<std::string> yVec;
+    for(unsigned int n=0;n<numPairs;++n)
+    {
+      std::string word=genRandomWord(len);
+      xVec.push_back(editWord(word));
+      yVec.push_back(word);
+    }
+
+        // Measure time of the distance matrix
+    std::vector<Score> matrixDists(numPairs);
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    for(unsigned int n=0;n<numPairs;++n)
+    {
+      if(prefixDist)
+        matrixDists[n]=editDist.calculateEditDistPrefix(xVec[n],yVec[n]);
+      else
+        matrixDists[n]=editDist.calculateEditDist(xVec[n],yVec[n]);
+    }
+    ctimer(&elapsed,&ucpu,&scpu);
+    double matrixTime=elapsed-elapsed_ant;
+
+        // Measure time of the operation cost
+    std::vector<Score> opCostDists(numPairs);
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    for(unsigned int n=0;n<numPairs;++n)
+    {
+      if(prefixDist)
+        opCostDists[n]=editDist.calculateEditDistPrefixOpCost(xVec[n],yVec[n]);
+      else
+        opCostDists[n]=editDist.calculateEditDistOpCost(xVec[n],yVec[n]);
+    }
+    ctimer(&elapsed,&ucpu,&scpu);
+    double opCostTime=elapsed-elapsed_ant;
+
+        // Check results
+    unsigned int numMismatches=0;
+    double sumDist=0;
+    for(unsigned int n=0;n<numPairs;++n)
+    {
+      sumDist+=matrixDists[n];
+      if(fabs(matrixDists[n]-opCostDists[n])>0.0001)
+        ++numMismatches;
+    }
+
+    printf("%u\t%u\t%g\t%u\t%g\t%g\n",len,numPairs,sumDist/numPairs,
+           numMismatches,1000000*matrixTime/numPairs,
+           1000000*opCostTime/numPairs);
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+std::string genRandomWord(unsigned int len)
+{
+  std::string word;
+  for(unsigned int j=0;j<len;++j)
+    word.push_back('a'+rand()%alphabetSize);
+  return word;
+}
+
+//---------------
+std::string editWord(const std::string& word)
+{
+      // Apply a random number of insertions, deletions and
+      // substitutions (about one every four characters)
+  std::string editedWord=word;
+  unsigned int numEdits=rand()%(word.size()/4+2);
+  for(unsigned int e=0;e<numEdits;++e)
+  {
+    unsigned int pos=rand()%(editedWord.size()+1);
+    switch(rand()%3)
+    {
+      case 0:
+        editedWord.insert(pos,1,'a'+rand()%alphabetSize);
+        break;
+      case 1:
+        if(pos<editedWord.size())
+          editedWord.erase(pos,1);
+        break;
+      default:
+        if(pos<editedWord.size())
+          editedWord[pos]='a'+rand()%alphabetSize;
+        break;
+    }
+  }
+  return editedWord;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+  readUnsignedInt(argc,argv, "-l", &maxLen);
+  readUnsignedInt(argc,argv, "-a", &alphabetSize);
+  readUnsignedInt(argc,argv, "-n", &numPairs);
+  readUnsignedInt(argc,argv, "-s", &seed);
+  if(readOption(argc,argv,"-p")!=-1)
+    prefixDist=true;
+  readFloat(argc,argv, "-hc", &hitCost);
+  if(maxLen==0 || numPairs==0 || alphabetSize==0 || alphabetSize>26)
+  {
+    std::cerr<<"Error: -l and -n values must be greater than zero and -a value must be between 1 and 26"<<std::endl;
+    return THOT_ERROR;
+  }
+  if(hitCost<0)
+  {
+    std::cerr<<"Error: -hc value must not be negative"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_bench_edit_dist [-l <int>] [-a <int>] [-n <int>] [-s <int>]\n");
+  printf("                            [-p] [-hc <float>] [--help]\n\n");
+  printf("-l <int>                    Maximum word length, lengths are doubled from 1\n");
+  printf("                            up to this value (128 by default).\n\n");
+  printf("-a <int>                    Alphabet size (26 by default).\n\n");
+  printf("-n <int>                    Number of word pairs per length (10000 by\n");
+  printf("                            default).\n\n");
+  printf("-s <int>                    Seed for the random number generator (31415 by\n");
+  printf("                            default).\n\n");
+  printf("-p                          Obtain the edit distance given that the second\n");
+  printf("                            word is an incomplete prefix.\n\n");
+  printf("-hc <float>                 Cost of the hit operation, the cost of the\n");
+  printf("                            insertion, substitution and deletion operations\n");
+  printf("                            is equal to 1 (0 by default).\n\n");
+  printf("--help                      Display this help and exit.\n\n");
+}
+
+//--------------------------------
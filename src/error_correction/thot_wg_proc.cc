@@ -45,6 +45,8 @@ int printNbList(const std::vector<std::pair<std::string,float> >& compWeights,
                 std::string nbListFile);
 int process_bp_par(const WordGraph& wordGraph,
                    thot_wg_proc_pars pars);
+unsigned int pruneWordGraph(WordGraph& wordGraph,
+                            const thot_wg_proc_pars& pars);
 int handleParameters(int argc,
                      char *argv[],
                      thot_wg_proc_pars& pars);
@@ -95,7 +97,7 @@ int processParameters(thot_wg_proc_pars pars)
   ret=wordGraph.load(pars.w_str.c_str());
   if(ret==THOT_ERROR) return THOT_ERROR;
   
-  if(pars.wgp_given)
+  if(pars.wgp_given || pars.wgpd_given)
   {
         // Prune word-graph
     WordGraph wgAux=wordGraph;
@@ -107,7 +109,7 @@ int processParameters(thot_wg_proc_pars pars)
     ctimer(&elapsed_ant,&ucpu,&scpu);
 
         // Prune word graph
-    unsigned int numPrunedArcs=wgAux.prune(pars.pruningThreshold);
+    unsigned int numPrunedArcs=pruneWordGraph(wgAux,pars);
     
         // Get final time
     ctimer(&elapsed,&ucpu,&scpu);
@@ -135,11 +137,11 @@ int processParameters(thot_wg_proc_pars pars)
       // Print n-best list
   if(pars.n_given)
   {
-    if(pars.wgp_given)
+    if(pars.wgp_given || pars.wgpd_given)
     {
           // Prune word-graph
       WordGraph wgAux=wordGraph;
-      wgAux.prune(pars.pruningThreshold);
+      pruneWordGraph(wgAux,pars);
 
           // Obtain component weights
       std::vector<std::pair<std::string,float> > compWeights;
@@ -188,14 +190,23 @@ int processParameters(thot_wg_proc_pars pars)
     if(ret==THOT_ERROR) return THOT_ERROR;
   }
 
+      // Print word-graph in binary format
+  if(pars.b_given)
+  {
+    std::string wgBinFile=pars.o_str;
+    wgBinFile=wgBinFile+".wgb";
+    ret=wordGraph.printBin(wgBinFile.c_str());
+    if(ret==THOT_ERROR) return THOT_ERROR;
+  }
+
       // Obtain and print new word-graph composed of useful states
   if(pars.u_given)
   {
     WordGraph wgAux=wordGraph;
-    if(pars.wgp_given)
+    if(pars.wgp_given || pars.wgpd_given)
     {
           // Prune word-graph
-      wgAux.prune(pars.pruningThreshold);
+      pruneWordGraph(wgAux,pars);
 
           // Obtain useful states
       wgAux.obtainWgComposedOfUsefulStates();
@@ -290,6 +301,16 @@ int printNbList(const std::vector<std::pair<std::string,float> >& compWeights,
   }
 }
 
+//---------------
+unsigned int pruneWordGraph(WordGraph& wordGraph,
+                            const thot_wg_proc_pars& pars)
+{
+  if(pars.wgpd_given)
+    return wordGraph.pruneGivenDensity(pars.pruningDensity,pars.numSrcWords);
+  else
+    return wordGraph.prune(pars.pruningThreshold);
+}
+
 //---------------
 int process_bp_par(const WordGraph& wordGraph,
                    thot_wg_proc_pars pars)
@@ -427,6 +448,24 @@ int takeParameters(int argc,
       }
     }
 
+        // -wgpd parameter
+    if(argv_stl[i]=="-wgpd" && !matched)
+    {
+      pars.wgpd_given=true;
+      if(i>=argc-2)
+      {
+        std::cerr<<"Error: two values should be given for -wgpd parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.pruningDensity=atof(argv_stl[i+1].c_str());
+        pars.numSrcWords=atoi(argv_stl[i+2].c_str());
+        ++matched;
+        i+=2;
+      }
+    }
+
         // -bp parameter
     if(argv_stl[i]=="-bp" && !matched)
     {
@@ -507,6 +546,13 @@ int takeParameters(int argc,
       ++matched;
     }
 
+        // -b parameter
+    if(argv_stl[i]=="-b" && !matched)
+    {
+      pars.b_given=true;
+      ++matched;
+    }
+
         // -v parameter
     if(argv_stl[i]=="-v" && !matched)
     {
@@ -546,6 +592,12 @@ int checkParameters(thot_wg_proc_pars& pars)
     std::cerr<<"Error: -o parameter not given!"<<std::endl;
     return THOT_ERROR;
   }
+
+  if(pars.wgp_given && pars.wgpd_given)
+  {
+    std::cerr<<"Error: -wgp and -wgpd parameters cannot be given simultaneously!"<<std::endl;
+    return THOT_ERROR;
+  }
   
   return THOT_OK;
 }
@@ -558,6 +610,9 @@ void printParameters(thot_wg_proc_pars pars)
   if(pars.wgp_given)
     std::cerr<<"-wgp: "<<pars.pruningThreshold<<std::endl;
 
+  if(pars.wgpd_given)
+    std::cerr<<"-wgpd: "<<pars.pruningDensity<<" "<<pars.numSrcWords<<std::endl;
+
   if(pars.bp_given)
   {
     std::cerr<<"-bp: "<<pars.hypStateIndex;
@@ -572,6 +627,9 @@ void printParameters(thot_wg_proc_pars pars)
   if(pars.t_given)
     std::cerr<<"-t"<<std::endl;
 
+  if(pars.b_given)
+    std::cerr<<"-b"<<std::endl;
+
   std::cerr<<"-o: "<<pars.o_str<<std::endl;
 }
 
@@ -580,7 +638,8 @@ void printUsage(void)
 {
   std::cerr<<"Usage: thot_wg_proc        -w <string>\n";
   std::cerr<<"                           [-bp <int> [<float1> ... <floatn>] ]\n";
-  std::cerr<<"                           [-wgp <float>] [-n <int> [-y] ] [-u] [-t]\n";
+  std::cerr<<"                           [-wgp <float> | -wgpd <float> <int>]\n";
+  std::cerr<<"                           [-n <int> [-y] ] [-u] [-t] [-b]\n";
   std::cerr<<"                           -o <string>\n";
   std::cerr<<"                           [-v|-v1] [--help] [--version]\n\n";
   std::cerr<<"-w <string>                File with word-graph to be loaded.\n";
@@ -595,6 +654,10 @@ void printUsage(void)
   std::cerr<<"                           If not given, the number of arcs is not\n";
   std::cerr<<"                           restricted.\n";
   std::cerr<<"                           NOTE: arcs must be topologically ordered.\n";
+  std::cerr<<"-wgpd <float> <int>        Prune word-graph using arc posteriors, retaining\n";
+  std::cerr<<"                           about <float> arcs per source word, where <int>\n";
+  std::cerr<<"                           is the number of source words.\n";
+  std::cerr<<"                           NOTE: arcs must be topologically ordered.\n";
   std::cerr<<"-n <int>                   Print n-best list of length <int>.\n";
   std::cerr<<"                           NOTE: -n and -wgp options can be combined\n";
   std::cerr<<"-y                         Incorporate hypothesis information when printing\n";
@@ -602,6 +665,7 @@ void printUsage(void)
   std::cerr<<"-u                         Print word-graph composed of useful states.\n";
   std::cerr<<"                           NOTE: -u and -wgp options can be combined\n";
   std::cerr<<"-t                         Print word-graph with arcs topologically ordered.\n";
+  std::cerr<<"-b                         Print word-graph in binary format (.wgb file).\n";
   std::cerr<<"-o <string>                Set prefix for output files.\n";
   std::cerr<<"-v | -v1                   Verbose modes.\n";
   std::cerr<<"--help                     Display this help and exit.\n";
@@ -37,6 +37,9 @@ struct thot_wg_proc_pars
   std::string w_str;
   bool wgp_given;
   float pruningThreshold;
+  bool wgpd_given;
+  float pruningDensity;
+  unsigned int numSrcWords;
   bool bp_given;
   unsigned int hypStateIndex;
   std::vector<float> compWeights;
@@ -44,6 +47,7 @@ struct thot_wg_proc_pars
   unsigned int nbListLen;
   bool u_given;
   bool t_given;
+  bool b_given;
   bool o_given;
   std::string o_str;
   bool v_given;
@@ -58,10 +62,12 @@ struct thot_wg_proc_pars
     {
       w_given=false;
       wgp_given=false;
+      wgpd_given=false;
       bp_given=false;
       n_given=false;
       u_given=false;
       t_given=false;
+      b_given=false;
       o_given=false;
       v_given=false;
       v1_given=false;      
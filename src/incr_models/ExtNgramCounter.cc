@@ -0,0 +1,315 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file ExtNgramCounter.cc
+ *
+ * @brief Definitions file for ExtNgramCounter.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "ExtNgramCounter.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+//--------------- ExtNgramCounter class method definitions
+
+//-------------------------
+ExtNgramCounter::ExtNgramCounter(void)
+{
+  ngramOrder=0;
+  memBudget=0;
+  bosIdx=0;
+  eosIdx=0;
+  numWords=0;
+  runCounter=0;
+}
+
+//-------------------------
+bool ExtNgramCounter::init(unsigned int _ngramOrder,
+                           unsigned int numThreads,
+                           size_t _memBudget,
+                           std::string _tmpFilesPrefix)
+{
+  clear();
+
+  if(_ngramOrder==0 || numThreads==0)
+  {
+    std::cerr<<"Error: n-gram order and number of threads must be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+  
+  ngramOrder=_ngramOrder;
+  memBudget=_memBudget;
+  tmpFilesPrefix=_tmpFilesPrefix;
+  partitions.resize(numThreads);
+  for(unsigned int i=0;i<partitions.size();++i)
+  {
+    partitions[i].memUsed=0;
+    partitions[i].runCounter=0;
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+void ExtNgramCounter::setBosEosIdx(WordIndex _bosIdx,
+                                   WordIndex _eosIdx)
+{
+  bosIdx=_bosIdx;
+  eosIdx=_eosIdx;
+}
+
+//-------------------------
+bool ExtNgramCounter::addSentences(const std::vector<std::vector<WordIndex> >& sentences)
+{
+  for(unsigned int i=0;i<sentences.size();++i)
+    numWords+=sentences[i].size()+2;
+  
+      // Count each partition in a different thread
+  std::vector<CountThreadData> threadData(partitions.size());
+  std::vector<pthread_t> threads(partitions.size());
+  unsigned int numLaunched=0;
+  for(unsigned int i=0;i<partitions.size();++i)
+  {
+    threadData[i].counterPtr=this;
+    threadData[i].partitionIdx=i;
+    threadData[i].sentencesPtr=&sentences;
+    threadData[i].error=false;
+    if(pthread_create(&threads[i],NULL,countThread,&threadData[i])!=0)
+    {
+      std::cerr<<"Error while creating counting thread "<<i<<std::endl;
+      break;
+    }
+    ++numLaunched;
+  }
+
+  bool error=(numLaunched<partitions.size());
+  for(unsigned int i=0;i<numLaunched;++i)
+  {
+    pthread_join(threads[i],NULL);
+    if(threadData[i].error)
+      error=true;
+  }
+
+  if(error)
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//-------------------------
+void* ExtNgramCounter::countThread(void* arg)
+{
+  CountThreadData* data=(CountThreadData*) arg;
+  if(data->counterPtr->countPartition(data->partitionIdx,*data->sentencesPtr)==THOT_ERROR)
+    data->error=true;
+  return NULL;
+}
+
+//-------------------------
+bool ExtNgramCounter::countPartition(unsigned int partitionIdx,
+                                     const std::vector<std::vector<WordIndex> >& sentences)
+{
+  Partition& partition=partitions[partitionIdx];
+  size_t partitionBudget=memBudget/partitions.size();
+  std::vector<WordIndex> paddedSent;
+  std::vector<WordIndex> key;
+  
+  for(unsigned int s=0;s<sentences.size();++s)
+  {
+        // Add begin and end of sentence symbols
+    paddedSent.clear();
+    paddedSent.push_back(bosIdx);
+    paddedSent.insert(paddedSent.end(),sentences[s].begin(),sentences[s].end());
+    paddedSent.push_back(eosIdx);
+
+        // Count the n-grams starting at each position whose first word
+        // belongs to the partition
+    for(unsigned int i=0;i<paddedSent.size();++i)
+    {
+      if(paddedSent[i]%partitions.size()!=partitionIdx)
+        continue;
+
+      key.clear();
+      for(unsigned int j=i;j<paddedSent.size() && j<i+ngramOrder;++j)
+      {
+        key.push_back(paddedSent[j]);
+        NgramCountMap::iterator iter=partition.counts.find(key);
+        if(iter!=partition.counts.end())
+        {
+          ++iter->second;
+        }
+        else
+        {
+          partition.counts[key]=1;
+          partition.memUsed+=sizeof(NgramCountMap::value_type)+2*sizeof(void*)+key.size()*sizeof(WordIndex);
+        }
+      }
+    }
+
+        // Spill counts if the budget of the partition has been exhausted
+    if(partition.memUsed>partitionBudget)
+    {
+      if(spillPartition(partitionIdx)==THOT_ERROR)
+        return THOT_ERROR;
+    }
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExtNgramCounter::spillPartition(unsigned int partitionIdx)
+{
+  Partition& partition=partitions[partitionIdx];
+  if(partition.counts.empty())
+    return THOT_OK;
+
+      // Sort entries
+  std::vector<const NgramCountMap::value_type*> entryPtrs;
+  entryPtrs.reserve(partition.counts.size());
+  for(NgramCountMap::const_iterator iter=partition.counts.begin();iter!=partition.counts.end();++iter)
+    entryPtrs.push_back(&(*iter));
+  std::sort(entryPtrs.begin(),entryPtrs.end(),EntryPtrSortCriterion());
+
+      // Open run file
+  std::ostringstream oss;
+  oss<<tmpFilesPrefix<<".p"<<partitionIdx<<".run"<<partition.runCounter;
+  ++partition.runCounter;
+  std::string runFileName=oss.str();
+  FILE* runFile=fopen(runFileName.c_str(),"wb");
+  if(runFile==NULL)
+  {
+    std::cerr<<"Error while creating temporary file "<<runFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  partition.runFileNames.push_back(runFileName);
+
+      // Write entries
+  std::vector<WordIndex> prevKey;
+  for(unsigned int i=0;i<entryPtrs.size();++i)
+  {
+    const std::vector<WordIndex>& key=entryPtrs[i]->first;
+    ExtSortUtils::writeRunEntry(runFile,prevKey,key.data(),key.size(),entryPtrs[i]->second);
+    prevKey=entryPtrs[i]->first;
+  }
+
+  if(fclose(runFile)!=0)
+  {
+    std::cerr<<"Error while writing temporary file "<<runFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Clear counts
+  partition.counts.clear();
+  partition.memUsed=0;
+  
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExtNgramCounter::startMerge(int verbose/*=0*/)
+{
+  runMerger.close();
+
+      // Spill remaining counts and gather the runs of all partitions
+  for(unsigned int i=0;i<partitions.size();++i)
+  {
+    if(spillPartition(i)==THOT_ERROR)
+      return THOT_ERROR;
+    runFileNames.insert(runFileNames.end(),partitions[i].runFileNames.begin(),partitions[i].runFileNames.end());
+    partitions[i].runFileNames.clear();
+  }
+
+  if(verbose)
+    std::cerr<<"Merging "<<runFileNames.size()<<" runs of n-gram counts..."<<std::endl;
+
+      // Reduce the number of runs so as to keep the number of open
+      // files bounded
+  if(ExtSortUtils::reduceNumRuns<uint64_t>(runFileNames,tmpFilesPrefix,runCounter,verbose)==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Open runs
+  if(runMerger.open(runFileNames)==THOT_ERROR)
+    return THOT_ERROR;
+  prefixCounts.assign(ngramOrder,0);
+  
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExtNgramCounter::nextNgram(std::vector<WordIndex>& ngram,
+                                uint64_t& histCount,
+                                uint64_t& ngramCount)
+{
+      // Sum the counts of the entries with the smallest key
+  if(!runMerger.next(ngram,ngramCount))
+    return false;
+
+      // N-grams are visited after their histories, so the count of the
+      // history is the last count obtained for an n-gram of its size
+  if(ngram.size()==1)
+    histCount=numWords;
+  else
+    histCount=prefixCounts[ngram.size()-2];
+  prefixCounts[ngram.size()-1]=ngramCount;
+  
+  return true;
+}
+
+//-------------------------
+uint64_t ExtNgramCounter::getNumWords(void)const
+{
+  return numWords;
+}
+
+//-------------------------
+size_t ExtNgramCounter::getNumRuns(void)const
+{
+  size_t numRuns=runFileNames.size();
+  for(unsigned int i=0;i<partitions.size();++i)
+    numRuns+=partitions[i].runFileNames.size();
+  return numRuns;
+}
+
+//-------------------------
+void ExtNgramCounter::clear(void)
+{
+  runMerger.close();
+  for(unsigned int i=0;i<partitions.size();++i)
+  {
+    for(unsigned int j=0;j<partitions[i].runFileNames.size();++j)
+      remove(partitions[i].runFileNames[j].c_str());
+  }
+  partitions.clear();
+  for(unsigned int i=0;i<runFileNames.size();++i)
+    remove(runFileNames[i].c_str());
+  runFileNames.clear();
+  runCounter=0;
+  numWords=0;
+  prefixCounts.clear();
+}
+
+//-------------------------
+ExtNgramCounter::~ExtNgramCounter()
+{
+  clear();
+}
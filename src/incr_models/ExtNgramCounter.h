@@ -0,0 +1,157 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file ExtNgramCounter.h
+ *
+ * @brief Defines the ExtNgramCounter class. ExtNgramCounter counts the
+ * n-grams of a corpus using several threads and a bounded amount of
+ * memory. N-grams are hash-partitioned by their first word, each
+ * partition is counted by a different thread in a hash table that is
+ * sorted and spilled to disk as a compressed binary run when its
+ * share of the memory budget is exhausted. The runs are finally
+ * k-way merged to obtain the n-grams in lexicographic order together
+ * with the counts of their histories.
+ */
+
+#ifndef _ExtNgramCounter_h
+#define _ExtNgramCounter_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordIndex.h"
+#include "WordIndexVecHashF.h"
+#include "ExtSortUtils.h"
+#include "ErrorDefs.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#if __GNUC__>2
+#include <ext/hash_map>
+using __gnu_cxx::hash_map;
+#else
+#include <hash_map>
+#endif
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ExtNgramCounter class
+
+class ExtNgramCounter
+{
+ public:
+
+        // Constructor
+    ExtNgramCounter(void);
+
+    bool init(unsigned int ngramOrder,
+              unsigned int numThreads,
+              size_t memBudget,
+              std::string tmpFilesPrefix);
+        // Initializes the counter. memBudget is given in bytes and is
+        // shared by the partitions, tmpFilesPrefix is used to name the
+        // temporary run files
+
+    void setBosEosIdx(WordIndex bosIdx,
+                      WordIndex eosIdx);
+        // Sets the indices of the begin and end of sentence symbols
+
+    bool addSentences(const std::vector<std::vector<WordIndex> >& sentences);
+        // Counts the n-grams of a block of sentences, including those
+        // containing the begin and end of sentence symbols
+
+    bool startMerge(int verbose=0);
+        // Spills the remaining counts and prepares the merge of the
+        // runs
+    bool nextNgram(std::vector<WordIndex>& ngram,
+                   uint64_t& histCount,
+                   uint64_t& ngramCount);
+        // Obtains the next n-gram in lexicographic order together with
+        // its count and the count of its history (for unigrams, the
+        // history count is the total number of words). Returns false
+        // when there are no more n-grams
+    
+    uint64_t getNumWords(void)const;
+    size_t getNumRuns(void)const;
+
+    void clear(void);
+        // Clears the counts and removes the temporary files
+
+        // Destructor
+    ~ExtNgramCounter();
+
+ protected:
+
+    typedef hash_map<std::vector<WordIndex>,uint64_t,WordIndexVecHashF> NgramCountMap;
+
+    struct Partition
+    {
+      NgramCountMap counts;
+      size_t memUsed;
+      unsigned int runCounter;
+      std::vector<std::string> runFileNames;
+    };
+
+        // Data given to each counting thread
+    struct CountThreadData
+    {
+      ExtNgramCounter* counterPtr;
+      unsigned int partitionIdx;
+      const std::vector<std::vector<WordIndex> >* sentencesPtr;
+      bool error;
+    };
+
+    class EntryPtrSortCriterion
+    {
+     public:
+      bool operator()(const NgramCountMap::value_type* a,
+                      const NgramCountMap::value_type* b)const
+        {
+          return a->first<b->first;
+        }
+    };
+
+    unsigned int ngramOrder;
+    size_t memBudget;
+    std::string tmpFilesPrefix;
+    WordIndex bosIdx;
+    WordIndex eosIdx;
+    uint64_t numWords;
+    std::vector<Partition> partitions;
+    std::vector<std::string> runFileNames;
+    unsigned int runCounter;
+
+        // Merge state
+    ExtSortUtils::RunMerger<uint64_t> runMerger;
+    std::vector<uint64_t> prefixCounts;
+
+    static void* countThread(void* arg);
+    bool countPartition(unsigned int partitionIdx,
+                        const std::vector<std::vector<WordIndex> >& sentences);
+    bool spillPartition(unsigned int partitionIdx);
+};
+
+#endif
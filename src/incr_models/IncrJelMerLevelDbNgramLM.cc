@@ -37,6 +37,38 @@ bool IncrJelMerLevelDbNgramLM::modelReadsAreProcessSafe(void)
   return false;
 }
 
+//------------------------------
+int IncrJelMerLevelDbNgramLM::trainSentence(std::vector<std::string> strVec,
+                                            Count c/*=1*/,
+                                            Count lowerBound/*=0*/,
+                                            int verbose/*=0*/)
+{
+  LevelDbNgramTable* levelDbTablePtr=dynamic_cast<LevelDbNgramTable*>(tablePtr);
+
+  levelDbTablePtr->beginUpdateBatch();
+  int ret=_incrJelMerNgramLM<Count,Count>::trainSentence(strVec,c,lowerBound,verbose);
+  if(levelDbTablePtr->commitUpdateBatch()==THOT_ERROR)
+    return THOT_ERROR;
+  
+  return ret;
+}
+
+//------------------------------
+int IncrJelMerLevelDbNgramLM::trainSentenceVec(std::vector<std::vector<std::string> > vecOfStrVec,
+                                               Count c/*=1*/,
+                                               Count lowerBound/*=0*/,
+                                               int verbose/*=0*/)
+{
+  LevelDbNgramTable* levelDbTablePtr=dynamic_cast<LevelDbNgramTable*>(tablePtr);
+
+  levelDbTablePtr->beginUpdateBatch();
+  int ret=_incrJelMerNgramLM<Count,Count>::trainSentenceVec(vecOfStrVec,c,lowerBound,verbose);
+  if(levelDbTablePtr->commitUpdateBatch()==THOT_ERROR)
+    return THOT_ERROR;
+  
+  return ret;
+}
+
 //------------------------------
 bool IncrJelMerLevelDbNgramLM::load(const char *fileName)
 {
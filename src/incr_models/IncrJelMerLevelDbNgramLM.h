@@ -77,6 +77,18 @@ class IncrJelMerLevelDbNgramLM: public _incrJelMerNgramLM<Count,Count>
             // Thread/Process safety related functions
         bool modelReadsAreProcessSafe(void);
 
+            // Functions to extend the model. The count updates of a
+            // sentence (or of a whole vector of sentences) are
+            // written to the database in a single batch
+        int trainSentence(std::vector<std::string> strVec,
+                          Count c=1,
+                          Count lowerBound=0,
+                          int verbose=0);
+        int trainSentenceVec(std::vector<std::vector<std::string> > vecOfStrVec,
+                             Count c=1,
+                             Count lowerBound=0,
+                             int verbose=0);
+
             // Functions to load and print the model (including model weights)
         bool load(const char *fileName);
         bool print(const char *fileName);
@@ -0,0 +1,125 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file IncrJelMerMmapNgramLM.cc
+ * 
+ * @brief Definitions file for IncrJelMerMmapNgramLM.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "IncrJelMerMmapNgramLM.h"
+
+//--------------- Classes --------------------------------------------
+
+//------------------------------
+bool IncrJelMerMmapNgramLM::load(const char *fileName)
+{
+  std::string lmFileName=getLmFileName(fileName);
+  std::string binFileName=lmFileName+MMAP_NGRAM_LM_BIN_EXT;
+  std::string vocabFileName=lmFileName+MMAP_NGRAM_LM_VCB_EXT;
+
+  if(binFileIsUpToDate(binFileName,lmFileName) && binFileIsUpToDate(vocabFileName,lmFileName))
+  {
+        // Load weights
+    bool retval=loadWeights(fileName);
+    if(retval==THOT_ERROR) return THOT_ERROR;
+
+        // Load binary n-gram file
+    return loadBin(lmFileName);
+  }
+  else
+  {
+        // Load text model
+    bool retval=_incrJelMerNgramLM<Count,Count>::load(fileName);
+    if(retval==THOT_ERROR) return THOT_ERROR;
+
+        // Generate binary n-gram file so as to speed up future loads
+    if(printBin(lmFileName)==THOT_ERROR)
+      std::cerr<<"Warning: binary n-gram file could not be generated, n-grams will be kept in memory"<<std::endl;
+    return THOT_OK;
+  }
+}
+
+//------------------------------
+bool IncrJelMerMmapNgramLM::loadBin(const std::string& lmFileName)
+{
+  std::string binFileName=lmFileName+MMAP_NGRAM_LM_BIN_EXT;
+  std::string vocabFileName=lmFileName+MMAP_NGRAM_LM_VCB_EXT;
+
+  std::cerr<<"Loading binary n-gram file "<<binFileName<<std::endl;
+  
+  bool retval=this->encPtr->load(vocabFileName.c_str());
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+  retval=tablePtr->load(binFileName.c_str());
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+  this->modelFileName=lmFileName;
+
+  return THOT_OK;
+}
+
+//------------------------------
+bool IncrJelMerMmapNgramLM::print(const char *fileName)
+{
+      // Print weights
+  bool retval=printWeights(fileName);
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+      // Print binary files
+  return printBin(getLmFileName(fileName));
+}
+
+//------------------------------
+bool IncrJelMerMmapNgramLM::printBin(const std::string& lmFileName)
+{
+  MmapNgramTable* mmapTablePtr=dynamic_cast<MmapNgramTable*>(tablePtr);
+  if(mmapTablePtr==NULL)
+    return THOT_ERROR;
+
+      // Merge overlay into a new binary n-gram file
+  std::string binFileName=lmFileName+MMAP_NGRAM_LM_BIN_EXT;
+  bool retval=mmapTablePtr->mergeOverlay(binFileName.c_str());
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+      // Print vocabulary
+  std::string vocabFileName=lmFileName+MMAP_NGRAM_LM_VCB_EXT;
+  return this->encPtr->print(vocabFileName.c_str());
+}
+
+//------------------------------
+std::string IncrJelMerMmapNgramLM::getLmFileName(const char *fileName)
+{
+  std::string mainFileName;
+  if(fileIsDescriptor(fileName,mainFileName))
+  {
+    std::string descFileName=fileName;
+    return absolutizeModelFileName(descFileName,mainFileName);
+  }
+  else
+  {
+    return fileName;
+  }
+}
+
+//------------------------------
+IncrJelMerMmapNgramLM::~IncrJelMerMmapNgramLM()
+{
+  
+}
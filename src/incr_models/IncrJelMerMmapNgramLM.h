@@ -0,0 +1,82 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file IncrJelMerMmapNgramLM.h
+ * 
+ * @brief Class to manage encoded incremental Jelinek-Mercer ngram
+ * language models p(x|vector<x>) whose n-gram counts are stored in a
+ * memory-mapped base file plus an in-memory overlay for online
+ * updates.
+ */
+
+#ifndef _IncrJelMerMmapNgramLM
+#define _IncrJelMerMmapNgramLM
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "_incrJelMerNgramLM.h"
+#include "MmapNgramTable.h"
+
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+#define MMAP_NGRAM_LM_BIN_EXT ".mmngr"
+#define MMAP_NGRAM_LM_VCB_EXT ".mmngr_vcb"
+
+//--------------- Classes --------------------------------------------
+
+//--------------- IncrJelMerMmapNgramLM class
+
+class IncrJelMerMmapNgramLM: public _incrJelMerNgramLM<Count,Count>
+{
+ public:
+
+  typedef _incrJelMerNgramLM<Count,Count>::SrcTableNode SrcTableNode;
+  typedef _incrJelMerNgramLM<Count,Count>::TrgTableNode TrgTableNode;
+
+      // Constructor
+  IncrJelMerMmapNgramLM():_incrJelMerNgramLM<Count,Count>()
+    {
+          // Set new pointer to table
+      tablePtr=new MmapNgramTable();
+    }
+
+      // Functions to load and print the model (including model
+      // weights). The binary n-gram file (.mmngr extension) is used
+      // if it is not older than the text file. Otherwise, the text file
+      // is loaded and the binary file is generated. Printing the model
+      // merges the in-memory updates into a new binary file
+  bool load(const char *fileName);
+  bool print(const char *fileName);
+
+      // Destructor
+  ~IncrJelMerMmapNgramLM();
+
+ private:
+
+  std::string getLmFileName(const char *fileName);
+  bool loadBin(const std::string& lmFileName);
+  bool printBin(const std::string& lmFileName);
+};
+
+#endif
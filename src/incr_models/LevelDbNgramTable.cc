@@ -46,6 +46,10 @@ LevelDbNgramTable::LevelDbNgramTable(void)
 
     std::string null_str(null_vec.begin(), null_vec.end());
     dbNullKey = null_str;
+
+    dbFormatKey = std::string(1, (char) LEVELDB_NGRAM_FORMAT_KEY_BYTE);
+    binaryValues = true;
+    batchDepth = 0;
 }
 
 //-------------------------
@@ -87,6 +91,62 @@ std::vector<WordIndex> LevelDbNgramTable::stringToVector(const std::string s)con
 
     return vec;
 }
+//-------------------------
+std::string LevelDbNgramTable::encodeValue(float count)const
+{
+    if(binaryValues)
+    {
+        // Store float as 4 bytes in little-endian order
+        uint32_t bits;
+        memcpy(&bits, &count, sizeof(float));
+
+        char bytes[4];
+        for(unsigned int i = 0; i < 4; i++)
+        {
+            bytes[i] = (char) ((bits >> (8 * i)) & 0xff);
+        }
+
+        return std::string(bytes, 4);
+    }
+    else
+    {
+        std::stringstream ss;
+        ss << count;
+        return ss.str();
+    }
+}
+
+//-------------------------
+float LevelDbNgramTable::decodeValue(const leveldb::Slice& value)const
+{
+    if(binaryValues)
+    {
+        if(value.size() != 4)
+            return 0;
+
+        uint32_t bits = 0;
+        for(unsigned int i = 0; i < 4; i++)
+        {
+            bits |= ((uint32_t) (unsigned char) value[i]) << (8 * i);
+        }
+
+        float count;
+        memcpy(&count, &bits, sizeof(float));
+
+        return count;
+    }
+    else
+    {
+        return atof(value.ToString().c_str());
+    }
+}
+
+//-------------------------
+bool LevelDbNgramTable::isReservedKey(const leveldb::Slice& key)const
+{
+    return key == leveldb::Slice(dbNullKey) || key == leveldb::Slice(dbFormatKey);
+}
+
 //-------------------------
 std::string LevelDbNgramTable::getDbNullKey(void)const
 {
@@ -117,11 +177,22 @@ bool LevelDbNgramTable::retrieveData(const std::string key, float &count)const
     std::string value_str;
     count = 0;
 
+    // Check updates that have not been committed yet
+    if(batchDepth > 0)
+    {
+        std::map<std::string, float>::const_iterator iter = pendingUpdates.find(key);
+        if(iter != pendingUpdates.end())
+        {
+            count = iter->second;
+            return true;
+        }
+    }
+
     leveldb::Status result = db->Get(leveldb::ReadOptions(), key, &value_str);  // Read stored src value
 
     if (result.ok())
     {
-        count = atof(value_str.c_str());
+        count = decodeValue(value_str);
         return true;
     }
     else
@@ -149,13 +220,13 @@ bool LevelDbNgramTable::retrieveData(const std::vector<WordIndex>& phrase, float
 //-------------------------
 bool LevelDbNgramTable::storeData(const std::string key, float count)
 {
-    std::stringstream ss;
-    ss << count;
-    std::string count_str = ss.str();
+    if(batchDepth > 0)
+    {
+        pendingUpdates[key] = count;
+        return true;
+    }
 
-    leveldb::WriteBatch batch;
-    batch.Put(key, count_str);
-    leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
+    leveldb::Status s = db->Put(leveldb::WriteOptions(), key, encodeValue(count));
 
     if(!s.ok())
         std::cerr << "Storing data status: " << s.ToString() << std::endl;
@@ -181,6 +252,147 @@ bool LevelDbNgramTable::storeData(const std::vector<WordIndex>& phrase, float co
     return storeData(key, count);
 }
 
+//-------------------------
+bool LevelDbNgramTable::writePendingUpdates(void)
+{
+    if(pendingUpdates.empty())
+        return true;
+
+    leveldb::WriteBatch batch;
+    for(std::map<std::string, float>::const_iterator iter = pendingUpdates.begin(); iter != pendingUpdates.end(); iter++)
+    {
+        batch.Put(iter->first, encodeValue(iter->second));
+    }
+    pendingUpdates.clear();
+
+    leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
+
+    if(!s.ok())
+        std::cerr << "Storing data status: " << s.ToString() << std::endl;
+
+    return s.ok();
+}
+
+//-------------------------
+void LevelDbNgramTable::beginUpdateBatch(void)
+{
+    batchDepth++;
+}
+
+//-------------------------
+bool LevelDbNgramTable::commitUpdateBatch(void)
+{
+    if(batchDepth == 0)
+        return THOT_OK;
+
+    batchDepth--;
+    if(batchDepth > 0)
+        return THOT_OK;
+
+    if(writePendingUpdates())
+        return THOT_OK;
+    else
+        return THOT_ERROR;
+}
+
+//-------------------------
+bool LevelDbNgramTable::detectValueFormat(void)
+{
+    std::string value_str;
+    leveldb::Status result = db->Get(leveldb::ReadOptions(), dbFormatKey, &value_str);
+
+    if(result.ok())
+    {
+        binaryValues = true;
+        if(value_str != encodeValue(LEVELDB_NGRAM_BIN_FORMAT_VERSION))
+        {
+            std::cerr << "Unsupported value format in LevelDB n-gram table " << dbName << std::endl;
+            return THOT_ERROR;
+        }
+        return THOT_OK;
+    }
+
+    // Databases without format key are either new or were created
+    // with the legacy text encoding
+    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    it->SeekToFirst();
+    bool isEmpty = !it->Valid();
+    delete it;
+
+    if(isEmpty)
+    {
+        binaryValues = true;
+        leveldb::Status s = db->Put(leveldb::WriteOptions(), dbFormatKey, encodeValue(LEVELDB_NGRAM_BIN_FORMAT_VERSION));
+        if(!s.ok())
+        {
+            std::cerr << "Storing data status: " << s.ToString() << std::endl;
+            return THOT_ERROR;
+        }
+    }
+    else
+    {
+        binaryValues = false;
+        std::cerr << "Warning: LevelDB n-gram table " << dbName << " uses the legacy text encoding, use thot_upgrade_leveldb_ngram to convert it" << std::endl;
+    }
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbNgramTable::hasBinaryValues(void)const
+{
+    return binaryValues;
+}
+
+//-------------------------
+bool LevelDbNgramTable::copyToBinaryTable(LevelDbNgramTable& outTable,
+                                          int verbose/*=0*/)const
+{
+    if(!outTable.hasBinaryValues())
+    {
+        std::cerr << "Error: output table does not use binary values" << std::endl;
+        return THOT_ERROR;
+    }
+
+    size_t numEntries = 0;
+    outTable.beginUpdateBatch();
+
+    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    for(it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        if(it->key() == leveldb::Slice(dbFormatKey))
+            continue;
+
+        if(it->key() == leveldb::Slice(dbNullKey))
+            outTable.storeData(std::vector<WordIndex>(), decodeValue(it->value()));
+        else
+            outTable.storeData(it->key().ToString(), decodeValue(it->value()));
+
+        numEntries++;
+        if(numEntries % 100000 == 0)
+        {
+            // Write entries in chunks to bound memory usage
+            outTable.commitUpdateBatch();
+            outTable.beginUpdateBatch();
+            if(verbose)
+                std::cerr << "Copied " << numEntries << " entries" << std::endl;
+        }
+    }
+    bool status_ok = it->status().ok();
+    delete it;
+
+    if(outTable.commitUpdateBatch() == THOT_ERROR || !status_ok)
+    {
+        std::cerr << "Error while copying LevelDB n-gram table" << std::endl;
+        return THOT_ERROR;
+    }
+
+    if(verbose)
+        std::cerr << "Copied " << numEntries << " entries" << std::endl;
+
+    return THOT_OK;
+}
+
 //-------------------------
 bool LevelDbNgramTable::init(std::string levelDbPath)
 {
@@ -235,10 +447,15 @@ bool LevelDbNgramTable::load(const char *fileName)
     }
 
     dbName = levelDbPath;
+    pendingUpdates.clear();
+    batchDepth = 0;
     leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
 
     if(status.ok())
     {
+        if(detectValueFormat() == THOT_ERROR)
+            return THOT_ERROR;
+
         // Restore null count
         float null_count;
         retrieveData(dbNullKey, null_count);
@@ -528,7 +745,7 @@ bool LevelDbNgramTable::getEntriesForSource(const std::vector<WordIndex>& s,
         {
             pdp.first = vec.back();  // t
             pdp.second.first = s_count;  // count(s)
-            pdp.second.second = Count(atof(it->value().ToString().c_str()));  // sount(s, t)
+            pdp.second.second = Count(decodeValue(it->value()));  // sount(s, t)
 
             if (fabs(pdp.second.second.get_c_st()) < EPSILON)  // Compare to 0
                 continue;
@@ -645,6 +862,8 @@ void LevelDbNgramTable::clear(void)
         }
 
         // Create empty DB
+        pendingUpdates.clear();
+        batchDepth = 0;
         leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
         
         if(!status.ok())
@@ -654,6 +873,10 @@ void LevelDbNgramTable::clear(void)
             exit(3);
         }
 
+        // New databases store binary values
+        if(detectValueFormat() == THOT_ERROR)
+            exit(3);
+
         // Clear empty key counter
         storeData(dbNullKey, 0);
         srcInfoNull = Count();
@@ -664,7 +887,11 @@ void LevelDbNgramTable::clear(void)
 LevelDbNgramTable::~LevelDbNgramTable(void)
 {
     if(db != NULL)
+    {
+        if(batchDepth > 0)
+            writePendingUpdates();
         delete db;
+    }
 
     if(options.filter_policy != NULL)
         delete options.filter_policy;
@@ -679,8 +906,8 @@ LevelDbNgramTable::const_iterator LevelDbNgramTable::begin(void)const
     leveldb::Iterator *local_iter = db->NewIterator(leveldb::ReadOptions());
     local_iter->SeekToFirst();
 
-    // Skip item, if it stores nullInfo, to be compatible with other implementations
-    if (local_iter->Valid() && local_iter->key().ToString() == getDbNullKey())
+    // Skip items storing nullInfo or the value format, to be compatible with other implementations
+    while (local_iter->Valid() && isReservedKey(local_iter->key()))
     {
         local_iter->Next();
     }
@@ -711,8 +938,8 @@ bool LevelDbNgramTable::const_iterator::operator++(void) //prefix
 {
     internalIter->Next();
 
-    // Skip item, if it stores nullInfo, to be compatible with other implementations
-    if (internalIter->Valid() && internalIter->key().ToString() == ptPtr->getDbNullKey())
+    // Skip items storing nullInfo or the value format, to be compatible with other implementations
+    while (internalIter->Valid() && ptPtr->isReservedKey(internalIter->key()))
     {
         internalIter->Next();
     }
@@ -759,7 +986,7 @@ LevelDbNgramTable::const_iterator::operator->(void)
     std::string key = internalIter->key().ToString();
     std::vector<WordIndex> key_vec = ptPtr->keyToVector(key);
 
-    float count = atof(internalIter->value().ToString().c_str());
+    float count = ptPtr->decodeValue(internalIter->value());
 
     dataItem = make_pair(key_vec, Count(count));
 
@@ -29,6 +29,11 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define WORD_INDEX_MODULO_BASE 254
 #define WORD_INDEX_MODULO_BYTES 3
 
+    // Key storing the format of the values. Its only byte is never
+    // used by n-gram keys, so it is placed after all of them
+#define LEVELDB_NGRAM_FORMAT_KEY_BYTE 255
+#define LEVELDB_NGRAM_BIN_FORMAT_VERSION 1
+
 //--------------- Include files --------------------------------------
 
 #if HAVE_CONFIG_H
@@ -40,6 +45,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "leveldb/filter_policy.h"
 #include "leveldb/write_batch.h"
 #include <sstream>
+#include <map>
+#include <stdint.h>
+#include <string.h>
 
 #include "BaseIncrCondProbTable.h"
 #include "ErrorDefs.h"
@@ -64,16 +72,29 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
         leveldb::Options options;
         std::string dbName;
         std::string dbNullKey;
+        std::string dbFormatKey;
+        bool binaryValues;
+            // Values are stored as 4-byte little-endian floats unless
+            // the database was created with the legacy text encoding
+        unsigned int batchDepth;
+        std::map<std::string, float> pendingUpdates;
+            // Updates that are delayed until the current update batch
+            // is committed
 
             // Converters
         std::string vectorToString(const std::vector<WordIndex>& vec)const;
         std::vector<WordIndex> stringToVector(const std::string s)const;
+        std::string encodeValue(float count)const;
+        float decodeValue(const leveldb::Slice& value)const;
+        bool isReservedKey(const leveldb::Slice& key)const;
         
             // Read and write data
         bool retrieveData(const std::string key, float &count)const;
         bool retrieveData(const std::vector<WordIndex>& phrase, float &count)const;
         bool storeData(const std::string key, float count);
         bool storeData(const std::vector<WordIndex>& phrase, float count);
+        bool writePendingUpdates(void);
+        bool detectValueFormat(void);
 
             // Returns information related to a given key.
         Count getInfo(const std::vector<WordIndex>& key, bool &found);
@@ -99,6 +120,24 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
         bool load(const char *fileName);
         //bool load(std::string fileName);
 
+            // Functions to group updates. Between a call to
+            // beginUpdateBatch() and the matching call to
+            // commitUpdateBatch(), updates are accumulated in memory and
+            // then written using a single leveldb::WriteBatch. Calls can
+            // be nested, the updates are written by the outermost
+            // commit. Point lookups observe the pending updates, range
+            // scans and iterators only observe committed data
+        void beginUpdateBatch(void);
+        bool commitUpdateBatch(void);
+
+            // Value encoding related functions
+        bool hasBinaryValues(void)const;
+        bool copyToBinaryTable(LevelDbNgramTable& outTable,
+                               int verbose=0)const;
+            // Copies the content of the table into outTable (which
+            // stores binary values), used to migrate databases created
+            // with the legacy text encoding
+
           // Basic functions
           // TODO Ordering by n-gram value
 
@@ -0,0 +1,1165 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MmapNgramTable.cc
+ *
+ * @brief Definitions file for MmapNgramTable.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "MmapNgramTable.h"
+#include "MathFuncs.h"
+#include <algorithm>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//--------------- Constants ------------------------------------------
+
+#define MMAP_NGRAM_MAGIC_LEN         16
+#define MMAP_NGRAM_NUM_ARRAYS         5
+#define MMAP_NGRAM_WRITER_BUF_SIZE    65536
+
+//--------------- Function declarations ------------------------------
+
+static size_t alignedSize(size_t bytes);
+
+//--------------- Classes --------------------------------------------
+
+//--------------- MmapNgramFileWriter class
+
+// Writes a base file given the number of entries of each order. The
+// arrays of the different orders are filled in parallel, each one
+// through a small buffer, so that the content of the file does not
+// need to be kept in memory
+
+class MmapNgramFileWriter
+{
+ public:
+  MmapNgramFileWriter(void);
+  bool open(const char *fileName,
+            const std::vector<uint64_t>& numEntries,
+            Count nullCount);
+  void append(unsigned int level,
+              WordIndex word,
+              float srcCount,
+              float srcTrgCount,
+              unsigned char flags,
+              uint64_t childOffset);
+      // Appends an entry of order level+1, childOffset is the position
+      // of its first child in the next order
+  uint64_t numAppended(unsigned int level)const;
+  bool close(void);
+  ~MmapNgramFileWriter();
+
+ private:
+  struct Section
+  {
+    off_t offset;
+    std::vector<char> buf;
+  };
+
+  int fd;
+  bool ok;
+  std::vector<uint64_t> numEntries;
+  std::vector<uint64_t> counts;
+  std::vector<Section> sections;
+
+  void write(unsigned int level,
+             unsigned int array,
+             const void* data,
+             size_t bytes);
+  void flush(Section& section);
+};
+
+//--------------- Function definitions
+
+//-------------------------
+static size_t alignedSize(size_t bytes)
+{
+  return (bytes+7) & ~((size_t)7);
+}
+
+//--------------- MmapNgramFileWriter class method definitions
+
+//-------------------------
+MmapNgramFileWriter::MmapNgramFileWriter(void)
+{
+  fd=-1;
+  ok=false;
+}
+
+//-------------------------
+bool MmapNgramFileWriter::open(const char *fileName,
+                               const std::vector<uint64_t>& _numEntries,
+                               Count nullCount)
+{
+  numEntries=_numEntries;
+  counts.assign(numEntries.size(),0);
+  sections.clear();
+  sections.resize(numEntries.size()*MMAP_NGRAM_NUM_ARRAYS);
+
+  fd=::open(fileName,O_WRONLY|O_CREAT|O_TRUNC,0644);
+  if(fd<0)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<" for writing"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Obtain header
+  std::vector<char> header(MMAP_NGRAM_MAGIC_LEN+4*sizeof(uint32_t)+numEntries.size()*sizeof(uint64_t),0);
+  strncpy(&header[0],MMAP_NGRAM_TABLE_MAGIC,MMAP_NGRAM_MAGIC_LEN-1);
+  uint32_t version=MMAP_NGRAM_TABLE_VERSION;
+  uint32_t maxOrder=numEntries.size();
+  float nullCountFloat=(float)nullCount;
+  memcpy(&header[MMAP_NGRAM_MAGIC_LEN],&version,sizeof(uint32_t));
+  memcpy(&header[MMAP_NGRAM_MAGIC_LEN+sizeof(uint32_t)],&maxOrder,sizeof(uint32_t));
+  memcpy(&header[MMAP_NGRAM_MAGIC_LEN+2*sizeof(uint32_t)],&nullCountFloat,sizeof(float));
+  for(unsigned int i=0;i<numEntries.size();++i)
+    memcpy(&header[MMAP_NGRAM_MAGIC_LEN+4*sizeof(uint32_t)+i*sizeof(uint64_t)],&numEntries[i],sizeof(uint64_t));
+
+      // Obtain the offsets of the arrays of each order
+  off_t offset=header.size();
+  for(unsigned int i=0;i<numEntries.size();++i)
+  {
+    size_t num=numEntries[i];
+    size_t arrayBytes[MMAP_NGRAM_NUM_ARRAYS]={num*sizeof(WordIndex),num*sizeof(float),num*sizeof(float),num,0};
+    if(i+1<numEntries.size())
+      arrayBytes[MMAP_NGRAM_NUM_ARRAYS-1]=(num+1)*sizeof(uint64_t);
+    for(unsigned int j=0;j<MMAP_NGRAM_NUM_ARRAYS;++j)
+    {
+      sections[i*MMAP_NGRAM_NUM_ARRAYS+j].offset=offset;
+      offset+=alignedSize(arrayBytes[j]);
+    }
+  }
+
+      // Write header and set file size, padding bytes are left as
+      // zeros
+  ok=(pwrite(fd,&header[0],header.size(),0)==(ssize_t)header.size() && ftruncate(fd,offset)==0);
+  if(!ok)
+  {
+    std::cerr<<"Error while writing file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+void MmapNgramFileWriter::append(unsigned int level,
+                                 WordIndex word,
+                                 float srcCount,
+                                 float srcTrgCount,
+                                 unsigned char flags,
+                                 uint64_t childOffset)
+{
+  if(level>=counts.size() || counts[level]>=numEntries[level])
+  {
+    ok=false;
+    return;
+  }
+  write(level,0,&word,sizeof(WordIndex));
+  write(level,1,&srcCount,sizeof(float));
+  write(level,2,&srcTrgCount,sizeof(float));
+  write(level,3,&flags,1);
+  if(level+1<counts.size())
+    write(level,4,&childOffset,sizeof(uint64_t));
+  ++counts[level];
+}
+
+//-------------------------
+uint64_t MmapNgramFileWriter::numAppended(unsigned int level)const
+{
+  return counts[level];
+}
+
+//-------------------------
+void MmapNgramFileWriter::write(unsigned int level,
+                                unsigned int array,
+                                const void* data,
+                                size_t bytes)
+{
+  Section& section=sections[level*MMAP_NGRAM_NUM_ARRAYS+array];
+  const char* charData=(const char*) data;
+  section.buf.insert(section.buf.end(),charData,charData+bytes);
+  if(section.buf.size()>=MMAP_NGRAM_WRITER_BUF_SIZE)
+    flush(section);
+}
+
+//-------------------------
+void MmapNgramFileWriter::flush(Section& section)
+{
+  size_t done=0;
+  while(ok && done<section.buf.size())
+  {
+    ssize_t written=pwrite(fd,&section.buf[done],section.buf.size()-done,section.offset);
+    if(written<=0)
+      ok=false;
+    else
+    {
+      done+=written;
+      section.offset+=written;
+    }
+  }
+  section.buf.clear();
+}
+
+//-------------------------
+bool MmapNgramFileWriter::close(void)
+{
+  if(fd<0)
+    return THOT_ERROR;
+
+      // Write the final child offset of each order
+  for(unsigned int i=0;i+1<counts.size();++i)
+    write(i,4,&numEntries[i+1],sizeof(uint64_t));
+
+  for(unsigned int i=0;i<sections.size();++i)
+    flush(sections[i]);
+  if(counts!=numEntries)
+    ok=false;
+  if(::close(fd)!=0)
+    ok=false;
+  fd=-1;
+  if(!ok)
+    return THOT_ERROR;
+  return THOT_OK;
+}
+
+//-------------------------
+MmapNgramFileWriter::~MmapNgramFileWriter()
+{
+  if(fd>=0)
+    ::close(fd);
+}
+
+//--------------- MmapNgramTable class method definitions
+
+//-------------------------
+MmapNgramTable::MmapNgramTable(void)
+{
+  mapAddr=NULL;
+  mapLength=0;
+  numBaseSrcTrgEntries=0;
+}
+
+//-------------------------
+bool MmapNgramTable::baseChildRange(const std::vector<WordIndex>& s,
+                                    uint64_t& begin,
+                                    uint64_t& end)const
+{
+  if(s.size()>=orders.size())
+    return false;
+
+  begin=0;
+  end=orders[0].numEntries;
+  for(unsigned int i=0;i<s.size();++i)
+  {
+    const WordIndex* first=orders[i].words+begin;
+    const WordIndex* last=orders[i].words+end;
+    const WordIndex* pos=std::lower_bound(first,last,s[i]);
+    if(pos==last || *pos!=s[i])
+      return false;
+    uint64_t idx=pos-orders[i].words;
+    begin=orders[i].childOffsets[idx];
+    end=orders[i].childOffsets[idx+1];
+  }
+  return true;
+}
+
+//-------------------------
+bool MmapNgramTable::lookupBase(const std::vector<WordIndex>& key,
+                                OverlayEntry& entry)const
+{
+  if(key.empty() || key.size()>orders.size())
+    return false;
+
+      // Obtain range of the context
+  uint64_t begin=0;
+  uint64_t end=orders[0].numEntries;
+  unsigned int last=key.size()-1;
+  for(unsigned int i=0;i<last;++i)
+  {
+    const WordIndex* first=orders[i].words+begin;
+    const WordIndex* lastPtr=orders[i].words+end;
+    const WordIndex* pos=std::lower_bound(first,lastPtr,key[i]);
+    if(pos==lastPtr || *pos!=key[i])
+      return false;
+    uint64_t idx=pos-orders[i].words;
+    begin=orders[i].childOffsets[idx];
+    end=orders[i].childOffsets[idx+1];
+  }
+
+      // Search last word
+  const OrderArrays& oa=orders[last];
+  const WordIndex* pos=std::lower_bound(oa.words+begin,oa.words+end,key[last]);
+  if(pos==oa.words+end || *pos!=key[last])
+    return false;
+  uint64_t idx=pos-oa.words;
+  entry.srcCount=oa.srcCounts[idx];
+  entry.srcTrgCount=oa.srcTrgCounts[idx];
+  entry.flags=oa.flags[idx];
+  return entry.flags!=0;
+}
+
+//-------------------------
+bool MmapNgramTable::lookupEntry(const std::vector<WordIndex>& key,
+                                 OverlayEntry& entry)const
+{
+  if(!overlay.empty())
+  {
+    Overlay::const_iterator iter=overlay.find(key);
+    if(iter!=overlay.end())
+    {
+      entry=iter->second;
+      return entry.flags!=0;
+    }
+  }
+  return lookupBase(key,entry);
+}
+
+//-------------------------
+MmapNgramTable::OverlayEntry& MmapNgramTable::getOverlayEntry(const std::vector<WordIndex>& key)
+{
+  Overlay::iterator iter=overlay.find(key);
+  if(iter!=overlay.end())
+    return iter->second;
+
+      // Initialize overlay entry with the content of the base file
+  OverlayEntry entry;
+  lookupBase(key,entry);
+  std::vector<WordIndex> context(key.begin(),key.end()-1);
+  overlayChildren[context].push_back(key.back());
+  return overlay.insert(std::make_pair(key,entry)).first->second;
+}
+
+//-------------------------
+void MmapNgramTable::addTableEntry(const std::vector<WordIndex>& s,
+                                   const WordIndex& t,
+                                   im_pair<Count,Count> inf)
+{
+  addSrcInfo(s,inf.first);
+  addSrcTrgInfo(s,t,inf.second);
+}
+
+//-------------------------
+void MmapNgramTable::addSrcInfo(const std::vector<WordIndex>& s,
+                                Count s_inf)
+{
+  if(s.size()!=0)
+  {
+    OverlayEntry& entry=getOverlayEntry(s);
+    entry.srcCount=s_inf;
+    entry.flags|=MMAP_NGRAM_HAS_SRC;
+  }
+  else
+  {
+    srcInfoNull=s_inf;
+  }
+}
+
+//-------------------------
+void MmapNgramTable::addSrcTrgInfo(const std::vector<WordIndex>& s,
+                                   const WordIndex& t,
+                                   Count st_inf)
+{
+  std::vector<WordIndex> st=s;
+  st.push_back(t);
+
+  OverlayEntry& entry=getOverlayEntry(st);
+  entry.srcTrgCount=st_inf;
+  entry.flags|=MMAP_NGRAM_HAS_SRCTRG;
+}
+
+//-------------------------
+void MmapNgramTable::incrCountsOfEntryLog(const std::vector<WordIndex>& s,
+                                          const WordIndex& t,
+                                          LogCount lc)
+{
+  std::vector<WordIndex> st=s;
+  st.push_back(t);
+
+  OverlayEntry& stEntry=getOverlayEntry(st);
+  if(!(stEntry.flags & MMAP_NGRAM_HAS_SRCTRG))
+    stEntry.srcTrgCount=0;
+  stEntry.srcTrgCount.incr_logcount((float)lc);
+  stEntry.flags|=MMAP_NGRAM_HAS_SRCTRG;
+
+  if(s.size()!=0)
+  {
+    OverlayEntry& sEntry=getOverlayEntry(s);
+    if(!(sEntry.flags & MMAP_NGRAM_HAS_SRC))
+      sEntry.srcCount=0;
+    sEntry.srcCount.incr_logcount((float)lc);
+    sEntry.flags|=MMAP_NGRAM_HAS_SRC;
+  }
+  else
+  {
+    srcInfoNull.incr_logcount((float)lc);
+  }
+}
+
+//-------------------------
+im_pair<Count,Count> MmapNgramTable::infSrcTrg(const std::vector<WordIndex>& s,
+                                               const WordIndex& t,
+                                               bool& found)
+{
+  im_pair<Count,Count> psst;
+  bool sFound;
+
+  psst.first=getSrcInfo(s,sFound);
+  psst.second=getSrcTrgInfo(s,t,found);
+  return psst;
+}
+
+//-------------------------
+Count MmapNgramTable::getSrcInfo(const std::vector<WordIndex>& s,
+                                 bool& found)
+{
+  if(s.size()==0)
+  {
+    found=true;
+    return srcInfoNull;
+  }
+  else
+  {
+    OverlayEntry entry;
+    found=lookupEntry(s,entry) && (entry.flags & MMAP_NGRAM_HAS_SRC);
+    if(found)
+      return entry.srcCount;
+    else
+      return 0;
+  }
+}
+
+//-------------------------
+Count MmapNgramTable::getSrcTrgInfo(const std::vector<WordIndex>& s,
+                                    const WordIndex& t,
+                                    bool& found)
+{
+  std::vector<WordIndex> st=s;
+  st.push_back(t);
+
+  OverlayEntry entry;
+  found=lookupEntry(st,entry) && (entry.flags & MMAP_NGRAM_HAS_SRCTRG);
+  if(found)
+    return entry.srcTrgCount;
+  else
+    return 0;
+}
+
+//-------------------------
+Prob MmapNgramTable::pTrgGivenSrc(const std::vector<WordIndex>& s,
+                                  const WordIndex& t)
+{
+  im_pair<Count,Count> psst;
+  bool found;
+
+  psst=infSrcTrg(s,t,found);
+  if(!found)
+  {
+    return 0;
+  }
+  else
+  {
+    if((float)psst.first==0) return 0;
+    else
+    {
+      return (float)psst.second.get_c_st()/(float)psst.first.get_c_s();
+    }
+  }
+}
+
+//-------------------------
+LgProb MmapNgramTable::logpTrgGivenSrc(const std::vector<WordIndex>& s,
+                                       const WordIndex& t)
+{
+  im_pair<Count,Count> psst;
+  bool found;
+
+  psst=infSrcTrg(s,t,found);
+  if(!found)
+  {
+    return SMALL_LG_NUM;
+  }
+  else
+  {
+    if((float)psst.first<=SMALL_LG_NUM) return SMALL_LG_NUM;
+    else
+    {
+      return (float)psst.second.get_lc_st()-(float)psst.first.get_lc_s();
+    }
+  }
+}
+
+//-------------------------
+Prob MmapNgramTable::pSrcGivenTrg(const std::vector<WordIndex>& s,
+                                  const WordIndex& t)
+{
+  return logpSrcGivenTrg(s,t).get_p();
+}
+
+//-------------------------
+LgProb MmapNgramTable::logpSrcGivenTrg(const std::vector<WordIndex>& s,
+                                       const WordIndex& t)
+{
+  LogCount lc_t=lcTrg(t);
+  if((float)lc_t<=SMALL_LG_NUM)
+  {
+    return SMALL_LG_NUM;
+  }
+  else
+  {
+    LogCount lc_st=lcSrcTrg(s,t);
+    return (float)lc_st-(float)lc_t;
+  }
+}
+
+//-------------------------
+bool MmapNgramTable::getEntriesForSource(const std::vector<WordIndex>& s,
+                                         TrgTableNode& trgtn)
+{
+  std::pair<WordIndex,im_pair<Count,Count> > pdp;
+  Count s_count=cSrc(s);
+
+  trgtn.clear();
+
+      // Visit children of s in the base file
+  uint64_t begin;
+  uint64_t end;
+  if(baseChildRange(s,begin,end))
+  {
+    const OrderArrays& oa=orders[s.size()];
+    std::vector<WordIndex> st=s;
+    st.push_back(0);
+    for(uint64_t i=begin;i<end;++i)
+    {
+      st.back()=oa.words[i];
+      OverlayEntry entry;
+      if(lookupEntry(st,entry) && (entry.flags & MMAP_NGRAM_HAS_SRCTRG)
+         && (double)entry.srcTrgCount.get_c_st()!=0)
+      {
+        pdp.first=oa.words[i];
+        pdp.second.first=s_count;
+        pdp.second.second=entry.srcTrgCount;
+        trgtn.insert(pdp);
+      }
+    }
+  }
+
+      // Visit overlay entries whose context is s
+  OverlayChildren::const_iterator childIter=overlayChildren.find(s);
+  if(childIter!=overlayChildren.end())
+  {
+    std::vector<WordIndex> st=s;
+    st.push_back(0);
+    for(unsigned int i=0;i<childIter->second.size();++i)
+    {
+      st.back()=childIter->second[i];
+      Overlay::const_iterator iter=overlay.find(st);
+      if((iter->second.flags & MMAP_NGRAM_HAS_SRCTRG)
+         && (double)iter->second.srcTrgCount.get_c_st()!=0)
+      {
+        pdp.first=st.back();
+        pdp.second.first=s_count;
+        pdp.second.second=iter->second.srcTrgCount;
+        trgtn.insert(pdp);
+      }
+    }
+  }
+
+  if(trgtn.size()>0) return true;
+  else return false;
+}
+
+//-------------------------
+bool MmapNgramTable::getEntriesForTarget(const WordIndex& t,
+                                         SrcTableNode& srctn)
+{
+  MergeCursor cursor;
+  std::vector<WordIndex> key;
+  OverlayEntry entry;
+  std::pair<std::vector<WordIndex>,im_pair<Count,Count> > pdp;
+
+  srctn.clear();
+  initMergeCursor(cursor);
+  while(nextMergedEntry(cursor,key,entry))
+  {
+    if((entry.flags & MMAP_NGRAM_HAS_SRCTRG) && key.size()>1 && key.back()==t
+       && (double)entry.srcTrgCount.get_c_st()!=0)
+    {
+      pdp.first.assign(key.begin(),key.end()-1);
+      pdp.second.first=cSrc(pdp.first);
+      pdp.second.second=entry.srcTrgCount;
+      srctn.insert(pdp);
+    }
+  }
+  if(srctn.size()>0) return true;
+  else return false;
+}
+
+//-------------------------
+bool MmapNgramTable::getNbestForSrc(const std::vector<WordIndex>& s,
+                                    NbestTableNode<WordIndex>& nbt)
+{
+  TrgTableNode tnode;
+  TrgTableNode::iterator tNodeIter;
+  bool ret;
+
+  nbt.clear();
+  ret=getEntriesForSource(s,tnode);
+  for(tNodeIter=tnode.begin();tNodeIter!=tnode.end();++tNodeIter)
+  {
+    nbt.insert((float)tNodeIter->second.second.get_lc_st()-(float)tNodeIter->second.first.get_lc_s(),tNodeIter->first);
+  }
+  return ret;
+}
+
+//-------------------------
+bool MmapNgramTable::getNbestForTrg(const WordIndex& t,
+                                    NbestTableNode<std::vector<WordIndex> >& nbt,
+                                    int N)
+{
+  SrcTableNode tnode;
+  SrcTableNode::iterator tNodeIter;
+  bool ret;
+
+  nbt.clear();
+  ret=getEntriesForTarget(t,tnode);
+  for(tNodeIter=tnode.begin();tNodeIter!=tnode.end();++tNodeIter)
+  {
+    nbt.insert((float)tNodeIter->second.second.get_lc_st()-(float)tNodeIter->second.first.get_lc_s(),tNodeIter->first);
+  }
+
+  if(N>=0)
+    while(nbt.size()>(unsigned int) N) nbt.removeLastElement();
+
+  return ret;
+}
+
+//-------------------------
+Count MmapNgramTable::cSrcTrg(const std::vector<WordIndex>& s,
+                              const WordIndex& t)
+{
+  bool found;
+  Count c=getSrcTrgInfo(s,t,found);
+  if(!found) return 0;
+  else return c.get_c_st();
+}
+
+//-------------------------
+Count MmapNgramTable::cSrc(const std::vector<WordIndex>& s)
+{
+  bool found;
+  Count c=getSrcInfo(s,found);
+  if(!found) return 0;
+  else return c.get_c_s();
+}
+
+//-------------------------
+Count MmapNgramTable::cTrg(const WordIndex& t)
+{
+  MergeCursor cursor;
+  std::vector<WordIndex> key;
+  OverlayEntry entry;
+  Count c_t=SMALL_LG_NUM;
+
+  initMergeCursor(cursor);
+  while(nextMergedEntry(cursor,key,entry))
+  {
+    if((entry.flags & MMAP_NGRAM_HAS_SRCTRG) && (double)entry.srcTrgCount.get_c_st()>0
+       && key.size()>1 && key[0]==t)
+    {
+      c_t=(float)c_t+(float)entry.srcTrgCount.get_c_st();
+    }
+  }
+  return c_t;
+}
+
+//-------------------------
+LogCount MmapNgramTable::lcSrcTrg(const std::vector<WordIndex>& s,
+                                  const WordIndex& t)
+{
+  bool found;
+  Count c=getSrcTrgInfo(s,t,found);
+  if(!found) return SMALL_LG_NUM;
+  else return c.get_lc_st();
+}
+
+//-------------------------
+LogCount MmapNgramTable::lcSrc(const std::vector<WordIndex>& s)
+{
+  bool found;
+  Count c=getSrcInfo(s,found);
+  if(!found) return SMALL_LG_NUM;
+  else return c.get_lc_s();
+}
+
+//-------------------------
+LogCount MmapNgramTable::lcTrg(const WordIndex& t)
+{
+  MergeCursor cursor;
+  std::vector<WordIndex> key;
+  OverlayEntry entry;
+  LogCount lc_t=SMALL_LG_NUM;
+
+  initMergeCursor(cursor);
+  while(nextMergedEntry(cursor,key,entry))
+  {
+    if((entry.flags & MMAP_NGRAM_HAS_SRCTRG) && (double)entry.srcTrgCount.get_lc_st()>SMALL_LG_NUM
+       && key.size()>1 && key[0]==t)
+    {
+      lc_t=MathFuncs::lns_sumlog(lc_t,entry.srcTrgCount.get_lc_st());
+    }
+  }
+  return lc_t;
+}
+
+//-------------------------
+void MmapNgramTable::initMergeCursor(MergeCursor& cursor)const
+{
+  cursor.idx.clear();
+  cursor.end.clear();
+  cursor.baseKey.clear();
+  if(!orders.empty() && orders[0].numEntries>0)
+  {
+    cursor.idx.push_back(0);
+    cursor.end.push_back(orders[0].numEntries);
+    cursor.baseKey.push_back(orders[0].words[0]);
+  }
+
+  cursor.sortedOverlay.clear();
+  for(Overlay::const_iterator iter=overlay.begin();iter!=overlay.end();++iter)
+    cursor.sortedOverlay.push_back(&(*iter));
+  std::sort(cursor.sortedOverlay.begin(),cursor.sortedOverlay.end(),OverlayPtrSortCriterion());
+  cursor.overlayPos=0;
+}
+
+//-------------------------
+void MmapNgramTable::advanceBaseCursor(MergeCursor& cursor)const
+{
+      // Descend to the children of the current entry if any
+  unsigned int d=cursor.idx.size()-1;
+  uint64_t i=cursor.idx[d];
+  if(d+1<orders.size() && orders[d].childOffsets[i]<orders[d].childOffsets[i+1])
+  {
+    uint64_t child=orders[d].childOffsets[i];
+    cursor.idx.push_back(child);
+    cursor.end.push_back(orders[d].childOffsets[i+1]);
+    cursor.baseKey.push_back(orders[d+1].words[child]);
+    return;
+  }
+
+      // Otherwise move to the next sibling, going up when the range of
+      // the current level is exhausted
+  while(!cursor.idx.empty())
+  {
+    d=cursor.idx.size()-1;
+    ++cursor.idx[d];
+    if(cursor.idx[d]<cursor.end[d])
+    {
+      cursor.baseKey[d]=orders[d].words[cursor.idx[d]];
+      return;
+    }
+    cursor.idx.pop_back();
+    cursor.end.pop_back();
+    cursor.baseKey.pop_back();
+  }
+}
+
+//-------------------------
+bool MmapNgramTable::nextMergedEntry(MergeCursor& cursor,
+                                     std::vector<WordIndex>& key,
+                                     OverlayEntry& entry)const
+{
+  bool baseValid=!cursor.idx.empty();
+  bool overlayValid=cursor.overlayPos<cursor.sortedOverlay.size();
+
+  if(!baseValid && !overlayValid)
+    return false;
+
+  if(baseValid && (!overlayValid || cursor.baseKey<cursor.sortedOverlay[cursor.overlayPos]->first))
+  {
+        // Next entry is only stored in base file
+    unsigned int d=cursor.idx.size()-1;
+    uint64_t i=cursor.idx[d];
+    key=cursor.baseKey;
+    entry.srcCount=orders[d].srcCounts[i];
+    entry.srcTrgCount=orders[d].srcTrgCounts[i];
+    entry.flags=orders[d].flags[i];
+    advanceBaseCursor(cursor);
+  }
+  else
+  {
+        // Next entry is stored in the overlay, which supersedes the base
+        // file
+    const Overlay::value_type* ovPtr=cursor.sortedOverlay[cursor.overlayPos];
+    key=ovPtr->first;
+    entry=ovPtr->second;
+    if(baseValid && cursor.baseKey==ovPtr->first)
+      advanceBaseCursor(cursor);
+    ++cursor.overlayPos;
+  }
+  return true;
+}
+
+//-------------------------
+unsigned int MmapNgramTable::firstNewLevel(std::vector<std::vector<WordIndex> >& lastKeys,
+                                           const std::vector<WordIndex>& key)const
+{
+      // Skip the prefixes of key that have already been appended
+  unsigned int level=0;
+  while(level+1<key.size() && lastKeys[level].size()==level+1
+        && std::equal(lastKeys[level].begin(),lastKeys[level].end(),key.begin()))
+    ++level;
+
+  for(unsigned int k=level;k<key.size();++k)
+    lastKeys[k].assign(key.begin(),key.begin()+k+1);
+  return level;
+}
+
+//-------------------------
+void MmapNgramTable::appendEntry(std::vector<OrderBuffers>& buffers,
+                                 std::vector<std::vector<WordIndex> >& lastKeys,
+                                 const std::vector<WordIndex>& key,
+                                 const OverlayEntry& entry)const
+{
+  for(unsigned int level=firstNewLevel(lastKeys,key);level<key.size();++level)
+  {
+        // Append entry (prefixes without entry are stored as nodes with
+        // no information to keep the trie connected)
+    OrderBuffers& ob=buffers[level];
+    ob.words.push_back(key[level]);
+    if(level+1==key.size())
+    {
+      ob.srcCounts.push_back((float)entry.srcCount);
+      ob.srcTrgCounts.push_back((float)entry.srcTrgCount);
+      ob.flags.push_back(entry.flags);
+    }
+    else
+    {
+      ob.srcCounts.push_back(0);
+      ob.srcTrgCounts.push_back(0);
+      ob.flags.push_back(0);
+    }
+    if(level+1<buffers.size())
+      ob.childOffsets.push_back(buffers[level+1].words.size());
+  }
+}
+
+//-------------------------
+bool MmapNgramTable::writeBaseFile(const char *fileName,
+                                   const std::vector<OrderBuffers>& buffers,
+                                   Count nullCount)const
+{
+  std::vector<uint64_t> numEntries(buffers.size());
+  for(unsigned int i=0;i<buffers.size();++i)
+    numEntries[i]=buffers[i].words.size();
+
+  MmapNgramFileWriter writer;
+  if(writer.open(fileName,numEntries,nullCount)==THOT_ERROR)
+    return THOT_ERROR;
+  for(unsigned int i=0;i<buffers.size();++i)
+  {
+    const OrderBuffers& ob=buffers[i];
+    for(size_t j=0;j<ob.words.size();++j)
+      writer.append(i,ob.words[j],ob.srcCounts[j],ob.srcTrgCounts[j],ob.flags[j],(i+1<buffers.size())?ob.childOffsets[j]:0);
+  }
+  if(writer.close()==THOT_ERROR)
+  {
+    std::cerr<<"Error while writing file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+void MmapNgramTable::beginBaseFile(unsigned int maxOrder)
+{
+  buildBuffers.clear();
+  buildBuffers.resize(maxOrder);
+  buildLastKeys.clear();
+  buildLastKeys.resize(maxOrder);
+}
+
+//-------------------------
+void MmapNgramTable::addBaseFileEntry(const std::vector<WordIndex>& key,
+                                      Count srcCount,
+                                      Count srcTrgCount,
+                                      bool hasSrc,
+                                      bool hasSrcTrg)
+{
+  if(key.empty() || key.size()>buildBuffers.size())
+    return;
+
+  OverlayEntry entry;
+  entry.srcCount=srcCount;
+  entry.srcTrgCount=srcTrgCount;
+  if(hasSrc) entry.flags|=MMAP_NGRAM_HAS_SRC;
+  if(hasSrcTrg) entry.flags|=MMAP_NGRAM_HAS_SRCTRG;
+  appendEntry(buildBuffers,buildLastKeys,key,entry);
+}
+
+//-------------------------
+bool MmapNgramTable::endBaseFile(const char *fileName,
+                                 Count nullCount)
+{
+  for(unsigned int i=0;i+1<buildBuffers.size();++i)
+    buildBuffers[i].childOffsets.push_back(buildBuffers[i+1].words.size());
+
+  bool retval=writeBaseFile(fileName,buildBuffers,nullCount);
+  buildBuffers.clear();
+  buildLastKeys.clear();
+  return retval;
+}
+
+//-------------------------
+bool MmapNgramTable::mergeOverlay(const char *fileName)
+{
+      // Determine maximum order
+  unsigned int maxOrder=orders.size();
+  for(Overlay::const_iterator iter=overlay.begin();iter!=overlay.end();++iter)
+  {
+    if(iter->first.size()>maxOrder)
+      maxOrder=iter->first.size();
+  }
+
+      // Count the entries of each order of the new base file
+  std::vector<uint64_t> numEntries(maxOrder,0);
+  std::vector<std::vector<WordIndex> > lastKeys(maxOrder);
+  MergeCursor cursor;
+  std::vector<WordIndex> key;
+  OverlayEntry entry;
+  initMergeCursor(cursor);
+  while(nextMergedEntry(cursor,key,entry))
+  {
+    if(entry.flags!=0)
+    {
+      for(unsigned int level=firstNewLevel(lastKeys,key);level<key.size();++level)
+        ++numEntries[level];
+    }
+  }
+
+      // Stream the merged entries to the new base file. The file is
+      // written under a temporary name so as the mapped file remains
+      // valid until the new one is complete
+  std::string tmpFileName=fileName;
+  tmpFileName+=".tmp";
+  MmapNgramFileWriter writer;
+  if(writer.open(tmpFileName.c_str(),numEntries,srcInfoNull)==THOT_ERROR)
+  {
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+  lastKeys.assign(maxOrder,std::vector<WordIndex>());
+  initMergeCursor(cursor);
+  while(nextMergedEntry(cursor,key,entry))
+  {
+    if(entry.flags!=0)
+    {
+      for(unsigned int level=firstNewLevel(lastKeys,key);level<key.size();++level)
+      {
+            // Prefixes without entry are stored as nodes with no
+            // information to keep the trie connected
+        uint64_t childOffset=(level+1<maxOrder)?writer.numAppended(level+1):0;
+        if(level+1==key.size())
+          writer.append(level,key[level],(float)entry.srcCount,(float)entry.srcTrgCount,entry.flags,childOffset);
+        else
+          writer.append(level,key[level],0,0,0,childOffset);
+      }
+    }
+  }
+  if(writer.close()==THOT_ERROR)
+  {
+    std::cerr<<"Error while writing file "<<tmpFileName<<std::endl;
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+  if(rename(tmpFileName.c_str(),fileName)!=0)
+  {
+    std::cerr<<"Error while renaming file "<<tmpFileName<<" to "<<fileName<<std::endl;
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+
+      // Map the new base file
+  return load(fileName);
+}
+
+//-------------------------
+bool MmapNgramTable::load(const char *fileName)
+{
+  clear();
+
+      // Map file
+  int fd=open(fileName,O_RDONLY);
+  if(fd<0)
+  {
+    std::cerr<<"Error while opening n-gram file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)!=0)
+  {
+    std::cerr<<"Error while obtaining size of n-gram file "<<fileName<<std::endl;
+    close(fd);
+    return THOT_ERROR;
+  }
+  size_t length=fileStat.st_size;
+  size_t headerLength=MMAP_NGRAM_MAGIC_LEN+4*sizeof(uint32_t);
+  if(length<headerLength)
+  {
+    std::cerr<<"Error, n-gram file "<<fileName<<" is truncated"<<std::endl;
+    close(fd);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,length,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping n-gram file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  mapAddr=addr;
+  mapLength=length;
+
+      // Read header
+  const char* base=(const char*) addr;
+  uint32_t version;
+  uint32_t maxOrder;
+  float nullCount;
+  memcpy(&version,base+MMAP_NGRAM_MAGIC_LEN,sizeof(uint32_t));
+  memcpy(&maxOrder,base+MMAP_NGRAM_MAGIC_LEN+sizeof(uint32_t),sizeof(uint32_t));
+  memcpy(&nullCount,base+MMAP_NGRAM_MAGIC_LEN+2*sizeof(uint32_t),sizeof(float));
+  if(strncmp(base,MMAP_NGRAM_TABLE_MAGIC,MMAP_NGRAM_MAGIC_LEN)!=0 || version!=MMAP_NGRAM_TABLE_VERSION)
+  {
+    std::cerr<<"Error, file "<<fileName<<" is not a valid binary n-gram file"<<std::endl;
+    unmapBase();
+    return THOT_ERROR;
+  }
+  size_t offset=headerLength+maxOrder*sizeof(uint64_t);
+  if(length<offset)
+  {
+    std::cerr<<"Error, n-gram file "<<fileName<<" is truncated"<<std::endl;
+    unmapBase();
+    return THOT_ERROR;
+  }
+
+      // Set pointers to the arrays of each order
+  orders.resize(maxOrder);
+  for(unsigned int i=0;i<maxOrder;++i)
+  {
+    OrderArrays& oa=orders[i];
+    memcpy(&oa.numEntries,base+headerLength+i*sizeof(uint64_t),sizeof(uint64_t));
+    size_t num=oa.numEntries;
+    size_t requiredLength=offset+3*alignedSize(num*sizeof(float))+alignedSize(num);
+    if(i+1<maxOrder)
+      requiredLength+=alignedSize((num+1)*sizeof(uint64_t));
+    if(length<requiredLength)
+    {
+      std::cerr<<"Error, n-gram file "<<fileName<<" is truncated"<<std::endl;
+      unmapBase();
+      return THOT_ERROR;
+    }
+    oa.words=(const WordIndex*)(base+offset);
+    offset+=alignedSize(num*sizeof(WordIndex));
+    oa.srcCounts=(const float*)(base+offset);
+    offset+=alignedSize(num*sizeof(float));
+    oa.srcTrgCounts=(const float*)(base+offset);
+    offset+=alignedSize(num*sizeof(float));
+    oa.flags=(const unsigned char*)(base+offset);
+    offset+=alignedSize(num);
+    if(i+1<maxOrder)
+    {
+      oa.childOffsets=(const uint64_t*)(base+offset);
+      offset+=alignedSize((num+1)*sizeof(uint64_t));
+    }
+    else
+      oa.childOffsets=NULL;
+
+    for(size_t j=0;j<num;++j)
+    {
+      if(oa.flags[j] & MMAP_NGRAM_HAS_SRCTRG)
+        ++numBaseSrcTrgEntries;
+    }
+  }
+  srcInfoNull=nullCount;
+  baseFileName=fileName;
+
+  return THOT_OK;
+}
+
+//-------------------------
+size_t MmapNgramTable::overlaySize(void)const
+{
+  return overlay.size();
+}
+
+//-------------------------
+unsigned int MmapNgramTable::getMaxOrder(void)const
+{
+  return orders.size();
+}
+
+//-------------------------
+size_t MmapNgramTable::size(void)
+{
+  size_t result=numBaseSrcTrgEntries;
+  for(Overlay::const_iterator iter=overlay.begin();iter!=overlay.end();++iter)
+  {
+    OverlayEntry entry;
+    bool inBase=lookupBase(iter->first,entry) && (entry.flags & MMAP_NGRAM_HAS_SRCTRG);
+    if(!inBase && (iter->second.flags & MMAP_NGRAM_HAS_SRCTRG))
+      ++result;
+  }
+  return result;
+}
+
+//-------------------------
+void MmapNgramTable::unmapBase(void)
+{
+  if(mapAddr!=NULL)
+  {
+    munmap(mapAddr,mapLength);
+    mapAddr=NULL;
+    mapLength=0;
+  }
+  orders.clear();
+  numBaseSrcTrgEntries=0;
+  baseFileName.clear();
+}
+
+//-------------------------
+void MmapNgramTable::clear(void)
+{
+  unmapBase();
+  overlay.clear();
+  overlayChildren.clear();
+  srcInfoNull=0;
+}
+
+//-------------------------
+MmapNgramTable::~MmapNgramTable()
+{
+  unmapBase();
+}
@@ -0,0 +1,250 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MmapNgramTable.h
+ *
+ * @brief Defines the MmapNgramTable class. MmapNgramTable stores
+ * n-gram counts in a frozen base file that is memory-mapped and
+ * organized as a sorted trie with one array per n-gram order (last
+ * word, counts and offsets to the children in the next order). Online
+ * updates are absorbed by an in-memory hash overlay that can be merged
+ * into a new base file.
+ */
+
+#ifndef _MmapNgramTable
+#define _MmapNgramTable
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BaseIncrCondProbTable.h"
+#include "ErrorDefs.h"
+#include "MathDefs.h"
+#include "WordIndexVecHashF.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#if __GNUC__>2
+#include <ext/hash_map>
+using __gnu_cxx::hash_map;
+#else
+#include <hash_map>
+#endif
+
+//--------------- Constants ------------------------------------------
+
+#define MMAP_NGRAM_TABLE_MAGIC      "thot_mmngr_bin"
+#define MMAP_NGRAM_TABLE_VERSION    1
+
+#define MMAP_NGRAM_HAS_SRC          1
+#define MMAP_NGRAM_HAS_SRCTRG       2
+
+//--------------- Classes --------------------------------------------
+
+//--------------- MmapNgramTable class
+
+class MmapNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>,WordIndex,Count,Count>
+{
+ public:
+
+  typedef BaseIncrCondProbTable<std::vector<WordIndex>,WordIndex,Count,Count>::SrcTableNode SrcTableNode;
+  typedef BaseIncrCondProbTable<std::vector<WordIndex>,WordIndex,Count,Count>::TrgTableNode TrgTableNode;
+
+      // Constructor
+  MmapNgramTable(void);
+
+      // Basic functions
+  void addTableEntry(const std::vector<WordIndex>& s,
+                     const WordIndex& t,
+                     im_pair<Count,Count> inf);
+  void addSrcInfo(const std::vector<WordIndex>& s,Count s_inf);
+  void addSrcTrgInfo(const std::vector<WordIndex>& s,
+                     const WordIndex& t,
+                     Count st_inf);
+  void incrCountsOfEntryLog(const std::vector<WordIndex>& s,
+                            const WordIndex& t,
+                            LogCount lc);
+  im_pair<Count,Count> infSrcTrg(const std::vector<WordIndex>& s,
+                                 const WordIndex& t,
+                                 bool& found);
+  Count getSrcInfo(const std::vector<WordIndex>& s,bool& found);
+  Count getSrcTrgInfo(const std::vector<WordIndex>& s,
+                      const WordIndex& t,
+                      bool& found);
+  Prob pTrgGivenSrc(const std::vector<WordIndex>& s,const WordIndex& t);
+  LgProb logpTrgGivenSrc(const std::vector<WordIndex>& s,const WordIndex& t);
+  Prob pSrcGivenTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  LgProb logpSrcGivenTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  bool getEntriesForSource(const std::vector<WordIndex>& s,TrgTableNode& trgtn);
+  bool getEntriesForTarget(const WordIndex& t,SrcTableNode& srctn);
+  bool getNbestForSrc(const std::vector<WordIndex>& s,
+                      NbestTableNode<WordIndex>& nbt);
+  bool getNbestForTrg(const WordIndex& t,
+                      NbestTableNode<std::vector<WordIndex> >& nbt,
+                      int N=-1);
+
+      // Count-related functions
+  Count cSrcTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  Count cSrc(const std::vector<WordIndex>& s);
+  Count cTrg(const WordIndex& t);
+  LogCount lcSrcTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  LogCount lcSrc(const std::vector<WordIndex>& s);
+  LogCount lcTrg(const WordIndex& t);
+
+      // Functions to load and merge the base file
+  bool load(const char *fileName);
+      // Memory-maps the base file given by fileName. The overlay is
+      // cleared
+  bool mergeOverlay(const char *fileName);
+      // Writes a new base file containing the base n-grams and the
+      // overlay updates, then maps it and clears the overlay. fileName
+      // may be the name of the file that is currently mapped
+  size_t overlaySize(void)const;
+  unsigned int getMaxOrder(void)const;
+
+      // Functions to build a base file from entries given in
+      // lexicographic order (each n-gram is given after its prefixes)
+  void beginBaseFile(unsigned int maxOrder);
+  void addBaseFileEntry(const std::vector<WordIndex>& key,
+                        Count srcCount,
+                        Count srcTrgCount,
+                        bool hasSrc,
+                        bool hasSrcTrg);
+  bool endBaseFile(const char *fileName,
+                   Count nullCount);
+
+      // size and clear functions
+  size_t size(void);
+  void clear(void);
+
+      // Destructor
+  ~MmapNgramTable();
+
+ protected:
+
+      // Overlay entry, the counts of an entry supersede those stored
+      // in the base file
+  struct OverlayEntry
+  {
+    Count srcCount;
+    Count srcTrgCount;
+    unsigned char flags;
+    OverlayEntry(){flags=0;}
+  };
+
+  typedef hash_map<std::vector<WordIndex>,OverlayEntry,WordIndexVecHashF> Overlay;
+
+      // Last words of the overlay entries indexed by their context
+  typedef hash_map<std::vector<WordIndex>,std::vector<WordIndex>,WordIndexVecHashF> OverlayChildren;
+
+      // Arrays of a given n-gram order in the base file. The children
+      // of entry i are stored in the range [childOffsets[i],
+      // childOffsets[i+1]) of the next order
+  struct OrderArrays
+  {
+    const WordIndex* words;
+    const float* srcCounts;
+    const float* srcTrgCounts;
+    const unsigned char* flags;
+    const uint64_t* childOffsets;
+    uint64_t numEntries;
+  };
+
+      // Data used to build a new base file
+  struct OrderBuffers
+  {
+    std::vector<WordIndex> words;
+    std::vector<float> srcCounts;
+    std::vector<float> srcTrgCounts;
+    std::vector<unsigned char> flags;
+    std::vector<uint64_t> childOffsets;
+  };
+
+  Overlay overlay;
+  OverlayChildren overlayChildren;
+  Count srcInfoNull;
+
+      // Base file data
+  std::string baseFileName;
+  void* mapAddr;
+  size_t mapLength;
+  std::vector<OrderArrays> orders;
+  size_t numBaseSrcTrgEntries;
+
+      // Base file being built by addBaseFileEntry()
+  std::vector<OrderBuffers> buildBuffers;
+  std::vector<std::vector<WordIndex> > buildLastKeys;
+
+      // Cursor used to visit the merged base and overlay entries in
+      // lexicographic order (each n-gram is visited before its
+      // extensions)
+  struct MergeCursor
+  {
+    std::vector<uint64_t> idx;
+    std::vector<uint64_t> end;
+    std::vector<WordIndex> baseKey;
+    std::vector<const Overlay::value_type*> sortedOverlay;
+    size_t overlayPos;
+  };
+
+  class OverlayPtrSortCriterion
+  {
+   public:
+    bool operator()(const Overlay::value_type* a,
+                    const Overlay::value_type* b)const
+      {
+        return a->first<b->first;
+      }
+  };
+
+      // Auxiliary functions
+  bool baseChildRange(const std::vector<WordIndex>& s,
+                      uint64_t& begin,
+                      uint64_t& end)const;
+      // Obtains the range of the entries of order |s|+1 whose context
+      // is s
+  bool lookupBase(const std::vector<WordIndex>& key,
+                  OverlayEntry& entry)const;
+  bool lookupEntry(const std::vector<WordIndex>& key,
+                   OverlayEntry& entry)const;
+  OverlayEntry& getOverlayEntry(const std::vector<WordIndex>& key);
+  void initMergeCursor(MergeCursor& cursor)const;
+  void advanceBaseCursor(MergeCursor& cursor)const;
+  bool nextMergedEntry(MergeCursor& cursor,
+                       std::vector<WordIndex>& key,
+                       OverlayEntry& entry)const;
+  unsigned int firstNewLevel(std::vector<std::vector<WordIndex> >& lastKeys,
+                             const std::vector<WordIndex>& key)const;
+      // Obtains the first level of the trie where key requires a new
+      // node given the last appended keys, lastKeys is updated
+  void appendEntry(std::vector<OrderBuffers>& buffers,
+                   std::vector<std::vector<WordIndex> >& lastKeys,
+                   const std::vector<WordIndex>& key,
+                   const OverlayEntry& entry)const;
+  bool writeBaseFile(const char *fileName,
+                     const std::vector<OrderBuffers>& buffers,
+                     Count nullCount)const;
+  void unmapBase(void);
+};
+
+#endif
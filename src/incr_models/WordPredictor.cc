@@ -137,27 +137,72 @@ void WordPredictor::addSentence(std::vector<std::string> strVec)
 //---------------------------------------
 void WordPredictor::addSentenceAux(std::vector<std::string> strVec)
 {
-  std::vector<char> vecChar;
-  std::string chain;
-  Count *cPtr;
-
   for(unsigned int i=0;i<strVec.size();++i)
   {
-    chain=strVec[i];
-    vecChar.clear();
-    for(unsigned int j=0;j<chain.size();++j)
-    {
-      vecChar.push_back(chain[j]);
-    }
-    cPtr=charTrie.find(vecChar);
-    if(cPtr==NULL)
-    {
-      charTrie.insert(vecChar,1);
-    }
+    if(!strVec[i].empty())
+      addWord(strVec[i]);
+  }
+}
+
+//---------------------------------------
+void WordPredictor::addWord(const std::string& word)
+{
+  std::vector<char> vecChar(word.begin(),word.end());
+  std::vector<Trie<char,WordPredictorNodeInfo>*> statePath;
+
+      // Obtain the trie states for the prefixes of the word, inserting
+      // it if necessary
+  charTrie.getStatePath(vecChar,statePath);
+  if(statePath.size()<vecChar.size())
+  {
+    charTrie.insert(vecChar,WordPredictorNodeInfo());
+    charTrie.getStatePath(vecChar,statePath);
+  }
+
+      // Increase count of the word
+  WordPredictorNodeInfo& wordInfo=statePath.back()->getData();
+  if(wordInfo.wordId==WP_INVALID_WORD_ID)
+  {
+    wordInfo.wordId=words.size();
+    words.push_back(word);
+  }
+  wordInfo.count=wordInfo.count+(Count)1;
+
+      // Update best completions of each prefix
+  updateBestCompletions(bestCompletionsForEmptyPrefix,wordInfo.count,wordInfo.wordId);
+  for(unsigned int i=0;i<statePath.size();++i)
+    updateBestCompletions(statePath[i]->getData().bestCompletions,wordInfo.count,wordInfo.wordId);
+}
+
+//---------------------------------------
+void WordPredictor::updateBestCompletions(std::vector<std::pair<Count,unsigned int> >& bestCompletions,
+                                          Count count,
+                                          unsigned int wordId)
+{
+      // Counts only increase, so a word not in the list can only enter
+      // it when its own count is updated
+  unsigned int pos=0;
+  while(pos<bestCompletions.size() && bestCompletions[pos].second!=wordId)
+    ++pos;
+  if(pos==bestCompletions.size())
+  {
+    if(bestCompletions.size()<WP_NUM_COMPLETIONS_PER_NODE)
+      bestCompletions.push_back(std::make_pair(count,wordId));
+    else if(count>bestCompletions.back().first)
+      bestCompletions.back()=std::make_pair(count,wordId);
     else
-    {
-      *cPtr=*cPtr+(Count)1;
-    }
+      return;
+    pos=bestCompletions.size()-1;
+  }
+  else
+    bestCompletions[pos].first=count;
+
+      // Move the updated entry to its position, words reaching a given
+      // count first are kept ahead
+  while(pos>0 && count>bestCompletions[pos-1].first)
+  {
+    std::swap(bestCompletions[pos],bestCompletions[pos-1]);
+    --pos;
   }
 }
 
@@ -165,36 +210,25 @@ void WordPredictor::addSentenceAux(std::vector<std::string> strVec)
 void WordPredictor::getSuffixList(std::string input,
                                   SuffixList &out)
 {
-  Trie<char,Count>* triePtr;
-  std::vector<char> charVec;
+  const std::vector<std::pair<Count,unsigned int> >* bestComplPtr;
   
   out.clear();
-  for(unsigned int i=0;i<input.size();++i)
-    charVec.push_back(input[i]);
-  triePtr=charTrie.getState(charVec);
-  if(triePtr!=NULL)
+  if(input.empty())
   {
-    Trie<char,Count>::const_iterator trieIter;
-    std::string suff;
-    unsigned int i;
-    
-    for(trieIter=triePtr->begin();trieIter!=triePtr->end();++trieIter)
-    {
-      suff="";
-      if((double)trieIter->second>(double)0)
-      {
-        if(input.size()>0 && trieIter->first[0]!=input[input.size()-1]) break;
-            // This checking is done to detect whether the iterator
-            // finish the iteration over the words that starts with the
-            // prefix input
-
-        for(i=1;i<trieIter->first.size();++i)
-        {
-          suff.push_back(trieIter->first[i]);
-        }
-        out[trieIter->second]=suff;
-      }
-    }
+    bestComplPtr=&bestCompletionsForEmptyPrefix;
+  }
+  else
+  {
+    std::vector<char> charVec(input.begin(),input.end());
+    Trie<char,WordPredictorNodeInfo>* triePtr=charTrie.getState(charVec);
+    if(triePtr==NULL) return;
+    bestComplPtr=&triePtr->getData().bestCompletions;
+  }
+
+  for(unsigned int i=0;i<bestComplPtr->size();++i)
+  {
+    const std::string& word=words[(*bestComplPtr)[i].second];
+    out.insert(std::make_pair((*bestComplPtr)[i].first,word.substr(input.size())));
   }
 }
 
@@ -220,6 +254,8 @@ std::pair<Count,std::string> WordPredictor::getBestSuffix(std::string input)
 void WordPredictor::clear(void)
 {
   charTrie.clear();
+  words.clear();
+  bestCompletionsForEmptyPrefix.clear();
   numSentsToRetain=1;
   strVecVec.clear();
 }
@@ -33,6 +33,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #  include <thot_config.h>
 #endif /* HAVE_CONFIG_H */
 
+#include <limits.h>
 #include <iostream>
 #include <iomanip>
 #include <map>
@@ -45,6 +46,30 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+#define WP_NUM_COMPLETIONS_PER_NODE   8
+#define WP_INVALID_WORD_ID            UINT_MAX
+
+//--------------- User defined types ---------------------------------
+
+/**
+ * @brief Information stored in each node of the character trie used by
+ * WordPredictor. Besides the count of the word ending at the node, the
+ * node keeps the WP_NUM_COMPLETIONS_PER_NODE words with highest count
+ * that start with the prefix represented by the node, sorted in
+ * decreasing order of count.
+ */
+struct WordPredictorNodeInfo
+{
+  Count count;
+  unsigned int wordId;
+  std::vector<std::pair<Count,unsigned int> > bestCompletions;
+
+  WordPredictorNodeInfo()
+    {
+      count=0;
+      wordId=WP_INVALID_WORD_ID;
+    }
+};
 
 //--------------- Classes --------------------------------------------
 
@@ -70,7 +95,10 @@ class WordPredictor
       // Add a new sentence to the word predictor
   void addSentence(std::vector<std::string> strVec);
 
-      // Get set of possible suffixes for a string
+      // Get set of possible suffixes for a string. Only the
+      // WP_NUM_COMPLETIONS_PER_NODE completions with highest count are
+      // considered, the cost of the lookup does not depend on the
+      // number of words starting with input
   void getSuffixList(std::string input,SuffixList &out);
 
       // Get the suffix with highest count for given string
@@ -83,13 +111,21 @@ class WordPredictor
   
  protected:
   
-  Trie<char,Count> charTrie;
+  Trie<char,WordPredictorNodeInfo> charTrie;
+  std::vector<std::string> words;
+  std::vector<std::pair<Count,unsigned int> > bestCompletionsForEmptyPrefix;
   unsigned int numSentsToRetain;
   std::vector<std::vector<std::string> > strVecVec;
   
   bool loadFileWithSents(const char *fileName);
   bool loadFileWithAdditionalInfo(const char *fileName);
   void addSentenceAux(std::vector<std::string> strVec);
+  void addWord(const std::string& word);
+  void updateBestCompletions(std::vector<std::pair<Count,unsigned int> >& bestCompletions,
+                             Count count,
+                             unsigned int wordId);
+      // Updates the list of best completions of a trie node given that
+      // the count of the word wordId has been increased to count
 
 };
 #endif
@@ -46,6 +46,22 @@ extern "C" {
 
 //--------------- typedefs -------------------------------------------
 
+// Sufficient statistics used to evaluate the perplexity of a corpus
+// during the weight updating process. Each n-gram of the corpus is
+// represented by the relative frequencies and weight indices of the
+// interpolated models, from the lowest order to the highest one (the
+// counts do not change when the weights are modified)
+struct JelMerPerpStats
+{
+  std::vector<float> relFreqs;
+  std::vector<unsigned int> weightIdxs;
+  std::vector<unsigned int> ngramOffsets;
+      // Levels of n-gram i are stored in [ngramOffsets[i],ngramOffsets[i+1])
+  std::vector<std::pair<unsigned int,unsigned int> > sentRanges;
+      // Range of n-grams of each sentence
+  unsigned int numWords;
+  double zeroGramProb;
+};
 
 //--------------- function declarations ------------------------------
 
@@ -96,17 +112,29 @@ class _incrJelMerNgramLM: public _incrNgramLM<SRC_INFO,SRCTRG_INFO>
   double sizeOfBucket;
 
       // Downhill-simplex related functions
-  int new_dhs_eval(const char *corpusFileName,
+  int new_dhs_eval(const JelMerPerpStats& perpStats,
                    FILE* tmp_file,
                    double* x,
                    double& obj_func);
 
+      // Functions to evaluate perplexity from sufficient statistics
+  int obtainPerpStats(const char *corpusFileName,
+                      JelMerPerpStats& perpStats);
+  void addNgramToPerpStats(const std::vector<WordIndex>& s,
+                           const WordIndex& t,
+                           JelMerPerpStats& perpStats);
+  double perplexityFromStats(const JelMerPerpStats& perpStats);
+
       // Weights related functions
   double getJelMerWeight(const std::vector<WordIndex>& s,
                          const WordIndex& t);
+  unsigned int getJelMerWeightIdx(const std::vector<WordIndex>& s,
+                                  const WordIndex& t);
   virtual double freqOfNgram(const std::vector<WordIndex>& s);
 
       // Recursive function to interpolate models
+  void removeExtraBos(const std::vector<WordIndex>& s,
+                      std::vector<WordIndex>& aux_s);
   Prob pTrgGivenSrcRec(const std::vector<WordIndex>& s,
                        const WordIndex& t);
 };
@@ -119,8 +147,22 @@ Prob _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::pTrgGivenSrc(const std::vector<Wo
                                                             const WordIndex& t)
 {
       // Remove extra BOS symbols
-  bool found;
   std::vector<WordIndex> aux_s;
+  removeExtraBos(s,aux_s);
+
+      // Calculate interpolated probability
+  Prob p=pTrgGivenSrcRec(aux_s,t);
+  return p;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::removeExtraBos(const std::vector<WordIndex>& s,
+                                                              std::vector<WordIndex>& aux_s)
+{
+  bool found;
+
+  aux_s.clear();
   if(s.size()>=2)
   {
     unsigned int i=0;
@@ -133,10 +175,6 @@ Prob _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::pTrgGivenSrc(const std::vector<Wo
       aux_s.push_back(s[i]);
   }
   else aux_s=s;
-
-      // Calculate interpolated probability
-  Prob p=pTrgGivenSrcRec(aux_s,t);
-  return p;
 }
 
 //---------------
@@ -179,12 +217,24 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::updateModelWeights(const char *cor
   double* x=(double*) malloc(ndim*sizeof(double));
   double y;
 
+      // Obtain sufficient statistics to evaluate perplexity (n-gram
+      // counts do not change during the weight updating process)
+  JelMerPerpStats perpStats;
+  if(obtainPerpStats(corpusFileName,perpStats)==THOT_ERROR)
+  {
+    free(start);
+    free(x);
+    return THOT_ERROR;
+  }
+
       // Create temporary file
   FILE* tmp_file=tmpfile();
   
   if(tmp_file==0)
   {
     std::cerr<<"Error updating of Jelinek Mercer's language model weights, tmp file could not be created"<<std::endl;
+    free(start);
+    free(x);
     return THOT_ERROR;
   }
     
@@ -211,7 +261,7 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::updateModelWeights(const char *cor
         break;
       case DSO_EVAL_FUNC: // A new function evaluation is requested by downhill simplex
         double perp;
-        int retEval=new_dhs_eval(corpusFileName,tmp_file,x,perp);
+        int retEval=new_dhs_eval(perpStats,tmp_file,x,perp);
         if(retEval==THOT_ERROR)
         {
           end=true;
@@ -254,17 +304,13 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::updateModelWeights(const char *cor
 
 //---------------
 template<class SRC_INFO,class SRCTRG_INFO>
-int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const char *corpusFileName,
+int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const JelMerPerpStats& perpStats,
                                                            FILE* tmp_file,
                                                            double* x,
                                                            double& obj_func)
 {
-  unsigned int numOfSentences;
-  unsigned int numWords;
-  LgProb totalLogProb;
   bool weightsArePositive=true;
   bool weightsAreBelowOne=true;
-  int retVal;
   
       // Fix weights to be evaluated
   for(unsigned int i=0;i<weights.size();++i)
@@ -276,12 +322,11 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const char *corpusFil
   if(weightsArePositive && weightsAreBelowOne)
   {
         // Obtain perplexity
-    retVal=this->perplexity(corpusFileName,numOfSentences,numWords,totalLogProb,obj_func);
+    obj_func=perplexityFromStats(perpStats);
   }
   else
   {
     obj_func=DBL_MAX;
-    retVal=THOT_OK;
   }
       // Print result to tmp file
   fprintf(tmp_file,"%g\n",obj_func);
@@ -290,17 +335,128 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const char *corpusFil
       // indicator is set at the start of the stream
   rewind(tmp_file);
 
-  return retVal;
+  return THOT_OK;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::obtainPerpStats(const char *corpusFileName,
+                                                              JelMerPerpStats& perpStats)
+{
+  AwkInputStream awk;
+  std::vector<WordIndex> state;
+  bool found;
+
+  perpStats.relFreqs.clear();
+  perpStats.weightIdxs.clear();
+  perpStats.ngramOffsets.clear();
+  perpStats.ngramOffsets.push_back(0);
+  perpStats.sentRanges.clear();
+  perpStats.numWords=0;
+  perpStats.zeroGramProb=(double)1.0/(double)this->getVocabSize();
+  
+      // Open corpus file
+  if(awk.open(corpusFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }  
+
+      // Process sentences in the same way as the perplexity() function
+  while(awk.getln())
+  {
+    if(awk.NF>=1)
+    {
+      unsigned int firstNgram=perpStats.ngramOffsets.size()-1;
+      perpStats.numWords+=awk.NF;
+      this->getStateForBeginOfSentence(state);
+      for(unsigned int i=1;i<=awk.NF;++i)
+      {
+        WordIndex w=this->stringToWordIndex(awk.dollar(i));
+        addNgramToPerpStats(state,w,perpStats);
+        this->addNextWordToState(w,state);
+      }
+      addNgramToPerpStats(state,this->getEosId(found),perpStats);
+      perpStats.sentRanges.push_back(std::make_pair(firstNgram,(unsigned int)perpStats.ngramOffsets.size()-1));
+    }
+    else
+    {
+          // perplexity() adds the log-probability of the previous
+          // sentence when an empty line is found
+      if(perpStats.sentRanges.empty())
+        perpStats.sentRanges.push_back(std::make_pair(0,0));
+      else
+        perpStats.sentRanges.push_back(perpStats.sentRanges.back());
+    }
+  }
+  return THOT_OK;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::addNgramToPerpStats(const std::vector<WordIndex>& s,
+                                                                   const WordIndex& t,
+                                                                   JelMerPerpStats& perpStats)
+{
+      // Obtain the models interpolated by pTrgGivenSrc(), from the
+      // lowest order to the highest one
+  std::vector<WordIndex> aux_s;
+  removeExtraBos(s,aux_s);
+  for(unsigned int i=0;i<=aux_s.size();++i)
+  {
+    std::vector<WordIndex> hist(aux_s.end()-i,aux_s.end());
+    perpStats.relFreqs.push_back((double)this->tablePtr->pTrgGivenSrc(hist,t));
+    perpStats.weightIdxs.push_back(getJelMerWeightIdx(hist,t));
+  }
+  perpStats.ngramOffsets.push_back(perpStats.relFreqs.size());
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::perplexityFromStats(const JelMerPerpStats& perpStats)
+{
+      // Obtain the log-probability of each n-gram
+  unsigned int numNgrams=perpStats.ngramOffsets.size()-1;
+  std::vector<double> ngramLogProbs(numNgrams);
+  for(unsigned int i=0;i<numNgrams;++i)
+  {
+    double p=perpStats.zeroGramProb;
+    for(unsigned int j=perpStats.ngramOffsets[i];j<perpStats.ngramOffsets[i+1];++j)
+    {
+      double weight=weights[perpStats.weightIdxs[j]];
+      p=weight*perpStats.relFreqs[j]+(1-weight)*p;
+    }
+    ngramLogProbs[i]=log(p);
+  }
+
+      // Accumulate sentence log-probabilities
+  double totalLogProb=0;
+  for(unsigned int i=0;i<perpStats.sentRanges.size();++i)
+  {
+    double sentLogProb=0;
+    for(unsigned int j=perpStats.sentRanges[i].first;j<perpStats.sentRanges[i].second;++j)
+      sentLogProb+=ngramLogProbs[j];
+    totalLogProb+=sentLogProb*((double)1/M_LN10);
+  }
+  return exp(-(totalLogProb/(perpStats.numWords+perpStats.sentRanges.size()))*M_LN10);
 }
 
 //---------------
 template<class SRC_INFO,class SRCTRG_INFO>
 double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeight(const std::vector<WordIndex>& s,
-                                                                 const WordIndex& /*t*/)
+                                                                 const WordIndex& t)
+{
+  return weights[getJelMerWeightIdx(s,t)];
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+unsigned int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeightIdx(const std::vector<WordIndex>& s,
+                                                                          const WordIndex& /*t*/)
 {
   if(numBucketsPerOrder==1)
   {
-    return weights[s.size()];
+    return s.size();
   }
   else
   {
@@ -311,8 +467,8 @@ double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeight(const std::vect
     if(bucketIdx>numBucketsPerOrder-1)
       bucketIdx=numBucketsPerOrder-1;
     
-        // Return weight
-    return weights[((order-1)*numBucketsPerOrder)+bucketIdx];
+        // Return weight index
+    return ((order-1)*numBucketsPerOrder)+bucketIdx;
   }
 }
 
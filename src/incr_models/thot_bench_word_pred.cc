@@ -0,0 +1,291 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_word_pred.cc
+ *
+ * @brief Micro-benchmark for the completion lookups of the
+ * WordPredictor class. A word predictor is trained on a corpus of
+ * random words with Zipfian frequencies (or on a given corpus), and
+ * the best completion of prefixes of different lengths is obtained
+ * both with the WordPredictor class and by scanning all the words
+ * starting with the prefix.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordPredictor.h"
+#include "AwkInputStream.h"
+#include "ErrorDefs.h"
+#include "ctimer.h"
+#include "options.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define WORDS_PER_SENT 20
+
+//--------------- Function Declarations ------------------------------
+
+void genRandomCorpus(std::vector<std::vector<std::string> >& corpus);
+bool loadCorpus(const char* fileName,
+                std::vector<std::vector<std::string> >& corpus);
+Count refBestCount(const std::map<std::string,Count>& wordCounts,
+                   const std::string& prefix);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Global variables -----------------------------------
+
+unsigned int vocSize=20000;
+unsigned int numTokens=500000;
+unsigned int maxPrefLen=6;
+unsigned int numQueries=10000;
+unsigned int seed=31415;
+bool corpusGiven=false;
+std::string corpusFileName;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_ERROR)
+    return THOT_ERROR;
+
+  srand(seed);
+
+      // Obtain corpus
+  std::vector<std::vector<std::string> > corpus;
+  if(corpusGiven)
+  {
+    if(loadCorpus(corpusFileName.c_str(),corpus)==THOT_ERROR)
+      return THOT_ERROR;
+  }
+  else
+    genRandomCorpus(corpus);
+
+      // Train word predictor and obtain word counts
+  double elapsed_ant,elapsed,ucpu,scpu;
+  WordPredictor wordPredictor;
+  std::map<std::string,Count> wordCounts;
+  std::vector<std::string> tokens;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int i=0;i<corpus.size();++i)
+    wordPredictor.addSentence(corpus[i]);
+  ctimer(&elapsed,&ucpu,&scpu);
+  for(unsigned int i=0;i<corpus.size();++i)
+  {
+    for(unsigned int j=0;j<corpus[i].size();++j)
+    {
+      wordCounts[corpus[i][j]]+=1;
+      tokens.push_back(corpus[i][j]);
+    }
+  }
+  printf("Sentences: %zu ; tokens: %zu ; words: %zu\n",corpus.size(),tokens.size(),wordCounts.size());
+  printf("Training time: %g s\n",elapsed-elapsed_ant);
+  if(tokens.empty())
+  {
+    std::cerr<<"Error: the corpus is empty"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  printf("PrefLen\tQueries\tAvgCompl\tMismatches\tScan(us)\tIndex(us)\n");
+  for(unsigned int prefLen=1;prefLen<=maxPrefLen;++prefLen)
+  {
+        // Obtain prefixes of tokens drawn from the corpus, so that
+        // frequent words are typed more often
+    std::vector<std::string> prefixes;
+    for(unsigned int q=0;q<numQueries*10 && prefixes.size()<numQueries;++q)
+    {
+      const std::string& token=tokens[rand()%tokens.size()];
+      if(token.size()>prefLen)
+        prefixes.push_back(token.substr(0,prefLen));
+    }
+    if(prefixes.empty()) continue;
+
+        // Check results
+    unsigned int numMismatches=0;
+    unsigned long numCompletions=0;
+    for(unsigned int q=0;q<prefixes.size();++q)
+    {
+      std::map<std::string,Count>::const_iterator iter=wordCounts.lower_bound(prefixes[q]);
+      for(;iter!=wordCounts.end() && iter->first.compare(0,prefLen,prefixes[q])==0;++iter)
+        ++numCompletions;
+      std::pair<Count,std::string> pcs=wordPredictor.getBestSuffix(prefixes[q]);
+      Count refCount=refBestCount(wordCounts,prefixes[q]);
+      std::map<std::string,Count>::const_iterator wordIter=wordCounts.find(prefixes[q]+pcs.second);
+      if((float)pcs.first!=(float)refCount || wordIter==wordCounts.end() || (float)wordIter->second!=(float)refCount)
+        ++numMismatches;
+    }
+
+        // Measure time of exhaustive scan
+    double sum=0;
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    for(unsigned int q=0;q<prefixes.size();++q)
+      sum+=(float)refBestCount(wordCounts,prefixes[q]);
+    ctimer(&elapsed,&ucpu,&scpu);
+    double scanTime=elapsed-elapsed_ant;
+
+        // Measure time of word predictor
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    for(unsigned int q=0;q<prefixes.size();++q)
+      sum-=(float)wordPredictor.getBestSuffix(prefixes[q]).first;
+    ctimer(&elapsed,&ucpu,&scpu);
+    double indexTime=elapsed-elapsed_ant;
+
+    printf("%u\t%zu\t%g\t%u\t%g\t%g\n",prefLen,prefixes.size(),
+           (double)numCompletions/prefixes.size(),numMismatches,
+           1000000*scanTime/prefixes.size(),1000000*indexTime/prefixes.size());
+    if(sum!=0) std::cerr<<"Warning: checksums differ"<<std::endl;
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+void genRandomCorpus(std::vector<std::vector<std::string> >& corpus)
+{
+      // Generate vocabulary
+  std::vector<std::string> vocab;
+  for(unsigned int i=0;i<vocSize;++i)
+  {
+    std::string word;
+    unsigned int len=2+rand()%11;
+    for(unsigned int j=0;j<len;++j)
+      word.push_back('a'+rand()%26);
+    vocab.push_back(word);
+  }
+
+      // Obtain cumulative Zipfian distribution over the vocabulary
+  std::vector<double> cumProbs(vocSize);
+  double total=0;
+  for(unsigned int i=0;i<vocSize;++i)
+  {
+    total+=1.0/(i+1);
+    cumProbs[i]=total;
+  }
+
+      // Generate sentences
+  std::vector<std::string> sent;
+  for(unsigned int i=0;i<numTokens;++i)
+  {
+    double r=total*((double)rand()/((double)RAND_MAX+1));
+    unsigned int rank=std::lower_bound(cumProbs.begin(),cumProbs.end(),r)-cumProbs.begin();
+    if(rank>=vocSize) rank=vocSize-1;
+    sent.push_back(vocab[rank]);
+    if(sent.size()==WORDS_PER_SENT)
+    {
+      corpus.push_back(sent);
+      sent.clear();
+    }
+  }
+  if(!sent.empty())
+    corpus.push_back(sent);
+}
+
+//---------------
+bool loadCorpus(const char* fileName,
+                std::vector<std::vector<std::string> >& corpus)
+{
+  AwkInputStream awk;
+  if(awk.open(fileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  while(awk.getln())
+  {
+    std::vector<std::string> sent;
+    for(unsigned int i=1;i<=awk.NF;++i)
+      sent.push_back(awk.dollar(i));
+    corpus.push_back(sent);
+  }
+  awk.close();
+  return THOT_OK;
+}
+
+//---------------
+Count refBestCount(const std::map<std::string,Count>& wordCounts,
+                   const std::string& prefix)
+{
+  Count bestCount=0;
+  std::map<std::string,Count>::const_iterator iter=wordCounts.lower_bound(prefix);
+  for(;iter!=wordCounts.end() && iter->first.compare(0,prefix.size(),prefix)==0;++iter)
+  {
+    if(iter->second>bestCount)
+      bestCount=iter->second;
+  }
+  return bestCount;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+  if(readSTLstring(argc,argv, "-c", &corpusFileName)!=-1)
+    corpusGiven=true;
+  readUnsignedInt(argc,argv, "-V", &vocSize);
+  readUnsignedInt(argc,argv, "-t", &numTokens);
+  readUnsignedInt(argc,argv, "-l", &maxPrefLen);
+  readUnsignedInt(argc,argv, "-n", &numQueries);
+  readUnsignedInt(argc,argv, "-s", &seed);
+  if(vocSize==0 || maxPrefLen==0 || numQueries==0)
+  {
+    std::cerr<<"Error: -V, -l and -n values must be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_bench_word_pred [-c <string> | -V <int> -t <int>] [-l <int>]\n");
+  printf("                            [-n <int>] [-s <int>] [--help]\n\n");
+  printf("-c <string>                 Train the word predictor on the given corpus\n");
+  printf("                            (one sentence per line) instead of a random one.\n\n");
+  printf("-V <int>                    Vocabulary size of the random corpus (20000 by\n");
+  printf("                            default).\n\n");
+  printf("-t <int>                    Number of tokens of the random corpus (500000 by\n");
+  printf("                            default).\n\n");
+  printf("-l <int>                    Maximum prefix length (6 by default).\n\n");
+  printf("-n <int>                    Number of queries per prefix length (10000 by\n");
+  printf("                            default).\n\n");
+  printf("-s <int>                    Seed for the random number generator (31415 by\n");
+  printf("                            default).\n\n");
+  printf("--help                      Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -0,0 +1,407 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/**
+ * @file thot_count_ngrams.cc
+ *
+ * @brief Extracts n-gram counts from a monolingual corpus using
+ * several threads and a bounded amount of memory. Counts can be
+ * printed in thot text format or stored as a LevelDB or a
+ * memory-mapped language model.
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LM_Defs.h"
+  // NOTE: this file should be included first, since it defines the
+  // _FILE_OFFSET_BITS constant. This constant has to be defined
+  // before including any STL header files to avoid conflicts.
+
+#include "ExtNgramCounter.h"
+#include "MmapNgramTable.h"
+#include "IncrJelMerMmapNgramLM.h"
+#include "lm_ienc.h"
+#ifdef THOT_HAVE_LEVELDB_LIB
+#include "LevelDbNgramTable.h"
+#endif
+#include "AwkInputStream.h"
+#include "ctimer.h"
+#include "options.h"
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdio.h>
+#include <unistd.h>
+
+//--------------- Constants ------------------------------------------
+
+#define TEXT_OUTPUT   0
+#define LDB_OUTPUT    1
+#define MMAP_OUTPUT   2
+
+  // Number of words of the blocks of sentences counted in parallel
+#define BLOCK_SIZE_IN_WORDS 1000000
+
+//--------------- Function Declarations ------------------------------
+
+int countNgrams(ExtNgramCounter& ngramCounter,
+                lm_ienc& encoder);
+int printTextCounts(ExtNgramCounter& ngramCounter,
+                    lm_ienc& encoder);
+int storeLevelDbCounts(ExtNgramCounter& ngramCounter,
+                       lm_ienc& encoder);
+int storeMmapCounts(ExtNgramCounter& ngramCounter,
+                    lm_ienc& encoder);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string corpusFileName;
+std::string outputFileName;
+std::string tdir="/tmp";
+unsigned int order;
+unsigned int numThreads=1;
+unsigned int memBudget=1024;
+bool unk=false;
+int outputType=TEXT_OUTPUT;
+int verbose=0;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Initialize counter
+  std::ostringstream oss;
+  oss<<tdir<<"/thot_count_ngrams."<<getpid();
+  ExtNgramCounter ngramCounter;
+  if(ngramCounter.init(order,numThreads,(size_t)memBudget*1024*1024,oss.str())==THOT_ERROR)
+    return THOT_ERROR;
+  lm_ienc encoder;
+  ngramCounter.setBosEosIdx(S_BEGIN,S_END);
+
+      // Count n-grams
+  double elapsed_ant,elapsed,ucpu,scpu;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  if(countNgrams(ngramCounter,encoder)==THOT_ERROR)
+    return THOT_ERROR;
+  if(ngramCounter.startMerge(verbose)==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Generate output
+  int ret;
+  switch(outputType)
+  {
+    case LDB_OUTPUT: ret=storeLevelDbCounts(ngramCounter,encoder);
+      break;
+    case MMAP_OUTPUT: ret=storeMmapCounts(ngramCounter,encoder);
+      break;
+    default: ret=printTextCounts(ngramCounter,encoder);
+      break;
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  
+  if(verbose)
+    std::cerr<<"Elapsed time: "<<elapsed-elapsed_ant<<" secs"<<std::endl;
+  
+  return ret;
+}
+
+//---------------
+int countNgrams(ExtNgramCounter& ngramCounter,
+                lm_ienc& encoder)
+{
+  AwkInputStream awk;
+  if(awk.open(corpusFileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  std::set<std::string> seenWords;
+  std::vector<std::vector<WordIndex> > block;
+  unsigned int blockSize=0;
+  unsigned int numSents=0;
+  while(awk.getln())
+  {
+        // Encode sentence
+    std::vector<WordIndex> sent;
+    for(unsigned int i=1;i<=awk.NF;++i)
+    {
+      std::string word=awk.dollar(i);
+      WordIndex w;
+      if(!encoder.HighTrg_to_Trg(word,w))
+      {
+        if(unk && seenWords.find(word)==seenWords.end())
+        {
+              // First occurrence of the word is replaced by the
+              // unknown word so as to reserve probability mass for it
+          seenWords.insert(word);
+          w=UNK_SYMBOL;
+        }
+        else
+        {
+          w=encoder.genHTrgCode(word);
+          encoder.addHTrgCode(word,w);
+        }
+      }
+      sent.push_back(w);
+    }
+    blockSize+=sent.size()+2;
+    block.push_back(sent);
+    ++numSents;
+    
+        // Count block of sentences
+    if(blockSize>=BLOCK_SIZE_IN_WORDS)
+    {
+      if(ngramCounter.addSentences(block)==THOT_ERROR)
+        return THOT_ERROR;
+      block.clear();
+      blockSize=0;
+      if(verbose)
+        std::cerr<<"Processed "<<numSents<<" sentences ("<<ngramCounter.getNumRuns()<<" runs)"<<std::endl;
+    }
+  }
+  if(ngramCounter.addSentences(block)==THOT_ERROR)
+    return THOT_ERROR;
+
+  if(verbose)
+    std::cerr<<"Processed "<<numSents<<" sentences, "<<ngramCounter.getNumWords()<<" words"<<std::endl;
+  
+  return THOT_OK;
+}
+
+//---------------
+int printTextCounts(ExtNgramCounter& ngramCounter,
+                    lm_ienc& encoder)
+{
+  FILE* outFile=stdout;
+  if(!outputFileName.empty())
+  {
+    outFile=fopen(outputFileName.c_str(),"w");
+    if(outFile==NULL)
+    {
+      std::cerr<<"Error while opening file "<<outputFileName<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  std::vector<WordIndex> ngram;
+  uint64_t histCount;
+  uint64_t ngramCount;
+  std::string word;
+  while(ngramCounter.nextNgram(ngram,histCount,ngramCount))
+  {
+    for(unsigned int i=0;i<ngram.size();++i)
+    {
+      encoder.Trg_to_HighTrg(ngram[i],word);
+      fprintf(outFile,"%s ",word.c_str());
+    }
+    fprintf(outFile,"%llu %llu\n",(unsigned long long)histCount,(unsigned long long)ngramCount);
+  }
+
+  bool error=ferror(outFile);
+  if(outFile!=stdout)
+    fclose(outFile);
+  if(error)
+  {
+    std::cerr<<"Error while writing n-gram counts"<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//---------------
+int storeLevelDbCounts(ExtNgramCounter& ngramCounter,
+                       lm_ienc& encoder)
+{
+#ifdef THOT_HAVE_LEVELDB_LIB
+  LevelDbNgramTable levelDbNt;
+  if(levelDbNt.init(outputFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Cannot create or recreate database (LevelDB) for language model"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Store n-grams, writes are grouped in batches
+  std::vector<WordIndex> ngram;
+  std::vector<WordIndex> hist;
+  uint64_t histCount;
+  uint64_t ngramCount;
+  unsigned int numEntries=0;
+  levelDbNt.beginUpdateBatch();
+  while(ngramCounter.nextNgram(ngram,histCount,ngramCount))
+  {
+    hist.assign(ngram.begin(),ngram.end()-1);
+    levelDbNt.addTableEntry(hist,ngram.back(),im_pair<Count,Count>(Count((float)histCount),Count((float)ngramCount)));
+    ++numEntries;
+    if(numEntries%100000==0)
+    {
+      if(levelDbNt.commitUpdateBatch()==THOT_ERROR)
+        return THOT_ERROR;
+      levelDbNt.beginUpdateBatch();
+    }
+  }
+  if(levelDbNt.commitUpdateBatch()==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Store vocabulary
+  std::string vocabFileName=outputFileName+".ldb_vcb";
+  return encoder.print(vocabFileName.c_str());
+#else
+  (void) ngramCounter;
+  (void) encoder;
+  std::cerr<<"Error: LevelDB output is not available (thot was built without LevelDB)"<<std::endl;
+  return THOT_ERROR;
+#endif
+}
+
+//---------------
+int storeMmapCounts(ExtNgramCounter& ngramCounter,
+                    lm_ienc& encoder)
+{
+  MmapNgramTable mmapNt;
+  mmapNt.beginBaseFile(order);
+
+      // Store n-grams. An n-gram is stored as history (c(s) is
+      // stored) iff it is followed by one of its extensions
+  std::vector<WordIndex> ngram;
+  std::vector<WordIndex> prevNgram;
+  uint64_t histCount;
+  uint64_t ngramCount;
+  uint64_t prevNgramCount=0;
+  bool pending=false;
+  while(ngramCounter.nextNgram(ngram,histCount,ngramCount))
+  {
+    if(pending)
+    {
+      bool hasExtensions=(ngram.size()==prevNgram.size()+1 && std::equal(prevNgram.begin(),prevNgram.end(),ngram.begin()));
+      mmapNt.addBaseFileEntry(prevNgram,Count((float)prevNgramCount),Count((float)prevNgramCount),hasExtensions,true);
+    }
+    prevNgram=ngram;
+    prevNgramCount=ngramCount;
+    pending=true;
+  }
+  if(pending)
+    mmapNt.addBaseFileEntry(prevNgram,Count((float)prevNgramCount),Count((float)prevNgramCount),false,true);
+
+  std::string binFileName=outputFileName+MMAP_NGRAM_LM_BIN_EXT;
+  if(mmapNt.endBaseFile(binFileName.c_str(),Count((float)ngramCounter.getNumWords()))==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Store vocabulary
+  std::string vocabFileName=outputFileName+MMAP_NGRAM_LM_VCB_EXT;
+  return encoder.print(vocabFileName.c_str());
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  int err;
+
+  if(argc==1 || readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+  
+      /* Take the corpus file name */
+  err=readSTLstring(argc,argv, "-c", &corpusFileName);
+  if(err==-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Take order of the n-grams */
+  err=readUnsignedInt(argc,argv, "-n", &order);
+  if(err==-1 || order==0)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Take output file name */
+  err=readSTLstring(argc,argv, "-o", &outputFileName);
+  if(err==-1)
+    outputFileName="";
+
+      /* Take number of threads */
+  err=readUnsignedInt(argc,argv, "-nt", &numThreads);
+  if(err!=-1 && numThreads==0)
+  {
+    std::cerr<<"Error: number of threads must be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      /* Take memory budget */
+  readUnsignedInt(argc,argv, "-mem", &memBudget);
+
+      /* Take directory for temporary files */
+  readSTLstring(argc,argv, "-tdir", &tdir);
+
+      /* Check -unk option */
+  if(readOption(argc,argv, "-unk")!=-1)
+    unk=true;
+
+      /* Check output type */
+  if(readOption(argc,argv, "-ldb")!=-1)
+    outputType=LDB_OUTPUT;
+  if(readOption(argc,argv, "-mmap")!=-1)
+    outputType=MMAP_OUTPUT;
+  if(outputType!=TEXT_OUTPUT && outputFileName.empty())
+  {
+    std::cerr<<"Error: -ldb and -mmap options require an output file name (-o option)"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      /* Check verbosity option */
+  if(readOption(argc,argv, "-v")!=-1)
+    verbose=1;
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_count_ngrams -c <string> -n <int> [-unk] [-o <string>]\n");
+  printf("                         [-ldb|-mmap] [-nt <int>] [-mem <int>]\n");
+  printf("                         [-tdir <string>] [-v] [--help]\n\n");
+  printf("-c <string>              Corpus file.\n\n");
+  printf("-n <int>                 Order of the n-grams.\n\n");
+  printf("-unk                     Reserve probability mass for the unknown word.\n\n");
+  printf("-o <string>              Output file name. Counts are printed to the\n");
+  printf("                         standard output in thot text format if not given.\n\n");
+  printf("-ldb                     Store counts as a LevelDB language model.\n\n");
+  printf("-mmap                    Store counts as a memory-mapped language model\n");
+  printf("                         (files with extensions %s and %s).\n\n",MMAP_NGRAM_LM_BIN_EXT,MMAP_NGRAM_LM_VCB_EXT);
+  printf("-nt <int>                Number of counting threads (1 by default).\n\n");
+  printf("-mem <int>               Memory budget in MB for the n-gram counts (1024 by\n");
+  printf("                         default). When exhausted, counts are spilled to\n");
+  printf("                         temporary binary files.\n\n");
+  printf("-tdir <string>           Directory for temporary files (/tmp by default).\n\n");
+  printf("-v                       Verbose mode.\n\n");
+  printf("--help                   Display this help and exit.\n\n");
+}
+
+//--------------------------------
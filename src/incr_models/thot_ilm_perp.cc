@@ -59,6 +59,7 @@ std::string corpusFileName;
 int verbose=0;
 int lmType=JEL_MER_LM;
 unsigned int order;
+unsigned int numThreads=1;
 
 //--------------- Function Definitions -------------------------------
 
@@ -96,7 +97,7 @@ int main(int argc,char *argv[])
       lm->setNgramOrder(order);
       
       ctimer(&elapsed_ant,&ucpu,&scpu);
-      int ret=lm->perplexity(corpusFileName.c_str(),sentenceNo,numWords,total_logp,perp,verbose);
+      int ret=lm->perplexityMt(corpusFileName.c_str(),numThreads,sentenceNo,numWords,total_logp,perp,verbose);
       if(ret==THOT_ERROR)
       {
         delete lm;
@@ -152,6 +153,21 @@ int TakeParameters(int argc,char *argv[])
    return THOT_ERROR;
  }
 
+      /* Take number of threads */
+ err=readUnsignedInt(argc,argv, "-nt", &numThreads);
+ if(err==-1)
+ {
+   numThreads=1;
+ }
+ else
+ {
+   if(numThreads==0)
+   {
+     std::cerr<<"Error: number of threads must be greater than zero"<<std::endl;
+     return THOT_ERROR;
+   }
+ }
+
      /* Check verbosity option */
  err=readOption(argc,argv, "-v");
  if(err!=-1)
@@ -194,12 +210,14 @@ void printUsage(void)
 {
  printf("Usage: thot_ilm_perp -c <string> -lm <string> -n <int>\n");
  printf("                     {-jm | -cjm} \n");
- printf("                     [-v|-v1]\n");
+ printf("                     [-nt <int>] [-v|-v1]\n");
  printf("-c <string>          Corpus file to be processed.\n\n"); 
  printf("-lm <string>         Language model file name.\n\n");
  printf("-n <int>             Order of the n-grams.\n\n");
  printf("-jm                  Use Jelinek-Mercer n-gram models.\n\n");
  printf("-cjm                 Use cache-based Jelinek-Mercer n-grams models.\n\n");
+ printf("-nt <int>            Number of threads used to score the corpus (1 by\n");
+ printf("                     default). Verbose modes imply a single thread.\n\n");
  printf("-v|-v1               Verbose modes.\n\n");
 }
 
@@ -61,6 +61,7 @@ std::string lmFileName;
 std::string corpusFileName;
 int verbose=0;
 unsigned int order;
+unsigned int numThreads=1;
 SimpleDynClassLoader<BaseNgramLM<std::vector<WordIndex> > > baseNgramLMDynClassLoader;
 BaseNgramLM<std::vector<WordIndex> >* lm;
 
@@ -93,7 +94,7 @@ int main(int argc,char *argv[])
       lm->setNgramOrder(order);
       
       ctimer(&elapsed_ant,&ucpu,&scpu);
-      int ret=lm->perplexity(corpusFileName.c_str(),sentenceNo,numWords,total_logp,perp,verbose);
+      int ret=lm->perplexityMt(corpusFileName.c_str(),numThreads,sentenceNo,numWords,total_logp,perp,verbose);
       if(ret==THOT_ERROR)
       {
         release_lm(true);
@@ -199,6 +200,21 @@ int TakeParameters(int argc,char *argv[])
    return THOT_ERROR;
  }
 
+      /* Take number of threads */
+ err=readUnsignedInt(argc,argv, "-nt", &numThreads);
+ if(err==-1)
+ {
+   numThreads=1;
+ }
+ else
+ {
+   if(numThreads==0)
+   {
+     std::cerr<<"Error: number of threads must be greater than zero"<<std::endl;
+     return THOT_ERROR;
+   }
+ }
+
      /* Check verbosity option */
  err=readOption(argc,argv, "-v");
  if(err!=-1)
@@ -219,9 +235,11 @@ int TakeParameters(int argc,char *argv[])
 void printUsage(void)
 {
  printf("Usage: thot_lm_perp -c <string> -lm <string> -n <int>\n");
- printf("                     [-v|-v1]\n");
+ printf("                     [-nt <int>] [-v|-v1]\n");
  printf("-c <string>          Corpus file to be processed.\n\n"); 
  printf("-lm <string>         Language model file name.\n\n");
  printf("-n <int>             Order of the n-grams.\n\n");
+ printf("-nt <int>            Number of threads used to score the corpus (1 by\n");
+ printf("                     default). Verbose modes imply a single thread.\n\n");
  printf("-v|-v1               Verbose modes.\n\n");
 }
@@ -152,7 +152,8 @@ int process_ttable(void)
         vocab[EOS_STR] = S_END;
         vocab[SP_SYM1_LM_STR] = SP_SYM1_LM;
         
-        // Process translation table
+        // Process translation table, entries are written in batches
+        levelDbNt.beginUpdateBatch();
         for(unsigned int i = 1; awk.getln(); i++)
         {
             std::vector<WordIndex> src;
@@ -171,8 +172,15 @@ int process_ttable(void)
             }
 
             if (i % 5000 == 0)
+            {
+                if(levelDbNt.commitUpdateBatch() == THOT_ERROR)
+                    return THOT_ERROR;
+                levelDbNt.beginUpdateBatch();
                 std::cerr << "Processed " << i << " lines" << std::endl;
+            }
         }
+        if(levelDbNt.commitUpdateBatch() == THOT_ERROR)
+            return THOT_ERROR;
 
         std::cerr << "levelDB size: " << levelDbNt.size() << std::endl;
 
@@ -0,0 +1,177 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2017 Adam Harasimowicz
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+
+/**
+ * @file thot_upgrade_leveldb_ngram.cc
+ *
+ * @brief Converts a LevelDB n-gram table created with the legacy text
+ * encoding of counts into the binary encoding.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "LevelDbNgramTable.h"
+#include <iostream>
+#include <stdio.h>
+#include "options.h"
+
+//--------------- Function Declarations ------------------------------
+
+int TakeParameters(int argc, char *argv[]);
+void printUsage(void);
+int upgrade_table(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string inputFile;
+std::string outputFile;
+int verbose = 0;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc, char *argv[])
+{
+    if(TakeParameters(argc,argv) == THOT_OK)
+        return upgrade_table();
+    else
+        return THOT_ERROR;
+}
+
+//---------------
+int upgrade_table(void)
+{
+    bool inPlace = outputFile.empty();
+    std::string outputDbName = inPlace ? inputFile + ".upgrade_tmp" : outputFile;
+
+    {
+        LevelDbNgramTable inputNt;
+        if(inputNt.load(inputFile.c_str()) == THOT_ERROR)
+        {
+            std::cerr << "Cannot open database (LevelDB) " << inputFile << std::endl;
+            return THOT_ERROR;
+        }
+
+        if(inputNt.hasBinaryValues() && inPlace)
+        {
+            std::cerr << "Database " << inputFile << " already stores binary values" << std::endl;
+            return THOT_OK;
+        }
+
+        LevelDbNgramTable outputNt;
+        if(outputNt.init(outputDbName) == THOT_ERROR)
+        {
+            std::cerr << "Cannot create database (LevelDB) " << outputDbName << std::endl;
+            return THOT_ERROR;
+        }
+
+        if(inputNt.copyToBinaryTable(outputNt, verbose) == THOT_ERROR)
+        {
+            outputNt.drop();
+            return THOT_ERROR;
+        }
+    }
+
+    if(inPlace)
+    {
+        // Replace the input database by the upgraded one
+        std::string backupDbName = inputFile + ".upgrade_bak";
+        if(rename(inputFile.c_str(), backupDbName.c_str()) != 0)
+        {
+            std::cerr << "Cannot rename " << inputFile << ", upgraded database kept in " << outputDbName << std::endl;
+            return THOT_ERROR;
+        }
+        if(rename(outputDbName.c_str(), inputFile.c_str()) != 0)
+        {
+            std::cerr << "Cannot rename " << outputDbName << ", original database kept in " << backupDbName << std::endl;
+            return THOT_ERROR;
+        }
+
+        leveldb::Status status = leveldb::DestroyDB(backupDbName, leveldb::Options());
+        if(!status.ok())
+        {
+            std::cerr << "Warning: cannot remove " << backupDbName << ": " << status.ToString() << std::endl;
+        }
+    }
+
+    std::cerr << "Database upgraded (output: " << (inPlace ? inputFile : outputFile) << ")" << std::endl;
+
+    return THOT_OK;
+}
+
+//---------------
+int TakeParameters(int argc, char *argv[])
+{
+    int err;
+
+    // Verify --help option
+    err = readOption(argc, argv, "--help");
+
+    if (err != -1)
+    {
+        printUsage();
+
+        return THOT_ERROR;
+    }
+
+    // Takes the input database
+    err = readSTLstring(argc,argv, "-i", &inputFile);
+
+    if (err == -1)
+    {
+        printUsage();
+
+        return THOT_ERROR;
+    }
+
+    // Takes the output database
+    err = readSTLstring(argc,argv, "-o", &outputFile);
+
+    if (err == -1)
+    {
+        outputFile = "";
+    }
+
+    // Check verbosity option
+    err = readOption(argc, argv, "-v");
+
+    if (err != -1)
+    {
+        verbose = 1;
+    }
+
+    return THOT_OK;  
+}
+
+//---------------
+void printUsage(void)
+{
+    printf("Usage: thot_upgrade_leveldb_ngram -i <string> [-o <string>] [-v] [--help]\n\n");
+    printf("-i <string>                  Name of the LevelDB n-gram table to be upgraded.\n\n");
+    printf("-o <string>                  Name of the output table. If not given, the\n");
+    printf("                             input table is replaced.\n\n");
+    printf("-v                           Verbose mode.\n\n");
+    printf("--help                       Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -300,6 +300,9 @@ bool vecx_x_incr_enc<HX,X>::load(const char *prefixFileName)
           //cout<<s<< " ||| " <<t<<" ||| "<<inf<<std::endl;
       this->hx_to_x[hx]=x;
       this->x_to_hx[x]=hx;
+          // Keep x_object up to date so that new codes do not collide
+          // with the loaded ones
+      if(x_object<x) x_object=x;
     }
     return THOT_OK;
   }  
@@ -33,6 +33,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "LM_Defs.h"
 #include "AwkInputStream.h"
+#include "ctimer.h"
+#include <pthread.h>
 #include <string>
 #include <vector>
 #include <math.h>
@@ -118,6 +120,19 @@ class BaseNgramLM
                          LgProb& totalLogProb,
                          double& perp,
                          int verbose=0);
+  virtual int perplexityMt(const char *corpusFileName,
+                           unsigned int numThreads,
+                           unsigned int& numOfSentences,
+                           unsigned int& numWords,
+                           LgProb& totalLogProb,
+                           double& perp,
+                           int verbose=0);
+      // Multi-threaded version of perplexity(). The sentences of the
+      // corpus are partitioned into numThreads blocks that are scored
+      // concurrently. Sentence log-probabilities are accumulated in
+      // corpus order, so the results are identical to those of
+      // perplexity(). The throughput of each thread is reported on
+      // the standard error output
   
       // Functions to extend the model
   virtual int trainSentence(std::vector<std::string> strVec,
@@ -143,6 +158,22 @@ class BaseNgramLM
 
       // Destructor
   virtual ~BaseNgramLM(){};
+
+ protected:
+
+      // Data shared with each perplexity thread
+  struct PerpThreadData
+  {
+    BaseNgramLM<LM_STATE>* lmPtr;
+    const std::vector<std::vector<std::string> >* sentencesPtr;
+    std::vector<LgProb>* logProbsPtr;
+    unsigned int begin;
+    unsigned int end;
+    unsigned int numWords;
+    double elapsedTime;
+  };
+
+  static void* perplexityThread(void* arg);
 };
 
 //--------------- Template function definitions
@@ -299,6 +330,131 @@ int BaseNgramLM<LM_STATE>::perplexity(const char *corpusFileName,
   return THOT_OK;
 }
 
+//---------------
+template<class LM_STATE>
+int BaseNgramLM<LM_STATE>::perplexityMt(const char *corpusFileName,
+                                        unsigned int numThreads,
+                                        unsigned int& numOfSentences,
+                                        unsigned int& numWords,
+                                        LgProb& totalLogProb,
+                                        double& perp,
+                                        int verbose)
+{
+      // Verbose mode prints per n-gram information, which requires
+      // the sentences to be processed sequentially
+  if(numThreads<=1 || verbose>0)
+    return perplexity(corpusFileName,numOfSentences,numWords,totalLogProb,perp,verbose);
+  
+  AwkInputStream awk;
+  std::vector<std::vector<std::string> > sentences;
+  
+      // Open corpus file
+  if(awk.open(corpusFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }  
+
+      // Read corpus
+  while(awk.getln())
+  {
+    std::vector<std::string> v;
+    for(unsigned int i=1;i<=awk.NF;++i)
+    {
+      v.push_back(awk.dollar(i));
+    }
+    sentences.push_back(v);
+  }
+  awk.close();
+
+      // Partition the corpus into blocks of consecutive sentences
+  if(numThreads>sentences.size())
+    numThreads=sentences.size();
+  std::vector<LgProb> logProbs(sentences.size(),0);
+  std::vector<PerpThreadData> threadData(numThreads);
+  std::vector<pthread_t> threads(numThreads);
+  for(unsigned int i=0;i<numThreads;++i)
+  {
+    threadData[i].lmPtr=this;
+    threadData[i].sentencesPtr=&sentences;
+    threadData[i].logProbsPtr=&logProbs;
+    threadData[i].begin=(unsigned int)(((size_t)sentences.size()*i)/numThreads);
+    threadData[i].end=(unsigned int)(((size_t)sentences.size()*(i+1))/numThreads);
+    threadData[i].numWords=0;
+    threadData[i].elapsedTime=0;
+  }
+
+      // Score the blocks concurrently
+  unsigned int numLaunched=0;
+  for(unsigned int i=0;i<numThreads;++i)
+  {
+    if(pthread_create(&threads[i],NULL,perplexityThread,&threadData[i])!=0)
+    {
+      std::cerr<<"Error while creating perplexity thread "<<i<<std::endl;
+      break;
+    }
+    ++numLaunched;
+  }
+  for(unsigned int i=0;i<numLaunched;++i)
+    pthread_join(threads[i],NULL);
+  if(numLaunched<numThreads)
+    return THOT_ERROR;
+
+      // Report throughput
+  for(unsigned int i=0;i<numThreads;++i)
+  {
+    unsigned int numSents=threadData[i].end-threadData[i].begin;
+    std::cerr<<"Thread "<<i<<": "<<numSents<<" sentences, "<<threadData[i].numWords<<" words, "<<threadData[i].elapsedTime<<" secs";
+    if(threadData[i].elapsedTime>0)
+      std::cerr<<" ("<<threadData[i].numWords/threadData[i].elapsedTime<<" words/sec)";
+    std::cerr<<std::endl;
+  }
+  
+      // Accumulate results in corpus order, as perplexity() does (empty
+      // lines contribute the log-probability of the previous sentence)
+  LgProb logp=0;
+  totalLogProb=0;
+  numWords=0;
+  numOfSentences=0;
+  for(unsigned int i=0;i<sentences.size();++i)
+  {
+    if(!sentences[i].empty())
+    {
+      numWords+=sentences[i].size();
+      logp=logProbs[i];
+    }
+    totalLogProb+=logp;
+    ++numOfSentences;
+  }
+
+  perp=exp(-((double)totalLogProb/(numWords+numOfSentences))*M_LN10);
+
+  return THOT_OK;
+}
+
+//---------------
+template<class LM_STATE>
+void* BaseNgramLM<LM_STATE>::perplexityThread(void* arg)
+{
+  PerpThreadData* data=(PerpThreadData*) arg;
+  double prevElapsedTime,elapsedTime,ucpu,scpu;
+
+  ctimer(&prevElapsedTime,&ucpu,&scpu);
+  for(unsigned int i=data->begin;i<data->end;++i)
+  {
+    const std::vector<std::string>& v=(*data->sentencesPtr)[i];
+    if(!v.empty())
+    {
+      data->numWords+=v.size();
+      (*data->logProbsPtr)[i]=data->lmPtr->getSentenceLog10ProbStr(v,0);
+    }
+  }
+  ctimer(&elapsedTime,&ucpu,&scpu);
+  data->elapsedTime=elapsedTime-prevElapsedTime;
+
+  return NULL;
+}
+
 //---------------
 template<class LM_STATE>
 int BaseNgramLM<LM_STATE>::trainSentence(std::vector<std::string> /*strVec*/,
@@ -0,0 +1,96 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ExtSortUtils.cc
+ * 
+ * @brief Definitions file for ExtSortUtils.h
+ */
+
+#include "ExtSortUtils.h"
+#include <sstream>
+
+namespace ExtSortUtils
+{
+  //---------------
+  void writeVarInt(FILE* file,
+                   uint64_t x)
+  {
+    while(x>=128)
+    {
+      putc((x&127)|128,file);
+      x>>=7;
+    }
+    putc(x,file);
+  }
+
+  //---------------
+  bool readVarInt(FILE* file,
+                  uint64_t& x)
+  {
+    x=0;
+    unsigned int shift=0;
+    int c;
+    while((c=getc(file))!=EOF)
+    {
+      x|=((uint64_t)(c&127))<<shift;
+      if(!(c&128))
+        return true;
+      shift+=7;
+    }
+    return false;
+  }
+
+  //---------------
+  void writeCount(FILE* file,
+                  uint64_t count)
+  {
+    writeVarInt(file,count);
+  }
+
+  //---------------
+  bool readCount(FILE* file,
+                 uint64_t& count)
+  {
+    return readVarInt(file,count);
+  }
+
+  //---------------
+  void writeCount(FILE* file,
+                  float count)
+  {
+    fwrite(&count,sizeof(float),1,file);
+  }
+
+  //---------------
+  bool readCount(FILE* file,
+                 float& count)
+  {
+    return fread(&count,sizeof(float),1,file)==1;
+  }
+
+  //---------------
+  std::string newRunFileName(const std::string& tmpFilesPrefix,
+                             unsigned int& runCounter)
+  {
+    std::ostringstream oss;
+    oss<<tmpFilesPrefix<<".run"<<runCounter;
+    ++runCounter;
+    return oss.str();
+  }
+}
@@ -0,0 +1,305 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ExtSortUtils.h
+ * @brief Defines utilities for counting in external memory. Keys
+ * (sequences of word indices) are accumulated in memory, sorted and
+ * spilled to disk as runs where each key is front-coded with respect
+ * to the previous one using variable-length integers. The runs are
+ * then k-way merged adding up the counts of equal keys.
+ */
+
+#ifndef _ExtSortUtils_h
+#define _ExtSortUtils_h
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordIndex.h"
+#include "ErrorDefs.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#define EXT_SORT_MAX_FAN_IN 64
+
+namespace ExtSortUtils
+{
+  void writeVarInt(FILE* file,
+                   uint64_t x);
+  bool readVarInt(FILE* file,
+                  uint64_t& x);
+      // Write and read unsigned integers using 7 bits per byte
+
+  void writeCount(FILE* file,
+                  uint64_t count);
+  bool readCount(FILE* file,
+                 uint64_t& count);
+  void writeCount(FILE* file,
+                  float count);
+  bool readCount(FILE* file,
+                 float& count);
+      // Write and read the count of a run entry, integer counts are
+      // stored as variable-length integers
+
+  std::string newRunFileName(const std::string& tmpFilesPrefix,
+                             unsigned int& runCounter);
+      // Obtains the name of a new run file, runCounter is increased
+
+  template<class COUNT>
+  struct RunEntry
+  {
+    std::vector<WordIndex> key;
+    COUNT count;
+  };
+
+  template<class COUNT>
+  void writeRunEntry(FILE* file,
+                     const std::vector<WordIndex>& prevKey,
+                     const WordIndex* key,
+                     size_t keyLen,
+                     COUNT count);
+      // Writes an entry of a run, the key is front-coded with respect
+      // to prevKey
+  template<class COUNT>
+  bool readRunEntry(FILE* file,
+                    RunEntry<COUNT>& runEntry);
+      // Reads an entry of a run, runEntry.key is expected to contain
+      // the previous key of the run
+
+  template<class COUNT>
+  class RunMerger
+  {
+   public:
+    bool open(const std::vector<std::string>& runFileNames);
+        // Opens the given runs
+    bool next(std::vector<WordIndex>& key,
+              COUNT& count);
+        // Obtains the next key in lexicographic order together with
+        // the sum of its counts in the runs. Returns false when there
+        // are no more keys
+    void close(void);
+    ~RunMerger();
+
+   private:
+    typedef std::pair<std::vector<WordIndex>,unsigned int> QueueElem;
+
+    std::vector<FILE*> files;
+    std::vector<RunEntry<COUNT> > heads;
+    std::priority_queue<QueueElem,std::vector<QueueElem>,std::greater<QueueElem> > prQueue;
+  };
+
+  template<class COUNT>
+  bool mergeRuns(const std::vector<std::string>& inputRuns,
+                 FILE* outRunFile);
+      // Merges the given runs into outRunFile
+  template<class COUNT>
+  bool reduceNumRuns(std::vector<std::string>& runFileNames,
+                     const std::string& tmpFilesPrefix,
+                     unsigned int& runCounter,
+                     int verbose=0);
+      // Merges groups of runs until there are no more than
+      // EXT_SORT_MAX_FAN_IN of them, so as to keep the number of open
+      // files bounded. The merged runs are removed
+}
+
+//--------------- Template function definitions
+
+namespace ExtSortUtils
+{
+  //---------------
+  template<class COUNT>
+  void writeRunEntry(FILE* file,
+                     const std::vector<WordIndex>& prevKey,
+                     const WordIndex* key,
+                     size_t keyLen,
+                     COUNT count)
+  {
+    size_t shared=0;
+    while(shared<prevKey.size() && shared<keyLen && prevKey[shared]==key[shared])
+      ++shared;
+
+    writeVarInt(file,shared);
+    writeVarInt(file,keyLen-shared);
+    for(size_t i=shared;i<keyLen;++i)
+      writeVarInt(file,key[i]);
+    writeCount(file,count);
+  }
+
+  //---------------
+  template<class COUNT>
+  bool readRunEntry(FILE* file,
+                    RunEntry<COUNT>& runEntry)
+  {
+    uint64_t shared;
+    uint64_t rest;
+    if(!readVarInt(file,shared) || !readVarInt(file,rest))
+      return false;
+
+    runEntry.key.resize(shared);
+    for(uint64_t i=0;i<rest;++i)
+    {
+      uint64_t w;
+      if(!readVarInt(file,w))
+        return false;
+      runEntry.key.push_back(w);
+    }
+    return readCount(file,runEntry.count);
+  }
+
+  //---------------
+  template<class COUNT>
+  bool RunMerger<COUNT>::open(const std::vector<std::string>& runFileNames)
+  {
+    close();
+    heads.resize(runFileNames.size());
+    for(unsigned int i=0;i<runFileNames.size();++i)
+    {
+      FILE* file=fopen(runFileNames[i].c_str(),"rb");
+      if(file==NULL)
+      {
+        std::cerr<<"Error while reading temporary file "<<runFileNames[i]<<std::endl;
+        close();
+        return THOT_ERROR;
+      }
+      files.push_back(file);
+      if(readRunEntry(file,heads[i]))
+        prQueue.push(std::make_pair(heads[i].key,i));
+    }
+    return THOT_OK;
+  }
+
+  //---------------
+  template<class COUNT>
+  bool RunMerger<COUNT>::next(std::vector<WordIndex>& key,
+                              COUNT& count)
+  {
+    if(prQueue.empty())
+      return false;
+
+    key=prQueue.top().first;
+    count=0;
+    while(!prQueue.empty() && prQueue.top().first==key)
+    {
+      unsigned int idx=prQueue.top().second;
+      prQueue.pop();
+      count+=heads[idx].count;
+      if(readRunEntry(files[idx],heads[idx]))
+        prQueue.push(std::make_pair(heads[idx].key,idx));
+    }
+    return true;
+  }
+
+  //---------------
+  template<class COUNT>
+  void RunMerger<COUNT>::close(void)
+  {
+    for(unsigned int i=0;i<files.size();++i)
+      fclose(files[i]);
+    files.clear();
+    heads.clear();
+    while(!prQueue.empty())
+      prQueue.pop();
+  }
+
+  //---------------
+  template<class COUNT>
+  RunMerger<COUNT>::~RunMerger()
+  {
+    close();
+  }
+
+  //---------------
+  template<class COUNT>
+  bool mergeRuns(const std::vector<std::string>& inputRuns,
+                 FILE* outRunFile)
+  {
+    RunMerger<COUNT> runMerger;
+    if(runMerger.open(inputRuns)==THOT_ERROR)
+      return THOT_ERROR;
+
+    std::vector<WordIndex> prevKey;
+    std::vector<WordIndex> key;
+    COUNT count;
+    while(runMerger.next(key,count))
+    {
+      writeRunEntry(outRunFile,prevKey,key.data(),key.size(),count);
+      prevKey.swap(key);
+    }
+    runMerger.close();
+
+    if(ferror(outRunFile))
+    {
+      std::cerr<<"Error while writing merged run"<<std::endl;
+      return THOT_ERROR;
+    }
+    return THOT_OK;
+  }
+
+  //---------------
+  template<class COUNT>
+  bool reduceNumRuns(std::vector<std::string>& runFileNames,
+                     const std::string& tmpFilesPrefix,
+                     unsigned int& runCounter,
+                     int verbose/*=0*/)
+  {
+    while(runFileNames.size()>EXT_SORT_MAX_FAN_IN)
+    {
+      std::vector<std::string> newRunFileNames;
+      for(unsigned int i=0;i<runFileNames.size();i+=EXT_SORT_MAX_FAN_IN)
+      {
+        unsigned int end=std::min(i+EXT_SORT_MAX_FAN_IN,(unsigned int)runFileNames.size());
+        std::vector<std::string> inputRuns(runFileNames.begin()+i,runFileNames.begin()+end);
+        std::string outRunFileName=newRunFileName(tmpFilesPrefix,runCounter);
+        FILE* outRunFile=fopen(outRunFileName.c_str(),"wb");
+        if(outRunFile==NULL)
+        {
+          std::cerr<<"Error while creating temporary file "<<outRunFileName<<std::endl;
+          runFileNames.erase(runFileNames.begin(),runFileNames.begin()+i);
+          runFileNames.insert(runFileNames.end(),newRunFileNames.begin(),newRunFileNames.end());
+          return THOT_ERROR;
+        }
+        bool ret=mergeRuns<COUNT>(inputRuns,outRunFile);
+        if(fclose(outRunFile)!=0)
+          ret=THOT_ERROR;
+        for(unsigned int j=0;j<inputRuns.size();++j)
+          remove(inputRuns[j].c_str());
+        newRunFileNames.push_back(outRunFileName);
+        if(ret==THOT_ERROR)
+        {
+          runFileNames.erase(runFileNames.begin(),runFileNames.begin()+end);
+          runFileNames.insert(runFileNames.end(),newRunFileNames.begin(),newRunFileNames.end());
+          return THOT_ERROR;
+        }
+      }
+      runFileNames.swap(newRunFileNames);
+      if(verbose)
+        std::cerr<<"Number of runs reduced to "<<runFileNames.size()<<std::endl;
+    }
+    return THOT_OK;
+  }
+}
+
+#endif
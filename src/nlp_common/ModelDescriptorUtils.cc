@@ -23,6 +23,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  */
 
 #include "ModelDescriptorUtils.h"
+#include <sys/stat.h>
 
 //---------------
 bool soFileIsExternal(std::string absoluteSoFileName)
@@ -278,3 +279,18 @@ bool printModelDescriptor(const std::vector<ModelDescriptorEntry>& modelDescEntr
     return THOT_OK;
   }
 }
+
+//---------------
+bool binFileIsUpToDate(std::string binFileName,
+                       std::string textFileName)
+{
+  struct stat binStat;
+  if(stat(binFileName.c_str(),&binStat)!=0)
+    return false;
+
+  struct stat textStat;
+  if(stat(textFileName.c_str(),&textStat)!=0)
+    return true;
+
+  return binStat.st_mtime>=textStat.st_mtime;
+}
@@ -62,4 +62,8 @@ bool extractModelEntryInfo(std::string fileName,
                            std::vector<ModelDescriptorEntry>& modelDescEntryVec);
 bool printModelDescriptor(const std::vector<ModelDescriptorEntry>& modelDescEntryVec,
                           std::string fileName);
+bool binFileIsUpToDate(std::string binFileName,
+                       std::string textFileName);
+    // Returns true if binFileName exists and it is not older than
+    // textFileName (or textFileName does not exist)
 #endif
@@ -65,6 +65,9 @@ class OrderedVector
      operator=(const OrderedVector<KEY,DATA,KEY_ORDER_REL>& ov);
 	DATA* push(const KEY& k,const DATA &d);
     DATA* insert(const KEY& k,const DATA &d);
+    void assignSorted(const KEY* keys,const DATA* data,size_t n);
+     // Replaces the content of the vector by n pairs whose keys are
+     // given in increasing order
 	void pop(void);
     const std::pair<KEY,DATA>& top(void);
     DATA* findPtr(const KEY& k);
@@ -280,6 +283,24 @@ DATA* OrderedVector<KEY,DATA,KEY_ORDER_REL>::insert(const KEY& k,
 {
   return push(k,d);
 }
+//-------------------------
+template<class KEY,class DATA,class KEY_ORDER_REL>
+void OrderedVector<KEY,DATA,KEY_ORDER_REL>::assignSorted(const KEY* keys,
+                                                         const DATA* data,
+                                                         size_t n)
+{
+  alloc(0);
+  if(n>0)
+  {
+    alloc(n);
+    for(size_t i=0;i<n;++i)
+    {
+      vec[i].first=keys[i];
+      vec[i].second=data[i];
+    }
+  }
+}
+
 //-------------------------
 template<class KEY,class DATA,class KEY_ORDER_REL>
 void OrderedVector<KEY,DATA,KEY_ORDER_REL>::pop(void)
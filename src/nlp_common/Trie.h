@@ -62,6 +62,11 @@ class Trie
   bool erase(const std::vector<KEY>& keySeq);
   DATA_TYPE* find(const std::vector<KEY>& keySeq);
   Trie<KEY,DATA_TYPE>* getState(const std::vector<KEY>& keySeq);
+  void getStatePath(const std::vector<KEY>& keySeq,
+                    std::vector<Trie<KEY,DATA_TYPE>*>& statePath);
+      // Obtains the states visited when searching keySeq, statePath[i]
+      // is the state for the subsequence keySeq[0]...keySeq[i]. The
+      // search stops at the first key that is not found.
   std::vector<DATA_TYPE*> findV(const std::vector<KEY>& keySeq);
   DATA_TYPE&  operator[](const std::vector<KEY>& keySeq);
   const DATA_TYPE&  operator[](const std::vector<KEY>& keySeq) const;
@@ -386,6 +391,37 @@ Trie<KEY,DATA_TYPE>* Trie<KEY,DATA_TYPE>::getState(const std::vector<KEY>& keySe
   }
   return t;  
 }
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void Trie<KEY,DATA_TYPE>::getStatePath(const std::vector<KEY>& keySeq,
+                                       std::vector<Trie<KEY,DATA_TYPE>*>& statePath)
+{
+  unsigned int i;
+  Trie<KEY,DATA_TYPE> *t;
+  KEY k;
+
+  statePath.clear();
+  t=this;
+  for(i=0;i<keySeq.size();++i) // for each position of the sequence...
+  { 
+    k=keySeq[i];
+    while(t->next!=NULL && t->key!=k) // search the key 'k'
+    {
+      t=t->next; 
+    }
+    if(t!=t->children && t->key==k) // key 'k' was found?
+    {
+      statePath.push_back(t);
+      if(i<keySeq.size()-1) // end of seq. not reached?
+      {
+        if(t->children!=NULL) t=t->children; // node t has children
+        else return; // node t has not any children
+      }
+    }
+    else return; // 'k' was not found
+  }
+}
 //---------------
 template<class KEY,class DATA_TYPE>
 std::vector<DATA_TYPE*> Trie<KEY,DATA_TYPE>::findV(const std::vector<KEY>& keySeq)
@@ -0,0 +1,40 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+
+#ifndef _WordIndexVecHashF_h
+#define _WordIndexVecHashF_h
+
+//--------------- WordIndexVecHashF class: Hash function for vectors of
+//                                         word indices
+
+#include "WordIndex.h"
+#include <vector>
+
+class WordIndexVecHashF
+{
+ public:
+  size_t operator() (const std::vector<WordIndex>& vec)const
+    {
+      size_t h=vec.size();
+      for(unsigned int i=0;i<vec.size();++i)
+        h=(h*1000003)^vec[i];
+      return h;
+    }
+};
+#endif
@@ -35,6 +35,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "PhrasePairInfo.h"
 #include "NbestTableNode.h"
 #include "PhraseTransTableNodeData.h"
+#include <algorithm>
 
 //--------------- Constants ------------------------------------------
 
@@ -56,12 +57,21 @@ class BasePhraseTable
 
     typedef std::map<std::vector<WordIndex>,PhrasePairInfo> SrcTableNode;
     typedef std::map<std::vector<WordIndex>,PhrasePairInfo> TrgTableNode;
+    typedef std::pair<std::pair<std::vector<WordIndex>,std::vector<WordIndex> >,PhrasePairInfo> TableEntry;
 
         // Abstract function definitions
     virtual void addTableEntry(const std::vector<WordIndex>& s,
                                const std::vector<WordIndex>& t,
                                PhrasePairInfo inf)=0;
         // Adds an entry to the probability table
+    virtual void addTableEntries(const std::vector<TableEntry>& entries)
+      {
+        for(size_t i=0;i<entries.size();++i)
+          addTableEntry(entries[i].first.first,entries[i].first.second,entries[i].second);
+      }
+        // Adds a set of entries to the probability table (bulk
+        // loading), the result is the same as adding them one by one
+        // with addTableEntry()
     virtual void addSrcInfo(const std::vector<WordIndex>& s,Count s_inf)=0;
     virtual void addSrcTrgInfo(const std::vector<WordIndex>& s,
                                const std::vector<WordIndex>& t,
@@ -137,6 +147,35 @@ class BasePhraseTable
     virtual ~BasePhraseTable(){};
 
  protected:
+
+        // Auxiliary functions for bulk loading
+    struct EntryPhraseOrder
+    {
+      const std::vector<TableEntry>* entriesPtr;
+      bool bySrc;
+      bool operator()(size_t i,size_t j)const
+        {
+          if(bySrc)
+            return (*entriesPtr)[i].first.first<(*entriesPtr)[j].first.first;
+          else
+            return (*entriesPtr)[i].first.second<(*entriesPtr)[j].first.second;
+        }
+    };
+    static void obtainEntryOrder(const std::vector<TableEntry>& entries,
+                                 bool bySrc,
+                                 std::vector<size_t>& order)
+      {
+        order.resize(entries.size());
+        for(size_t i=0;i<order.size();++i)
+          order[i]=i;
+        EntryPhraseOrder entryPhraseOrder;
+        entryPhraseOrder.entriesPtr=&entries;
+        entryPhraseOrder.bySrc=bySrc;
+        std::stable_sort(order.begin(),order.end(),entryPhraseOrder);
+      }
+        // Obtains the indices of the entries sorted by source (or
+        // target) phrase, entries with equal phrases keep their
+        // relative order
 };
 
 #endif
@@ -0,0 +1,268 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ExtPhrasePairCounter.cc
+ *
+ * @brief Definitions file for ExtPhrasePairCounter.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "ExtPhrasePairCounter.h"
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+//--------------- ExtPhrasePairCounter class method definitions
+
+//-------------------------
+ExtPhrasePairCounter::ExtPhrasePairCounter(void)
+{
+  memBudget=0;
+  runCounter=0;
+}
+
+//-------------------------
+bool ExtPhrasePairCounter::init(size_t _memBudget,
+                                std::string _tmpFilesPrefix)
+{
+  clear();
+
+  memBudget=_memBudget;
+  tmpFilesPrefix=_tmpFilesPrefix;
+  if(memBudget<3*sizeof(KeyRecord))
+  {
+    std::cerr<<"Error: memory budget of external phrase pair counter is too small"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Check that temporary files can be created
+  std::string probeFileName=tmpFilesPrefix+".probe";
+  FILE* probeFile=fopen(probeFileName.c_str(),"wb");
+  if(probeFile==NULL)
+  {
+    std::cerr<<"Error: temporary file "<<probeFileName<<" could not be created"<<std::endl;
+    return THOT_ERROR;
+  }
+  fclose(probeFile);
+  remove(probeFileName.c_str());
+
+      // Two thirds of the budget are devoted to the arena storing the
+      // keys, the rest is devoted to the key records
+  try
+  {
+    keyArena.reserve((2*memBudget/3)/sizeof(WordIndex));
+    keyRecords.reserve((memBudget/3)/sizeof(KeyRecord));
+  }
+  catch(const std::bad_alloc&)
+  {
+    std::cerr<<"Error: memory budget of external phrase pair counter could not be allocated"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExtPhrasePairCounter::addPair(const std::vector<WordIndex>& s,
+                                   const std::vector<WordIndex>& t,
+                                   float count)
+{
+  size_t keyLen=s.size()+t.size()+2;
+
+      // Spill buffer if the budget has been exhausted
+  if(!keyRecords.empty())
+  {
+    if(keyArena.size()+keyLen>keyArena.capacity() || keyRecords.size()==keyRecords.capacity())
+    {
+      if(spillBuffer()==THOT_ERROR)
+        return THOT_ERROR;
+    }
+  }
+
+      // Store key in arena
+  KeyRecord keyRecord;
+  keyRecord.offset=keyArena.size();
+  keyRecord.len=keyLen;
+  keyRecord.count=count;
+  keyArena.push_back(s.size());
+  keyArena.insert(keyArena.end(),s.begin(),s.end());
+  keyArena.push_back(t.size());
+  keyArena.insert(keyArena.end(),t.begin(),t.end());
+  keyRecords.push_back(keyRecord);
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExtPhrasePairCounter::KeyRecordSortCriterion::operator()(const KeyRecord& a,
+                                                              const KeyRecord& b)const
+{
+  return std::lexicographical_compare(arenaRef.begin()+a.offset,arenaRef.begin()+a.offset+a.len,
+                                      arenaRef.begin()+b.offset,arenaRef.begin()+b.offset+b.len);
+}
+
+//-------------------------
+bool ExtPhrasePairCounter::spillBuffer(void)
+{
+  if(keyRecords.empty())
+    return THOT_OK;
+
+      // Sort key records
+  std::sort(keyRecords.begin(),keyRecords.end(),KeyRecordSortCriterion(keyArena));
+
+      // Open run file
+  std::string runFileName=ExtSortUtils::newRunFileName(tmpFilesPrefix,runCounter);
+  FILE* runFile=fopen(runFileName.c_str(),"wb");
+  if(runFile==NULL)
+  {
+    std::cerr<<"Error while creating temporary file "<<runFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Write aggregated entries
+  std::vector<WordIndex> prevKey;
+  unsigned int i=0;
+  while(i<keyRecords.size())
+  {
+    const WordIndex* key=&keyArena[keyRecords[i].offset];
+    unsigned int keyLen=keyRecords[i].len;
+    float count=keyRecords[i].count;
+    unsigned int j=i+1;
+    while(j<keyRecords.size() && keyRecords[j].len==keyLen &&
+          std::equal(key,key+keyLen,keyArena.begin()+keyRecords[j].offset))
+    {
+      count+=keyRecords[j].count;
+      ++j;
+    }
+    ExtSortUtils::writeRunEntry(runFile,prevKey,key,keyLen,count);
+    prevKey.assign(key,key+keyLen);
+    i=j;
+  }
+
+  if(fclose(runFile)!=0)
+  {
+    std::cerr<<"Error while writing temporary file "<<runFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  runFileNames.push_back(runFileName);
+
+      // Clear buffer (the reserved memory is kept)
+  keyArena.clear();
+  keyRecords.clear();
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExtPhrasePairCounter::printTTable(FILE* file,
+                                       const BasePhraseModel& vocabModel,
+                                       int verbose/*=0*/)
+{
+  if(spillBuffer()==THOT_ERROR)
+    return THOT_ERROR;
+
+  if(verbose)
+    std::cerr<<"Merging "<<runFileNames.size()<<" runs of phrase pair counts..."<<std::endl;
+
+      // Reduce the number of runs so as to keep the number of open
+      // files bounded
+  if(ExtSortUtils::reduceNumRuns<float>(runFileNames,tmpFilesPrefix,runCounter,verbose)==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Print phrase table while merging the runs. Entries sharing the
+      // same source phrase are contiguous, so c(s) can be computed for
+      // each group
+  ExtSortUtils::RunMerger<float> runMerger;
+  if(runMerger.open(runFileNames)==THOT_ERROR)
+    return THOT_ERROR;
+  std::vector<RunEntry> srcGroup;
+  RunEntry runEntry;
+  while(runMerger.next(runEntry.key,runEntry.count))
+  {
+    if(!srcGroup.empty() && !sameSrcPhrase(srcGroup.back().key,runEntry.key))
+    {
+      printSrcGroup(file,vocabModel,srcGroup);
+      srcGroup.clear();
+    }
+    srcGroup.push_back(runEntry);
+  }
+  if(!srcGroup.empty())
+    printSrcGroup(file,vocabModel,srcGroup);
+
+  return THOT_OK;
+}
+
+//-------------------------
+void ExtPhrasePairCounter::printSrcGroup(FILE* file,
+                                         const BasePhraseModel& vocabModel,
+                                         const std::vector<RunEntry>& srcGroup)
+{
+      // Obtain c(s)
+  float srcCount=0;
+  for(unsigned int i=0;i<srcGroup.size();++i)
+    srcCount+=srcGroup[i].count;
+
+      // Print entries
+  for(unsigned int i=0;i<srcGroup.size();++i)
+  {
+    const std::vector<WordIndex>& key=srcGroup[i].key;
+    unsigned int srcLen=key[0];
+    for(unsigned int j=1;j<=srcLen;++j)
+      fprintf(file,"%s ",vocabModel.wordIndexToSrcString(key[j]).c_str());
+    fprintf(file,"|||");
+    for(unsigned int j=srcLen+2;j<key.size();++j)
+      fprintf(file," %s",vocabModel.wordIndexToTrgString(key[j]).c_str());
+    fprintf(file," ||| %.8f %.8f\n",srcCount,srcGroup[i].count);
+  }
+}
+
+//-------------------------
+bool ExtPhrasePairCounter::sameSrcPhrase(const std::vector<WordIndex>& key1,
+                                         const std::vector<WordIndex>& key2)
+{
+  if(key1[0]!=key2[0])
+    return false;
+  else
+    return std::equal(key1.begin(),key1.begin()+key1[0]+1,key2.begin());
+}
+
+//-------------------------
+size_t ExtPhrasePairCounter::getNumRuns(void)const
+{
+  return runFileNames.size();
+}
+
+//-------------------------
+void ExtPhrasePairCounter::clear(void)
+{
+  keyArena.clear();
+  keyRecords.clear();
+  for(unsigned int i=0;i<runFileNames.size();++i)
+    remove(runFileNames[i].c_str());
+  runFileNames.clear();
+  runCounter=0;
+}
+
+//-------------------------
+ExtPhrasePairCounter::~ExtPhrasePairCounter()
+{
+  clear();
+}
@@ -0,0 +1,124 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ExtPhrasePairCounter.h
+ *
+ * @brief Defines the ExtPhrasePairCounter class.
+ * ExtPhrasePairCounter aggregates phrase pair counts using a bounded
+ * amount of memory. Phrase pairs are stored in an arena buffer which
+ * is sorted and spilled to disk as a compressed binary run each time
+ * the memory budget is exhausted. The runs are finally k-way merged
+ * to obtain the phrase table.
+ */
+
+#ifndef _ExtPhrasePairCounter_h
+#define _ExtPhrasePairCounter_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BasePhraseModel.h"
+#include "WordIndex.h"
+#include "ExtSortUtils.h"
+#include "ErrorDefs.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ExtPhrasePairCounter class
+
+class ExtPhrasePairCounter
+{
+ public:
+
+        // Constructor
+    ExtPhrasePairCounter(void);
+
+    bool init(size_t memBudget,
+              std::string tmpFilesPrefix);
+        // Initializes the counter. memBudget is given in bytes,
+        // tmpFilesPrefix is used to name the temporary run files
+
+    bool addPair(const std::vector<WordIndex>& s,
+                 const std::vector<WordIndex>& t,
+                 float count);
+        // Adds a phrase pair count, spilling the buffer to disk if
+        // the memory budget is exceeded
+
+    bool printTTable(FILE* file,
+                     const BasePhraseModel& vocabModel,
+                     int verbose=0);
+        // Merges the runs and prints the resulting phrase table in
+        // thot format (entries are grouped by source phrase). The
+        // vocabulary of vocabModel is used to obtain the strings
+
+    size_t getNumRuns(void)const;
+
+    void clear(void);
+        // Clears the buffer and removes the temporary files
+
+        // Destructor
+    ~ExtPhrasePairCounter();
+
+ protected:
+
+        // Each key is stored in the arena as the sequence
+        // [|s|,s_1,...,s_|s|,|t|,t_1,...,t_|t|]
+    struct KeyRecord
+    {
+      size_t offset;
+      unsigned int len;
+      float count;
+    };
+
+    typedef ExtSortUtils::RunEntry<float> RunEntry;
+
+    class KeyRecordSortCriterion
+    {
+     public:
+      KeyRecordSortCriterion(const std::vector<WordIndex>& arena):arenaRef(arena){}
+      bool operator()(const KeyRecord& a,
+                      const KeyRecord& b)const;
+     private:
+      const std::vector<WordIndex>& arenaRef;
+    };
+
+    size_t memBudget;
+    std::string tmpFilesPrefix;
+    std::vector<WordIndex> keyArena;
+    std::vector<KeyRecord> keyRecords;
+    std::vector<std::string> runFileNames;
+    unsigned int runCounter;
+
+    bool spillBuffer(void);
+
+        // Phrase table printing functions
+    void printSrcGroup(FILE* file,
+                       const BasePhraseModel& vocabModel,
+                       const std::vector<RunEntry>& srcGroup);
+    bool sameSrcPhrase(const std::vector<WordIndex>& key1,
+                       const std::vector<WordIndex>& key2);
+};
+
+#endif
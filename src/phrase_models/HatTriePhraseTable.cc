@@ -222,6 +222,44 @@ void HatTriePhraseTable::addTableEntry(const std::vector<WordIndex>& s,
     addSrcTrgInfo(s, t, inf.second.get_c_st());  // (src, trg)
 }
 
+//-------------------------
+void HatTriePhraseTable::addTableEntries(const std::vector<TableEntry>& entries)
+{
+    std::vector<size_t> order;
+
+    // Add source phrases, each one is stored only once with the last
+    // count given for it
+    obtainEntryOrder(entries, true, order);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const TableEntry& entry = entries[order[i]];
+        if (i + 1 == order.size() || entries[order[i + 1]].first.first != entry.first.first)
+            addSrcInfo(entry.first.first, entry.second.first.get_c_s());
+    }
+
+    // Add target phrases, their counts are aggregated so that each
+    // one is looked up and stored only once
+    obtainEntryOrder(entries, false, order);
+    Count t_count = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const TableEntry& entry = entries[order[i]];
+        t_count = t_count + entry.second.second;
+        if (i + 1 == order.size() || entries[order[i + 1]].first.second != entry.first.second)
+        {
+            addTrgInfo(entry.first.second, (cTrg(entry.first.second) + t_count).get_c_s());
+            t_count = 0;
+        }
+    }
+
+    // Add (s, t) entries, grouped by target phrase as their keys
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const TableEntry& entry = entries[order[i]];
+        addSrcTrgInfo(entry.first.first, entry.first.second, entry.second.second.get_c_st());
+    }
+}
+
 //-------------------------
 void HatTriePhraseTable::addSrcInfo(const std::vector<WordIndex>& s,
                                     Count s_inf)
@@ -78,6 +78,9 @@ class HatTriePhraseTable: public BasePhraseTable
                                    const std::vector<WordIndex>& t,
                                    PhrasePairInfo inf);
             // Adds an entry to the probability table
+        virtual void addTableEntries(const std::vector<TableEntry>& entries);
+            // Adds a set of entries to the probability table (bulk
+            // loading)
         virtual void addSrcInfo(const std::vector<WordIndex>& s, Count s_inf);
         virtual void addSrcTrgInfo(const std::vector<WordIndex>& s,
                                    const std::vector<WordIndex>& t,
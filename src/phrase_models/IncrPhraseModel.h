@@ -77,6 +77,7 @@ class IncrPhraseModel: public _incrPhraseModel
 
         // Functions to print models using standard C library
     void printTTable(FILE* file);
+    void printBinTTable(FILE* file);
 };
 
 #endif
@@ -155,3 +155,66 @@ void SegLenTable::printSegmLengthTable(std::ostream &outS)
      }
    }
 }
+
+//-------------------------
+bool SegLenTable::loadBin(const char *segmLengthTableFileName)
+{
+  std::cerr<<"Loading segmentation length table in binary format from file "<<segmLengthTableFileName<<std::endl;
+
+  std::ifstream inF(segmLengthTableFileName,std::ios::in | std::ios::binary);
+  if(!inF)
+  {
+    std::cerr<<"Error in segmentation length table file, file "<<segmLengthTableFileName<<" does not exist.\n";
+    return THOT_ERROR;
+  }
+
+      // Verify header
+  char magic[sizeof(SEGLENTABLE_BIN_MAGIC)];
+  unsigned int version;
+  unsigned int maxLen;
+  inF.read(magic,sizeof(magic));
+  inF.read((char*)&version,sizeof(unsigned int));
+  inF.read((char*)&maxLen,sizeof(unsigned int));
+  if(!inF || strncmp(magic,SEGLENTABLE_BIN_MAGIC,sizeof(magic))!=0 ||
+     version!=SEGLENTABLE_BIN_VERSION || maxLen!=MAX_SENTENCE_LENGTH)
+  {
+    std::cerr<<"Error: incompatible segmentation length table file "<<segmLengthTableFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Read tables
+  inF.read((char*)segmLengthCount,sizeof(segmLengthCount));
+  inF.read((char*)ksegmLengthCountMargin,sizeof(ksegmLengthCountMargin));
+  if(!inF)
+  {
+    std::cerr<<"Error: truncated segmentation length table file "<<segmLengthTableFileName<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool SegLenTable::printBin(const char *segmLengthTableFileName)
+{
+  std::ofstream outF(segmLengthTableFileName,std::ios::out | std::ios::binary);
+  if(!outF)
+  {
+    std::cerr<<"Error while printing segmentation length table."<<std::endl;
+    return THOT_ERROR;
+  }
+
+  unsigned int version=SEGLENTABLE_BIN_VERSION;
+  unsigned int maxLen=MAX_SENTENCE_LENGTH;
+  outF.write(SEGLENTABLE_BIN_MAGIC,sizeof(SEGLENTABLE_BIN_MAGIC));
+  outF.write((char*)&version,sizeof(unsigned int));
+  outF.write((char*)&maxLen,sizeof(unsigned int));
+  outF.write((char*)segmLengthCount,sizeof(segmLengthCount));
+  outF.write((char*)ksegmLengthCountMargin,sizeof(ksegmLengthCountMargin));
+
+  if(!outF)
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
@@ -36,11 +36,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <string.h>
 #include "AwkInputStream.h"
 #include "Prob.h"
 
 //--------------- Constants ------------------------------------------
 
+#define SEGLENTABLE_BIN_MAGIC   "thot_seglen_bin"
+#define SEGLENTABLE_BIN_VERSION 1
 
 //--------------- typedefs -------------------------------------------
 
@@ -69,6 +72,10 @@ class SegLenTable
     bool printSegmLengthTable(char *outputFileName);
     bool load_seglentable(const char *segmLengthTableFileName);
 	void printSegmLengthTable(std::ostream &outS);
+
+        // Binary snapshot functions
+    bool loadBin(const char *segmLengthTableFileName);
+    bool printBin(const char *segmLengthTableFileName);
   
   private:
     
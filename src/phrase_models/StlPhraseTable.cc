@@ -163,6 +163,69 @@ void StlPhraseTable::addTableEntry(const std::vector<WordIndex>& s,
     addSrcTrgInfo(s, t, inf.second.get_c_st());  // (src, trg)
 }
 
+//-------------------------
+void StlPhraseTable::addTableEntries(const std::vector<TableEntry>& entries)
+{
+    std::vector<size_t> order;
+    std::vector<SrcPhraseInfo::iterator> srcIters(entries.size());
+    std::vector<TrgPhraseInfo::iterator> trgIters(entries.size());
+
+    // Add source phrases in ascending order, so insertions take
+    // amortized constant time. Only the last count given for each
+    // source phrase is kept
+    obtainEntryOrder(entries, true, order);
+    for (size_t i = 0; i < order.size(); )
+    {
+        const std::vector<WordIndex>& s = entries[order[i]].first.first;
+        size_t j = i;
+        while (j + 1 < order.size() && entries[order[j + 1]].first.first == s)
+            ++j;
+
+        SrcPhraseInfo::iterator iter = srcPhraseInfo.insert(srcPhraseInfo.end(), std::make_pair(s, Count(0)));
+        iter->second = entries[order[j]].second.first.get_c_s();
+        for (size_t k = i; k <= j; ++k)
+            srcIters[order[k]] = iter;
+        i = j + 1;
+    }
+
+    // Add target phrases in ascending order, their counts are
+    // aggregated before being stored
+    obtainEntryOrder(entries, false, order);
+    for (size_t i = 0; i < order.size(); )
+    {
+        const std::vector<WordIndex>& t = entries[order[i]].first.second;
+        size_t j = i;
+        while (j + 1 < order.size() && entries[order[j + 1]].first.second == t)
+            ++j;
+
+        size_t prevSize = trgPhraseInfo.size();
+        TrgPhraseInfo::iterator iter = trgPhraseInfo.insert(trgPhraseInfo.end(), std::make_pair(t, Count(0)));
+        Count t_count = (trgPhraseInfo.size() == prevSize) ? iter->second : Count(0);
+        for (size_t k = i; k <= j; ++k)
+        {
+            t_count = t_count + entries[order[k]].second.second;
+            trgIters[order[k]] = iter;
+        }
+        iter->second = t_count.get_c_s();
+        i = j + 1;
+    }
+
+    // Add (s, t) entries following the order of their keys
+    std::vector<SrcTrgKey> keys(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        keys[i] = SrcTrgKey(srcIters[i], trgIters[i]);
+    SrcTrgKeyIndexOrder keyIndexOrder;
+    keyIndexOrder.keysPtr = &keys;
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), keyIndexOrder);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        SrcTrgPhraseInfo::iterator iter = srcTrgPhraseInfo.insert(srcTrgPhraseInfo.end(), std::make_pair(keys[order[i]], Count(0)));
+        iter->second = entries[order[i]].second.second.get_c_st();
+    }
+}
+
 //-------------------------
 void StlPhraseTable::addSrcInfo(const std::vector<WordIndex>& s,
                                 Count s_inf)
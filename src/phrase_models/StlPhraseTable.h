@@ -94,6 +94,19 @@ class StlPhraseTable: public BasePhraseTable
 
         typedef std::map<SrcTrgKey, Count, SrcTrgKeyComparator> SrcTrgPhraseInfo;
 
+        struct SrcTrgKeyIndexOrder
+        {
+            /* Sorts indices of a vector of (s, t) keys following the
+               order of the (s, t) data structure. Used for bulk
+               loading. */
+
+            const std::vector<SrcTrgKey>* keysPtr;
+            bool operator()(size_t left, size_t right)const
+            {
+                return SrcTrgKeyComparator()((*keysPtr)[left], (*keysPtr)[right]);
+            }
+        };
+
             // Constructor
         StlPhraseTable(void);
 
@@ -102,6 +115,9 @@ class StlPhraseTable: public BasePhraseTable
                                    const std::vector<WordIndex>& t,
                                    PhrasePairInfo inf);
             // Adds an entry to the probability table
+        virtual void addTableEntries(const std::vector<TableEntry>& entries);
+            // Adds a set of entries to the probability table (bulk
+            // loading)
         virtual void addSrcInfo(const std::vector<WordIndex>& s, Count s_inf);
         virtual void addSrcTrgInfo(const std::vector<WordIndex>& s,
                                    const std::vector<WordIndex>& t,
@@ -61,6 +61,29 @@ void WbaIncrPhraseModel::printTTable(FILE* file)
   }
 }
 
+//-------------------------
+void WbaIncrPhraseModel::printBinTTable(FILE* file)
+{
+  HatTriePhraseTable* ptPtr=0;
+
+  ptPtr=dynamic_cast<HatTriePhraseTable*>(basePhraseTablePtr);
+
+  if(ptPtr) // C++ RTTI
+  {
+    HatTriePhraseTable::const_iterator phraseTIter;
+
+    for(phraseTIter=ptPtr->begin();phraseTIter!=ptPtr->end();++phraseTIter)
+    {
+      HatTriePhraseTable::SrcTableNode srctn;
+      HatTriePhraseTable::SrcTableNode::iterator srctnIter;
+      ptPtr->getEntriesForTarget(phraseTIter->first,srctn);
+
+      for(srctnIter=srctn.begin();srctnIter!=srctn.end();++srctnIter)
+        printBinTTableEntry(file,srctnIter->first,phraseTIter->first,srctnIter->second);
+    }
+  }
+}
+
 #else
 //-------------------------
 void WbaIncrPhraseModel::printTTable(FILE* file)
@@ -93,6 +116,29 @@ void WbaIncrPhraseModel::printTTable(FILE* file)
   }
 }
 
+//-------------------------
+void WbaIncrPhraseModel::printBinTTable(FILE* file)
+{
+  StlPhraseTable* ptPtr=0;
+
+  ptPtr=dynamic_cast<StlPhraseTable*>(basePhraseTablePtr);
+
+  if(ptPtr) // C++ RTTI
+  {
+    StlPhraseTable::TrgPhraseInfo::const_iterator phraseTIter;
+
+    for(phraseTIter=ptPtr->beginTrg();phraseTIter!=ptPtr->endTrg();++phraseTIter)
+    {
+      StlPhraseTable::SrcTableNode srctn;
+      StlPhraseTable::SrcTableNode::iterator srctnIter;
+      ptPtr->getEntriesForTarget(phraseTIter->first,srctn);
+
+      for(srctnIter=srctn.begin();srctnIter!=srctn.end();++srctnIter)
+        printBinTTableEntry(file,srctnIter->first,phraseTIter->first,srctnIter->second);
+    }
+  }
+}
+
 #endif
 
 
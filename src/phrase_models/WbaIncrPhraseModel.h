@@ -79,6 +79,7 @@ class WbaIncrPhraseModel: public _wbaIncrPhraseModel
 
         // Functions to print models using standard C library
     void printTTable(FILE* file);
+    void printBinTTable(FILE* file);
 };
 
 #endif
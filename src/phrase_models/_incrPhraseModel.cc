@@ -33,6 +33,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 _incrPhraseModel::_incrPhraseModel(void)
 {
+  printBinSnapshots=true;
 }
 
 //-------------------------
@@ -300,6 +301,21 @@ bool _incrPhraseModel::load_given_prefix(const char *prefix)
 //-------------------------
 bool _incrPhraseModel::load_ttable(const char *_incrPhraseModelFileName)
 {
+      // Use binary snapshot if available
+  std::string binFileName=_incrPhraseModelFileName;
+  binFileName+=".bin";
+  if(binFileIsUpToDate(binFileName,_incrPhraseModelFileName))
+  {
+    SingleWordVocab prevSingleWordVocab=singleWordVocab;
+    if(loadBinTTable(binFileName.c_str())==THOT_OK)
+      return THOT_OK;
+    std::cerr<<"Warning: binary snapshot could not be loaded, using plain text ttable"<<std::endl;
+
+        // Discard the vocabulary entries added by the failed load
+    singleWordVocab=prevSingleWordVocab;
+    basePhraseTablePtr->clear();
+  }
+
   AwkInputStream awk;
   
   if(awk.open(_incrPhraseModelFileName)==THOT_ERROR)
@@ -396,9 +412,137 @@ bool _incrPhraseModel::loadPlainTextTTable(const char *phraseTTableFileName)
  return THOT_OK;
 }
 
+//-------------------------
+bool _incrPhraseModel::loadBinTTable(const char *phraseTTableFileName)
+{
+  std::cerr<<"Loading phrase ttable in binary format from file "<<phraseTTableFileName<<std::endl;
+
+  FILE* file=fopen(phraseTTableFileName,"rb");
+  if(file==NULL)
+  {
+    std::cerr<<"Error in phrase model file: "<<phraseTTableFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Verify header
+  char magic[sizeof(THOT_TTABLE_BIN_MAGIC)];
+  unsigned int version;
+  if(fread(magic,sizeof(magic),1,file)!=1 || strncmp(magic,THOT_TTABLE_BIN_MAGIC,sizeof(magic))!=0 ||
+     fread(&version,sizeof(unsigned int),1,file)!=1 || version!=THOT_TTABLE_BIN_VERSION)
+  {
+    std::cerr<<"Error: incompatible binary ttable file "<<phraseTTableFileName<<std::endl;
+    fclose(file);
+    return THOT_ERROR;
+  }
+
+      // Read vocabularies, the identifiers stored in the file are
+      // remapped to those of the current vocabularies
+  std::vector<WordIndex> srcIdRemap;
+  std::vector<WordIndex> trgIdRemap;
+  if(loadBinVocab(file,true,srcIdRemap)==THOT_ERROR || loadBinVocab(file,false,trgIdRemap)==THOT_ERROR)
+  {
+    std::cerr<<"Error while reading vocabularies from binary ttable file "<<phraseTTableFileName<<std::endl;
+    fclose(file);
+    return THOT_ERROR;
+  }
+
+      // Read entries until the terminating zero-length source phrase,
+      // the table is only modified once the whole file has been read
+  std::vector<BasePhraseTable::TableEntry> entries;
+  std::vector<WordIndex> s;
+  std::vector<WordIndex> t;
+  while(true)
+  {
+    unsigned int slen;
+    unsigned int tlen;
+    float c[2];
+    if(fread(&slen,sizeof(unsigned int),1,file)!=1)
+      break;
+    if(slen==0)
+    {
+      fclose(file);
+      basePhraseTablePtr->addTableEntries(entries);
+      return THOT_OK;
+    }
+    s.resize(slen);
+    if(fread(&s[0],sizeof(WordIndex),slen,file)!=slen)
+      break;
+    if(fread(&tlen,sizeof(unsigned int),1,file)!=1 || tlen==0)
+      break;
+    t.resize(tlen);
+    if(fread(&t[0],sizeof(WordIndex),tlen,file)!=tlen)
+      break;
+    if(fread(c,sizeof(float),2,file)!=2)
+      break;
+
+    bool remapOk=true;
+    for(unsigned int i=0;i<slen;++i)
+    {
+      if(s[i]>=srcIdRemap.size()) remapOk=false;
+      else s[i]=srcIdRemap[s[i]];
+    }
+    for(unsigned int i=0;i<tlen;++i)
+    {
+      if(t[i]>=trgIdRemap.size()) remapOk=false;
+      else t[i]=trgIdRemap[t[i]];
+    }
+    if(!remapOk)
+      break;
+
+    PhrasePairInfo phpinfo;
+    phpinfo.first=c[0];
+    phpinfo.second=c[1];
+    entries.push_back(std::make_pair(std::make_pair(s,t),phpinfo));
+  }
+
+  std::cerr<<"Error: truncated or corrupted binary ttable file "<<phraseTTableFileName<<std::endl;
+  fclose(file);
+  return THOT_ERROR;
+}
+
+//-------------------------
+bool _incrPhraseModel::loadBinVocab(FILE* file,
+                                    bool isSrcVocab,
+                                    std::vector<WordIndex>& idRemap)
+{
+  unsigned int vocSize;
+  if(fread(&vocSize,sizeof(unsigned int),1,file)!=1)
+    return THOT_ERROR;
+
+  idRemap.clear();
+  std::string str;
+  for(unsigned int i=0;i<vocSize;++i)
+  {
+    WordIndex w;
+    unsigned int len;
+    if(fread(&w,sizeof(WordIndex),1,file)!=1 || fread(&len,sizeof(unsigned int),1,file)!=1)
+      return THOT_ERROR;
+    str.resize(len);
+    if(len>0 && fread(&str[0],1,len,file)!=len)
+      return THOT_ERROR;
+
+    if(w>=idRemap.size())
+      idRemap.resize(w+1,UNK_WORD);
+    if(isSrcVocab)
+      idRemap[w]=addSrcSymbol(str);
+    else
+      idRemap[w]=addTrgSymbol(str);
+  }
+  return THOT_OK;
+}
+
 //-------------------------
 bool _incrPhraseModel::load_seglentable(const char *segmLengthTableFileName)
 {
+      // Use binary snapshot if available
+  std::string binFileName=segmLengthTableFileName;
+  binFileName+=".bin";
+  if(binFileIsUpToDate(binFileName,segmLengthTableFileName))
+  {
+    if(segLenTable.loadBin(binFileName.c_str())==THOT_OK)
+      return THOT_OK;
+    std::cerr<<"Warning: binary snapshot could not be loaded, using plain text segmentation length table"<<std::endl;
+  }
   return segLenTable.load_seglentable(segmLengthTableFileName);
 }
 
@@ -430,10 +574,34 @@ bool _incrPhraseModel::print(const char *prefix)
   segLenTableFileName+=".seglentable";
   retVal=printSegmLengthTable(segLenTableFileName.c_str());
   if(retVal) return THOT_ERROR;
+
+      // Print binary snapshots unless disabled (they are printed
+      // after the text files so as to be considered up to date)
+  if(printBinSnapshots)
+    return printBin(absolutizedMainFileName.c_str());
   
   return THOT_OK;
 }
 
+//-------------------------
+bool _incrPhraseModel::printBin(const char *prefix)
+{
+  std::string ttableFileName=prefix;
+  ttableFileName+=".ttable.bin";
+  bool retVal=printBinTTable(ttableFileName.c_str());
+  if(retVal) return THOT_ERROR;
+
+  std::string segLenTableFileName=prefix;
+  segLenTableFileName+=".seglentable.bin";
+  return segLenTable.printBin(segLenTableFileName.c_str());
+}
+
+//-------------------------
+void _incrPhraseModel::setPrintBinSnapshots(bool _printBinSnapshots)
+{
+  printBinSnapshots=_printBinSnapshots;
+}
+
 //-------------------------
 bool _incrPhraseModel::printTTable(const char *outputFileName)
 {
@@ -448,10 +616,87 @@ bool _incrPhraseModel::printTTable(const char *outputFileName)
   else
   {
     printTTable(outf);
+    fclose(outf);
     return THOT_OK;
   }
 }
 
+//-------------------------
+bool _incrPhraseModel::printBinTTable(const char *outputFileName)
+{
+  FILE *outf;
+
+  outf=fopen(outputFileName,"wb");
+  if(outf==NULL)
+  {
+    std::cerr<<"Error while printing binary phrase model to file."<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+  {
+        // Print header and vocabularies
+    unsigned int version=THOT_TTABLE_BIN_VERSION;
+    fwrite(THOT_TTABLE_BIN_MAGIC,sizeof(THOT_TTABLE_BIN_MAGIC),1,outf);
+    fwrite(&version,sizeof(unsigned int),1,outf);
+    printBinVocab(outf,singleWordVocab.getSrcVocab());
+    printBinVocab(outf,singleWordVocab.getTrgVocab());
+
+        // Print entries followed by a zero-length source phrase
+    printBinTTable(outf);
+    unsigned int endMark=0;
+    fwrite(&endMark,sizeof(unsigned int),1,outf);
+
+    bool err=ferror(outf);
+    fclose(outf);
+    if(err)
+    {
+      std::cerr<<"Error while printing binary phrase model to file."<<std::endl;
+      return THOT_ERROR;
+    }
+    return THOT_OK;
+  }
+}
+
+//-------------------------
+void _incrPhraseModel::printBinVocab(FILE* file,
+                                     const SingleWordVocab::StrToIdxVocab& vocab)
+{
+      // Vocabulary entries are printed sorted by identifier
+  std::vector<std::pair<WordIndex,std::string> > idStrVec;
+  SingleWordVocab::StrToIdxVocab::const_iterator vocabIter;
+  for(vocabIter=vocab.begin();vocabIter!=vocab.end();++vocabIter)
+    idStrVec.push_back(std::make_pair(vocabIter->second,vocabIter->first));
+  std::sort(idStrVec.begin(),idStrVec.end());
+
+  unsigned int vocSize=idStrVec.size();
+  fwrite(&vocSize,sizeof(unsigned int),1,file);
+  for(unsigned int i=0;i<idStrVec.size();++i)
+  {
+    unsigned int len=idStrVec[i].second.size();
+    fwrite(&idStrVec[i].first,sizeof(WordIndex),1,file);
+    fwrite(&len,sizeof(unsigned int),1,file);
+    fwrite(idStrVec[i].second.c_str(),1,len,file);
+  }
+}
+
+//-------------------------
+void _incrPhraseModel::printBinTTableEntry(FILE* file,
+                                           const std::vector<WordIndex>& s,
+                                           const std::vector<WordIndex>& t,
+                                           PhrasePairInfo ppInfo)
+{
+  unsigned int slen=s.size();
+  unsigned int tlen=t.size();
+  float c[2];
+  c[0]=(float)ppInfo.first.get_c_s();
+  c[1]=(float)ppInfo.second.get_c_st();
+  fwrite(&slen,sizeof(unsigned int),1,file);
+  fwrite(&s[0],sizeof(WordIndex),slen,file);
+  fwrite(&tlen,sizeof(unsigned int),1,file);
+  fwrite(&t[0],sizeof(WordIndex),tlen,file);
+  fwrite(c,sizeof(float),2,file);
+}
+
 //-------------------------
 bool _incrPhraseModel::printSegmLengthTable(const char *outputFileName)
 {
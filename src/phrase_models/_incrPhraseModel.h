@@ -51,12 +51,16 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <algorithm>
 #include <map>
 
 //--------------- Constants ------------------------------------------
 
 #define THOT_COUNT_OUTPUT       2 
 
+#define THOT_TTABLE_BIN_MAGIC   "thot_ttable_bin"
+#define THOT_TTABLE_BIN_VERSION 1
+
 //--------------- typedefs -------------------------------------------
 
 typedef NbestTransTable<std::vector<WordIndex>,PhraseTransTableNodeData> PhraseNbestTransTable;
@@ -159,9 +163,18 @@ class _incrPhraseModel: public BaseIncrPhraseModel
         // Printing functions
     bool print(const char* prefix);
         // Prints the whole model
+    bool printBin(const char* prefix);
+        // Prints binary snapshots of the translation and segmentation
+        // length tables (.ttable.bin and .seglentable.bin files). The
+        // snapshots are preferred by load() as long as they are not
+        // older than the corresponding text files
+    void setPrintBinSnapshots(bool _printBinSnapshots);
+        // Determines whether print() also generates the binary
+        // snapshots (enabled by default)
     
         // Functions to print the model tables
     virtual bool printTTable(const char *outputFileName);
+    bool printBinTTable(const char *outputFileName);
 	bool printSegmLengthTable(const char *outputFileName);
 
         // Source vocabulary functions
@@ -231,9 +244,19 @@ class _incrPhraseModel: public BaseIncrPhraseModel
     TrgCutsTable trgCutsTable;
     
     TrgSegmLenTable trgSegmLenTable;
+
+    bool printBinSnapshots;
     
         // Functions to print models using standard C library
     virtual void printTTable(FILE* file)=0;
+    virtual void printBinTTable(FILE* file)=0;
+        // Prints the entries of the binary snapshot of the ttable
+    void printBinTTableEntry(FILE* file,
+                             const std::vector<WordIndex>& s,
+                             const std::vector<WordIndex>& t,
+                             PhrasePairInfo ppInfo);
+    void printBinVocab(FILE* file,
+                       const SingleWordVocab::StrToIdxVocab& vocab);
 
     void printNbestTransTableNode(NbestTableNode<PhraseTransTableNodeData> tTableNode,
                                   std::ostream &outS);
@@ -243,6 +266,12 @@ class _incrPhraseModel: public BaseIncrPhraseModel
     virtual bool loadPlainTextTTable(const char *phraseTTableFileName);
         // Reads a plain text phrase model file, returns non-zero if
         // error
+    bool loadBinTTable(const char *phraseTTableFileName);
+        // Reads a binary snapshot of the ttable, returns non-zero if
+        // error
+    bool loadBinVocab(FILE* file,
+                      bool isSrcVocab,
+                      std::vector<WordIndex>& idRemap);
 };
 
 #endif
@@ -31,6 +31,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "PhraseExtractUtils.h"
 #include "IncrPhraseModel.h"
 #include "WbaIncrPhraseModel.h"
+#include "ExtPhrasePairCounter.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -50,6 +51,8 @@ struct thot_gen_phr_model_pars
   std::string outputFilesPrefix;
   PhraseExtractParameters phePars;
   bool BRF;
+  unsigned int memBudget;
+  bool binSnapshot;
   int verbose;
 };
 
@@ -60,26 +63,38 @@ struct thot_gen_phr_model_pars
 
 int genPhrModel(thot_gen_phr_model_pars pars);
 int genPhrModelBasedOnAligns(thot_gen_phr_model_pars pars,
-                             _incrPhraseModel* _incrPhraseModelPtr);
-void extendModelFromAlignments(PhraseExtractParameters phePars,
-                               bool BRF,
-                               _incrPhraseModel* _incrPhraseModelPtr,
-                               AlignmentExtractor& alignmentExtractor,
-                               int verbose=0);
-void extendModelFromPairPlusAlig(PhraseExtractParameters phePars,
-                                 _incrPhraseModel* _incrPhraseModelPtr,
-                                 std::vector<std::string>& ns,
-                                 std::vector<std::string>& t,
-                                 WordAligMatrix& waMatrix,
-                                 float numReps,
-                                 int verbose=0);
-void extendModelFromPairPlusAligBrf(PhraseExtractParameters phePars,
-                                    _incrPhraseModel* _incrPhraseModelPtr,
-                                    std::vector<std::string>& ns,
-                                    std::vector<std::string>& t,
-                                    WordAligMatrix& waMatrix,
-                                    float numReps,
-                                    int verbose=0);
+                             _incrPhraseModel* _incrPhraseModelPtr,
+                             ExtPhrasePairCounter* extCounterPtr);
+int extendModelFromAlignments(PhraseExtractParameters phePars,
+                              bool BRF,
+                              _incrPhraseModel* _incrPhraseModelPtr,
+                              ExtPhrasePairCounter* extCounterPtr,
+                              AlignmentExtractor& alignmentExtractor,
+                              int verbose=0);
+int extendModelFromPairPlusAlig(PhraseExtractParameters phePars,
+                                _incrPhraseModel* _incrPhraseModelPtr,
+                                ExtPhrasePairCounter* extCounterPtr,
+                                std::vector<std::string>& ns,
+                                std::vector<std::string>& t,
+                                WordAligMatrix& waMatrix,
+                                float numReps,
+                                int verbose=0);
+int extendModelFromPairPlusAligBrf(PhraseExtractParameters phePars,
+                                   _incrPhraseModel* _incrPhraseModelPtr,
+                                   ExtPhrasePairCounter* extCounterPtr,
+                                   std::vector<std::string>& ns,
+                                   std::vector<std::string>& t,
+                                   WordAligMatrix& waMatrix,
+                                   float numReps,
+                                   int verbose=0);
+int storePhrasePairs(const std::vector<PhrasePair>& vecPhPair,
+                     _incrPhraseModel* _incrPhraseModelPtr,
+                     ExtPhrasePairCounter* extCounterPtr,
+                     float numReps);
+int printExtTTable(std::string outFileName,
+                   _incrPhraseModel* _incrPhraseModelPtr,
+                   ExtPhrasePairCounter* extCounterPtr,
+                   int verbose=0);
 void printUsage(void);
 void version(void);
 int takeParameters(int argc,
@@ -104,10 +119,25 @@ int genPhrModel(thot_gen_phr_model_pars pars)
       // create model pointer
   _incrPhraseModel* _incrPhraseModelPtr=new IncrPhraseModel;
 
+      // create external counter if a memory budget was given (the
+      // model is then only used to store the vocabularies)
+  ExtPhrasePairCounter* extCounterPtr=NULL;
+  if(pars.memBudget>0)
+  {
+    extCounterPtr=new ExtPhrasePairCounter;
+    if(extCounterPtr->init((size_t)pars.memBudget*1024*1024,pars.outputFilesPrefix+".tmp")==THOT_ERROR)
+    {
+      delete extCounterPtr;
+      delete _incrPhraseModelPtr;
+      return THOT_ERROR;
+    }
+  }
+
       // generate phrase model given a GIZA alignment file
-  int ret=genPhrModelBasedOnAligns(pars,_incrPhraseModelPtr);
+  int ret=genPhrModelBasedOnAligns(pars,_incrPhraseModelPtr,extCounterPtr);
   if(ret==THOT_ERROR)
   {
+    delete extCounterPtr;
     delete _incrPhraseModelPtr;
     return THOT_ERROR;
   }
@@ -116,12 +146,35 @@ int genPhrModel(thot_gen_phr_model_pars pars)
    std::string outFileName=pars.outputFilesPrefix;
    outFileName+=".ttable";
        // output in thot native format
-   ret=_incrPhraseModelPtr->printTTable(outFileName.c_str());
+   if(extCounterPtr)
+     ret=printExtTTable(outFileName,_incrPhraseModelPtr,extCounterPtr,pars.verbose);
+   else
+     ret=_incrPhraseModelPtr->printTTable(outFileName.c_str());
+   delete extCounterPtr;
    if(ret==THOT_ERROR)
    {
      delete _incrPhraseModelPtr;
      return THOT_ERROR;
    }
+
+       // print binary snapshot of the ttable
+   if(pars.binSnapshot)
+   {
+     if(pars.memBudget>0)
+     {
+       std::cerr<<"Warning: binary snapshots cannot be generated when counting in external memory"<<std::endl;
+     }
+     else
+     {
+       std::string binFileName=outFileName+".bin";
+       ret=_incrPhraseModelPtr->printBinTTable(binFileName.c_str());
+       if(ret==THOT_ERROR)
+       {
+         delete _incrPhraseModelPtr;
+         return THOT_ERROR;
+       }
+     }
+   }
    
        // print segmentation length table
    if(pars.BRF==1)
@@ -139,7 +192,8 @@ int genPhrModel(thot_gen_phr_model_pars pars)
 
 //---------------
 int genPhrModelBasedOnAligns(thot_gen_phr_model_pars pars,
-                             _incrPhraseModel* _incrPhraseModelPtr)
+                             _incrPhraseModel* _incrPhraseModelPtr,
+                             ExtPhrasePairCounter* extCounterPtr)
 {
       // Initialize alignment extractor
   AlignmentExtractor alignmentExtractor;
@@ -151,19 +205,20 @@ int genPhrModelBasedOnAligns(thot_gen_phr_model_pars pars,
   }
       // Extend phrase model using the alignments provided by the
       // extractor
-  extendModelFromAlignments(pars.phePars,pars.BRF,_incrPhraseModelPtr,alignmentExtractor,pars.verbose);
+  ret=extendModelFromAlignments(pars.phePars,pars.BRF,_incrPhraseModelPtr,extCounterPtr,alignmentExtractor,pars.verbose);
   
   alignmentExtractor.close();
   
-  return THOT_OK;  
+  return ret;  
 }
 
 //---------------
-void extendModelFromAlignments(PhraseExtractParameters phePars,
-                               bool BRF,
-                               _incrPhraseModel* _incrPhraseModelPtr,
-                               AlignmentExtractor& alignmentExtractor,
-                               int verbose/*=0*/)
+int extendModelFromAlignments(PhraseExtractParameters phePars,
+                              bool BRF,
+                              _incrPhraseModel* _incrPhraseModelPtr,
+                              ExtPhrasePairCounter* extCounterPtr,
+                              AlignmentExtractor& alignmentExtractor,
+                              int verbose/*=0*/)
 {
       // Iterate over alignments
   int numSent=0;	
@@ -187,24 +242,32 @@ void extendModelFromAlignments(PhraseExtractParameters phePars,
         std::cerr<<std::endl;
       }
           // Extend model from individual alignment
+      int ret;
       if(BRF)
-        extendModelFromPairPlusAligBrf(phePars,_incrPhraseModelPtr,ns,t,waMatrix,numReps,verbose);
+        ret=extendModelFromPairPlusAligBrf(phePars,_incrPhraseModelPtr,extCounterPtr,ns,t,waMatrix,numReps,verbose);
       else
-        extendModelFromPairPlusAlig(phePars,_incrPhraseModelPtr,ns,t,waMatrix,numReps,verbose);
+        ret=extendModelFromPairPlusAlig(phePars,_incrPhraseModelPtr,extCounterPtr,ns,t,waMatrix,numReps,verbose);
+      if(ret==THOT_ERROR)
+      {
+        std::cerr<<"Error while storing the phrase pairs of sentence pair "<<numSent<<std::endl;
+        return THOT_ERROR;
+      }
     }
     else
       std::cerr<< "  Warning: Max. sentence length exceeded for sentence pair "<<numSent<<std::endl;
   }
+  return THOT_OK;
 }
 
 //---------------
-void extendModelFromPairPlusAlig(PhraseExtractParameters phePars,
-                                 _incrPhraseModel* _incrPhraseModelPtr,
-                                 std::vector<std::string>& ns,
-                                 std::vector<std::string>& t,
-                                 WordAligMatrix& waMatrix,
-                                 float numReps,
-                                 int verbose/*=0*/)
+int extendModelFromPairPlusAlig(PhraseExtractParameters phePars,
+                                _incrPhraseModel* _incrPhraseModelPtr,
+                                ExtPhrasePairCounter* extCounterPtr,
+                                std::vector<std::string>& ns,
+                                std::vector<std::string>& t,
+                                WordAligMatrix& waMatrix,
+                                float numReps,
+                                int verbose/*=0*/)
 {
       // Extract phrase using BRF estimation
   std::vector<PhrasePair> vecUnfiltPhPair;
@@ -215,20 +278,18 @@ void extendModelFromPairPlusAlig(PhraseExtractParameters phePars,
   PhraseExtractUtils::filterPhrasePairs(vecUnfiltPhPair,vecPhPair);
 
       // Store phrases in model
-  for(unsigned int i=0;i<vecPhPair.size();++i)
-  {
-    _incrPhraseModelPtr->strIncrCountsOfEntry(vecPhPair[i].s_,vecPhPair[i].t_,numReps*vecPhPair[i].weight);
-  }
+  return storePhrasePairs(vecPhPair,_incrPhraseModelPtr,extCounterPtr,numReps);
 }
 
 //---------------
-void extendModelFromPairPlusAligBrf(PhraseExtractParameters phePars,
-                                    _incrPhraseModel* _incrPhraseModelPtr,
-                                    std::vector<std::string>& ns,
-                                    std::vector<std::string>& t,
-                                    WordAligMatrix& waMatrix,
-                                    float numReps,
-                                    int verbose/*=0*/)
+int extendModelFromPairPlusAligBrf(PhraseExtractParameters phePars,
+                                   _incrPhraseModel* _incrPhraseModelPtr,
+                                   ExtPhrasePairCounter* extCounterPtr,
+                                   std::vector<std::string>& ns,
+                                   std::vector<std::string>& t,
+                                   WordAligMatrix& waMatrix,
+                                   float numReps,
+                                   int verbose/*=0*/)
 {
       // Extract phrase using BRF estimation
   std::vector<PhrasePair> vecUnfiltPhPair;
@@ -239,10 +300,50 @@ void extendModelFromPairPlusAligBrf(PhraseExtractParameters phePars,
   PhraseExtractUtils::filterPhrasePairs(vecUnfiltPhPair,vecPhPair);
 
       // Store phrases in model
+  return storePhrasePairs(vecPhPair,_incrPhraseModelPtr,extCounterPtr,numReps);
+}
+
+//---------------
+int storePhrasePairs(const std::vector<PhrasePair>& vecPhPair,
+                     _incrPhraseModel* _incrPhraseModelPtr,
+                     ExtPhrasePairCounter* extCounterPtr,
+                     float numReps)
+{
   for(unsigned int x=0;x<vecPhPair.size();++x)
   {
-    _incrPhraseModelPtr->strIncrCountsOfEntry(vecPhPair[x].s_,vecPhPair[x].t_,numReps*vecPhPair[x].weight);
+    if(extCounterPtr)
+    {
+          // Only the vocabularies are kept in memory
+      std::vector<WordIndex> s=_incrPhraseModelPtr->strVectorToSrcIndexVector(vecPhPair[x].s_);
+      std::vector<WordIndex> t=_incrPhraseModelPtr->strVectorToTrgIndexVector(vecPhPair[x].t_);
+      if(extCounterPtr->addPair(s,t,numReps*vecPhPair[x].weight)==THOT_ERROR)
+        return THOT_ERROR;
+    }
+    else
+      _incrPhraseModelPtr->strIncrCountsOfEntry(vecPhPair[x].s_,vecPhPair[x].t_,numReps*vecPhPair[x].weight);
   }
+  return THOT_OK;
+}
+
+//---------------
+int printExtTTable(std::string outFileName,
+                   _incrPhraseModel* _incrPhraseModelPtr,
+                   ExtPhrasePairCounter* extCounterPtr,
+                   int verbose/*=0*/)
+{
+  FILE* outf=fopen(outFileName.c_str(),"w");
+  if(outf==NULL)
+  {
+    std::cerr<<"Error while printing phrase table."<<std::endl;
+    return THOT_ERROR;
+  }
+  int ret=extCounterPtr->printTTable(outf,*_incrPhraseModelPtr,verbose);
+  if(fclose(outf)!=0)
+  {
+    std::cerr<<"Error while writing phrase table file "<<outFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return ret;
 }
 
 //---------------
@@ -312,6 +413,21 @@ int takeParameters(int argc,
  {
    pars.BRF=0;
  }
+
+ /* Verify binary snapshot option */
+ err=readOption(argc,argv, "-bin");
+ pars.binSnapshot=1;
+ if(err==-1)
+ {
+   pars.binSnapshot=0;
+ }
+
+ /* Take the memory budget */
+ err=readUnsignedInt(argc,argv, "-mem", &pars.memBudget);
+ if(err==-1)
+ {
+   pars.memBudget=0;
+ }
       
  /* Verify verbose option */
  pars.verbose=0;
@@ -337,7 +453,7 @@ void printDesc(void)
 void printUsage(void)
 {
  std::cerr<<"Usage: thot_gen_phr_model -g <string> [-m <int>] [-mon]\n";
- std::cerr<<"                          [-brf] -o <string> [-p]\n";
+ std::cerr<<"                          [-brf] [-mem <int>] [-bin] -o <string> [-p]\n";
  std::cerr<<"                          [-v | -v1] [--help] [--version]\n\n";
  std::cerr<<"-g <string>               Name of the alignment file in GIZA format for\n";
  std::cerr<<"                          generating a phrase model.\n\n"; 
@@ -346,6 +462,12 @@ void printUsage(void)
  std::cerr<<"-mon                      Generate monotone model.\n\n";
  std::cerr<<"-brf                      Obtain bisegmentation-based RF model (RF by\n";
  std::cerr<<"                          default).\n\n";
+ std::cerr<<"-mem <int>                Count phrase pairs in external memory using a\n";
+ std::cerr<<"                          buffer of <int> MB. Sorted runs of counts are\n";
+ std::cerr<<"                          stored in temporary files with the output\n";
+ std::cerr<<"                          prefix and merged at the end.\n\n";
+ std::cerr<<"-bin                      Also print a binary snapshot of the ttable\n";
+ std::cerr<<"                          (.ttable.bin file) for fast loading.\n\n";
  std::cerr<<"-o <string>               Set output files prefix name.\n\n";
  std::cerr<<"-v | -v1                  Verbose mode | more verbosity\n\n";
  std::cerr<<"--help                    Display this help and exit\n\n";
@@ -0,0 +1,407 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file NbUncoupledAssistedTrans.h
+ *
+ * @brief Declares the NbUncoupledAssistedTrans template class, this
+ * class implements uncoupled assisted translators based on n-best
+ * lists. The source sentence is translated only once, when
+ * translateWithPrefix() is called. The word-graph generated by the
+ * decoder is kept together with the n-best list extracted from it, and
+ * each subsequent prefix is answered by correcting the stored n-best
+ * translations.
+ */
+
+#ifndef _NbUncoupledAssistedTrans_h
+#define _NbUncoupledAssistedTrans_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <StrProcUtils.h>
+#include "_nbUncoupledAssistedTrans.h"
+#include "_stackDecoderRec.h"
+#include "NbestCorrections.h"
+#include "WordGraph.h"
+#include <map>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+
+//--------------- NbUncoupledAssistedTrans template class
+
+/**
+ * @brief The NbUncoupledAssistedTrans template class implements
+ * uncoupled assisted translators based on n-best lists.
+ */
+
+template<class SMT_MODEL>
+class NbUncoupledAssistedTrans: public _nbUncoupledAssistedTrans<SMT_MODEL>
+{
+ public:
+
+  typedef typename SMT_MODEL::Hypothesis Hypothesis;
+
+  NbUncoupledAssistedTrans(void);
+      // Constructor
+
+      // Link statistical translation model with the decoder
+  int link_stack_trans(BaseStackDecoder<SMT_MODEL>* _sd_ptr);
+
+      // Link cat error correcting model with the decoder
+  void link_cat_ec_model(BaseEcModelForNbUcat* _ecm_ucat_ptr);
+
+      // Basic services
+  std::string translateWithPrefix(std::string s,
+                                  std::string pref,
+                                  const RejectedWordsSet& rejectedWords=RejectedWordsSet(),
+                                  unsigned int verbose=0);
+      // Translates std::string s using pref as prefix, uncoupled
+      // version. The word-graph of the translation is stored and used
+      // by subsequent calls to addStrToPrefix()
+  std::string addStrToPrefix(std::string s,
+                             const RejectedWordsSet& rejectedWords=RejectedWordsSet(),
+                             unsigned int verbose=0);
+      // Adds the string 's' to the user prefix. No translation is
+      // carried out, the n-best list obtained for the current sentence
+      // is corrected instead
+  void resetPrefix(void);
+      // Resets the prefix
+
+  void set_n(unsigned int n);
+      // Sets the size of n-best translations list used in uncoupled
+      // assisted translation
+
+      // Model weights functions
+  void setWeights(std::vector<float> wVec);
+  unsigned int getNumWeights(void);
+  void printWeights(std::ostream &outS);
+
+      // clear() function
+  void clear(void);
+      // Remove all data structures used by the assisted translator
+
+      // Destructor
+  virtual ~NbUncoupledAssistedTrans();
+
+ protected:
+
+      // CAT-related data members
+  _stackDecoderRec<SMT_MODEL>* sdr_ptr;     // Pointer to a stack decoder
+
+  BaseEcModelForNbUcat* ecm_ucat_ptr;  // Pointer to the error
+                                       // correcting model
+
+  float psutw;                   // Weight for the translation score
+                                 // used in CAT
+
+  float putw;                    // Weight for the error correcting
+                                 // model score used in CAT
+
+  unsigned int n;                // Size of the n-best list
+
+      // Search space for the current sentence
+  std::string source;
+  bool completeHypReachable;
+  WordGraph wordGraph;
+  std::vector<std::pair<Score,std::vector<std::string> > > nbestTrans;
+  bool nbestTransUpToDate;
+
+      // CAT-related data members
+  std::string catPrefix;
+  std::map<std::string,std::string> resultForPrefix;
+
+      // Auxiliary functions
+  void obtainNbestTrans(void);
+  std::string correctNbestTrans(const RejectedWordsSet& rejectedWords,
+                                unsigned int verbose);
+  bool wordSatisfiesRejWordConstraint(std::string word,
+                                      const RejectedWordsSet& rejectedWords);
+};
+
+//--------------- NbUncoupledAssistedTrans template class method definitions
+
+//---------------------------------------
+template<class SMT_MODEL>
+NbUncoupledAssistedTrans<SMT_MODEL>::NbUncoupledAssistedTrans(void):_nbUncoupledAssistedTrans<SMT_MODEL>()
+{
+  psutw=1;
+  putw=1;
+  n=1;
+  sdr_ptr=NULL;
+  ecm_ucat_ptr=NULL;
+  completeHypReachable=false;
+  nbestTransUpToDate=false;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+int NbUncoupledAssistedTrans<SMT_MODEL>::link_stack_trans(BaseStackDecoder<SMT_MODEL>* _sd_ptr)
+{
+  sdr_ptr=dynamic_cast<_stackDecoderRec<SMT_MODEL>*>(_sd_ptr);
+  if(sdr_ptr)
+    return THOT_OK;
+  else
+    return THOT_ERROR;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::link_cat_ec_model(BaseEcModelForNbUcat* _ecm_ucat_ptr)
+{
+  ecm_ucat_ptr=_ecm_ucat_ptr;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+std::string NbUncoupledAssistedTrans<SMT_MODEL>::translateWithPrefix(std::string s,
+                                                                     std::string pref,
+                                                                     const RejectedWordsSet& rejectedWords,
+                                                                     unsigned int verbose)
+{
+      // Clear information about the previous sentence
+  source=s;
+  catPrefix.clear();
+  resultForPrefix.clear();
+  nbestTrans.clear();
+  nbestTransUpToDate=false;
+  ecm_ucat_ptr->clearTempVars();
+
+      // Get pointer to the statistical machine translation model
+  SMT_MODEL* smtm_ptr=sdr_ptr->get_smt_model_ptr();
+
+      // Translate sentence generating a word-graph
+  sdr_ptr->enableWordGraph();
+  Hypothesis hyp=sdr_ptr->translate(s);
+  completeHypReachable=smtm_ptr->isComplete(hyp);
+
+      // Store word-graph, the decoder word-graph is overwritten by
+      // subsequent translations
+  wordGraph=*sdr_ptr->getWordGraphPtr();
+  if(verbose)
+  {
+    std::cerr<<"Storing word-graph,";
+    std::cerr<<" #Nodes: "<<wordGraph.numStates();
+    std::cerr<<" , #Arcs: "<<wordGraph.numArcs()<<std::endl;
+  }
+
+  if(completeHypReachable)
+  {
+    return addStrToPrefix(pref,rejectedWords,verbose);
+  }
+  else
+  {
+        // No translations were obtained
+    if(verbose) std::cerr<<"Unable to translate sentence!"<<std::endl;
+    std::string nullStr="";
+    return nullStr;
+  }
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+std::string NbUncoupledAssistedTrans<SMT_MODEL>::addStrToPrefix(std::string s,
+                                                                const RejectedWordsSet& rejectedWords,
+                                                                unsigned int verbose)
+{
+  catPrefix=catPrefix+s;
+  if(!completeHypReachable)
+    return "";
+
+      // Check if the prefix was already processed (the stored results
+      // were obtained without rejected words)
+  if(rejectedWords.empty())
+  {
+    std::map<std::string,std::string>::iterator mapIter=resultForPrefix.find(catPrefix);
+    if(mapIter!=resultForPrefix.end())
+      return mapIter->second;
+  }
+
+      // Obtain n-best list from stored word-graph if necessary
+  if(!nbestTransUpToDate)
+    obtainNbestTrans();
+
+      // Correct n-best list
+  std::string result=correctNbestTrans(rejectedWords,verbose);
+  if(rejectedWords.empty())
+    resultForPrefix[catPrefix]=result;
+  return result;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::obtainNbestTrans(void)
+{
+  std::vector<std::pair<Score,std::string> > nblist;
+  std::vector<NbSearchHighLevelHyp> highLevelHypList;
+  std::vector<std::vector<Score> > scoreCompsVec;
+
+  wordGraph.obtainNbestList(n,nblist,highLevelHypList,scoreCompsVec);
+  nbestTrans.clear();
+  for(unsigned int i=0;i<nblist.size();++i)
+    nbestTrans.push_back(std::make_pair(nblist[i].first,StrProcUtils::stringToStringVector(nblist[i].second)));
+  nbestTransUpToDate=true;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+std::string NbUncoupledAssistedTrans<SMT_MODEL>::correctNbestTrans(const RejectedWordsSet& rejectedWords,
+                                                                   unsigned int verbose)
+{
+  std::vector<std::string> prefixVec=StrProcUtils::stringToStringVector(catPrefix);
+  std::vector<std::string> bestCorrection;
+  Score bestScore=SMALL_SCORE;
+  bool correctionFound=false;
+
+  for(unsigned int i=0;i<nbestTrans.size();++i)
+  {
+        // Set one cut per word for unrestricted correction
+    std::vector<unsigned int> sourceCuts;
+    for(unsigned int j=1;j<=nbestTrans[i].second.size();++j)
+      sourceCuts.push_back(j);
+
+        // Correct translation
+    NbestCorrections nbestCorrections=ecm_ucat_ptr->correct(nbestTrans[i].second,
+                                                            sourceCuts,
+                                                            prefixVec,
+                                                            1,
+                                                            verbose);
+    if(!nbestCorrections.empty())
+    {
+          // Discard the correction if the word following the prefix
+          // was rejected
+      const std::vector<std::string>& correction=nbestCorrections.begin()->second;
+      if(!rejectedWords.empty() && correction.size()>prefixVec.size() &&
+         !wordSatisfiesRejWordConstraint(correction[prefixVec.size()],rejectedWords))
+        continue;
+
+      Score score=psutw*nbestTrans[i].first+putw*nbestCorrections.begin()->first;
+      if(!correctionFound || score>bestScore)
+      {
+        bestScore=score;
+        bestCorrection=nbestCorrections.begin()->second;
+        correctionFound=true;
+      }
+    }
+  }
+  if(verbose)
+    std::cerr<<nbestTrans.size()<<" translations were corrected, best score: "<<bestScore<<std::endl;
+
+  std::string result="";
+  for(unsigned int i=0;i<bestCorrection.size();++i)
+  {
+    if(i==0) result=bestCorrection[0];
+    else result+=" "+bestCorrection[i];
+  }
+  return result;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+bool NbUncoupledAssistedTrans<SMT_MODEL>::wordSatisfiesRejWordConstraint(std::string word,
+                                                                         const RejectedWordsSet& rejectedWords)
+{
+  RejectedWordsSet::const_iterator strSetIter;
+  for(strSetIter=rejectedWords.begin();strSetIter!=rejectedWords.end();++strSetIter)
+  {
+        // Obtain accepted prefix and rejected suffix
+    const std::string& accepted_prefix=strSetIter->first;
+    const std::string& rejected_suffix=strSetIter->second;
+
+        // Check if word is compatible with accepted prefix
+    if(word.compare(0,accepted_prefix.size(),accepted_prefix)!=0)
+      return false;
+    
+        // Check if word contains rejected suffix
+    if(word.substr(accepted_prefix.size())==rejected_suffix)
+      return false;
+  }
+  return true;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::resetPrefix(void)
+{
+  catPrefix.clear();
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::set_n(unsigned int _n)
+{
+  if(_n!=n)
+  {
+        // The n-best list is regenerated from the stored word-graph
+    n=_n;
+    nbestTransUpToDate=false;
+    resultForPrefix.clear();
+  }
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::setWeights(std::vector<float> wVec)
+{
+  if(wVec.size()>=1) psutw=wVec[0];
+  if(wVec.size()>=2) putw=wVec[1];
+  resultForPrefix.clear();
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+unsigned int NbUncoupledAssistedTrans<SMT_MODEL>::getNumWeights(void)
+{
+  return 2;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::printWeights(std::ostream &outS)
+{
+  outS<<"psutw: "<<psutw<<" , ";
+  outS<<"putw: "<<putw;
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+void NbUncoupledAssistedTrans<SMT_MODEL>::clear(void)
+{
+  resetPrefix();
+  source.clear();
+  completeHypReachable=false;
+  wordGraph.clear();
+  nbestTrans.clear();
+  nbestTransUpToDate=false;
+  resultForPrefix.clear();
+}
+
+//---------------------------------
+template<class SMT_MODEL>
+NbUncoupledAssistedTrans<SMT_MODEL>::~NbUncoupledAssistedTrans(void)
+{
+}
+
+#endif
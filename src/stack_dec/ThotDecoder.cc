@@ -25,6 +25,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "ThotDecoder.h"
+#include <stdlib.h>
+#include <unistd.h>
 
 //--------------- ThotDecoder class functions
 
@@ -197,8 +199,12 @@ void ThotDecoder::init_translator_legacy_impl(void)
   pthread_mutex_init(&atomic_op_mut,NULL);
   pthread_mutex_init(&non_atomic_op_mut,NULL);
   pthread_mutex_init(&preproc_mut,NULL);
+  pthread_mutex_init(&wg_precomp_mut,NULL);
   pthread_cond_init(&non_atomic_op_cond,NULL);
   non_atomic_ops_running=0;
+
+      // Set maximum number of precomputed word graphs
+  tdWgPrecompVars.queue.setMaxStoredWgs(TDEC_MAX_PRECOMP_WGS);
 }
 
 //--------------------------
@@ -302,8 +308,12 @@ void ThotDecoder::init_translator_feat_impl(void)
   pthread_mutex_init(&atomic_op_mut,NULL);
   pthread_mutex_init(&non_atomic_op_mut,NULL);
   pthread_mutex_init(&preproc_mut,NULL);
+  pthread_mutex_init(&wg_precomp_mut,NULL);
   pthread_cond_init(&non_atomic_op_cond,NULL);
   non_atomic_ops_running=0;
+
+      // Set maximum number of precomputed word graphs
+  tdWgPrecompVars.queue.setMaxStoredWgs(TDEC_MAX_PRECOMP_WGS);
 }
 
 //--------------------------
@@ -493,6 +503,81 @@ void ThotDecoder::release_idx_data(size_t idx)
   }
 }
 
+//--------------------------
+int ThotDecoder::init_wg_precomp_data(void)
+{
+      // Create a translator instance
+  tdWgPrecompVars.stackDecoderPtr=tdCommonVars.dynClassFactoryHandler.baseStackDecoderDynClassLoader.make_obj(tdCommonVars.dynClassFactoryHandler.baseStackDecoderInitPars);
+  if(tdWgPrecompVars.stackDecoderPtr==NULL)
+  {
+    StdCerrThreadSafe<<"Error: BaseStackDecoder pointer could not be instantiated"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Create statistical machine translation model instance (it is
+      // cloned from the main one)
+  BaseSmtModel<SmtModel::Hypothesis>* baseSmtModelPtr=tdCommonVars.smtModelPtr->clone();
+  tdWgPrecompVars.smtModelPtr=dynamic_cast<BasePbTransModel<SmtModel::Hypothesis>* >(baseSmtModelPtr);
+
+      // Create translation metadata object
+  tdWgPrecompVars.trMetadataPtr=tdCommonVars.dynClassFactoryHandler.baseTranslationMetadataDynClassLoader.make_obj(tdCommonVars.dynClassFactoryHandler.baseTranslationMetadataInitPars);
+  if(tdWgPrecompVars.trMetadataPtr==NULL)
+  {
+    StdCerrThreadSafe<<"Error: BaseTranslationMetadata pointer could not be instantiated"<<std::endl;
+    release_wg_precomp_translator();
+    return THOT_ERROR;
+  }
+
+      // Link translation metadata
+  tdWgPrecompVars.smtModelPtr->link_trans_metadata(tdWgPrecompVars.trMetadataPtr);
+
+      // Link statistical machine translation model
+  int ret=tdWgPrecompVars.stackDecoderPtr->link_smt_model(tdWgPrecompVars.smtModelPtr);
+  tdWgPrecompVars.stackDecoderRecPtr=dynamic_cast<_stackDecoderRec<SmtModel>*>(tdWgPrecompVars.stackDecoderPtr);
+  if(ret==THOT_ERROR || tdWgPrecompVars.stackDecoderRecPtr==NULL)
+  {
+    StdCerrThreadSafe<<"Error while creating translator to precompute word graphs, revise master.ini file"<<std::endl;
+    release_wg_precomp_translator();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------
+void ThotDecoder::release_wg_precomp_translator(void)
+{
+  delete tdWgPrecompVars.smtModelPtr;
+  delete tdWgPrecompVars.stackDecoderPtr;
+  delete tdWgPrecompVars.trMetadataPtr;
+  tdWgPrecompVars.smtModelPtr=NULL;
+  tdWgPrecompVars.stackDecoderPtr=NULL;
+  tdWgPrecompVars.stackDecoderRecPtr=NULL;
+  tdWgPrecompVars.trMetadataPtr=NULL;
+}
+
+//--------------------------
+void ThotDecoder::release_wg_precomp_data(void)
+{
+      // NOTE: this function requires the worker thread to be stopped
+  release_wg_precomp_translator();
+
+      // Reset queue
+  std::vector<WgPrecompSentFile> removedWgs;
+  pthread_mutex_lock(&wg_precomp_mut);
+  tdWgPrecompVars.queue.clear(removedWgs);
+  tdWgPrecompVars.stopRequested=false;
+  pthread_mutex_unlock(&wg_precomp_mut);
+
+      // Remove precomputed word graphs
+  for(unsigned int i=0;i<removedWgs.size();++i)
+    remove(removedWgs[i].second.c_str());
+  if(!tdWgPrecompVars.wgDir.empty())
+    rmdir(tdWgPrecompVars.wgDir.c_str());
+  tdWgPrecompVars.wgDir.clear();
+  tdWgPrecompVars.numWgFilesCreated=0;
+}
+
 //--------------------------
 size_t ThotDecoder::get_vecidx_for_user_id(int user_id)
 {
@@ -1068,6 +1153,16 @@ int ThotDecoder::initUserPars(int user_id,
       // Set cat weights
   set_catw(user_id,tdup.catWeightsVec,verbose);
 
+      // Store parameters for the translator used to precompute word
+      // graphs, the word graphs of the next sentences are obtained
+      // again if the parameters of the decoder change
+  bool wgPrecompParsChanged=(tdWgPrecompVars.userPars.S!=tdup.S ||
+                             tdWgPrecompVars.userPars.be!=tdup.be ||
+                             tdWgPrecompVars.userPars.G!=tdup.G);
+  tdWgPrecompVars.userPars=tdup;
+  if(wgPrecompParsChanged)
+    refreshPrecompWgs("",verbose);
+
       // Unlock non_atomic_op_cond mutex
   pthread_mutex_unlock(&non_atomic_op_mut);
 
@@ -1923,10 +2018,12 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
   }
 
       // Check if pre/post processing is enabled
+  std::string trainedSrcSent;
   if(tdState.preprocId)
   {
         // Pre/post processing enabled
     std::string preprocSrcSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,srcSent,tdState.caseconv,false);
+    trainedSrcSent=preprocSrcSent;
     std::string preprocRefSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,refSent,tdState.caseconv,false);
 
         // Obtain system translation
@@ -1961,6 +2058,7 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
   else
   {
         // Pre/post processing disabled
+    trainedSrcSent=srcSent;
 
         // Obtain system translation
     if(tdPerUserVarsVec[idx].stackDecoderRecPtr)
@@ -1991,6 +2089,11 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
     if(verbose) StdCerrThreadSafeCond(printTid)<<"Training time: "<<elapsedTime-prevElapsedTime<<std::endl;
   }
 
+      // Obtain again the precomputed word graphs of the next sentences
+      // with the trained models, the one of the trained sentence is not
+      // needed anymore
+  refreshPrecompWgs(trainedSrcSent,verbose);
+
       // Unlock non_atomic_op_cond mutex
   pthread_mutex_unlock(&non_atomic_op_mut);
 
@@ -2305,6 +2408,286 @@ std::string ThotDecoder::translateSentenceAux(size_t idx,
   }
 }
 
+//--------------------------
+int ThotDecoder::precomputeWordGraphs(int user_id,
+                                      const std::vector<std::string>& sentences,
+                                      int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // Increase non_atomic_ops_running variable
+  increase_non_atomic_ops_running();
+
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
+
+  pthread_mutex_lock(&per_user_mut[idx]);
+  /////////// begin of user mutex
+
+      // Preprocess sentences in the same way as startCat() does, so
+      // that they can be found in the word graph handler
+  bool wgSupported=(tdPerUserVarsVec[idx].stackDecoderRecPtr!=NULL);
+  std::vector<std::string> preprocSents;
+  for(unsigned int i=0;wgSupported && i<sentences.size();++i)
+  {
+    if(tdState.preprocId)
+      preprocSents.push_back(normalizePrecompWgSent(preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,sentences[i],tdState.caseconv,false)));
+    else
+      preprocSents.push_back(normalizePrecompWgSent(sentences[i]));
+  }
+
+  /////////// end of user mutex 
+  pthread_mutex_unlock(&per_user_mut[idx]);
+
+      // Decrease non_atomic_ops_running variable
+  decrease_non_atomic_ops_running();
+
+  if(!wgSupported)
+  {
+    StdCerrThreadSafeCond(printTid)<<"Error: the decoder does not generate word graphs, sentences will not be precomputed"<<std::endl;
+    return 0;
+  }
+
+  pthread_mutex_lock(&wg_precomp_mut);
+  /////////// begin of word graph precomputation mutex
+
+      // Queue sentences whose word graph is not available
+  int numQueued=0;
+  for(unsigned int i=0;!tdWgPrecompVars.stopRequested && i<preprocSents.size();++i)
+  {
+    bool found;
+    tdCommonVars.wgHandlerPtr->pathAssociatedToSentence(StrProcUtils::stringToStringVector(preprocSents[i]),found);
+    if(!found && tdWgPrecompVars.queue.request(preprocSents[i]))
+      ++numQueued;
+  }
+  tdWgPrecompVars.verbose=verbose;
+  if(verbose)
+    StdCerrThreadSafeCond(printTid)<<numQueued<<" out of "<<sentences.size()<<" sentences queued for word graph precomputation"<<std::endl;
+
+      // Start worker thread if it is not running
+  if(tdWgPrecompVars.queue.pendingSentAvailable())
+    startWgPrecompWorker(printTid);
+
+  /////////// end of word graph precomputation mutex
+  pthread_mutex_unlock(&wg_precomp_mut);
+
+  return numQueued;
+}
+
+//--------------------------
+void ThotDecoder::startWgPrecompWorker(bool printTid)
+{
+      // NOTE: this function requires wg_precomp_mut to be locked
+  if(tdWgPrecompVars.workerRunning)
+    return;
+  
+      // Release resources of the previous worker, which has already
+      // finished
+  if(tdWgPrecompVars.workerStarted)
+    pthread_join(tdWgPrecompVars.workerTid,NULL);
+    
+  int thread_err=pthread_create(&tdWgPrecompVars.workerTid,NULL,wgPrecompWorker,(void*) this);
+  tdWgPrecompVars.workerStarted=(thread_err==0);
+  tdWgPrecompVars.workerRunning=(thread_err==0);
+  if(thread_err!=0)
+    StdCerrThreadSafeCond(printTid)<<"Warning: call to pthread_create failed, word graphs will not be precomputed"<<std::endl;
+}
+
+//--------------------------
+void* ThotDecoder::wgPrecompWorker(void* thotDecoderPtr)
+{
+  ((ThotDecoder*) thotDecoderPtr)->processPendingWgPrecompSents();
+  return NULL;
+}
+
+//--------------------------
+void ThotDecoder::processPendingWgPrecompSents(void)
+{
+  while(true)
+  {
+    pthread_mutex_lock(&wg_precomp_mut);
+    /////////// begin of word graph precomputation mutex
+        // The worker finishes when there are no pending sentences or
+        // the maximum number of word graphs that have not been served
+        // are stored, it is started again when a sentence is served
+    std::string sentence;
+    if(tdWgPrecompVars.stopRequested || !tdWgPrecompVars.queue.nextPendingSent(sentence))
+    {
+      tdWgPrecompVars.workerRunning=false;
+      pthread_mutex_unlock(&wg_precomp_mut);
+      return;
+    }
+    int verbose=tdWgPrecompVars.verbose;
+    /////////// end of word graph precomputation mutex
+    pthread_mutex_unlock(&wg_precomp_mut);
+
+        // Translate sentence, the word graph precomputation works as
+        // any other non-atomic operation
+    increase_non_atomic_ops_running();
+    int ret=precomputeWordGraph(sentence,verbose);
+    decrease_non_atomic_ops_running();
+
+        // Allow the sentence to be requested again if precomputation
+        // failed
+    if(ret==THOT_ERROR)
+    {
+      pthread_mutex_lock(&wg_precomp_mut);
+      tdWgPrecompVars.queue.cancel(sentence);
+      pthread_mutex_unlock(&wg_precomp_mut);
+    }
+  }
+}
+
+//--------------------------
+int ThotDecoder::precomputeWordGraph(std::string sentence,
+                                     int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // Create translator if necessary
+  if(tdWgPrecompVars.stackDecoderPtr==NULL)
+  {
+    int ret=init_wg_precomp_data();
+    if(ret==THOT_ERROR)
+      return THOT_ERROR;
+  }
+
+      // Create directory to store word graphs if necessary
+  if(tdWgPrecompVars.wgDir.empty())
+  {
+    const char* tmpDir=getenv("TMPDIR");
+    std::string dirTemplate=std::string((tmpDir!=NULL && tmpDir[0]!='\0')?tmpDir:"/tmp")+"/thot_wgs_XXXXXX";
+    std::vector<char> dirBuf(dirTemplate.begin(),dirTemplate.end());
+    dirBuf.push_back('\0');
+    if(mkdtemp(&dirBuf[0])==NULL)
+    {
+      StdCerrThreadSafeCond(printTid)<<"Error while creating directory for precomputed word graphs: "<<dirTemplate<<std::endl;
+      return THOT_ERROR;
+    }
+    tdWgPrecompVars.wgDir=&dirBuf[0];
+  }
+
+      // Set decoder parameters given in the user parameters
+  tdWgPrecompVars.stackDecoderPtr->set_S_par(tdWgPrecompVars.userPars.S);
+  tdWgPrecompVars.stackDecoderPtr->set_breadthFirst(!tdWgPrecompVars.userPars.be);
+  tdWgPrecompVars.stackDecoderPtr->set_G_par(tdWgPrecompVars.userPars.G);
+
+      // Translate sentence generating a word graph. Best score pruning
+      // is disabled as done by the assisted translators
+  tdWgPrecompVars.stackDecoderPtr->useBestScorePruning(false);
+  tdWgPrecompVars.stackDecoderRecPtr->enableWordGraph();
+  tdWgPrecompVars.stackDecoderPtr->translate(sentence);
+
+      // Store word graph
+  std::ostringstream wgFileName;
+  wgFileName<<tdWgPrecompVars.wgDir<<"/"<<tdWgPrecompVars.numWgFilesCreated<<".wgb";
+  ++tdWgPrecompVars.numWgFilesCreated;
+  WordGraph* wgPtr=tdWgPrecompVars.stackDecoderRecPtr->getWordGraphPtr();
+  int ret=wgPtr->printBin(wgFileName.str().c_str(),true);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+  pthread_mutex_lock(&wg_precomp_mut);
+  /////////// begin of word graph precomputation mutex
+
+      // Register word graph in the word graph handler
+  std::vector<WgPrecompSentFile> removedWgs;
+  tdWgPrecompVars.queue.store(sentence,wgFileName.str(),removedWgs);
+  tdCommonVars.wgHandlerPtr->addEntry(StrProcUtils::stringToStringVector(sentence),wgFileName.str());
+
+      // Remove the word graphs replaced by the new one (served word
+      // graphs are removed when the maximum number is reached)
+  for(unsigned int i=0;i<removedWgs.size();++i)
+  {
+    if(removedWgs[i].first!=sentence)
+      tdCommonVars.wgHandlerPtr->removeEntry(StrProcUtils::stringToStringVector(removedWgs[i].first));
+    remove(removedWgs[i].second.c_str());
+  }
+
+  /////////// end of word graph precomputation mutex
+  pthread_mutex_unlock(&wg_precomp_mut);
+  if(verbose)
+  {
+    StdCerrThreadSafeCond(printTid)<<"Word graph precomputed for sentence: "<<sentence<<std::endl;
+    StdCerrThreadSafeCond(printTid)<<" - #Arcs: "<<wgPtr->numArcs()<<", file: "<<wgFileName.str()<<std::endl;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------
+std::string ThotDecoder::normalizePrecompWgSent(std::string sentence)
+{
+  return StrProcUtils::stringVectorToString(StrProcUtils::stringToStringVector(sentence));
+}
+
+//--------------------------
+void ThotDecoder::markPrecompWgServed(std::string servedSent,
+                                      bool printTid)
+{
+  pthread_mutex_lock(&wg_precomp_mut);
+  /////////// begin of word graph precomputation mutex
+
+      // The word graph of the sentence can be removed from now on,
+      // which may allow the worker to continue
+  tdWgPrecompVars.queue.markServed(normalizePrecompWgSent(servedSent));
+  if(!tdWgPrecompVars.stopRequested && tdWgPrecompVars.queue.pendingSentAvailable())
+    startWgPrecompWorker(printTid);
+
+  /////////// end of word graph precomputation mutex
+  pthread_mutex_unlock(&wg_precomp_mut);
+}
+
+//--------------------------
+void ThotDecoder::refreshPrecompWgs(std::string servedSent,
+                                    int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+  pthread_mutex_lock(&wg_precomp_mut);
+  /////////// begin of word graph precomputation mutex
+
+      // The stored word graphs are still used (they are rescored with
+      // the current weights when loaded), only the ones of the next
+      // sentences to be served are obtained again with the current
+      // models
+  if(!servedSent.empty())
+    tdWgPrecompVars.queue.markServed(normalizePrecompWgSent(servedSent));
+  unsigned int numRequeued=0;
+  if(!tdWgPrecompVars.stopRequested)
+    numRequeued=tdWgPrecompVars.queue.requeueUnserved(TDEC_PRECOMP_WG_LOOKAHEAD);
+
+      // The translator is cloned again from the current models when the
+      // next sentence is processed (the worker thread is not
+      // translating since an atomic operation is being executed)
+  release_wg_precomp_translator();
+
+  if(verbose && numRequeued>0)
+    StdCerrThreadSafeCond(printTid)<<numRequeued<<" sentences queued again for word graph precomputation"<<std::endl;
+  if(!tdWgPrecompVars.stopRequested && tdWgPrecompVars.queue.pendingSentAvailable())
+    startWgPrecompWorker(printTid);
+  
+  /////////// end of word graph precomputation mutex
+  pthread_mutex_unlock(&wg_precomp_mut);
+}
+
+//--------------------------
+void ThotDecoder::stopWgPrecomp(void)
+{
+  pthread_mutex_lock(&wg_precomp_mut);
+  /////////// begin of word graph precomputation mutex
+  tdWgPrecompVars.stopRequested=true;
+  bool joinRequired=tdWgPrecompVars.workerStarted;
+  tdWgPrecompVars.workerStarted=false;
+  /////////// end of word graph precomputation mutex
+  pthread_mutex_unlock(&wg_precomp_mut);
+
+      // Wait until the sentence being translated is finished
+  if(joinRequired)
+    pthread_join(tdWgPrecompVars.workerTid,NULL);
+}
+
 //--------------------------
 void ThotDecoder::sentPairVerCov(int user_id,
                                  const char *srcSent,
@@ -2405,6 +2788,7 @@ void ThotDecoder::startCat(int user_id,
                                                                     emptyRejWordsSet,
                                                                     externalFuncVerbosity(verbose));
     catResult=postprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,aux.c_str(),tdState.caseconv);
+    markPrecompWgServed(preprocSent,printTid);
     if(verbose)
     {
       StdCerrThreadSafeCond(printTid)<<"Preprocessed sentence: "<<preprocSent<<std::endl;
@@ -2420,6 +2804,7 @@ void ThotDecoder::startCat(int user_id,
                                                                           "",
                                                                           emptyRejWordsSet,
                                                                           externalFuncVerbosity(verbose));
+    markPrecompWgServed(sentenceToTranslate,printTid);
     if(verbose)
     {
       StdCerrThreadSafeCond(printTid)<<"Translation: "<<catResult<<std::endl;
@@ -2479,13 +2864,9 @@ void ThotDecoder::addStrToPrefAux(size_t idx,
 {
   bool printTid=threadIdShouldBePrinted(verbose);
 
-  if(tdPerUserVarsVec[idx]._nbUncoupledAssistedTransPtr)
-  {
-        // Execute specific actions for uncoupled assisted translators
-        // Disable best score pruning
-    tdPerUserVarsVec[idx].stackDecoderPtr->useBestScorePruning(false);
-  }
-  
+      // Uncoupled assisted translators reuse the search space obtained
+      // in startCat(), so there is no need to disable best score
+      // pruning here
   if(totalPrefixVec[idx]=="") totalPrefixVec[idx]=strToAddToPref;
   else totalPrefixVec[idx]=totalPrefixVec[idx]+strToAddToPref;
 
@@ -2543,13 +2924,6 @@ void ThotDecoder::addStrToPrefAux(size_t idx,
       StdCerrThreadSafeCond(printTid)<<"Final output: "<<catResult<<"|"<<std::endl;
     }
   }
-
-  if(tdPerUserVarsVec[idx]._nbUncoupledAssistedTransPtr)
-  {
-        // Execute specific actions for uncoupled assisted translators
-        // Enable best score pruning
-    tdPerUserVarsVec[idx].stackDecoderPtr->useBestScorePruning(true);
-  }
 }
 
 //--------------------------
@@ -2662,15 +3036,59 @@ int ThotDecoder::use_caseconv(int user_id,
   return ret;
 }
 
+//--------------------------
+bool ThotDecoder::getWordGraphSize(int user_id,
+                                   size_t& numStates,
+                                   size_t& numArcs)
+{
+      // Increase non_atomic_ops_running variable
+  increase_non_atomic_ops_running();
+
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+
+  pthread_mutex_lock(&per_user_mut[idx]);
+  /////////// begin of user mutex
+
+  bool ret=THOT_ERROR;
+  numStates=0;
+  numArcs=0;
+      // The word graph used by the assisted translator may have been
+      // obtained from the word graph handler instead of the decoder
+  const WordGraph* wgPtr=NULL;
+  if(tdPerUserVarsVec[idx].wgUncoupledAssistedTransPtr)
+    wgPtr=tdPerUserVarsVec[idx].wgUncoupledAssistedTransPtr->getWordGraphPtr();
+  if(wgPtr==NULL && tdPerUserVarsVec[idx].stackDecoderRecPtr)
+    wgPtr=tdPerUserVarsVec[idx].stackDecoderRecPtr->getWordGraphPtr();
+  if(wgPtr)
+  {
+    numStates=wgPtr->numStates();
+    numArcs=wgPtr->numArcs();
+    ret=THOT_OK;
+  }
+
+  /////////// end of user mutex 
+  pthread_mutex_unlock(&per_user_mut[idx]);
+
+      // Decrease non_atomic_ops_running variable
+  decrease_non_atomic_ops_running();
+
+  return ret;
+}
+
 //--------------------------
 void ThotDecoder::clearTrans(int /*verbose=0*/)
 {
+      // Stop word graph precomputation
+  stopWgPrecomp();
+
   pthread_mutex_lock(&atomic_op_mut);
   /////////// begin of mutex 
 
       // Wait until all non-atomic operations have finished
   wait_on_non_atomic_op_cond();
 
+  release_wg_precomp_data();
   tdCommonVars.wgHandlerPtr->clear();
   tdCommonVars.smtModelPtr->clear();
   tdCommonVars.ecModelPtr->clear();
@@ -3285,6 +3703,7 @@ void ThotDecoder::destroy_feat_impl(void)
   pthread_mutex_destroy(&atomic_op_mut);
   pthread_mutex_destroy(&non_atomic_op_mut);
   pthread_mutex_destroy(&preproc_mut);
+  pthread_mutex_destroy(&wg_precomp_mut);
   pthread_cond_destroy(&non_atomic_op_cond);
   for(unsigned int i=0;i<per_user_mut.size();++i)
     pthread_mutex_destroy(&per_user_mut[i]);
@@ -3319,6 +3738,7 @@ void ThotDecoder::destroy_legacy_impl(void)
   pthread_mutex_destroy(&atomic_op_mut);
   pthread_mutex_destroy(&non_atomic_op_mut);
   pthread_mutex_destroy(&preproc_mut);
+  pthread_mutex_destroy(&wg_precomp_mut);
   pthread_cond_destroy(&non_atomic_op_cond);
   for(unsigned int i=0;i<per_user_mut.size();++i)
     pthread_mutex_destroy(&per_user_mut[i]);
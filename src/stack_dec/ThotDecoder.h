@@ -53,6 +53,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "ThotDecoderPerUserVars.h"
 #include "ThotDecoderState.h"
 #include "ThotDecoderUserPars.h"
+#include "ThotDecoderWgPrecompVars.h"
 #include "ModelDescriptorUtils.h"
 
 #include "StdCerrThreadSafePrint.h"
@@ -76,6 +77,16 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
                                            // a word using the word
                                            // predictor
 
+#define TDEC_MAX_PRECOMP_WGS        256  // Maximum number of
+                                           // precomputed word graphs
+                                           // stored, the precomputation
+                                           // is paused when reached by
+                                           // word graphs not served yet
+
+#define TDEC_PRECOMP_WG_LOOKAHEAD     4  // Number of precomputed word
+                                           // graphs obtained again when
+                                           // the models are trained
+
 #define THOTDEC_NON_VERBOSE_MODE      0
 #define THOTDEC_NORMAL_VERBOSE_MODE   1
 #define THOTDEC_DEBUG_VERBOSE_MODE    2
@@ -149,10 +160,29 @@ class ThotDecoder
                int verbose=0);
   void resetPrefix(int user_id,
                    int verbose=0);
+  int precomputeWordGraphs(int user_id,
+                           const std::vector<std::string>& sentences,
+                           int verbose=0);
+      // Queues the given sentences so as to translate them in the
+      // background. The resulting word graphs are stored in the word
+      // graph handler, to be used when the sentences are translated
+      // later. Returns the number of sentences queued. The word graphs
+      // of the next sentences are precomputed again when the models
+      // are trained
   int use_caseconv(int user_id,
                     const char *caseConvFile,
                     int verbose=0);
   
+      // Word graph-related functions
+  bool getWordGraphSize(int user_id,
+                        size_t& numStates,
+                        size_t& numArcs);
+      // Obtains the size of the word graph used by the assisted
+      // translator of the given user in its last translation (or the
+      // one generated by its decoder if the assisted translator is not
+      // based on word graphs). Returns THOT_ERROR if the decoder does
+      // not generate word graphs
+
       // Clear translator data structures
   void clearTrans(int verbose=0);
 
@@ -184,6 +214,10 @@ class ThotDecoder
   pthread_cond_t non_atomic_op_cond;
   unsigned int non_atomic_ops_running;
   std::vector<pthread_mutex_t> per_user_mut;
+  pthread_mutex_t wg_precomp_mut;
+
+      // Word graph precomputation variables
+  ThotDecoderWgPrecompVars tdWgPrecompVars;
   
       // Mutex- and condition-related functions
   void wait_on_non_atomic_op_cond(void);
@@ -284,6 +318,27 @@ class ThotDecoder
   size_t get_vecidx_for_user_id(int user_id);
   int init_idx_data(size_t idx);
   void release_idx_data(size_t idx);
+  int init_wg_precomp_data(void);
+  void release_wg_precomp_translator(void);
+  void release_wg_precomp_data(void);
+
+      // Functions to precompute word graphs in the background
+  static void* wgPrecompWorker(void* thotDecoderPtr);
+  void processPendingWgPrecompSents(void);
+  int precomputeWordGraph(std::string sentence,
+                          int verbose=0);
+  void startWgPrecompWorker(bool printTid);
+  std::string normalizePrecompWgSent(std::string sentence);
+  void markPrecompWgServed(std::string servedSent,
+                           bool printTid);
+      // Allows the word graph precomputed for servedSent to be removed
+  void refreshPrecompWgs(std::string servedSent,
+                         int verbose=0);
+      // Marks servedSent as served and queues again the next
+      // TDEC_PRECOMP_WG_LOOKAHEAD sentences whose word graphs have been
+      // precomputed, so as to obtain them with the current models. This
+      // function must be called while executing an atomic operation
+  void stopWgPrecomp(void);
 
       // Auxiliary functions for translation
   std::string translateSentenceAux(size_t idx,
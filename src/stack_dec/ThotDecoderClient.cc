@@ -196,6 +196,26 @@ void ThotDecoderClient::resetPref(int user_id)
   }        
 }
 
+//--------------------------
+void ThotDecoderClient::sendSentsForWgPrecomp(int user_id,
+                                              const std::vector<std::string>& sentences,
+                                              int& numQueued)
+{
+  if(connected)
+  {
+    BasicSocketUtils::writeInt(fileDesc,PRECOMPUTE_WGS);
+    BasicSocketUtils::writeInt(fileDesc,user_id);
+    BasicSocketUtils::writeInt(fileDesc,sentences.size());
+    for(unsigned int i=0;i<sentences.size();++i)
+      BasicSocketUtils::writeStr(fileDesc,sentences[i].c_str());
+    numQueued=BasicSocketUtils::recvInt(fileDesc);
+  }
+  else
+  {
+    throw std::runtime_error("ThotDecoderClient not connected");        
+  }
+}
+
 //--------------------------
 void ThotDecoderClient::sendPrintRequest(int user_id)
 {
@@ -36,6 +36,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <BasicSocketUtils.h>
 #include <StrProcUtils.h>
 #include <string>
+#include <vector>
 #include <iostream>
 
 //--------------- Constants ------------------------------------------
@@ -80,6 +81,9 @@ class ThotDecoderClient
                       const char* strToAddToPref,
                       std::string &translatedSentence);
     void resetPref(int user_id);
+    void sendSentsForWgPrecomp(int user_id,
+                               const std::vector<std::string>& sentences,
+                               int& numQueued);
     void sendPrintRequest(int user_id);
     void sendEndServerRequest(int user_id);
     void disconnect(int user_id);
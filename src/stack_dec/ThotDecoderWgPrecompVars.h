@@ -0,0 +1,81 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ThotDecoderWgPrecompVars_h
+#define _ThotDecoderWgPrecompVars_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BaseTranslationMetadata.h"
+#include "_stackDecoderRec.h"
+#include "BaseStackDecoder.h"
+#include THOT_SMTMODEL_H // Define SmtModel type. It is set in
+                              // configure by checking SMTMODEL_H
+                              // variable (default value: SmtModel.h)
+#include "ThotDecoderUserPars.h"
+#include "WgPrecompQueue.h"
+#include <pthread.h>
+#include <string>
+
+//--------------- Classes --------------------------------------------
+
+class ThotDecoderWgPrecompVars
+{
+ public:
+      // Translator used by the background worker, it is created the
+      // first time a sentence is processed
+  BasePbTransModel<SmtModel::Hypothesis>* smtModelPtr;
+  BaseStackDecoder<SmtModel>* stackDecoderPtr;
+  _stackDecoderRec<SmtModel>* stackDecoderRecPtr;
+  BaseTranslationMetadata<SmtModel::HypScoreInfo>* trMetadataPtr;
+  ThotDecoderUserPars userPars;
+
+      // Preprocessed sentences that have been requested, together with
+      // the files of their word graphs
+  WgPrecompQueue queue;
+
+      // Directory where the word graphs are stored
+  std::string wgDir;
+  unsigned int numWgFilesCreated;
+
+      // Worker thread state
+  pthread_t workerTid;
+  bool workerStarted;
+  bool workerRunning;
+  bool stopRequested;
+  int verbose;
+
+  ThotDecoderWgPrecompVars()
+    {
+      smtModelPtr=NULL;
+      stackDecoderPtr=NULL;
+      stackDecoderRecPtr=NULL;
+      trMetadataPtr=NULL;
+      numWgFilesCreated=0;
+      workerStarted=false;
+      workerRunning=false;
+      stopRequested=false;
+      verbose=0;
+    }
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgPrecompQueue.cc
+ *
+ * @brief Definitions file for WgPrecompQueue.h
+ */
+
+//--------------- Include files ---------------------------------------
+
+#include "WgPrecompQueue.h"
+#include <algorithm>
+
+//--------------- Classes ---------------------------------------------
+
+//-------------------------
+WgPrecompQueue::WgPrecompQueue(void)
+{
+  maxStoredWgs=1;
+}
+
+//-------------------------
+void WgPrecompQueue::setMaxStoredWgs(unsigned int _maxStoredWgs)
+{
+  maxStoredWgs=_maxStoredWgs;
+}
+
+//-------------------------
+bool WgPrecompQueue::request(const std::string& sentence)
+{
+  if(requestedSents.find(sentence)!=requestedSents.end())
+    return false;
+
+  pendingSents.push_back(sentence);
+  requestedSents.insert(sentence);
+  return true;
+}
+
+//-------------------------
+bool WgPrecompQueue::nextPendingSent(std::string& sentence)
+{
+  if(!pendingSentAvailable())
+    return false;
+
+  sentence=pendingSents.front();
+  pendingSents.pop_front();
+  sentsBeingTranslated.insert(sentence);
+  return true;
+}
+
+//-------------------------
+bool WgPrecompQueue::pendingSentAvailable(void)const
+{
+  return !pendingSents.empty() && roomForWg(pendingSents.front());
+}
+
+//-------------------------
+void WgPrecompQueue::cancel(const std::string& sentence)
+{
+  sentsBeingTranslated.erase(sentence);
+
+      // Keep the word graph previously stored for the sentence if any
+  if(!isStored(sentence))
+    removeSent(sentence);
+}
+
+//-------------------------
+void WgPrecompQueue::store(const std::string& sentence,
+                           const std::string& wgFile,
+                           std::vector<WgPrecompSentFile>& removedWgs)
+{
+  removedWgs.clear();
+  sentsBeingTranslated.erase(sentence);
+
+      // Replace the word graph of the sentence if it was already stored
+  std::deque<WgPrecompSentFile>::iterator wgIter=findStoredWg(sentence);
+  if(wgIter!=storedWgs.end())
+  {
+    removedWgs.push_back(*wgIter);
+    wgIter->second=wgFile;
+    return;
+  }
+
+      // Remove the oldest served word graphs if the maximum number has
+      // been reached (nextPendingSent() ensures that they exist)
+  while(!storedWgs.empty() && storedWgs.size()>=maxStoredWgs)
+  {
+    wgIter=storedWgs.begin();
+    while(wgIter!=storedWgs.end() && servedSents.find(wgIter->first)==servedSents.end())
+      ++wgIter;
+    if(wgIter==storedWgs.end())
+      wgIter=storedWgs.begin();
+    removedWgs.push_back(*wgIter);
+    std::string removedSent=wgIter->first;
+    storedWgs.erase(wgIter);
+    removeSent(removedSent);
+  }
+  storedWgs.push_back(std::make_pair(sentence,wgFile));
+}
+
+//-------------------------
+void WgPrecompQueue::markServed(const std::string& sentence)
+{
+  if(requestedSents.find(sentence)==requestedSents.end())
+    return;
+
+      // The sentence does not need to be translated anymore
+  std::deque<std::string>::iterator pendIter=std::find(pendingSents.begin(),pendingSents.end(),sentence);
+  if(pendIter!=pendingSents.end())
+    pendingSents.erase(pendIter);
+
+  if(isStored(sentence) || sentsBeingTranslated.find(sentence)!=sentsBeingTranslated.end())
+    servedSents.insert(sentence);
+  else
+    requestedSents.erase(sentence);
+}
+
+//-------------------------
+unsigned int WgPrecompQueue::requeueUnserved(unsigned int maxSents)
+{
+      // Sentences of the window that are already pending or being
+      // translated are not queued again
+  std::vector<std::string> sentsToRequeue;
+  unsigned int numUnserved=0;
+  for(std::deque<WgPrecompSentFile>::const_iterator wgIter=storedWgs.begin();wgIter!=storedWgs.end() && numUnserved<maxSents;++wgIter)
+  {
+    const std::string& sentence=wgIter->first;
+    if(servedSents.find(sentence)==servedSents.end())
+    {
+      ++numUnserved;
+      if(sentsBeingTranslated.find(sentence)==sentsBeingTranslated.end() &&
+         std::find(pendingSents.begin(),pendingSents.end(),sentence)==pendingSents.end())
+        sentsToRequeue.push_back(sentence);
+    }
+  }
+  pendingSents.insert(pendingSents.begin(),sentsToRequeue.begin(),sentsToRequeue.end());
+  return sentsToRequeue.size();
+}
+
+//-------------------------
+void WgPrecompQueue::clear(std::vector<WgPrecompSentFile>& removedWgs)
+{
+  removedWgs.assign(storedWgs.begin(),storedWgs.end());
+  pendingSents.clear();
+  sentsBeingTranslated.clear();
+  requestedSents.clear();
+  storedWgs.clear();
+  servedSents.clear();
+}
+
+//-------------------------
+size_t WgPrecompQueue::numPendingSents(void)const
+{
+  return pendingSents.size();
+}
+
+//-------------------------
+size_t WgPrecompQueue::numStoredWgs(void)const
+{
+  return storedWgs.size();
+}
+
+//-------------------------
+size_t WgPrecompQueue::numUnservedWgs(void)const
+{
+  size_t result=0;
+  for(std::deque<WgPrecompSentFile>::const_iterator wgIter=storedWgs.begin();wgIter!=storedWgs.end();++wgIter)
+  {
+    if(servedSents.find(wgIter->first)==servedSents.end())
+      ++result;
+  }
+  return result;
+}
+
+//-------------------------
+std::deque<WgPrecompSentFile>::iterator WgPrecompQueue::findStoredWg(const std::string& sentence)
+{
+  std::deque<WgPrecompSentFile>::iterator wgIter;
+  for(wgIter=storedWgs.begin();wgIter!=storedWgs.end();++wgIter)
+  {
+    if(wgIter->first==sentence)
+      break;
+  }
+  return wgIter;
+}
+
+//-------------------------
+bool WgPrecompQueue::isStored(const std::string& sentence)const
+{
+  for(std::deque<WgPrecompSentFile>::const_iterator wgIter=storedWgs.begin();wgIter!=storedWgs.end();++wgIter)
+  {
+    if(wgIter->first==sentence)
+      return true;
+  }
+  return false;
+}
+
+//-------------------------
+bool WgPrecompQueue::roomForWg(const std::string& sentence)const
+{
+      // A new word graph of a stored sentence replaces the previous one
+  if(isStored(sentence))
+    return true;
+
+      // Only the word graphs that have not been served are kept, the
+      // ones being obtained for new sentences are also taken into
+      // account
+  size_t numKeptWgs=numUnservedWgs();
+  std::set<std::string>::const_iterator sentIter;
+  for(sentIter=sentsBeingTranslated.begin();sentIter!=sentsBeingTranslated.end();++sentIter)
+  {
+    if(!isStored(*sentIter) && servedSents.find(*sentIter)==servedSents.end())
+      ++numKeptWgs;
+  }
+  return numKeptWgs<maxStoredWgs;
+}
+
+//-------------------------
+void WgPrecompQueue::removeSent(const std::string& sentence)
+{
+  std::deque<std::string>::iterator pendIter=std::find(pendingSents.begin(),pendingSents.end(),sentence);
+  if(pendIter!=pendingSents.end())
+    pendingSents.erase(pendIter);
+  requestedSents.erase(sentence);
+  servedSents.erase(sentence);
+}
@@ -0,0 +1,130 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgPrecompQueue.h
+ *
+ * @brief The WgPrecompQueue class keeps track of the sentences whose
+ * word graphs are precomputed in the background, from the moment they
+ * are requested until their word graphs are removed.
+ */
+
+#ifndef _WgPrecompQueue_h
+#define _WgPrecompQueue_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <deque>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+//--------------- typedefs -------------------------------------------
+
+    // Sentence and file of a stored word graph
+typedef std::pair<std::string,std::string> WgPrecompSentFile;
+
+//--------------- WgPrecompQueue class
+
+/**
+ * @brief Queue of sentences whose word graphs are precomputed. At most
+ * maxStoredWgs word graphs are kept, only the word graphs of the
+ * sentences that have already been served can be removed to make room
+ * for new ones. The precomputation is paused while the limit is
+ * reached with word graphs that have not been served. This class is
+ * not thread safe.
+ */
+
+class WgPrecompQueue
+{
+ public:
+
+      // Constructor
+  WgPrecompQueue(void);
+
+      // Basic functions
+  void setMaxStoredWgs(unsigned int _maxStoredWgs);
+  bool request(const std::string& sentence);
+      // Queues the given sentence if it has not been requested
+      // before. Returns true if the sentence was queued
+  bool nextPendingSent(std::string& sentence);
+      // Obtains the next sentence to be translated. Returns false if
+      // there are no pending sentences or there is no room to store
+      // its word graph
+  bool pendingSentAvailable(void)const;
+      // Returns true if nextPendingSent() would obtain a sentence
+  void cancel(const std::string& sentence);
+      // Finishes the translation of a sentence whose word graph could
+      // not be obtained, the sentence can be requested again
+  void store(const std::string& sentence,
+             const std::string& wgFile,
+             std::vector<WgPrecompSentFile>& removedWgs);
+      // Stores the word graph file of a sentence obtained by means of
+      // nextPendingSent(). removedWgs contains the word graphs that
+      // are no longer stored (the previous word graph of the sentence
+      // or served word graphs removed to make room for the new one)
+  void markServed(const std::string& sentence);
+      // Marks the sentence as served, its word graph can be removed
+      // from now on and it is not translated if it is still pending
+  unsigned int requeueUnserved(unsigned int maxSents);
+      // Queues again the first maxSents stored sentences that have not
+      // been served, ahead of the rest of pending sentences. Their
+      // word graphs are kept until they are replaced. Returns the
+      // number of sentences queued
+  void clear(std::vector<WgPrecompSentFile>& removedWgs);
+      // Removes all sentences, removedWgs contains the word graphs
+      // that were stored
+
+      // Size related functions
+  size_t numPendingSents(void)const;
+  size_t numStoredWgs(void)const;
+  size_t numUnservedWgs(void)const;
+
+ protected:
+
+  unsigned int maxStoredWgs;
+
+      // Sentences pending to be translated
+  std::deque<std::string> pendingSents;
+
+      // Sentences being translated
+  std::set<std::string> sentsBeingTranslated;
+
+      // Sentences that are pending, being translated or stored
+  std::set<std::string> requestedSents;
+
+      // Sentences whose word graphs have been stored, from the oldest to
+      // the newest
+  std::deque<WgPrecompSentFile> storedWgs;
+
+      // Sentences being translated or stored that have been served
+  std::set<std::string> servedSents;
+
+      // Auxiliary functions
+  std::deque<WgPrecompSentFile>::iterator findStoredWg(const std::string& sentence);
+  bool isStored(const std::string& sentence)const;
+  bool roomForWg(const std::string& sentence)const;
+  void removeSent(const std::string& sentence);
+};
+
+#endif
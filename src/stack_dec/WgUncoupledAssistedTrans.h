@@ -89,6 +89,12 @@ class WgUncoupledAssistedTrans: public _assistedTrans<SMT_MODEL>
       // Sets the word-graph pruning parameter used in uncoupled
       // assisted translation
 
+  const WordGraph* getWordGraphPtr(void)const;
+      // Returns a pointer to the word-graph used in the last call to
+      // translateWithPrefix() (obtained from the word-graph handler or
+      // generated by the translator), or NULL if no sentence has been
+      // translated
+
       // Model weights functions
   void setWeights(std::vector<float> wVec);
   unsigned int getNumWeights(void);
@@ -114,6 +120,9 @@ class WgUncoupledAssistedTrans: public _assistedTrans<SMT_MODEL>
                       // handler
   
   WgHandler* wgh_ptr; // Pointer to a word-graph handler
+
+  WordGraph* used_wg_ptr; // Pointer to the word-graph used in the last
+                          // translation
   
   float psutw;                   // Weight for the p(s|u,t) model used
                                  // in CAT
@@ -152,6 +161,7 @@ WgUncoupledAssistedTrans<SMT_MODEL>::WgUncoupledAssistedTrans(void):_assistedTra
   sdr_ptr=NULL;
   wgp_ptr=NULL;
   wgh_ptr=NULL;
+  used_wg_ptr=NULL;
 
       // Create pointer to wordgraph
   wg_ptr=new WordGraph;
@@ -210,6 +220,7 @@ std::string WgUncoupledAssistedTrans<SMT_MODEL>::translateWithPrefix(std::string
   
       // Initialize word-graph processor with word-graph
   wgp_ptr->link_wg(wg_ptr_aux);
+  used_wg_ptr=wg_ptr_aux;
   if(verbose)
   {
     std::cerr<<"Linking word-graph with word-graph processor,";
@@ -265,9 +276,17 @@ WgUncoupledAssistedTrans<SMT_MODEL>::obtainWgUsingWgHandler(std::string s,
   std::string wgPathStr=wgh_ptr->pathAssociatedToSentence(sentStrVec,found);
   if(found)
   {
-        // Load word graph
+        // Load word graph, the sentence is translated again if the
+        // file is not available (precomputed word graphs can be
+        // removed by the background worker after the query)
     wg_ptr->clear();
-    wg_ptr->load(wgPathStr.c_str());
+    if(wg_ptr->load(wgPathStr.c_str())==THOT_ERROR)
+    {
+      if(verbose)
+        std::cerr<<"Word graph could not be loaded from "<<wgPathStr<<", the sentence will be translated"<<std::endl;
+      wg_ptr->clear();
+      return NULL;
+    }
 
         // Obtain original word graph component weights
     std::vector<std::pair<std::string,float> > originalWgCompWeights;
@@ -421,4 +440,11 @@ void WgUncoupledAssistedTrans<SMT_MODEL>::set_wgp(float _wgp)
   wgp=_wgp;
 }
 
+//---------------------------------
+template<class SMT_MODEL>
+const WordGraph* WgUncoupledAssistedTrans<SMT_MODEL>::getWordGraphPtr(void)const
+{
+  return used_wg_ptr;
+}
+
 #endif
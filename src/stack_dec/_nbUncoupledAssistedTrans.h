@@ -67,11 +67,14 @@ class _nbUncoupledAssistedTrans: public _assistedTrans<SMT_MODEL>
                                           std::string pref,
                                           const RejectedWordsSet& rejectedWords=RejectedWordsSet(),
                                           unsigned int verbose=0)=0;
-      // Translates std::string s using pref as prefix, uncoupled version
+      // Translates std::string s using pref as prefix, uncoupled
+      // version. This is the only function that is expected to carry
+      // out a search for the sentence
   virtual std::string addStrToPrefix(std::string s,
                                      const RejectedWordsSet& rejectedWords=RejectedWordsSet(),
                                      unsigned int verbose=0)=0;
-      // Adds the string 's' to the user prefix
+      // Adds the string 's' to the user prefix, the search space
+      // obtained by translateWithPrefix() is reused
   virtual void resetPrefix(void)=0;
       // Resets the prefix
 
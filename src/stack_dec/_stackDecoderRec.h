@@ -78,9 +78,18 @@ class _stackDecoderRec: public _stackDecoder<SMT_MODEL>
   unsigned int pruneWordGraph(float threshold);
       // Prune word graph using the given threshold. Returns number of
       // pruned arcs
+  unsigned int pruneWordGraphGivenDensity(float density,
+                                          unsigned int numSrcWords);
+      // Prune word graph using arc posteriors so as to retain about
+      // density*numSrcWords arcs. Returns number of pruned arcs
      
       // Functions to print word graphs
-  bool printWordGraph(const char* filename);
+  bool printWordGraph(const char* filename,
+                      bool binary=false);
+      // Prints the word graph to the file filename.wg, or to
+      // filename.wgb in binary format if binary is true. The
+      // information about the hypothesis states is printed to
+      // filename.idx
   
 
   void clear(void);
@@ -187,7 +196,18 @@ unsigned int _stackDecoderRec<SMT_MODEL>::pruneWordGraph(float threshold)
 
 //---------------------------------------
 template<class SMT_MODEL>
-bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename)
+unsigned int _stackDecoderRec<SMT_MODEL>::pruneWordGraphGivenDensity(float density,
+                                                                     unsigned int numSrcWords)
+{
+      // Prune word graph
+  unsigned int numPrunedArcs=wordGraphPtr->pruneGivenDensity(density,numSrcWords);
+  return numPrunedArcs;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename,
+                                                 bool binary/*=false*/)
 {
   int ret;
 
@@ -201,8 +221,16 @@ bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename)
   }
       // Print word graph
   std::string filenameWordGraph=filename;
-  filenameWordGraph=filenameWordGraph+".wg";
-  ret=wordGraphPtr->print(filenameWordGraph.c_str(),true);
+  if(binary)
+  {
+    filenameWordGraph=filenameWordGraph+".wgb";
+    ret=wordGraphPtr->printBin(filenameWordGraph.c_str(),true);
+  }
+  else
+  {
+    filenameWordGraph=filenameWordGraph+".wg";
+    ret=wordGraphPtr->print(filenameWordGraph.c_str(),true);
+  }
       // NOTE: if the second parameter of wordGraphPtr->print() is set to
       // true, only useful states (those that allow us to reach to a
       // final state) are printed
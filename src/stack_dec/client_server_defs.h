@@ -48,5 +48,6 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define PRINT_MODELS              9
 #define END_CLIENT_DIALOG        10
 #define END_SERVER               11
+#define PRECOMPUTE_WGS           12
 
 #endif
@@ -0,0 +1,593 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_imt.cc
+ *
+ * @brief Benchmark for the interactive machine translation services
+ * of the ThotDecoder class. Post-editing sessions are simulated from
+ * reference translations (following the protocol of the
+ * thot_cat_using_client.sh script, with occasional typing errors
+ * corrected with backspaces and word rejections), or replayed from a
+ * recorded session log. The latency of each operation, the size of
+ * the word graphs and the KSMR are reported.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ThotDecoder.h"
+#include "ErrorDefs.h"
+#include "StrProcUtils.h"
+#include "ctimer.h"
+#include "options.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define BENCH_USER_ID          0
+#define MAX_ITERS            200
+
+#define START_CAT_OP           0
+#define ADD_STR_TO_PREF_OP     1
+#define SET_PREF_OP            2
+#define RESET_PREF_OP          3
+#define NUM_OPS                4
+
+//--------------- Type definitions -----------------------------------
+
+struct KsmrCounts
+{
+  unsigned int keyStrokes;
+  unsigned int mouseActions;
+  unsigned int acceptances;
+  unsigned int chars;
+  unsigned int numSents;
+  unsigned int numUnfinishedSents;
+
+  KsmrCounts()
+    {
+      keyStrokes=0;
+      mouseActions=0;
+      acceptances=0;
+      chars=0;
+      numSents=0;
+      numUnfinishedSents=0;
+    }
+};
+
+//--------------- Function Declarations ------------------------------
+
+int simulateSessions(ThotDecoder& thotDecoder,
+                     const std::vector<std::string>& srcSents,
+                     const std::vector<std::string>& refSents,
+                     KsmrCounts& ksmrCounts);
+int replaySessions(ThotDecoder& thotDecoder,
+                   const std::vector<std::string>& logLines);
+std::string timedStartCat(ThotDecoder& thotDecoder,
+                          const std::string& srcSent);
+std::string timedAddStrToPref(ThotDecoder& thotDecoder,
+                              const std::string& str);
+std::string timedSetPref(ThotDecoder& thotDecoder,
+                         const std::string& pref,
+                         const RejectedWordsSet& rejectedWords);
+void timedResetPrefix(ThotDecoder& thotDecoder);
+std::string extendPref(const std::string& ref,
+                       const std::string& hyp);
+std::string nextWord(const std::string& sent,
+                     const std::string& pref);
+size_t utf8CharLen(const std::string& str,
+                   size_t pos);
+size_t numUtf8Chars(const std::string& str);
+bool randomEvent(float prob);
+void printLatencyStats(void);
+void printSizeStats(const char* name,
+                    std::vector<size_t> values);
+double percentile(const std::vector<double>& sortedValues,
+                  double p);
+int loadLines(const char* fileName,
+              std::vector<std::string>& lines);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string cfgFileName;
+std::string srcFileName;
+std::string refFileName;
+std::string logFileName;
+float bsProb=0.05;
+float rjProb=0.05;
+unsigned int seed=31415;
+int verbose=0;
+
+const char* opNames[NUM_OPS]={"startCat","addStrToPref","setPref","resetPrefix"};
+std::vector<double> opLatencies[NUM_OPS];
+std::vector<size_t> wgNumStates;
+std::vector<size_t> wgNumArcs;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_ERROR)
+    return THOT_ERROR;
+
+  srand(seed);
+
+      // Load input files
+  std::vector<std::string> srcSents;
+  std::vector<std::string> refSents;
+  std::vector<std::string> logLines;
+  if(!logFileName.empty())
+  {
+    if(loadLines(logFileName.c_str(),logLines)==THOT_ERROR)
+      return THOT_ERROR;
+  }
+  else
+  {
+    if(loadLines(srcFileName.c_str(),srcSents)==THOT_ERROR)
+      return THOT_ERROR;
+    if(loadLines(refFileName.c_str(),refSents)==THOT_ERROR)
+      return THOT_ERROR;
+    if(srcSents.size()!=refSents.size())
+    {
+      std::cerr<<"Error: the number of source and reference sentences differ"<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+      // Initialize decoder
+  ThotDecoder thotDecoder;
+  ThotDecoderUserPars tdup;
+  int ret=thotDecoder.initUsingCfgFile(cfgFileName,tdup,verbose);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+  ret=thotDecoder.initUserPars(BENCH_USER_ID,tdup,verbose);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Process sessions
+  KsmrCounts ksmrCounts;
+  double elapsed_ant,elapsed,ucpu,scpu;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  if(!logFileName.empty())
+    ret=replaySessions(thotDecoder,logLines);
+  else
+    ret=simulateSessions(thotDecoder,srcSents,refSents,ksmrCounts);
+  ctimer(&elapsed,&ucpu,&scpu);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Print results
+  printf("Total time: %g s\n\n",elapsed-elapsed_ant);
+  printLatencyStats();
+  printf("\n");
+  printSizeStats("Word graph states",wgNumStates);
+  printSizeStats("Word graph arcs",wgNumArcs);
+  if(logFileName.empty())
+  {
+    printf("\nSentences: %u ; unfinished: %u\n",ksmrCounts.numSents,ksmrCounts.numUnfinishedSents);
+    if(ksmrCounts.chars>0)
+    {
+      printf("KSMR (KS+MA+MAacc/CHARS): %.2f (%u+%u+%u/%u)\n",
+             100.0*(ksmrCounts.keyStrokes+ksmrCounts.mouseActions+ksmrCounts.acceptances)/ksmrCounts.chars,
+             ksmrCounts.keyStrokes,ksmrCounts.mouseActions,ksmrCounts.acceptances,ksmrCounts.chars);
+      printf("KSR (KS/CHARS): %.2f (%u/%u)\n",
+             100.0*ksmrCounts.keyStrokes/ksmrCounts.chars,
+             ksmrCounts.keyStrokes,ksmrCounts.chars);
+    }
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+int simulateSessions(ThotDecoder& thotDecoder,
+                     const std::vector<std::string>& srcSents,
+                     const std::vector<std::string>& refSents,
+                     KsmrCounts& ksmrCounts)
+{
+  for(unsigned int n=0;n<srcSents.size();++n)
+  {
+    const std::string& ref=refSents[n];
+    if(verbose)
+    {
+      std::cerr<<"Sentence "<<n+1<<std::endl;
+      std::cerr<<" - source: "<<srcSents[n]<<std::endl;
+      std::cerr<<" - reference: "<<ref<<std::endl;
+    }
+
+        // Initial iteration
+    std::string hyp=timedStartCat(thotDecoder,srcSents[n]);
+    if(verbose) std::cerr<<" - hyp: "<<hyp<<std::endl;
+
+        // Following iterations
+    unsigned int keyStrokes=0;
+    unsigned int mouseActions=0;
+    unsigned int iter=1;
+    std::string prev;
+    RejectedWordsSet rejectedWords;
+    bool rejectionTried=false;
+    while(!StrProcUtils::isPrefix(ref,hyp) && iter<MAX_ITERS)
+    {
+      ++iter;
+
+          // Reject the next word of the hypothesis if it is wrong (at
+          // most once for each prefix)
+      if(!rejectionTried && (prev.empty() || prev[prev.size()-1]==' '))
+      {
+        rejectionTried=true;
+        std::string hypWord=nextWord(hyp,prev);
+        if(randomEvent(rjProb) && !hypWord.empty() && hypWord!=nextWord(ref,prev))
+        {
+          rejectedWords.insert(std::make_pair("",hypWord));
+          ++mouseActions;
+          hyp=timedSetPref(thotDecoder,prev,rejectedWords);
+          if(verbose) std::cerr<<" - hyp (after rejecting \""<<hypWord<<"\"): "<<hyp<<std::endl;
+          continue;
+        }
+      }
+
+          // Compute new prefix, the user accepts the longest common
+          // prefix of the hypothesis and the reference and types one
+          // character
+      std::string newPref=extendPref(ref,hyp);
+      if(newPref.size()<=prev.size() || !StrProcUtils::isPrefix(prev,newPref))
+        newPref=extendPref(ref,prev);
+      size_t acceptedLen=newPref.size();
+      if(acceptedLen>prev.size())
+      {
+        --acceptedLen;
+        while(acceptedLen>prev.size() && (newPref[acceptedLen]&0xC0)==0x80)
+          --acceptedLen;
+      }
+      if(numUtf8Chars(newPref)-numUtf8Chars(prev)>1)
+        ++mouseActions;
+
+          // Type a wrong character and delete it with a backspace
+      if(randomEvent(bsProb))
+      {
+        std::string wrongChar=(newPref.substr(acceptedLen)=="x")?"y":"x";
+        timedAddStrToPref(thotDecoder,newPref.substr(prev.size(),acceptedLen-prev.size())+wrongChar);
+        if(acceptedLen==0)
+          timedResetPrefix(thotDecoder);
+        else
+          timedSetPref(thotDecoder,newPref.substr(0,acceptedLen),RejectedWordsSet());
+        keyStrokes+=2;
+        prev=newPref.substr(0,acceptedLen);
+      }
+
+          // Append new string to the prefix
+      ++keyStrokes;
+      hyp=timedAddStrToPref(thotDecoder,newPref.substr(prev.size()));
+      if(verbose) std::cerr<<" - hyp (prefix \""<<newPref<<"\"): "<<hyp<<std::endl;
+      prev=newPref;
+      rejectedWords.clear();
+      rejectionTried=false;
+    }
+
+        // Update counts
+    ++ksmrCounts.numSents;
+    if(iter<MAX_ITERS)
+    {
+      ksmrCounts.keyStrokes+=keyStrokes;
+      ksmrCounts.mouseActions+=mouseActions;
+      ++ksmrCounts.acceptances;
+      ksmrCounts.chars+=numUtf8Chars(ref);
+    }
+    else
+    {
+      std::cerr<<"Warning: maximum number of iterations exceeded for sentence number "<<n+1<<std::endl;
+      ++ksmrCounts.numUnfinishedSents;
+    }
+  }
+  return THOT_OK;
+}
+
+//---------------
+int replaySessions(ThotDecoder& thotDecoder,
+                   const std::vector<std::string>& logLines)
+{
+  for(unsigned int i=0;i<logLines.size();++i)
+  {
+        // Obtain operation and its argument
+    std::string op=logLines[i].substr(0,2);
+    std::string arg;
+    if(logLines[i].size()>3)
+      arg=logLines[i].substr(3);
+
+    std::string hyp;
+    if(op=="sc")
+      hyp=timedStartCat(thotDecoder,arg);
+    else if(op=="ap")
+      hyp=timedAddStrToPref(thotDecoder,arg);
+    else if(op=="sp")
+      hyp=timedSetPref(thotDecoder,arg,RejectedWordsSet());
+    else if(op=="rp")
+      timedResetPrefix(thotDecoder);
+    else
+    {
+      std::cerr<<"Error: unknown operation in line "<<i+1<<" of session log: "<<logLines[i]<<std::endl;
+      return THOT_ERROR;
+    }
+    if(verbose) std::cerr<<op<<" \""<<arg<<"\": "<<hyp<<std::endl;
+  }
+  return THOT_OK;
+}
+
+//---------------
+std::string timedStartCat(ThotDecoder& thotDecoder,
+                          const std::string& srcSent)
+{
+  std::string catResult;
+  double elapsed_ant,elapsed,ucpu,scpu;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  thotDecoder.startCat(BENCH_USER_ID,srcSent.c_str(),catResult);
+  ctimer(&elapsed,&ucpu,&scpu);
+  opLatencies[START_CAT_OP].push_back(1000*(elapsed-elapsed_ant));
+
+      // Obtain word graph size
+  size_t numStates;
+  size_t numArcs;
+  if(thotDecoder.getWordGraphSize(BENCH_USER_ID,numStates,numArcs)==THOT_OK)
+  {
+    wgNumStates.push_back(numStates);
+    wgNumArcs.push_back(numArcs);
+  }
+  return catResult;
+}
+
+//---------------
+std::string timedAddStrToPref(ThotDecoder& thotDecoder,
+                              const std::string& str)
+{
+  std::string catResult;
+  double elapsed_ant,elapsed,ucpu,scpu;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  thotDecoder.addStrToPref(BENCH_USER_ID,str.c_str(),RejectedWordsSet(),catResult);
+  ctimer(&elapsed,&ucpu,&scpu);
+  opLatencies[ADD_STR_TO_PREF_OP].push_back(1000*(elapsed-elapsed_ant));
+  return catResult;
+}
+
+//---------------
+std::string timedSetPref(ThotDecoder& thotDecoder,
+                         const std::string& pref,
+                         const RejectedWordsSet& rejectedWords)
+{
+  std::string catResult;
+  double elapsed_ant,elapsed,ucpu,scpu;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  thotDecoder.setPref(BENCH_USER_ID,pref.c_str(),rejectedWords,catResult);
+  ctimer(&elapsed,&ucpu,&scpu);
+  opLatencies[SET_PREF_OP].push_back(1000*(elapsed-elapsed_ant));
+  return catResult;
+}
+
+//---------------
+void timedResetPrefix(ThotDecoder& thotDecoder)
+{
+  double elapsed_ant,elapsed,ucpu,scpu;
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  thotDecoder.resetPrefix(BENCH_USER_ID);
+  ctimer(&elapsed,&ucpu,&scpu);
+  opLatencies[RESET_PREF_OP].push_back(1000*(elapsed-elapsed_ant));
+}
+
+//---------------
+std::string extendPref(const std::string& ref,
+                       const std::string& hyp)
+{
+      // Obtain longest common prefix of ref and hyp plus the following
+      // character of ref (if any)
+  size_t pos=0;
+  while(pos<ref.size() && pos<hyp.size() && ref[pos]==hyp[pos])
+    ++pos;
+
+      // Move back to the beginning of the current character
+  while(pos>0 && pos<ref.size() && (ref[pos]&0xC0)==0x80)
+    --pos;
+
+  if(pos<ref.size())
+    pos+=utf8CharLen(ref,pos);
+  return ref.substr(0,pos);
+}
+
+//---------------
+std::string nextWord(const std::string& sent,
+                     const std::string& pref)
+{
+  if(!StrProcUtils::isPrefix(pref,sent))
+    return "";
+  std::vector<std::string> words=StrProcUtils::stringToStringVector(sent.substr(pref.size()));
+  if(words.empty())
+    return "";
+  else
+    return words[0];
+}
+
+//---------------
+size_t utf8CharLen(const std::string& str,
+                   size_t pos)
+{
+  unsigned char c=str[pos];
+  size_t len=1;
+  if(c>=0xF0) len=4;
+  else if(c>=0xE0) len=3;
+  else if(c>=0xC0) len=2;
+  if(pos+len>str.size())
+    len=str.size()-pos;
+  return len;
+}
+
+//---------------
+size_t numUtf8Chars(const std::string& str)
+{
+  size_t result=0;
+  for(size_t i=0;i<str.size();++i)
+  {
+    if((str[i]&0xC0)!=0x80)
+      ++result;
+  }
+  return result;
+}
+
+//---------------
+bool randomEvent(float prob)
+{
+  return ((double)rand()/((double)RAND_MAX+1))<prob;
+}
+
+//---------------
+void printLatencyStats(void)
+{
+  printf("Operation\tCount\tMean(ms)\tp50(ms)\tp95(ms)\tp99(ms)\tMax(ms)\n");
+  for(unsigned int i=0;i<NUM_OPS;++i)
+  {
+    std::vector<double> sortedValues=opLatencies[i];
+    std::sort(sortedValues.begin(),sortedValues.end());
+    if(sortedValues.empty())
+    {
+      printf("%s\t0\t-\t-\t-\t-\t-\n",opNames[i]);
+    }
+    else
+    {
+      double sum=0;
+      for(unsigned int j=0;j<sortedValues.size();++j)
+        sum+=sortedValues[j];
+      printf("%s\t%zu\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\n",opNames[i],sortedValues.size(),
+             sum/sortedValues.size(),percentile(sortedValues,50),percentile(sortedValues,95),
+             percentile(sortedValues,99),sortedValues.back());
+    }
+  }
+}
+
+//---------------
+void printSizeStats(const char* name,
+                    std::vector<size_t> values)
+{
+  if(values.empty())
+  {
+    printf("%s: not available\n",name);
+    return;
+  }
+  std::sort(values.begin(),values.end());
+  std::vector<double> sortedValues(values.begin(),values.end());
+  double sum=0;
+  for(unsigned int i=0;i<sortedValues.size();++i)
+    sum+=sortedValues[i];
+  printf("%s (mean/p50/p95/max): %.1f/%g/%g/%g\n",name,sum/sortedValues.size(),
+         percentile(sortedValues,50),percentile(sortedValues,95),sortedValues.back());
+}
+
+//---------------
+double percentile(const std::vector<double>& sortedValues,
+                  double p)
+{
+      // Nearest-rank percentile
+  size_t rank=(size_t) ceil(p/100*sortedValues.size());
+  if(rank==0) rank=1;
+  return sortedValues[rank-1];
+}
+
+//---------------
+int loadLines(const char* fileName,
+              std::vector<std::string>& lines)
+{
+  std::ifstream inS(fileName);
+  if(!inS)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  std::string line;
+  while(std::getline(inS,line))
+    lines.push_back(line);
+  return THOT_OK;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  if(argc==1 || readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+  if(readSTLstring(argc,argv, "-c", &cfgFileName)==-1)
+  {
+    std::cerr<<"Error: parameter -c not given"<<std::endl;
+    return THOT_ERROR;
+  }
+  if(readSTLstring(argc,argv, "-l", &logFileName)==-1)
+  {
+    if(readSTLstring(argc,argv, "-t", &srcFileName)==-1 ||
+       readSTLstring(argc,argv, "-r", &refFileName)==-1)
+    {
+      std::cerr<<"Error: either -t and -r or -l parameters should be given"<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+  readFloat(argc,argv, "-bs", &bsProb);
+  readFloat(argc,argv, "-rj", &rjProb);
+  readUnsignedInt(argc,argv, "-s", &seed);
+  if(readOption(argc,argv, "-v")!=-1)
+    verbose=1;
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_bench_imt -c <string> {-t <string> -r <string> | -l <string>}\n");
+  printf("                      [-bs <float>] [-rj <float>] [-s <int>] [-v]\n");
+  printf("                      [--help]\n\n");
+  printf("-c <string>           Configuration file.\n\n");
+  printf("-t <string>           File with the sentences to translate.\n\n");
+  printf("-r <string>           File with reference sentences, they are used to\n");
+  printf("                      simulate the post-editing sessions.\n\n");
+  printf("-l <string>           Replay the post-editing sessions recorded in the\n");
+  printf("                      given file instead of simulating them. Each line\n");
+  printf("                      contains an operation: \"sc <src>\" (startCat),\n");
+  printf("                      \"ap <str>\" (addStrToPref), \"sp <pref>\" (setPref)\n");
+  printf("                      or \"rp\" (resetPrefix).\n\n");
+  printf("-bs <float>           Probability of typing a wrong character that is\n");
+  printf("                      deleted with a backspace (0.05 by default).\n\n");
+  printf("-rj <float>           Probability of rejecting the next word of the\n");
+  printf("                      hypothesis when it is wrong (0.05 by default).\n\n");
+  printf("-s <int>              Seed for the random number generator (31415 by\n");
+  printf("                      default).\n\n");
+  printf("-v                    Verbose mode.\n\n");
+  printf("--help                Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -49,6 +49,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 void process_request(const thot_client_pars& tdcPars);
 int extractJsonFileContent(std::string jsonFileName,
                            std::string& jsonFileContent);
+int extractSentences(std::string fileName,
+                     std::vector<std::string>& sentences);
 int TakeParameters(int argc,
                    char *argv[],
                    thot_client_pars& tdcPars);
@@ -78,6 +80,14 @@ int main(int argc,char *argv[])
         return THOT_ERROR;
     }
     
+        // Read sentences whose word graphs are to be precomputed
+    if(!tdcPars.wgPrecompFileName.empty())
+    {
+      int ret=extractSentences(tdcPars.wgPrecompFileName,tdcPars.sentencesToPrecompute);
+      if(ret==THOT_ERROR)
+        return THOT_ERROR;
+    }
+
         // Process request
     try
     {
@@ -101,6 +111,7 @@ void process_request(const thot_client_pars& tdcPars)
   std::vector<std::string> v;
   std::string translatedSentence;
   std::string bestHypInfo;
+  int numQueued;
   ThotDecoderClient thotDecoderClient;
   double elapsed_ant,elapsed,ucpu,scpu;
   double connection_latency=0;
@@ -158,6 +169,10 @@ void process_request(const thot_client_pars& tdcPars)
       break;
     case RESET_PREF: thotDecoderClient.resetPref(tdcPars.user_id);
       break;
+    case PRECOMPUTE_WGS: thotDecoderClient.sendSentsForWgPrecomp(tdcPars.user_id,tdcPars.sentencesToPrecompute,numQueued);
+      if(tdcPars.verbose)
+        std::cerr<<numQueued<<" sentences queued for word graph precomputation"<<std::endl;
+      break;
     case PRINT_MODELS: thotDecoderClient.sendPrintRequest(tdcPars.user_id);
       break;
     case END_SERVER: thotDecoderClient.sendEndServerRequest(tdcPars.user_id);
@@ -198,6 +213,28 @@ int extractJsonFileContent(std::string jsonFileName,
   }
 }
 
+//---------------
+int extractSentences(std::string fileName,
+                     std::vector<std::string>& sentences)
+{
+  AwkInputStream awk;
+  if(awk.open(fileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file with sentences "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+  {
+    sentences.clear();
+    while(awk.getln())
+    {
+      if(awk.NF>0)
+        sentences.push_back(awk.dollar(0));
+    }
+    return THOT_OK;
+  }
+}
+
 //---------------
 int TakeParameters(int argc,
                    char *argv[],
@@ -318,6 +355,15 @@ int TakeParameters(int argc,
    return THOT_OK;
  }
 
+     /* Take the file with the sentences whose word graphs are to be
+      * precomputed */
+ err=readSTLstring(argc,argv, "-pw",&tdcPars.wgPrecompFileName);
+ if(err==0)
+ {
+   tdcPars.server_request_code=PRECOMPUTE_WGS;
+   return THOT_OK;
+ }
+
      /* Check -rp option */
  err=readOption(argc,argv,"-rp");
  if(err!=-1)
@@ -362,6 +408,7 @@ void printUsage(void)
   std::cerr<<"                             | -t <string> | -th <string> | -j <string> |\n";
   std::cerr<<"                             | -c <srcstring> <refstring> |\n";
   std::cerr<<"                             | -sc <string> | -ap <string> | -rp |\n";
+  std::cerr<<"                             | -pw <string> |\n";
   std::cerr<<"                             | -o <string> | -e } [ -v ]\n";
   std::cerr<<"                             [--help] [--version]\n\n";
   std::cerr<<"-i <string>                  Set IP address of the server.\n";
@@ -382,6 +429,9 @@ void printUsage(void)
   std::cerr<<"                             the null string as prefix.\n";
   std::cerr<<"-ap <string>                 Add string to prefix.\n";
   std::cerr<<"-rp <string>                 Reset prefix.\n";
+  std::cerr<<"-pw <string>                 Announce the sentences given in a file (one per\n";
+  std::cerr<<"                             line) so that the server precomputes their word\n";
+  std::cerr<<"                             graphs in the background.\n";
   std::cerr<<"-pr                          Print models.\n";
   std::cerr<<"-e                           End server.\n";
   std::cerr<<"-v                           Verbose mode.\n";
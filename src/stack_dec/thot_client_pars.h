@@ -44,6 +44,8 @@ struct thot_client_pars
   std::string strToAddToPref;
   std::string serverIP;
   std::string jsonFileName;
+  std::string wgPrecompFileName;
+  std::vector<std::string> sentencesToPrecompute;
   std::vector<float> floatVec;
   int user_id;
   int server_request_code;
@@ -86,8 +86,10 @@ struct thot_ms_dec_pars
   std::string transModelPref;
   std::string customFeatsFile;
   std::string wordGraphFileName;
+  bool wgBinary;
   std::string outFile;
   float wgPruningThreshold;
+  float wgPruningDensity;
   std::vector<float> weightVec;
 
   thot_ms_dec_pars()
@@ -102,6 +104,8 @@ struct thot_ms_dec_pars
       be=0;
       wgPruningThreshold=DISABLE_WORDGRAPH;
       wgPruningThreshold=UNLIMITED_DENSITY;
+      wgPruningDensity=UNLIMITED_DENSITY;
+      wgBinary=false;
       verbosity=0;
     }
 };
@@ -678,8 +682,11 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
         {
           char wgFileNameForSent[256];
           sprintf(wgFileNameForSent,"%s_%06d",tdp.wordGraphFileName.c_str(),sentNo);
-          stackDecoderRecPtr->pruneWordGraph(tdp.wgPruningThreshold);
-          stackDecoderRecPtr->printWordGraph(wgFileNameForSent);
+          if(tdp.wgPruningDensity!=UNLIMITED_DENSITY)
+            stackDecoderRecPtr->pruneWordGraphGivenDensity(tdp.wgPruningDensity,stringToStringVector(srcSentenceString).size());
+          else
+            stackDecoderRecPtr->pruneWordGraph(tdp.wgPruningThreshold);
+          stackDecoderRecPtr->printWordGraph(wgFileNameForSent,tdp.wgBinary);
         }
       }
 
@@ -859,6 +866,14 @@ void takeParametersGivenArgcArgv(int argc,
  {
        // Take -wgp parameter 
    err=readFloat(argc,argv, "-wgp", &tdp.wgPruningThreshold);
+
+       // Take -wgpd parameter 
+   err=readFloat(argc,argv, "-wgpd", &tdp.wgPruningDensity);
+
+       // Take -wgb parameter
+   err=readOption(argc,argv, "-wgb");
+   if(err!=-1)
+     tdp.wgBinary=true;
  }
 
      // Take verbosity parameter
@@ -946,6 +961,9 @@ void printParameters(const thot_ms_dec_pars& tdp)
      std::cerr<<"word graph pruning threshold: word graph density unrestricted"<<std::endl;
    else
      std::cerr<<"word graph pruning threshold: "<<tdp.wgPruningThreshold<<std::endl;
+   if(tdp.wgPruningDensity!=UNLIMITED_DENSITY)
+     std::cerr<<"word graph density per source word (posterior pruning): "<<tdp.wgPruningDensity<<std::endl;
+   std::cerr<<"word graph format: "<<(tdp.wgBinary?"binary":"text")<<std::endl;
  }
  else
  {
@@ -979,7 +997,7 @@ void printUsage(void)
   std::cerr << "                 [-W <float>] [-S <int>] [-A <int>]"<<std::endl;
   std::cerr << "                 [-I <int>] [-G <int>] [-h <int>]"<<std::endl;
   std::cerr << "                 [-be] [ -nomon <int>] [-tmw <float> ... <float>]"<<std::endl;
-  std::cerr << "                 [-wg <string> [-wgp <float>] ]"<<std::endl;
+  std::cerr << "                 [-wg <string> [-wgp <float>|-wgpd <float>] [-wgb] ]"<<std::endl;
   std::cerr << "                 [-v|-v1|-v2]"<<std::endl;
   std::cerr << "                 [--help] [--version]"<<std::endl<<std::endl;
   std::cerr << " -c <string>           : Configuration file (command-line options override"<<std::endl;
@@ -1021,6 +1039,10 @@ void printUsage(void)
   std::cerr << "                                       state is retained.\n";
   std::cerr << "                         If not given, the number of arcs is not\n";
   std::cerr << "                         restricted.\n";
+  std::cerr << " -wgpd <float>         : Prune word-graph using arc posteriors, retaining\n";
+  std::cerr << "                         about <float> arcs per source word.\n";
+  std::cerr << " -wgb                  : Print word graphs in binary format (.wgb files),\n";
+  std::cerr << "                         which can be memory-mapped when loaded.\n";
   std::cerr << " -v|-v1|-v2            : verbose modes."<<std::endl;
   std::cerr << " --help                : Display this help and exit."<<std::endl;
   std::cerr << " --version             : Output version information and exit."<<std::endl;
@@ -457,7 +457,9 @@ void process_request_switch(int sockd,
   std::string bestHypInfo;
   std::string catResult;
   std::vector<float> floatVec;
+  std::vector<std::string> strVec;
   RejectedWordsSet emptyRejWordsSet;
+  int numSents;
   int ret;
   
   switch(server_request_type)
@@ -517,6 +519,19 @@ void process_request_switch(int sockd,
       thotDecoderPtr->resetPrefix(user_id);
       BasicSocketUtils::writeInt(sockd,THOT_OK);
       break;
+
+    case PRECOMPUTE_WGS: // NOTE: sentences are translated in the
+                         // background, the reply only contains the
+                         // number of sentences queued
+      numSents=BasicSocketUtils::recvInt(sockd);
+      for(int i=0;i<numSents;++i)
+      {
+        BasicSocketUtils::recvStlStr(sockd,stlStr);
+        strVec.push_back(stlStr);
+      }
+      ret=thotDecoderPtr->precomputeWordGraphs(user_id,strVec,verbose);
+      BasicSocketUtils::writeInt(sockd,ret);
+      break;
       
     case PRINT_MODELS:
       ret=thotDecoderPtr->printModels(verbose);
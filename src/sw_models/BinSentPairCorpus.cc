@@ -0,0 +1,470 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BinSentPairCorpus.cc
+ *
+ * @brief Definitions file for BinSentPairCorpus.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "BinSentPairCorpus.h"
+#include "AwkInputStream.h"
+#include "SingleWordVocab.h"
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//--------------- Constants ------------------------------------------
+
+#define BIN_SENT_PAIR_CORPUS_MAGIC_LEN  16
+#define BIN_SENT_PAIR_CORPUS_HEADER_LEN (BIN_SENT_PAIR_CORPUS_MAGIC_LEN+2*sizeof(uint32_t)+7*sizeof(uint64_t))
+
+//--------------- Type definitions -----------------------------------
+
+#ifdef THOT_DISABLE_SPACE_EFFICIENT_VOCAB_STRUCTURES
+typedef std::map<std::string,uint32_t> CorpusVocab;
+#else
+typedef hash_map<std::string,uint32_t,StringHashF> CorpusVocab;
+#endif
+
+//--------------- Function declarations ------------------------------
+
+static size_t alignedSize(size_t bytes);
+static bool writePadded(FILE* file,
+                        const void* data,
+                        size_t bytes);
+static uint32_t getWordId(const std::string& word,
+                          CorpusVocab& vocab,
+                          std::vector<std::string>& words);
+static bool writeVocab(FILE* file,
+                       const std::vector<std::string>& words);
+
+//--------------- Function definitions
+
+//-------------------------
+static size_t alignedSize(size_t bytes)
+{
+  return (bytes+7) & ~((size_t)7);
+}
+
+//-------------------------
+static bool writePadded(FILE* file,
+                        const void* data,
+                        size_t bytes)
+{
+  const char padding[8]={0,0,0,0,0,0,0,0};
+
+  if(bytes>0 && fwrite(data,1,bytes,file)!=bytes)
+    return THOT_ERROR;
+  size_t padLen=alignedSize(bytes)-bytes;
+  if(padLen>0 && fwrite(padding,1,padLen,file)!=padLen)
+    return THOT_ERROR;
+  return THOT_OK;
+}
+
+//-------------------------
+static uint32_t getWordId(const std::string& word,
+                          CorpusVocab& vocab,
+                          std::vector<std::string>& words)
+{
+  CorpusVocab::iterator iter=vocab.find(word);
+  if(iter!=vocab.end())
+    return iter->second;
+  else
+  {
+    uint32_t id=words.size();
+    vocab[word]=id;
+    words.push_back(word);
+    return id;
+  }
+}
+
+//-------------------------
+static bool writeVocab(FILE* file,
+                       const std::vector<std::string>& words)
+{
+  std::vector<uint64_t> offsets(words.size()+1);
+  offsets[0]=0;
+  for(size_t k=0;k<words.size();++k)
+    offsets[k+1]=offsets[k]+words[k].size();
+  if(writePadded(file,&offsets[0],offsets.size()*sizeof(uint64_t))==THOT_ERROR)
+    return THOT_ERROR;
+  for(size_t k=0;k<words.size();++k)
+  {
+    if(!words[k].empty() && fwrite(words[k].c_str(),1,words[k].size(),file)!=words[k].size())
+      return THOT_ERROR;
+  }
+  size_t padLen=alignedSize(offsets.back())-offsets.back();
+  const char padding[8]={0,0,0,0,0,0,0,0};
+  if(padLen>0 && fwrite(padding,1,padLen,file)!=padLen)
+    return THOT_ERROR;
+  return THOT_OK;
+}
+
+//--------------- BinSentPairCorpus class function definitions
+
+//-------------------------
+BinSentPairCorpus::BinSentPairCorpus(void)
+{
+  mapAddr=NULL;
+  mapLength=0;
+  clear();
+}
+
+//-------------------------
+bool BinSentPairCorpus::encode(const char *srcFileName,
+                               const char *trgFileName,
+                               const char *sentCountsFile,
+                               const char *binFileName)
+{
+  AwkInputStream awkSrc;
+  AwkInputStream awkTrg;
+  AwkInputStream awkSrcTrgC;
+
+      // Open files
+  if(awkSrc.open(srcFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error in source language file: "<<srcFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  if(awkTrg.open(trgFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error in target language file: "<<trgFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  bool countFileExists=false;
+  if(strlen(sentCountsFile)>0)
+  {
+    if(awkSrcTrgC.open(sentCountsFile)==THOT_ERROR)
+    {
+      std::cerr<<"Error in file with sentence counts: "<<sentCountsFile<<std::endl;
+      return THOT_ERROR;
+    }
+    countFileExists=true;
+  }
+
+      // First pass: obtain vocabularies, sentence lengths and counts
+  CorpusVocab srcVocab;
+  CorpusVocab trgVocab;
+  std::vector<std::string> srcWords;
+  std::vector<std::string> trgWords;
+  std::vector<uint64_t> srcOffsets(1,0);
+  std::vector<uint64_t> trgOffsets(1,0);
+  std::vector<float> counts;
+  while(awkSrc.getln())
+  {
+    if(!awkTrg.getln())
+    {
+      std::cerr<<"Error: the number of source and target sentences differ!"<<std::endl;
+      return THOT_ERROR;
+    }
+    for(unsigned int i=1;i<=awkSrc.NF;++i)
+      getWordId(awkSrc.dollar(i),srcVocab,srcWords);
+    for(unsigned int i=1;i<=awkTrg.NF;++i)
+      getWordId(awkTrg.dollar(i),trgVocab,trgWords);
+    srcOffsets.push_back(srcOffsets.back()+awkSrc.NF);
+    trgOffsets.push_back(trgOffsets.back()+awkTrg.NF);
+    if(countFileExists)
+    {
+      if(!awkSrcTrgC.getln())
+      {
+        std::cerr<<"Error: the number of sentence pairs and sentence counts differ!"<<std::endl;
+        return THOT_ERROR;
+      }
+      counts.push_back(atof(awkSrcTrgC.dollar(1).c_str()));
+    }
+    else
+      counts.push_back(1);
+  }
+  if(awkTrg.getln())
+  {
+    std::cerr<<"Error: the number of source and target sentences differ!"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Write header
+  FILE* file=fopen(binFileName,"wb");
+  if(file==NULL)
+  {
+    std::cerr<<"Error while creating binary corpus file "<<binFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  char magic[BIN_SENT_PAIR_CORPUS_MAGIC_LEN];
+  memset(magic,0,BIN_SENT_PAIR_CORPUS_MAGIC_LEN);
+  memcpy(magic,BIN_SENT_PAIR_CORPUS_MAGIC,strlen(BIN_SENT_PAIR_CORPUS_MAGIC));
+  uint32_t header32[2]={BIN_SENT_PAIR_CORPUS_VERSION,0};
+  uint64_t header64[7];
+  header64[0]=counts.size();
+  header64[1]=srcOffsets.back();
+  header64[2]=trgOffsets.back();
+  header64[3]=srcWords.size();
+  header64[4]=trgWords.size();
+  header64[5]=0;
+  header64[6]=0;
+  bool ok=(fwrite(magic,1,BIN_SENT_PAIR_CORPUS_MAGIC_LEN,file)==BIN_SENT_PAIR_CORPUS_MAGIC_LEN &&
+           fwrite(header32,sizeof(uint32_t),2,file)==2 &&
+           fwrite(header64,sizeof(uint64_t),7,file)==7);
+
+      // Write sentence offsets
+  ok=ok && writePadded(file,&srcOffsets[0],srcOffsets.size()*sizeof(uint64_t))==THOT_OK;
+  ok=ok && writePadded(file,&trgOffsets[0],trgOffsets.size()*sizeof(uint64_t))==THOT_OK;
+
+      // Second pass: write word ids of source and target sentences
+  std::vector<AwkInputStream*> awkVec;
+  awkVec.push_back(&awkSrc);
+  awkVec.push_back(&awkTrg);
+  std::vector<CorpusVocab*> vocabVec;
+  vocabVec.push_back(&srcVocab);
+  vocabVec.push_back(&trgVocab);
+  for(unsigned int k=0;k<awkVec.size() && ok;++k)
+  {
+    awkVec[k]->rwd();
+    size_t numIds=0;
+    std::vector<uint32_t> ids;
+    while(awkVec[k]->getln() && ok)
+    {
+      ids.clear();
+      for(unsigned int i=1;i<=awkVec[k]->NF;++i)
+        ids.push_back((*vocabVec[k])[awkVec[k]->dollar(i)]);
+      if(!ids.empty())
+        ok=(fwrite(&ids[0],sizeof(uint32_t),ids.size(),file)==ids.size());
+      numIds+=ids.size();
+    }
+    size_t padLen=alignedSize(numIds*sizeof(uint32_t))-numIds*sizeof(uint32_t);
+    const char padding[8]={0,0,0,0,0,0,0,0};
+    if(ok && padLen>0)
+      ok=(fwrite(padding,1,padLen,file)==padLen);
+  }
+
+      // Write counts and vocabularies
+  ok=ok && writePadded(file,counts.empty()? NULL: &counts[0],counts.size()*sizeof(float))==THOT_OK;
+  ok=ok && writeVocab(file,srcWords)==THOT_OK;
+  ok=ok && writeVocab(file,trgWords)==THOT_OK;
+
+  if(fclose(file)!=0 || !ok)
+  {
+    std::cerr<<"Error while writing binary corpus file "<<binFileName<<std::endl;
+    remove(binFileName);
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool BinSentPairCorpus::isBinCorpus(const char *fileName)
+{
+  FILE* file=fopen(fileName,"rb");
+  if(file==NULL)
+    return false;
+  char magic[BIN_SENT_PAIR_CORPUS_MAGIC_LEN];
+  bool result=(fread(magic,1,BIN_SENT_PAIR_CORPUS_MAGIC_LEN,file)==BIN_SENT_PAIR_CORPUS_MAGIC_LEN &&
+               strncmp(magic,BIN_SENT_PAIR_CORPUS_MAGIC,BIN_SENT_PAIR_CORPUS_MAGIC_LEN)==0);
+  fclose(file);
+  return result;
+}
+
+//-------------------------
+bool BinSentPairCorpus::open(const char *binFileName)
+{
+  clear();
+
+      // Map file
+  int fd=::open(binFileName,O_RDONLY);
+  if(fd<0)
+  {
+    std::cerr<<"Error while opening binary corpus file "<<binFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)!=0)
+  {
+    std::cerr<<"Error while obtaining size of binary corpus file "<<binFileName<<std::endl;
+    close(fd);
+    return THOT_ERROR;
+  }
+  size_t length=fileStat.st_size;
+  if(length<BIN_SENT_PAIR_CORPUS_HEADER_LEN)
+  {
+    std::cerr<<"Error, binary corpus file "<<binFileName<<" is truncated"<<std::endl;
+    close(fd);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,length,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping binary corpus file "<<binFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  mapAddr=addr;
+  mapLength=length;
+
+      // Read header
+  const char* base=(const char*) addr;
+  uint32_t version;
+  uint64_t header64[7];
+  memcpy(&version,base+BIN_SENT_PAIR_CORPUS_MAGIC_LEN,sizeof(uint32_t));
+  memcpy(header64,base+BIN_SENT_PAIR_CORPUS_MAGIC_LEN+2*sizeof(uint32_t),7*sizeof(uint64_t));
+  if(strncmp(base,BIN_SENT_PAIR_CORPUS_MAGIC,BIN_SENT_PAIR_CORPUS_MAGIC_LEN)!=0 || version!=BIN_SENT_PAIR_CORPUS_VERSION)
+  {
+    std::cerr<<"Error, file "<<binFileName<<" is not a valid binary corpus file"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+  nsents=header64[0];
+  uint64_t nSrcIds=header64[1];
+  uint64_t nTrgIds=header64[2];
+  srcVocSize=header64[3];
+  trgVocSize=header64[4];
+
+      // Set pointers to the arrays
+  size_t offset=BIN_SENT_PAIR_CORPUS_HEADER_LEN;
+  size_t requiredLength=offset+2*alignedSize((nsents+1)*sizeof(uint64_t))+alignedSize(nSrcIds*sizeof(uint32_t))+alignedSize(nTrgIds*sizeof(uint32_t))+alignedSize(nsents*sizeof(float))+alignedSize((srcVocSize+1)*sizeof(uint64_t))+alignedSize((trgVocSize+1)*sizeof(uint64_t));
+  if(length<requiredLength)
+  {
+    std::cerr<<"Error, binary corpus file "<<binFileName<<" is truncated"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+  srcOffsets=(const uint64_t*)(base+offset);
+  offset+=alignedSize((nsents+1)*sizeof(uint64_t));
+  trgOffsets=(const uint64_t*)(base+offset);
+  offset+=alignedSize((nsents+1)*sizeof(uint64_t));
+  srcIds=(const uint32_t*)(base+offset);
+  offset+=alignedSize(nSrcIds*sizeof(uint32_t));
+  trgIds=(const uint32_t*)(base+offset);
+  offset+=alignedSize(nTrgIds*sizeof(uint32_t));
+  counts=(const float*)(base+offset);
+  offset+=alignedSize(nsents*sizeof(float));
+  srcVocOffsets=(const uint64_t*)(base+offset);
+  offset+=alignedSize((srcVocSize+1)*sizeof(uint64_t));
+  srcVocChars=base+offset;
+  offset+=alignedSize(srcVocOffsets[srcVocSize]);
+  if(length<offset+alignedSize((trgVocSize+1)*sizeof(uint64_t)))
+  {
+    std::cerr<<"Error, binary corpus file "<<binFileName<<" is truncated"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+  trgVocOffsets=(const uint64_t*)(base+offset);
+  offset+=alignedSize((trgVocSize+1)*sizeof(uint64_t));
+  trgVocChars=base+offset;
+  offset+=alignedSize(trgVocOffsets[trgVocSize]);
+  if(length<offset)
+  {
+    std::cerr<<"Error, binary corpus file "<<binFileName<<" is truncated"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+size_t BinSentPairCorpus::numSentPairs(void)const
+{
+  return nsents;
+}
+
+//-------------------------
+const uint32_t* BinSentPairCorpus::srcSent(size_t n,
+                                           unsigned int& len)const
+{
+  len=srcOffsets[n+1]-srcOffsets[n];
+  return srcIds+srcOffsets[n];
+}
+
+//-------------------------
+const uint32_t* BinSentPairCorpus::trgSent(size_t n,
+                                           unsigned int& len)const
+{
+  len=trgOffsets[n+1]-trgOffsets[n];
+  return trgIds+trgOffsets[n];
+}
+
+//-------------------------
+float BinSentPairCorpus::count(size_t n)const
+{
+  return counts[n];
+}
+
+//-------------------------
+size_t BinSentPairCorpus::srcVocabSize(void)const
+{
+  return srcVocSize;
+}
+
+//-------------------------
+size_t BinSentPairCorpus::trgVocabSize(void)const
+{
+  return trgVocSize;
+}
+
+//-------------------------
+std::string BinSentPairCorpus::srcWordStr(uint32_t id)const
+{
+  return wordStr(srcVocOffsets,srcVocChars,id);
+}
+
+//-------------------------
+std::string BinSentPairCorpus::trgWordStr(uint32_t id)const
+{
+  return wordStr(trgVocOffsets,trgVocChars,id);
+}
+
+//-------------------------
+std::string BinSentPairCorpus::wordStr(const uint64_t* vocOffsets,
+                                       const char* vocChars,
+                                       uint32_t id)const
+{
+  return std::string(vocChars+vocOffsets[id],vocOffsets[id+1]-vocOffsets[id]);
+}
+
+//-------------------------
+void BinSentPairCorpus::clear(void)
+{
+  if(mapAddr!=NULL)
+    munmap(mapAddr,mapLength);
+  mapAddr=NULL;
+  mapLength=0;
+  nsents=0;
+  srcVocSize=0;
+  trgVocSize=0;
+  srcOffsets=NULL;
+  trgOffsets=NULL;
+  srcIds=NULL;
+  trgIds=NULL;
+  counts=NULL;
+  srcVocOffsets=NULL;
+  srcVocChars=NULL;
+  trgVocOffsets=NULL;
+  trgVocChars=NULL;
+}
+
+//-------------------------
+BinSentPairCorpus::~BinSentPairCorpus()
+{
+  clear();
+}
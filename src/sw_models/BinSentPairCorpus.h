@@ -0,0 +1,119 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BinSentPairCorpus.h
+ *
+ * @brief Defines the BinSentPairCorpus class. BinSentPairCorpus gives
+ * random access to a parallel corpus stored in a pre-encoded binary
+ * file. The file contains the word ids of each sentence, the offsets of
+ * each sentence in the arrays of ids, the sentence pair counts and the
+ * source and target vocabularies of the corpus. The file is
+ * memory-mapped, so sentences are accessed without copies.
+ *
+ */
+
+#ifndef _BinSentPairCorpus_h
+#define _BinSentPairCorpus_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <ErrorDefs.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define BIN_SENT_PAIR_CORPUS_MAGIC    "thot_corpus_bin"
+#define BIN_SENT_PAIR_CORPUS_VERSION  1
+
+//--------------- Classes --------------------------------------------
+
+//--------------- BinSentPairCorpus class
+
+class BinSentPairCorpus
+{
+ public:
+
+      // Constructor
+  BinSentPairCorpus(void);
+
+      // Functions to create and open binary corpora
+  static bool encode(const char *srcFileName,
+                     const char *trgFileName,
+                     const char *sentCountsFile,
+                     const char *binFileName);
+      // Encodes the given text files into a binary corpus.
+      // sentCountsFile can be empty, in which case all sentence pairs
+      // have count one
+  static bool isBinCorpus(const char *fileName);
+      // Returns true if the given file is a binary corpus
+  bool open(const char *binFileName);
+
+      // Functions to access the sentence pairs
+  size_t numSentPairs(void)const;
+  const uint32_t* srcSent(size_t n,
+                          unsigned int& len)const;
+  const uint32_t* trgSent(size_t n,
+                          unsigned int& len)const;
+      // Return the ids of the words of the n'th source and target
+      // sentences, ids are local to the corpus vocabularies
+  float count(size_t n)const;
+  size_t srcVocabSize(void)const;
+  size_t trgVocabSize(void)const;
+  std::string srcWordStr(uint32_t id)const;
+  std::string trgWordStr(uint32_t id)const;
+
+      // clear function
+  void clear(void);
+
+      // Destructor
+  ~BinSentPairCorpus();
+
+ protected:
+
+  void* mapAddr;
+  size_t mapLength;
+  uint64_t nsents;
+  uint64_t srcVocSize;
+  uint64_t trgVocSize;
+  const uint64_t* srcOffsets;
+  const uint64_t* trgOffsets;
+  const uint32_t* srcIds;
+  const uint32_t* trgIds;
+  const float* counts;
+  const uint64_t* srcVocOffsets;
+  const char* srcVocChars;
+  const uint64_t* trgVocOffsets;
+  const char* trgVocChars;
+
+  std::string wordStr(const uint64_t* vocOffsets,
+                      const char* vocChars,
+                      uint32_t id)const;
+
+      // Forbid copies
+  BinSentPairCorpus(const BinSentPairCorpus&);
+  BinSentPairCorpus& operator=(const BinSentPairCorpus&);
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file EmSentPairProcessor.h
+ *
+ * @brief Defines the EmSentPairProcessor class template, which
+ * executes the E-step of an alignment model for a block of sentence
+ * pairs using several threads. The block is divided into chunks of
+ * EM_SENT_PAIR_CHUNK_SIZE sentence pairs that are processed as they
+ * are requested by the threads. The local sufficient statistics of
+ * each chunk are added to those of the model in chunk order, so the
+ * results do not depend on the number of threads.
+ */
+
+#ifndef _EmSentPairProcessor_h
+#define _EmSentPairProcessor_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <pthread.h>
+#include <iostream>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define EM_SENT_PAIR_CHUNK_SIZE 256
+
+//--------------- Classes --------------------------------------------
+
+//--------------- EmSentPairProcessor class
+
+template<class MODEL,class SENT_PAIR,class SCRATCH>
+class EmSentPairProcessor
+{
+ public:
+
+  typedef void (MODEL::*SentPairFunc)(const SENT_PAIR& sentPair,
+                                      SCRATCH& emScratch);
+  typedef void (MODEL::*MergeFunc)(SCRATCH& emScratch);
+
+      // Constructor. sentPairFunc computes the local sufficient
+      // statistics of a sentence pair and mergeFunc adds the local
+      // sufficient statistics of a scratch object to those of the
+      // model (leaving the scratch object ready for a new chunk)
+  EmSentPairProcessor(MODEL* _modelPtr,
+                      SentPairFunc _sentPairFunc,
+                      MergeFunc _mergeFunc);
+
+  void process(const std::vector<SENT_PAIR>& sentPairs,
+               const std::vector<SCRATCH*>& emScratchPtrVec);
+      // Processes sentPairs using one thread per scratch object. The
+      // calling thread works with the first one, if some of the
+      // remaining threads cannot be created, their work is done by the
+      // threads that are running
+
+ private:
+
+      // Data given to each thread
+  struct ThreadData
+  {
+    EmSentPairProcessor* procPtr;
+    SCRATCH* emScratchPtr;
+  };
+
+  MODEL* modelPtr;
+  SentPairFunc sentPairFunc;
+  MergeFunc mergeFunc;
+
+  const std::vector<SENT_PAIR>* sentPairsPtr;
+  unsigned int numChunks;
+  unsigned int nextChunkToProcess;
+  unsigned int nextChunkToMerge;
+  pthread_mutex_t mutex;
+  pthread_cond_t mergeCond;
+
+  static void* processThread(void* arg);
+  void processChunks(SCRATCH& emScratch);
+};
+
+//--------------- EmSentPairProcessor class method definitions
+
+//-------------------------
+template<class MODEL,class SENT_PAIR,class SCRATCH>
+EmSentPairProcessor<MODEL,SENT_PAIR,SCRATCH>::EmSentPairProcessor(MODEL* _modelPtr,
+                                                                  SentPairFunc _sentPairFunc,
+                                                                  MergeFunc _mergeFunc)
+{
+  modelPtr=_modelPtr;
+  sentPairFunc=_sentPairFunc;
+  mergeFunc=_mergeFunc;
+  sentPairsPtr=NULL;
+  numChunks=0;
+  nextChunkToProcess=0;
+  nextChunkToMerge=0;
+}
+
+//-------------------------
+template<class MODEL,class SENT_PAIR,class SCRATCH>
+void EmSentPairProcessor<MODEL,SENT_PAIR,SCRATCH>::process(const std::vector<SENT_PAIR>& sentPairs,
+                                                           const std::vector<SCRATCH*>& emScratchPtrVec)
+{
+  sentPairsPtr=&sentPairs;
+  numChunks=(sentPairs.size()+EM_SENT_PAIR_CHUNK_SIZE-1)/EM_SENT_PAIR_CHUNK_SIZE;
+  nextChunkToProcess=0;
+  nextChunkToMerge=0;
+  pthread_mutex_init(&mutex,NULL);
+  pthread_cond_init(&mergeCond,NULL);
+
+      // Launch threads
+  std::vector<ThreadData> threadDataVec(emScratchPtrVec.size());
+  std::vector<pthread_t> threadIds(emScratchPtrVec.size());
+  std::vector<bool> launched(emScratchPtrVec.size(),false);
+  for(unsigned int k=1;k<emScratchPtrVec.size() && k<numChunks;++k)
+  {
+    threadDataVec[k].procPtr=this;
+    threadDataVec[k].emScratchPtr=emScratchPtrVec[k];
+    if(pthread_create(&threadIds[k],NULL,processThread,&threadDataVec[k])!=0)
+      std::cerr<<"Warning: E-step thread "<<k<<" could not be created, its work will be done by the running threads"<<std::endl;
+    else
+      launched[k]=true;
+  }
+
+      // The calling thread also processes chunks
+  processChunks(*emScratchPtrVec[0]);
+
+  for(unsigned int k=1;k<launched.size();++k)
+  {
+    if(launched[k])
+      pthread_join(threadIds[k],NULL);
+  }
+
+  pthread_cond_destroy(&mergeCond);
+  pthread_mutex_destroy(&mutex);
+  sentPairsPtr=NULL;
+}
+
+//-------------------------
+template<class MODEL,class SENT_PAIR,class SCRATCH>
+void* EmSentPairProcessor<MODEL,SENT_PAIR,SCRATCH>::processThread(void* arg)
+{
+  ThreadData* threadDataPtr=(ThreadData*) arg;
+  threadDataPtr->procPtr->processChunks(*threadDataPtr->emScratchPtr);
+  return NULL;
+}
+
+//-------------------------
+template<class MODEL,class SENT_PAIR,class SCRATCH>
+void EmSentPairProcessor<MODEL,SENT_PAIR,SCRATCH>::processChunks(SCRATCH& emScratch)
+{
+  const std::vector<SENT_PAIR>& sentPairs=*sentPairsPtr;
+  while(true)
+  {
+        // Obtain next chunk
+    pthread_mutex_lock(&mutex);
+    unsigned int chunk=nextChunkToProcess;
+    if(chunk<numChunks)
+      ++nextChunkToProcess;
+    pthread_mutex_unlock(&mutex);
+    if(chunk>=numChunks)
+      break;
+
+        // Compute local sufficient statistics of the chunk
+    unsigned int begin=chunk*EM_SENT_PAIR_CHUNK_SIZE;
+    unsigned int end=begin+EM_SENT_PAIR_CHUNK_SIZE;
+    if(end>sentPairs.size())
+      end=sentPairs.size();
+    for(unsigned int k=begin;k<end;++k)
+      (modelPtr->*sentPairFunc)(sentPairs[k],emScratch);
+
+        // Add them to those of the model once the previous chunks have
+        // been added (chunks are obtained in increasing order, so the
+        // previous chunks are being processed or waiting here)
+    pthread_mutex_lock(&mutex);
+    while(nextChunkToMerge!=chunk)
+      pthread_cond_wait(&mergeCond,&mutex);
+    (modelPtr->*mergeFunc)(emScratch);
+    ++nextChunkToMerge;
+    pthread_cond_broadcast(&mergeCond);
+    pthread_mutex_unlock(&mutex);
+  }
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file HmmFbKernels.cc
+ *
+ * @brief Definitions file for HmmFbKernels.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "HmmFbKernels.h"
+#include <MathDefs.h>
+
+//--------------- HmmFbKernels namespace function definitions
+
+namespace HmmFbKernels
+{
+  //---------------
+  void lgProbsToProbs(const std::vector<double>& lgProbs,
+                      std::vector<double>& probs)
+  {
+    probs.resize(lgProbs.size());
+    for(unsigned int k=0;k<lgProbs.size();++k)
+      probs[k]=exp(lgProbs[k]);
+  }
+
+  //---------------
+  static bool normalizeRow(unsigned int nslen,
+                           double* row,
+                           double& scale)
+  {
+    double sum=0;
+    for(unsigned int i=0;i<nslen;++i)
+      sum+=row[i];
+
+        // Check underflow
+    if(!(sum>=DBL_MIN && sum<=DBL_MAX))
+      return false;
+
+    double invSum=1.0/sum;
+    for(unsigned int i=0;i<nslen;++i)
+      row[i]*=invSum;
+    scale=sum;
+    return true;
+  }
+
+  //---------------
+  bool scaledForward(unsigned int nslen,
+                     unsigned int tlen,
+                     const double* initProbs,
+                     const double* aligProbs,
+                     const double* lexProbs,
+                     double* alpha,
+                     double* scales)
+  {
+    if(tlen==0)
+      return true;
+
+        // Process first target position
+    for(unsigned int i=0;i<nslen;++i)
+      alpha[i]=initProbs[i]*lexProbs[i];
+    if(!normalizeRow(nslen,alpha,scales[0]))
+      return false;
+
+        // Process remaining target positions
+    for(unsigned int j=1;j<tlen;++j)
+    {
+      const double* prevRow=alpha+(j-1)*nslen;
+      double* row=alpha+j*nslen;
+      const double* lexRow=lexProbs+j*nslen;
+
+          // Obtain product of the transposed transition matrix and the
+          // previous row. The inner loop accesses contiguous memory
+      for(unsigned int i=0;i<nslen;++i)
+        row[i]=0;
+      for(unsigned int ip=0;ip<nslen;++ip)
+      {
+        double prevAlpha=prevRow[ip];
+        const double* aligRow=aligProbs+ip*nslen;
+        for(unsigned int i=0;i<nslen;++i)
+          row[i]+=prevAlpha*aligRow[i];
+      }
+      for(unsigned int i=0;i<nslen;++i)
+        row[i]*=lexRow[i];
+
+      if(!normalizeRow(nslen,row,scales[j]))
+        return false;
+    }
+    return true;
+  }
+
+  //---------------
+  void scaledBackward(unsigned int nslen,
+                      unsigned int tlen,
+                      const double* aligProbs,
+                      const double* lexProbs,
+                      const double* scales,
+                      double* beta)
+  {
+    if(tlen==0)
+      return;
+
+        // Initialize last row
+    double* lastRow=beta+(tlen-1)*nslen;
+    for(unsigned int i=0;i<nslen;++i)
+      lastRow[i]=1.0;
+
+        // Process remaining target positions
+    std::vector<double> lexBeta(nslen);
+    for(unsigned int j=tlen-1;j>0;--j)
+    {
+      const double* nextRow=beta+j*nslen;
+      const double* lexRow=lexProbs+j*nslen;
+      double* row=beta+(j-1)*nslen;
+
+      for(unsigned int i=0;i<nslen;++i)
+        lexBeta[i]=lexRow[i]*nextRow[i];
+
+          // Obtain product of the transition matrix and lexBeta. The
+          // inner loop accesses contiguous memory
+      double invScale=1.0/scales[j];
+      for(unsigned int i=0;i<nslen;++i)
+      {
+        const double* aligRow=aligProbs+i*nslen;
+        double d=0;
+        for(unsigned int i_tilde=0;i_tilde<nslen;++i_tilde)
+          d+=aligRow[i_tilde]*lexBeta[i_tilde];
+        row[i]=d*invScale;
+      }
+    }
+  }
+
+  //---------------
+  double lgProbGivenScales(unsigned int tlen,
+                           const double* scales)
+  {
+    double lp=0;
+    for(unsigned int j=0;j<tlen;++j)
+      lp+=log(scales[j]);
+    return lp;
+  }
+
+  //---------------
+  void viterbi(unsigned int nslen,
+               unsigned int tlen,
+               const double* initLgProbs,
+               const double* aligLgProbs,
+               const double* lexLgProbs,
+               double* vit,
+               PositionIndex* pred)
+  {
+    if(tlen==0)
+      return;
+
+        // Process first target position
+    for(unsigned int i=0;i<nslen;++i)
+    {
+      vit[i]=initLgProbs[i]+lexLgProbs[i];
+      pred[i]=0;
+    }
+
+        // Process remaining target positions
+    for(unsigned int j=1;j<tlen;++j)
+    {
+      const double* prevRow=vit+(j-1)*nslen;
+      double* row=vit+j*nslen;
+      PositionIndex* predRow=pred+j*nslen;
+      const double* lexRow=lexLgProbs+j*nslen;
+
+      for(unsigned int i=0;i<nslen;++i)
+      {
+        row[i]=SMALL_LG_NUM;
+        predRow[i]=0;
+      }
+          // Previous positions are explored in increasing order so as
+          // to keep the first best predecessor in case of ties
+      for(unsigned int ip=0;ip<nslen;++ip)
+      {
+        double prevVit=prevRow[ip];
+        const double* aligRow=aligLgProbs+ip*nslen;
+        for(unsigned int i=0;i<nslen;++i)
+        {
+          double lp=prevVit+aligRow[i]+lexRow[i];
+          if(lp>row[i])
+          {
+            row[i]=lp;
+            predRow[i]=ip+1;
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file HmmFbKernels.h
+ *
+ * @brief Defines the forward, backward and Viterbi kernels used by
+ * HMM-based alignment models. The kernels work with flat row-major
+ * buffers: for a sentence pair with nslen extended source positions and
+ * tlen target positions, matrices indexed by (j,i) have tlen rows of
+ * nslen elements, and the transition matrix has nslen rows (previous
+ * position) of nslen elements (current position). All positions are
+ * zero-based.
+ */
+
+#ifndef _HmmFbKernels_h
+#define _HmmFbKernels_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "SwDefs.h"
+#include <math.h>
+#include <float.h>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- function declarations ------------------------------
+
+namespace HmmFbKernels
+{
+  void lgProbsToProbs(const std::vector<double>& lgProbs,
+                      std::vector<double>& probs);
+      // Exponentiates the elements of lgProbs
+
+  bool scaledForward(unsigned int nslen,
+                     unsigned int tlen,
+                     const double* initProbs,
+                     const double* aligProbs,
+                     const double* lexProbs,
+                     double* alpha,
+                     double* scales);
+      // Computes the forward matrix using per-position scaling.
+      // initProbs (nslen elements) contains the alignment
+      // probabilities for the first target position, aligProbs (nslen
+      // x nslen) the transition probabilities and lexProbs (tlen x
+      // nslen) the lexical probabilities. On return, each row of alpha
+      // (tlen x nslen) sums to one and scales (tlen elements) contains
+      // the normalization factors, so that the log of the unscaled
+      // alpha value for (j,i) is log(alpha[j][i]) plus the sum of
+      // log(scales[k]) for k<=j. Returns false if a normalization
+      // factor underflows, in which case the log-space algorithm
+      // should be used instead
+
+  void scaledBackward(unsigned int nslen,
+                      unsigned int tlen,
+                      const double* aligProbs,
+                      const double* lexProbs,
+                      const double* scales,
+                      double* beta);
+      // Computes the backward matrix (tlen x nslen) using the
+      // normalization factors obtained by scaledForward(). The log of
+      // the unscaled beta value for (j,i) is log(beta[j][i]) plus the
+      // sum of log(scales[k]) for k>j
+
+  double lgProbGivenScales(unsigned int tlen,
+                           const double* scales);
+      // Returns the log-probability of the target sentence given the
+      // normalization factors obtained by scaledForward()
+
+  void viterbi(unsigned int nslen,
+               unsigned int tlen,
+               const double* initLgProbs,
+               const double* aligLgProbs,
+               const double* lexLgProbs,
+               double* vit,
+               PositionIndex* pred);
+      // Computes the Viterbi matrix (tlen x nslen) and the matrix of
+      // predecessors given log-probabilities. Predecessors are stored
+      // as one-based positions, zero is used for the first target
+      // position or when no predecessor improves SMALL_LG_NUM
+}
+
+#endif
@@ -42,6 +42,14 @@ void IncrIbm1AligModel::set_expval_maxnsize(unsigned int _anji_maxnsize)
   anji.set_maxnsize(_anji_maxnsize);
 }
 
+//-------------------------   
+bool IncrIbm1AligModel::set_expval_mmap_prefix(const char* prefFileName)
+{
+  std::string anjiArenaFile=prefFileName;
+  anjiArenaFile=anjiArenaFile+".anji_arena";
+  return anji.set_mmap_file(anjiArenaFile.c_str());
+}
+
 //-------------------------   
 unsigned int IncrIbm1AligModel::numSentPairs(void)
 {
@@ -110,7 +118,6 @@ void IncrIbm1AligModel::clearInfoAboutSentRange(void)
       // Clear info about sentence range
   sentenceHandler.clear();
   anji.clear();
-  anji_aux.clear();
 }
 
 //-------------------------
@@ -119,6 +126,9 @@ std::vector<WordIndex> IncrIbm1AligModel::getSrcSent(unsigned int n)
   std::vector<std::string> srcsStr;
   std::vector<WordIndex> result;
 
+  if(getSrcSentFromCorpusIds(n,result))
+    return result;
+
   sentenceHandler.getSrcSent(n,srcsStr);
   for(unsigned int i=0;i<srcsStr.size();++i)
   {
@@ -142,6 +152,9 @@ std::vector<WordIndex> IncrIbm1AligModel::getTrgSent(unsigned int n)
   std::vector<std::string> trgsStr;
   std::vector<WordIndex> trgs;
 
+  if(getTrgSentFromCorpusIds(n,trgs))
+    return trgs;
+
   sentenceHandler.getTrgSent(n,trgsStr);
   for(unsigned int i=0;i<trgsStr.size();++i)
   {
@@ -166,32 +179,115 @@ bool IncrIbm1AligModel::sentenceLengthIsOk(const std::vector<WordIndex> sentence
 void IncrIbm1AligModel::calcNewLocalSuffStats(std::pair<unsigned int,unsigned int> sentPairRange,
                                               int verbosity)
 {
-      // Iterate over the training samples
-  for(unsigned int n=sentPairRange.first;n<=sentPairRange.second;++n)
-  {
-        // Calculate sufficient statistics
+      // Determine block size. If the matrix of expected values has
+      // restricted size, the sentence pairs of a block must not share
+      // entries of the matrix
+  unsigned int blockSize=IBM_EM_THREAD_BLOCK_SIZE;
+  unsigned int maxnsize=anji.get_maxnsize();
+  if(maxnsize>0 && maxnsize<blockSize)
+    blockSize=maxnsize;
+
+  std::vector<EmScratch*> emScratchPtrVec(numThreads);
+  for(unsigned int k=0;k<numThreads;++k)
+    emScratchPtrVec[k]=createEmScratch();
+  EmSentPairProcessor<IncrIbm1AligModel,EmSentPair,EmScratch> emProcessor(this,
+                                                                         &IncrIbm1AligModel::calcNewLocalSuffStatsSentPair,
+                                                                         &IncrIbm1AligModel::mergeEmScratch);
+
+  unsigned int first=sentPairRange.first;
+  while(first<=sentPairRange.second)
+  {
+    unsigned int last=sentPairRange.second;
+    if(last-first>=blockSize)
+      last=first+blockSize-1;
+
+        // Read sentence pairs of the block. Entries for the expected
+        // values are initialized here, since this cannot be done
+        // concurrently
+    std::vector<EmSentPair> sentPairs;
+    for(unsigned int n=first;n<=last;++n)
+    {
+      std::vector<WordIndex> srcSent=getSrcSent(n);
+      EmSentPair emSentPair;
+      emSentPair.n=n;
+      emSentPair.nsrcSent=extendWithNullWord(srcSent);
+      emSentPair.trgSent=getTrgSent(n);
+      if(sentenceLengthIsOk(srcSent) && sentenceLengthIsOk(emSentPair.trgSent))
+      {
+        sentenceHandler.getCount(n,emSentPair.weight);
+        unsigned int mapped_n;
+        if(anji.init_nth_entry(n,emSentPair.nsrcSent.size(),emSentPair.trgSent.size(),mapped_n)==THOT_ERROR && anji.get_maxnsize()>0)
+          std::cerr<<"Warning, training pair "<<n+1<<" discarded since its expected values could not be stored"<<std::endl;
+        else
+          sentPairs.push_back(emSentPair);
+      }
+      else
+      {
+        if(verbosity)
+        {
+          std::cerr<<"Warning, training pair "<<n+1<<" discarded due to sentence length (slen: "<<srcSent.size()<<" , tlen: "<<emSentPair.trgSent.size()<<")"<<std::endl;
+        }
+      }
+    }
+
+        // Calculate and add local sufficient statistics
+    emProcessor.process(sentPairs,emScratchPtrVec);
+
+    if(last==sentPairRange.second)
+      break;
+    first=last+1;
+  }
 
-        // Init vars for n'th sample
-    std::vector<WordIndex> srcSent=getSrcSent(n);
-    std::vector<WordIndex> nsrcSent=extendWithNullWord(srcSent);
-    std::vector<WordIndex> trgSent=getTrgSent(n);
+  for(unsigned int k=0;k<numThreads;++k)
+    delete emScratchPtrVec[k];
+}
+
+//-------------------------
+void IncrIbm1AligModel::calcNewLocalSuffStatsSentPair(const EmSentPair& emSentPair,
+                                                      EmScratch& emScratch)
+{
+  calc_anji(emSentPair.n,emSentPair.nsrcSent,emSentPair.trgSent,emSentPair.weight,emScratch);
+}
 
-    Count weight;
-    sentenceHandler.getCount(n,weight);
+//-------------------------
+IncrIbm1AligModel::EmScratch* IncrIbm1AligModel::createEmScratch(void)
+{
+  return new EmScratch;
+}
 
-        // Process sentence pair only if both sentences are not empty
-    if(sentenceLengthIsOk(srcSent) && sentenceLengthIsOk(trgSent))
+//-------------------------
+void IncrIbm1AligModel::mergeEmScratch(EmScratch& emScratch)
+{
+      // Add lexical sufficient statistics
+  if(lexAuxVar.empty())
+  {
+    lexAuxVar.swap(emScratch.lexAuxVar);
+  }
+  else
+  {
+    while(lexAuxVar.size()<emScratch.lexAuxVar.size())
     {
-          // Calculate sufficient statistics for anji values
-      calc_anji(n,nsrcSent,trgSent,weight);
+      LexAuxVarElem lexAuxVarElem;
+      lexAuxVar.push_back(lexAuxVarElem);
     }
-    else
+    for(unsigned int s=0;s<emScratch.lexAuxVar.size();++s)
     {
-      if(verbosity)
+      for(LexAuxVarElem::iterator iter=emScratch.lexAuxVar[s].begin();iter!=emScratch.lexAuxVar[s].end();++iter)
       {
-        std::cerr<<"Warning, training pair "<<n+1<<" discarded due to sentence length (slen: "<<srcSent.size()<<" , tlen: "<<trgSent.size()<<")"<<std::endl;
+        LexAuxVarElem::iterator lexAuxVarElemIter=lexAuxVar[s].find(iter->first);
+        if(lexAuxVarElemIter!=lexAuxVar[s].end())
+        {
+          if(iter->second.first!=SMALL_LG_NUM)
+            lexAuxVarElemIter->second.first=MathFuncs::lns_sumlog_float(lexAuxVarElemIter->second.first,iter->second.first);
+          lexAuxVarElemIter->second.second=MathFuncs::lns_sumlog_float(lexAuxVarElemIter->second.second,iter->second.second);
+        }
+        else
+        {
+          lexAuxVar[s][iter->first]=iter->second;
+        }
       }
     }
+    emScratch.lexAuxVar.clear();
   }
 }
 
@@ -199,7 +295,8 @@ void IncrIbm1AligModel::calcNewLocalSuffStats(std::pair<unsigned int,unsigned in
 void IncrIbm1AligModel::calc_anji(unsigned int n,
                                   const std::vector<WordIndex>& nsrcSent,
                                   const std::vector<WordIndex>& trgSent,
-                                  const Count& weight)
+                                  const Count& weight,
+                                  EmScratch& emScratch)
 {
       // Initialize anji and anji_aux
   unsigned int mapped_n;
@@ -207,7 +304,7 @@ void IncrIbm1AligModel::calc_anji(unsigned int n,
     
   unsigned int n_aux=1;
   unsigned int mapped_n_aux;
-  anji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
+  emScratch.anji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
 
       // Calculate new estimation of anji
   for(unsigned int j=1;j<=trgSent.size();++j)
@@ -228,26 +325,26 @@ void IncrIbm1AligModel::calc_anji(unsigned int n,
         // Set value of anji_aux
     for(unsigned int i=0;i<nsrcSent.size();++i)
     {
-      anji_aux.set_fast(mapped_n_aux,j,i,numVec[i]/sum_anji_num_forall_s);
+      emScratch.anji_aux.set_fast(mapped_n_aux,j,i,numVec[i]/sum_anji_num_forall_s);
     }
   }
 
       // Gather sufficient statistics
-  if(anji_aux.n_size()!=0)
+  if(emScratch.anji_aux.n_size()!=0)
   {
     for(unsigned int j=1;j<=trgSent.size();++j)
     {
       for(unsigned int i=0;i<nsrcSent.size();++i)
       {
             // Fill variables for n_aux,j,i
-        fillEmAuxVars(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight);
+        fillEmAuxVars(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight,emScratch);
 
             // Update anji
-        anji.set_fast(mapped_n,j,i,anji_aux.get_invp(n_aux,j,i));
+        anji.set_fast(mapped_n,j,i,emScratch.anji_aux.get_invp(n_aux,j,i));
       }
     }
         // clear anji_aux data structure
-    anji_aux.clear();
+    emScratch.anji_aux.clear();
   }
 }
 
@@ -281,7 +378,8 @@ void IncrIbm1AligModel::fillEmAuxVars(unsigned int mapped_n,
                                       PositionIndex j,
                                       const std::vector<WordIndex>& nsrcSent,
                                       const std::vector<WordIndex>& trgSent,
-                                      const Count& weight)
+                                      const Count& weight,
+                                      EmScratch& emScratch)
 {
       // Init vars
   float weighted_curr_anji=0;
@@ -293,7 +391,7 @@ void IncrIbm1AligModel::fillEmAuxVars(unsigned int mapped_n,
       weighted_curr_anji=SMOOTHING_WEIGHTED_ANJI;
   }
 
-  float weighted_new_anji=(float)weight*anji_aux.get_invp_fast(mapped_n_aux,j,i);
+  float weighted_new_anji=(float)weight*emScratch.anji_aux.get_invp_fast(mapped_n_aux,j,i);
   if(weighted_new_anji!=0 && weighted_new_anji<SMOOTHING_WEIGHTED_ANJI)
     weighted_new_anji=SMOOTHING_WEIGHTED_ANJI;
 
@@ -310,14 +408,14 @@ void IncrIbm1AligModel::fillEmAuxVars(unsigned int mapped_n,
   float weighted_new_lanji=log(weighted_new_anji);
 
       // Store contributions
-  while(lexAuxVar.size()<=s)
+  while(emScratch.lexAuxVar.size()<=s)
   {
     LexAuxVarElem lexAuxVarElem;
-    lexAuxVar.push_back(lexAuxVarElem);
+    emScratch.lexAuxVar.push_back(lexAuxVarElem);
   }
   
-  LexAuxVarElem::iterator lexAuxVarElemIter=lexAuxVar[s].find(t);
-  if(lexAuxVarElemIter!=lexAuxVar[s].end())
+  LexAuxVarElem::iterator lexAuxVarElemIter=emScratch.lexAuxVar[s].find(t);
+  if(lexAuxVarElemIter!=emScratch.lexAuxVar[s].end())
   {
     if(weighted_curr_lanji!=SMALL_LG_NUM)
       lexAuxVarElemIter->second.first=MathFuncs::lns_sumlog_float(lexAuxVarElemIter->second.first,weighted_curr_lanji);
@@ -325,7 +423,7 @@ void IncrIbm1AligModel::fillEmAuxVars(unsigned int mapped_n,
   }
   else
   {
-    lexAuxVar[s][t]=std::make_pair(weighted_curr_lanji,weighted_new_lanji);
+    emScratch.lexAuxVar[s][t]=std::make_pair(weighted_curr_lanji,weighted_new_lanji);
   }
 }
 
@@ -883,7 +981,6 @@ void IncrIbm1AligModel::clear(void)
 {
   _swAligModel<std::vector<Prob> >::clear();
   anji.clear();
-  anji_aux.clear();
   incrLexTable.clear();
   sentLengthModel.clear();
 }
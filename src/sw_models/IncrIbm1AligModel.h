@@ -39,12 +39,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "IncrLexTable.h"
 #include "BestLgProbForTrgWord.h"
 #include "LexAuxVar.h"
+#include "EmSentPairProcessor.h"
 
 //--------------- Constants ------------------------------------------
 
 #define ARBITRARY_PTS            0.1
 #define SMOOTHING_ANJI_NUM       1e-6
 #define SMOOTHING_WEIGHTED_ANJI  1e-6
+#define IBM_EM_THREAD_BLOCK_SIZE 10000
 
 //--------------- typedefs -------------------------------------------
 
@@ -66,6 +68,7 @@ class IncrIbm1AligModel: public _incrSwAligModel<std::vector<Prob> >
    IncrIbm1AligModel();
 
    void set_expval_maxnsize(unsigned int _anji_maxnsize);
+   bool set_expval_mmap_prefix(const char* prefFileName);
        // Function to set a maximum size for the vector of expected
        // values anji (by default the size is not restricted)
 
@@ -177,11 +180,30 @@ class IncrIbm1AligModel: public _incrSwAligModel<std::vector<Prob> >
    ~IncrIbm1AligModel();
 
   protected:
-      
+
+       // Scratch data structures and local sufficient statistics used
+       // to compute the expected values for a set of sentence pairs
+       // (each thread of the E-step works with its own instance)
+   struct EmScratch
+   {
+     anjiMatrix anji_aux;
+     LexAuxVar lexAuxVar;
+
+     virtual ~EmScratch(){}
+   };
+
+       // Sentence pair to be processed by the E-step
+   struct EmSentPair
+   {
+     unsigned int n;
+     std::vector<WordIndex> nsrcSent;
+     std::vector<WordIndex> trgSent;
+     Count weight;
+   };
+
    WeightedIncrNormSlm sentLengthModel;
 
    anjiMatrix anji;
-   anjiMatrix anji_aux;
        // Data structures for manipulating expected values
 
    LexAuxVar lexAuxVar;
@@ -222,10 +244,21 @@ class IncrIbm1AligModel: public _incrSwAligModel<std::vector<Prob> >
    // EM-related functions
    void calcNewLocalSuffStats(std::pair<unsigned int,unsigned int> sentPairRange,
                               int verbosity=0);
+       // The sentence pairs are processed in blocks using numThreads
+       // threads (see EmSentPairProcessor.h)
+   void calcNewLocalSuffStatsSentPair(const EmSentPair& emSentPair,
+                                      EmScratch& emScratch);
+   virtual EmScratch* createEmScratch(void);
+       // Returns a new scratch object, derived classes storing
+       // additional sufficient statistics override this function
+   virtual void mergeEmScratch(EmScratch& emScratch);
+       // Adds the local sufficient statistics stored in emScratch to
+       // lexAuxVar
    void calc_anji(unsigned int n,
                   const std::vector<WordIndex>& nsrcSent,
                   const std::vector<WordIndex>& trgSent,
-                  const Count& weight);
+                  const Count& weight,
+                  EmScratch& emScratch);
    virtual double calc_anji_num(const std::vector<WordIndex>& nsrcSent,
                                 const std::vector<WordIndex>& trgSent,
                                 unsigned int i,
@@ -236,7 +269,8 @@ class IncrIbm1AligModel: public _incrSwAligModel<std::vector<Prob> >
                               PositionIndex j,
                               const std::vector<WordIndex>& nsrcSent,
                               const std::vector<WordIndex>& trgSent,
-                              const Count& weight);
+                              const Count& weight,
+                              EmScratch& emScratch);
    virtual void updatePars(void);
    virtual float obtainLogNewSuffStat(float lcurrSuffStat,
                                       float lLocalSuffStatCurr,
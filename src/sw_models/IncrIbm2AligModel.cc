@@ -91,6 +91,43 @@ double IncrIbm2AligModel::calc_anji_num_alig(PositionIndex i,
   }
 }
 
+//-------------------------
+IncrIbm1AligModel::EmScratch* IncrIbm2AligModel::createEmScratch(void)
+{
+  return new Ibm2EmScratch;
+}
+
+//-------------------------
+void IncrIbm2AligModel::mergeEmScratch(EmScratch& emScratch)
+{
+  IncrIbm1AligModel::mergeEmScratch(emScratch);
+
+      // Add alignment sufficient statistics
+  Ibm2EmScratch& ibm2EmScratch=static_cast<Ibm2EmScratch&>(emScratch);
+  if(aligAuxVar.empty())
+  {
+    aligAuxVar.swap(ibm2EmScratch.aligAuxVar);
+  }
+  else
+  {
+    for(AligAuxVar::iterator iter=ibm2EmScratch.aligAuxVar.begin();iter!=ibm2EmScratch.aligAuxVar.end();++iter)
+    {
+      AligAuxVar::iterator aligAuxVarIter=aligAuxVar.find(iter->first);
+      if(aligAuxVarIter!=aligAuxVar.end())
+      {
+        if(iter->second.first!=SMALL_LG_NUM)
+          aligAuxVarIter->second.first=MathFuncs::lns_sumlog_float(aligAuxVarIter->second.first,iter->second.first);
+        aligAuxVarIter->second.second=MathFuncs::lns_sumlog_float(aligAuxVarIter->second.second,iter->second.second);
+      }
+      else
+      {
+        aligAuxVar[iter->first]=iter->second;
+      }
+    }
+    ibm2EmScratch.aligAuxVar.clear();
+  }
+}
+
 //-------------------------   
 void IncrIbm2AligModel::fillEmAuxVars(unsigned int mapped_n,
                                       unsigned int mapped_n_aux,
@@ -98,10 +135,11 @@ void IncrIbm2AligModel::fillEmAuxVars(unsigned int mapped_n,
                                       PositionIndex j,
                                       const std::vector<WordIndex>& nsrcSent,
                                       const std::vector<WordIndex>& trgSent,
-                                      const Count& weight)
+                                      const Count& weight,
+                                      EmScratch& emScratch)
 {
-  IncrIbm1AligModel::fillEmAuxVars(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight);
-  fillEmAuxVarsAlig(mapped_n,mapped_n_aux,i,j,nsrcSent.size()-1,trgSent.size(),weight);
+  IncrIbm1AligModel::fillEmAuxVars(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight,emScratch);
+  fillEmAuxVarsAlig(mapped_n,mapped_n_aux,i,j,nsrcSent.size()-1,trgSent.size(),weight,static_cast<Ibm2EmScratch&>(emScratch));
 }
 
 //-------------------------   
@@ -111,7 +149,8 @@ void IncrIbm2AligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
                                           PositionIndex j,
                                           PositionIndex slen,
                                           PositionIndex tlen,
-                                          const Count& weight)
+                                          const Count& weight,
+                                          Ibm2EmScratch& ibm2EmScratch)
 {
       // Init vars
   float curr_anji=anji.get_fast(mapped_n,j,i);
@@ -123,7 +162,7 @@ void IncrIbm2AligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
       weighted_curr_anji=SMOOTHING_WEIGHTED_ANJI;
   }
 
-  float weighted_new_anji=(float)weight*anji_aux.get_invp_fast(mapped_n_aux,j,i);
+  float weighted_new_anji=(float)weight*ibm2EmScratch.anji_aux.get_invp_fast(mapped_n_aux,j,i);
   if(weighted_new_anji<SMOOTHING_WEIGHTED_ANJI)
     weighted_new_anji=SMOOTHING_WEIGHTED_ANJI;
   
@@ -144,8 +183,8 @@ void IncrIbm2AligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
   float weighted_new_lanji=log(weighted_new_anji);
 
       // Store contributions
-  AligAuxVar::iterator aligAuxVarIter=aligAuxVar.find(std::make_pair(as,i));
-  if(aligAuxVarIter!=aligAuxVar.end())
+  AligAuxVar::iterator aligAuxVarIter=ibm2EmScratch.aligAuxVar.find(std::make_pair(as,i));
+  if(aligAuxVarIter!=ibm2EmScratch.aligAuxVar.end())
   {
     if(weighted_curr_lanji!=SMALL_LG_NUM)
       aligAuxVarIter->second.first=MathFuncs::lns_sumlog_float(aligAuxVarIter->second.first,weighted_curr_lanji);
@@ -153,7 +192,7 @@ void IncrIbm2AligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
   }
   else
   {
-    aligAuxVar[std::make_pair(as,i)]=std::make_pair(weighted_curr_lanji,weighted_new_lanji);
+    ibm2EmScratch.aligAuxVar[std::make_pair(as,i)]=std::make_pair(weighted_curr_lanji,weighted_new_lanji);
   }
 }
 
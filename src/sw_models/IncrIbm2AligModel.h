@@ -135,6 +135,13 @@ class IncrIbm2AligModel: public IncrIbm1AligModel
    AligAuxVar aligAuxVar;
        // EM algorithm auxiliary variables
 
+       // Scratch data structures for the E-step, including local
+       // sufficient statistics for the alignment parameters
+   struct Ibm2EmScratch: public EmScratch
+   {
+     AligAuxVar aligAuxVar;
+   };
+
    // Auxiliar scoring functions
    virtual double unsmoothed_aProb(PositionIndex j,
                                    PositionIndex slen,
@@ -156,20 +163,24 @@ class IncrIbm2AligModel: public IncrIbm1AligModel
                              PositionIndex j,
                              PositionIndex slen,
                              PositionIndex tlen);
+   EmScratch* createEmScratch(void);
+   void mergeEmScratch(EmScratch& emScratch);
    void fillEmAuxVars(unsigned int mapped_n,
                       unsigned int mapped_n_aux,
                       PositionIndex i,
                       PositionIndex j,
                       const std::vector<WordIndex>& nsrcSent,
                       const std::vector<WordIndex>& trgSent,
-                      const Count& weight);
+                      const Count& weight,
+                      EmScratch& emScratch);
    void fillEmAuxVarsAlig(unsigned int mapped_n,
                           unsigned int mapped_n_aux,
                           PositionIndex i,
                           PositionIndex j,
                           PositionIndex slen,
                           PositionIndex tlen,
-                          const Count& weight);
+                          const Count& weight,
+                          Ibm2EmScratch& ibm2EmScratch);
    void updatePars(void);
    void updateParsAlig(void);
 
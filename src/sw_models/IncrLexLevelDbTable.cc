@@ -338,32 +338,23 @@ bool IncrLexLevelDbTable::loadBin(const char* lexNumDenFile)
 
     std::cerr << "Loading lexnd in LevelDB format from binary file in " << binFile << std::endl;
 
-    std::ifstream inF (binFile.c_str(), std::ios::in | std::ios::binary);
-    if (!inF)
+    // Binary files can be given in CSR or legacy format
+    LexCsrTableReader reader;
+    if(reader.open(binFile.c_str()) == THOT_ERROR)
     {
-        std::cerr << "Error in lexical nd file, file " << binFile << " does not exist. ";
+        std::cerr << "Error in lexical nd file, file " << binFile << " could not be opened. ";
 
         return THOT_ERROR;
     }
 
     // Read data stored in binary file and insert them to LevelDB
-    bool end = false;
-    while(!end)
+    WordIndex s;
+    WordIndex t;
+    float numer;
+    float denom;
+    while(reader.getNextRecord(s, t, numer, denom))
     {
-        WordIndex s;
-        WordIndex t;
-        float numer;
-        float denom;
-
-        if(inF.read((char*) &s, sizeof(WordIndex)))
-        {
-            inF.read((char*) &t, sizeof(WordIndex));
-            inF.read((char*) &numer, sizeof(float));
-            inF.read((char*) &denom, sizeof(float));
-
-            setLexNumDen(s, t, numer, denom);
-        }
-        else end = true;
+        setLexNumDen(s, t, numer, denom);
     }
 
     return THOT_OK;
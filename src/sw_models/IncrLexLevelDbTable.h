@@ -39,6 +39,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <_incrLexTable.h>
 #include <ErrorDefs.h>
 #include <StatModelDefs.h>
+#include <LexCsrTableReader.h>
 
 #include "leveldb/cache.h"
 #include "leveldb/db.h"
@@ -153,36 +153,90 @@ bool IncrLexTable::loadBin(const char* lexNumDenFile)
 
   std::cerr<<"Loading lexnd file in binary format from "<<lexNumDenFile<<std::endl;
 
-      // Try to open file  
-  std::ifstream inF (lexNumDenFile, std::ios::in | std::ios::binary);
-  if (!inF)
+      // Try to open file
+  LexCsrTableReader reader;
+  if(reader.open(lexNumDenFile)==THOT_ERROR)
   {
-    std::cerr<<"Error in lexical nd file, file "<<lexNumDenFile<<" does not exist.\n";
-    return THOT_ERROR;    
+    std::cerr<<"Error in lexical nd file, file "<<lexNumDenFile<<" could not be opened.\n";
+    return THOT_ERROR;
   }
   else
   {
-        // Read register
-    bool end=false;
-    while(!end)
+    if(reader.isCsr())
+      loadCsr(reader);
+    else
     {
+          // Read registers of legacy file
       WordIndex s;
       WordIndex t;
       float numer;
       float denom;
-      if(inF.read((char*)&s,sizeof(WordIndex)))
-      {
-        inF.read((char*)&t,sizeof(WordIndex));
-        inF.read((char*)&numer,sizeof(float));
-        inF.read((char*)&denom,sizeof(float));
+      while(reader.getNextRecord(s,t,numer,denom))
         setLexNumDen(s,t,numer,denom);
-      }
-      else end=true;
     }
     return THOT_OK;
   }
 }
 
+//-------------------------
+void IncrLexTable::loadCsr(const LexCsrTableReader& reader)
+{
+      // Load denominators
+  lexDenom.resize(reader.numRows(),std::make_pair(false,0));
+  for(size_t s=0;s<reader.numRows();++s)
+  {
+    bool found;
+    float denom=reader.getDenom(s,found);
+    lexDenom[s]=std::make_pair(found,denom);
+  }
+
+#ifdef THOT_DISABLE_SPACE_EFFICIENT_LEXDATA_STRUCTURES
+  for(size_t s=0;s<reader.numRows();++s)
+  {
+    for(const LexCsrEntry* entryPtr=reader.rowBegin(s);entryPtr!=reader.rowEnd(s);++entryPtr)
+      setLexNumer(s,entryPtr->trg,entryPtr->numer);
+  }
+#else
+      // Rows of the file are given by source word and lexNumer is
+      // indexed by target word. Transpose the entries by counting sort,
+      // obtaining the source words of each target word in increasing
+      // order, so the entries of each target word can be assigned at
+      // once
+  std::vector<uint64_t> trgOffsets;
+  const LexCsrEntry* entriesEnd=reader.rowBegin(0)+reader.numEntries();
+  for(const LexCsrEntry* entryPtr=reader.rowBegin(0);entryPtr!=entriesEnd;++entryPtr)
+  {
+    if(trgOffsets.size()<=(size_t)entryPtr->trg+1)
+      trgOffsets.resize((size_t)entryPtr->trg+2,0);
+    ++trgOffsets[entryPtr->trg+1];
+  }
+  for(size_t t=1;t<trgOffsets.size();++t)
+    trgOffsets[t]+=trgOffsets[t-1];
+
+  std::vector<WordIndex> srcVec(reader.numEntries());
+  std::vector<float> numerVec(reader.numEntries());
+  std::vector<uint64_t> nextPos(trgOffsets);
+  for(size_t s=0;s<reader.numRows();++s)
+  {
+    for(const LexCsrEntry* entryPtr=reader.rowBegin(s);entryPtr!=reader.rowEnd(s);++entryPtr)
+    {
+      uint64_t pos=nextPos[entryPtr->trg]++;
+      srcVec[pos]=s;
+      numerVec[pos]=entryPtr->numer;
+    }
+  }
+
+  if(!trgOffsets.empty())
+    lexNumer.resize(trgOffsets.size()-1);
+  for(size_t t=0;t<lexNumer.size();++t)
+  {
+    size_t num=trgOffsets[t+1]-trgOffsets[t];
+    if(num>0)
+      lexNumer[t].assignSorted(&srcVec[trgOffsets[t]],&numerVec[trgOffsets[t]],num);
+  }
+#endif
+}
+
 //-------------------------
 bool IncrLexTable::loadPlainText(const char* lexNumDenFile)
 {
@@ -229,7 +283,7 @@ bool IncrLexTable::print(const char* lexNumDenFile)
 bool IncrLexTable::printBin(const char* lexNumDenFile)
 {
   std::ofstream outF;
-  outF.open(lexNumDenFile,std::ios::out);
+  outF.open(lexNumDenFile,std::ios::out | std::ios::binary);
   if(!outF)
   {
     std::cerr<<"Error while printing lexical nd file."<<std::endl;
@@ -237,21 +291,59 @@ bool IncrLexTable::printBin(const char* lexNumDenFile)
   }
   else
   {
-        // print file with lexical nd values
+        // Transpose the entries of lexNumer, which is indexed by
+        // target word, since the file is sorted by source word
+    std::vector<uint64_t> srcOffsets;
     for(WordIndex t=0;t<lexNumer.size();++t)
     {
       LexNumerElem::const_iterator numElemIter;
       for(numElemIter=lexNumer[t].begin();numElemIter!=lexNumer[t].end();++numElemIter)
       {
-        bool found;
-        outF.write((char*)&numElemIter->first,sizeof(WordIndex));
-        outF.write((char*)&t,sizeof(WordIndex));
-        outF.write((char*)&numElemIter->second,sizeof(float));
-        float denom=getLexDenom(numElemIter->first,found);
-        outF.write((char*)&denom,sizeof(float));
+        if(srcOffsets.size()<=(size_t)numElemIter->first+1)
+          srcOffsets.resize((size_t)numElemIter->first+2,0);
+        ++srcOffsets[numElemIter->first+1];
       }
     }
-    return THOT_OK;
+    for(size_t s=1;s<srcOffsets.size();++s)
+      srcOffsets[s]+=srcOffsets[s-1];
+
+    std::vector<WordIndex> trgVec(srcOffsets.empty()?0:srcOffsets.back());
+    std::vector<float> numerVec(trgVec.size());
+    std::vector<uint64_t> nextPos(srcOffsets);
+    for(WordIndex t=0;t<lexNumer.size();++t)
+    {
+#ifdef THOT_DISABLE_SPACE_EFFICIENT_LEXDATA_STRUCTURES
+          // Entries of hash maps are not sorted
+      std::vector<std::pair<WordIndex,float> > elemVec(lexNumer[t].begin(),lexNumer[t].end());
+      std::sort(elemVec.begin(),elemVec.end());
+      std::vector<std::pair<WordIndex,float> >::const_iterator numElemIter;
+      for(numElemIter=elemVec.begin();numElemIter!=elemVec.end();++numElemIter)
+#else
+      LexNumerElem::const_iterator numElemIter;
+      for(numElemIter=lexNumer[t].begin();numElemIter!=lexNumer[t].end();++numElemIter)
+#endif
+      {
+        uint64_t pos=nextPos[numElemIter->first]++;
+        trgVec[pos]=t;
+        numerVec[pos]=numElemIter->second;
+      }
+    }
+
+        // Write file in CSR format
+    LexCsrTableWriter writer;
+    if(writer.open(outF)==THOT_ERROR)
+      return THOT_ERROR;
+    for(size_t s=0;s+1<srcOffsets.size();++s)
+    {
+      for(uint64_t pos=srcOffsets[s];pos<srcOffsets[s+1];++pos)
+        writer.addEntry(s,trgVec[pos],numerVec[pos]);
+    }
+    for(size_t s=0;s<lexDenom.size();++s)
+    {
+      if(lexDenom[s].first)
+        writer.setDenom(s,lexDenom[s].second);
+    }
+    return writer.close();
   }
 }
 
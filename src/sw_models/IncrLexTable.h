@@ -34,10 +34,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include <_incrLexTable.h>
+#include <LexCsrTableReader.h>
+#include <LexCsrTableWriter.h>
 #include <ErrorDefs.h>
 #include <fstream>
 #include <AwkInputStream.h>
 #include <StatModelDefs.h>
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -125,6 +128,7 @@ class IncrLexTable : public _incrLexTable
 
        // load and print auxiliary functions
    bool loadBin(const char* lexNumDenFile);
+   void loadCsr(const LexCsrTableReader& reader);
    bool loadPlainText(const char* lexNumDenFile);
    bool printBin(const char* lexNumDenFile);
    bool printPlainText(const char* lexNumDenFile);
@@ -0,0 +1,72 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LexCsrTableDefs.h
+ *
+ * @brief Constants and types of the CSR (compressed sparse row) format
+ * for binary lexical tables. A table in this format is composed of a
+ * header (magic string, version and size of WordIndex), the array of
+ * (target word, numerator) entries sorted by source and target word,
+ * the array of offsets of the first entry of each source word, the
+ * array of denominators of each source word, the array of flags
+ * telling whether a denominator is defined and a trailer with the
+ * number of source words (rows) and entries. Keeping the counts in the
+ * trailer allows the tables to be written in one pass to non-seekable
+ * streams. All arrays are aligned to 8 bytes, so the file can be
+ * memory-mapped.
+ */
+
+#ifndef _LexCsrTableDefs_h
+#define _LexCsrTableDefs_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordIndex.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//--------------- Constants ------------------------------------------
+
+#define LEX_CSR_TABLE_MAGIC         "thot_lexcsr_bin"
+#define LEX_CSR_TABLE_MAGIC_LEN     16
+#define LEX_CSR_TABLE_VERSION       1
+#define LEX_CSR_TABLE_HEADER_LEN    (LEX_CSR_TABLE_MAGIC_LEN+2*sizeof(uint32_t))
+#define LEX_CSR_TABLE_TRAILER_LEN   (2*sizeof(uint64_t))
+#define LEX_CSR_TABLE_INPUT_BUFFER_SIZE 1048576
+
+//--------------- Type definitions -----------------------------------
+
+struct LexCsrEntry
+{
+  WordIndex trg;
+  float numer;
+};
+
+//--------------- Function definitions -------------------------------
+
+inline size_t lexCsrAlignedSize(size_t bytes)
+{
+  return (bytes+7) & ~((size_t)7);
+}
+
+#endif
@@ -0,0 +1,282 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LexCsrTableReader.cc
+ *
+ * @brief Definitions file for LexCsrTableReader.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LexCsrTableReader.h"
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//--------------- LexCsrTableReader class function definitions
+
+//-------------------------
+LexCsrTableReader::LexCsrTableReader(void)
+{
+  csr=false;
+  mapAddr=NULL;
+  mapLength=0;
+  nRows=0;
+  nEntries=0;
+  entries=NULL;
+  rowOffsets=NULL;
+  denoms=NULL;
+  denomFlags=NULL;
+  currRow=0;
+  currEntry=0;
+}
+
+//-------------------------
+bool LexCsrTableReader::isCsrTable(const char* fileName)
+{
+  FILE* file=fopen(fileName,"rb");
+  if(file==NULL)
+    return false;
+  char magic[LEX_CSR_TABLE_MAGIC_LEN];
+  bool result=(fread(magic,1,LEX_CSR_TABLE_MAGIC_LEN,file)==LEX_CSR_TABLE_MAGIC_LEN
+               && strncmp(magic,LEX_CSR_TABLE_MAGIC,LEX_CSR_TABLE_MAGIC_LEN)==0);
+  fclose(file);
+  return result;
+}
+
+//-------------------------
+bool LexCsrTableReader::open(const char* fileName)
+{
+  close();
+
+  if(isCsrTable(fileName))
+  {
+    csr=true;
+    return mapCsrTable(fileName);
+  }
+  else
+  {
+        // Legacy tables are read sequentially, records are small, so a
+        // large buffer is used to reduce the number of reads
+    csr=false;
+    legacyBuffer.resize(LEX_CSR_TABLE_INPUT_BUFFER_SIZE);
+    legacyInF.rdbuf()->pubsetbuf(&legacyBuffer[0],legacyBuffer.size());
+    legacyInF.open(fileName,std::ios::in | std::ios::binary);
+    if(!legacyInF)
+    {
+      std::cerr<<"Error in file with lexical table, file "<<fileName<<" does not exist.\n";
+      return THOT_ERROR;
+    }
+    return THOT_OK;
+  }
+}
+
+//-------------------------
+bool LexCsrTableReader::mapCsrTable(const char* fileName)
+{
+  int fd=::open(fileName,O_RDONLY);
+  if(fd<0)
+  {
+    std::cerr<<"Error while opening lexical table "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)!=0)
+  {
+    std::cerr<<"Error while obtaining size of lexical table "<<fileName<<std::endl;
+    ::close(fd);
+    return THOT_ERROR;
+  }
+  size_t length=fileStat.st_size;
+  if(length<LEX_CSR_TABLE_HEADER_LEN+LEX_CSR_TABLE_TRAILER_LEN)
+  {
+    std::cerr<<"Error, lexical table "<<fileName<<" is truncated"<<std::endl;
+    ::close(fd);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,length,PROT_READ,MAP_SHARED,fd,0);
+  ::close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping lexical table "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  mapAddr=addr;
+  mapLength=length;
+
+      // Read header and trailer
+  const char* base=(const char*) addr;
+  uint32_t version;
+  uint32_t wordIndexSize;
+  memcpy(&version,base+LEX_CSR_TABLE_MAGIC_LEN,sizeof(uint32_t));
+  memcpy(&wordIndexSize,base+LEX_CSR_TABLE_MAGIC_LEN+sizeof(uint32_t),sizeof(uint32_t));
+  if(version!=LEX_CSR_TABLE_VERSION || wordIndexSize!=sizeof(WordIndex))
+  {
+    std::cerr<<"Error, lexical table "<<fileName<<" has version "<<version<<" and word index size "<<wordIndexSize<<" (expected "<<LEX_CSR_TABLE_VERSION<<" and "<<sizeof(WordIndex)<<")"<<std::endl;
+    close();
+    return THOT_ERROR;
+  }
+  memcpy(&nRows,base+length-LEX_CSR_TABLE_TRAILER_LEN,sizeof(uint64_t));
+  memcpy(&nEntries,base+length-sizeof(uint64_t),sizeof(uint64_t));
+
+      // Set pointers to the arrays
+  size_t offset=LEX_CSR_TABLE_HEADER_LEN;
+  size_t requiredLength=offset+lexCsrAlignedSize(nEntries*sizeof(LexCsrEntry))
+    +(nRows+1)*sizeof(uint64_t)+lexCsrAlignedSize(nRows*sizeof(float))
+    +lexCsrAlignedSize(nRows)+LEX_CSR_TABLE_TRAILER_LEN;
+  if(length!=requiredLength)
+  {
+    std::cerr<<"Error, lexical table "<<fileName<<" is truncated"<<std::endl;
+    close();
+    return THOT_ERROR;
+  }
+  entries=(const LexCsrEntry*)(base+offset);
+  offset+=lexCsrAlignedSize(nEntries*sizeof(LexCsrEntry));
+  rowOffsets=(const uint64_t*)(base+offset);
+  offset+=(nRows+1)*sizeof(uint64_t);
+  denoms=(const float*)(base+offset);
+  offset+=lexCsrAlignedSize(nRows*sizeof(float));
+  denomFlags=(const unsigned char*)(base+offset);
+
+      // Entries are read sequentially
+  madvise(addr,length,MADV_SEQUENTIAL);
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool LexCsrTableReader::isCsr(void)const
+{
+  return csr;
+}
+
+//-------------------------
+bool LexCsrTableReader::getNextRecord(WordIndex& s,
+                                      WordIndex& t,
+                                      float& numer,
+                                      float& denom)
+{
+  if(csr)
+  {
+    if(currEntry>=nEntries)
+      return false;
+
+        // Skip rows whose entries have already been read
+    while(rowOffsets[currRow+1]<=currEntry)
+      ++currRow;
+
+    bool found;
+    s=currRow;
+    t=entries[currEntry].trg;
+    numer=entries[currEntry].numer;
+    denom=getDenom(s,found);
+    ++currEntry;
+    return true;
+  }
+  else
+  {
+    if(legacyInF.read((char*)&s,sizeof(WordIndex)))
+    {
+      legacyInF.read((char*)&t,sizeof(WordIndex));
+      legacyInF.read((char*)&numer,sizeof(float));
+      legacyInF.read((char*)&denom,sizeof(float));
+      return true;
+    }
+    else return false;
+  }
+}
+
+//-------------------------
+uint64_t LexCsrTableReader::numRows(void)const
+{
+  return nRows;
+}
+
+//-------------------------
+uint64_t LexCsrTableReader::numEntries(void)const
+{
+  return nEntries;
+}
+
+//-------------------------
+const LexCsrEntry* LexCsrTableReader::rowBegin(WordIndex s)const
+{
+  if(s>=nRows)
+    return entries+nEntries;
+  else
+    return entries+rowOffsets[s];
+}
+
+//-------------------------
+const LexCsrEntry* LexCsrTableReader::rowEnd(WordIndex s)const
+{
+  if(s>=nRows)
+    return entries+nEntries;
+  else
+    return entries+rowOffsets[s+1];
+}
+
+//-------------------------
+float LexCsrTableReader::getDenom(WordIndex s,
+                                  bool& found)const
+{
+  if(s<nRows && denomFlags[s])
+  {
+    found=true;
+    return denoms[s];
+  }
+  else
+  {
+    found=false;
+    return 0;
+  }
+}
+
+//-------------------------
+void LexCsrTableReader::close(void)
+{
+  if(mapAddr!=NULL)
+  {
+    munmap(mapAddr,mapLength);
+    mapAddr=NULL;
+    mapLength=0;
+  }
+  if(legacyInF.is_open())
+    legacyInF.close();
+  legacyInF.clear();
+  csr=false;
+  nRows=0;
+  nEntries=0;
+  entries=NULL;
+  rowOffsets=NULL;
+  denoms=NULL;
+  denomFlags=NULL;
+  currRow=0;
+  currEntry=0;
+}
+
+//-------------------------
+LexCsrTableReader::~LexCsrTableReader()
+{
+  close();
+}
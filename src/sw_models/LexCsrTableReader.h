@@ -0,0 +1,109 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LexCsrTableReader.h
+ *
+ * @brief Defines the LexCsrTableReader class, which reads binary
+ * lexical tables. Tables in the CSR format described in
+ * LexCsrTableDefs.h are memory-mapped, giving direct access to the
+ * entries of each source word. Tables in the legacy format, composed
+ * of (s,t,numer,denom) records, are read sequentially. Both formats can
+ * be traversed record by record by means of the getNextRecord()
+ * function.
+ */
+
+#ifndef _LexCsrTableReader_h
+#define _LexCsrTableReader_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "LexCsrTableDefs.h"
+#include "ErrorDefs.h"
+#include <fstream>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LexCsrTableReader class
+
+class LexCsrTableReader
+{
+ public:
+
+      // Constructor
+  LexCsrTableReader(void);
+
+  bool open(const char* fileName);
+      // Opens a lexical table given in CSR or legacy format
+  static bool isCsrTable(const char* fileName);
+      // Returns true if the given file contains a table in CSR format
+  bool isCsr(void)const;
+
+  bool getNextRecord(WordIndex& s,
+                     WordIndex& t,
+                     float& numer,
+                     float& denom);
+      // Reads the next entry of the table, returns false if there are
+      // no entries left. The entries of CSR tables are returned in
+      // increasing (s,t) order
+
+      // Functions to access tables in CSR format
+  uint64_t numRows(void)const;
+  uint64_t numEntries(void)const;
+  const LexCsrEntry* rowBegin(WordIndex s)const;
+  const LexCsrEntry* rowEnd(WordIndex s)const;
+      // Return the range of entries of source word s, sorted by target
+      // word
+  float getDenom(WordIndex s,
+                 bool& found)const;
+
+      // close function
+  void close(void);
+
+      // Destructor
+  ~LexCsrTableReader();
+
+ protected:
+
+  bool csr;
+  void* mapAddr;
+  size_t mapLength;
+  uint64_t nRows;
+  uint64_t nEntries;
+  const LexCsrEntry* entries;
+  const uint64_t* rowOffsets;
+  const float* denoms;
+  const unsigned char* denomFlags;
+  uint64_t currRow;
+  uint64_t currEntry;
+  std::ifstream legacyInF;
+  std::vector<char> legacyBuffer;
+
+  bool mapCsrTable(const char* fileName);
+
+      // Forbid copies
+  LexCsrTableReader(const LexCsrTableReader&);
+  LexCsrTableReader& operator=(const LexCsrTableReader&);
+};
+
+#endif
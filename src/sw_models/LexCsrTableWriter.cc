@@ -0,0 +1,250 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LexCsrTableWriter.cc
+ *
+ * @brief Definitions file for LexCsrTableWriter.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LexCsrTableWriter.h"
+#include <MathFuncs.h>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- TrgWordLogCount struct
+
+struct TrgWordLogCount
+{
+  WordIndex trgWidx;
+  float lcSrcTrg;
+};
+
+//--------------- SortByLogCount class
+
+class SortByLogCount
+{
+ public:
+  bool operator()(const TrgWordLogCount& a,
+                  const TrgWordLogCount& b)const
+    {
+      return b.lcSrcTrg<a.lcSrcTrg;
+    }
+};
+
+//--------------- SortByTrgWord class
+
+class SortByTrgWord
+{
+ public:
+  bool operator()(const TrgWordLogCount& a,
+                  const TrgWordLogCount& b)const
+    {
+      return a.trgWidx<b.trgWidx;
+    }
+};
+
+//--------------- LexCsrTableWriter class function definitions
+
+//-------------------------
+LexCsrTableWriter::LexCsrTableWriter(void)
+{
+  outS=NULL;
+  nEntries=0;
+  lastSrc=0;
+  lastTrg=0;
+}
+
+//-------------------------
+bool LexCsrTableWriter::open(std::ostream& outStream)
+{
+  outS=&outStream;
+  rowOffsets.clear();
+  denoms.clear();
+  denomFlags.clear();
+  nEntries=0;
+
+  char magic[LEX_CSR_TABLE_MAGIC_LEN];
+  memset(magic,0,LEX_CSR_TABLE_MAGIC_LEN);
+  memcpy(magic,LEX_CSR_TABLE_MAGIC,strlen(LEX_CSR_TABLE_MAGIC));
+  uint32_t version=LEX_CSR_TABLE_VERSION;
+  uint32_t wordIndexSize=sizeof(WordIndex);
+  outS->write(magic,LEX_CSR_TABLE_MAGIC_LEN);
+  outS->write((char*)&version,sizeof(uint32_t));
+  outS->write((char*)&wordIndexSize,sizeof(uint32_t));
+
+  if(outS->good())
+    return THOT_OK;
+  else
+  {
+    std::cerr<<"Error while writing header of lexical table"<<std::endl;
+    return THOT_ERROR;
+  }
+}
+
+//-------------------------
+bool LexCsrTableWriter::addEntry(WordIndex s,
+                                 WordIndex t,
+                                 float numer)
+{
+      // Check order of entries
+  if(nEntries>0 && (s<lastSrc || (s==lastSrc && t<=lastTrg)))
+  {
+    std::cerr<<"Error, entries of lexical table are not sorted ("<<s<<" "<<t<<" given after "<<lastSrc<<" "<<lastTrg<<")"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Open rows up to s
+  while(rowOffsets.size()<=s)
+    rowOffsets.push_back(nEntries);
+
+  LexCsrEntry entry;
+  memset(&entry,0,sizeof(LexCsrEntry));
+  entry.trg=t;
+  entry.numer=numer;
+  outS->write((char*)&entry,sizeof(LexCsrEntry));
+  ++nEntries;
+  lastSrc=s;
+  lastTrg=t;
+
+  return THOT_OK;
+}
+
+//-------------------------
+void LexCsrTableWriter::setDenom(WordIndex s,
+                                 float denom)
+{
+  if(denoms.size()<=s)
+  {
+    denoms.resize(s+1,0);
+    denomFlags.resize(s+1,0);
+  }
+  denoms[s]=denom;
+  denomFlags[s]=1;
+}
+
+//-------------------------
+bool LexCsrTableWriter::addPrunedEntries(WordIndex s,
+                                         const std::vector<WordIndex>& trgWordVec,
+                                         const std::vector<float>& lcSrcTrgVec,
+                                         unsigned int maxTrgWords,
+                                         float cutoffProb)
+{
+  if(trgWordVec.empty())
+    return THOT_OK;
+
+      // Obtain count of source word
+  float lcSrc=lcSrcTrgVec[0];
+  for(unsigned int n=1;n<lcSrcTrgVec.size();++n)
+    lcSrc=MathFuncs::lns_sumlog(lcSrc,lcSrcTrgVec[n]);
+
+      // Sort counts for source word
+  std::vector<TrgWordLogCount> trgWordLogCountVec(trgWordVec.size());
+  for(unsigned int n=0;n<trgWordVec.size();++n)
+  {
+    trgWordLogCountVec[n].trgWidx=trgWordVec[n];
+    trgWordLogCountVec[n].lcSrcTrg=lcSrcTrgVec[n];
+  }
+  std::sort(trgWordLogCountVec.begin(),trgWordLogCountVec.end(),SortByLogCount());
+
+      // Determine number of counts to keep
+  float newLcSrc=SMALL_LG_NUM;
+  unsigned int numFiltTrgWords=0;
+  for(unsigned int n=0;n<trgWordLogCountVec.size();++n)
+  {
+    float prob=exp(trgWordLogCountVec[n].lcSrcTrg-lcSrc);
+    if((numFiltTrgWords<maxTrgWords || maxTrgWords==0) && prob>=cutoffProb)
+    {
+      newLcSrc=MathFuncs::lns_sumlog(newLcSrc,trgWordLogCountVec[n].lcSrcTrg);
+      ++numFiltTrgWords;
+    }
+    else break;
+  }
+
+      // Add entries (the entries of each source word are sorted by
+      // target word)
+  trgWordLogCountVec.resize(numFiltTrgWords);
+  std::sort(trgWordLogCountVec.begin(),trgWordLogCountVec.end(),SortByTrgWord());
+  for(unsigned int n=0;n<numFiltTrgWords;++n)
+  {
+    if(addEntry(s,trgWordLogCountVec[n].trgWidx,trgWordLogCountVec[n].lcSrcTrg)==THOT_ERROR)
+      return THOT_ERROR;
+  }
+  if(numFiltTrgWords>0)
+    setDenom(s,newLcSrc);
+  return THOT_OK;
+}
+
+//-------------------------
+bool LexCsrTableWriter::close(void)
+{
+      // Close remaining rows
+  uint64_t numRows=rowOffsets.size();
+  if(numRows<denoms.size())
+    numRows=denoms.size();
+  while(rowOffsets.size()<numRows+1)
+    rowOffsets.push_back(nEntries);
+  denoms.resize(numRows,0);
+  denomFlags.resize(numRows,0);
+
+      // Write arrays
+  writePadded(NULL,nEntries*sizeof(LexCsrEntry));
+  writePadded(&rowOffsets[0],rowOffsets.size()*sizeof(uint64_t));
+  writePadded(denoms.empty()?NULL:&denoms[0],denoms.size()*sizeof(float));
+  writePadded(denomFlags.empty()?NULL:&denomFlags[0],denomFlags.size());
+
+      // Write trailer
+  outS->write((char*)&numRows,sizeof(uint64_t));
+  outS->write((char*)&nEntries,sizeof(uint64_t));
+  outS->flush();
+
+  if(outS->good())
+    return THOT_OK;
+  else
+  {
+    std::cerr<<"Error while writing lexical table"<<std::endl;
+    return THOT_ERROR;
+  }
+}
+
+//-------------------------
+uint64_t LexCsrTableWriter::numEntries(void)const
+{
+  return nEntries;
+}
+
+//-------------------------
+bool LexCsrTableWriter::writePadded(const void* data,
+                                    size_t bytes)
+{
+      // data is NULL when only the padding of an array that has
+      // already been written is required
+  const char padding[8]={0,0,0,0,0,0,0,0};
+
+  if(data!=NULL && bytes>0)
+    outS->write((const char*)data,bytes);
+  size_t padLen=lexCsrAlignedSize(bytes)-bytes;
+  if(padLen>0)
+    outS->write(padding,padLen);
+  return outS->good()?THOT_OK:THOT_ERROR;
+}
@@ -0,0 +1,92 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LexCsrTableWriter.h
+ *
+ * @brief Defines the LexCsrTableWriter class, which writes binary
+ * lexical tables in the CSR format described in LexCsrTableDefs.h.
+ * Entries are written to the output stream as they are added, only the
+ * offsets and denominators of each source word are kept in memory.
+ */
+
+#ifndef _LexCsrTableWriter_h
+#define _LexCsrTableWriter_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "LexCsrTableDefs.h"
+#include "ErrorDefs.h"
+#include <iostream>
+#include <vector>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LexCsrTableWriter class
+
+class LexCsrTableWriter
+{
+ public:
+
+      // Constructor
+  LexCsrTableWriter(void);
+
+  bool open(std::ostream& outStream);
+      // Writes the header of the table to outStream
+  bool addEntry(WordIndex s,
+                WordIndex t,
+                float numer);
+      // Appends the numerator of the pair s,t. Entries must be added
+      // in increasing (s,t) order
+  void setDenom(WordIndex s,
+                float denom);
+      // Sets the denominator of s, it can be called in any order
+  bool addPrunedEntries(WordIndex s,
+                        const std::vector<WordIndex>& trgWordVec,
+                        const std::vector<float>& lcSrcTrgVec,
+                        unsigned int maxTrgWords,
+                        float cutoffProb);
+      // Appends the entries of s given the target words (in increasing
+      // order) and their log-counts, keeping the most frequent target
+      // words up to maxTrgWords (unlimited if zero) whose probability
+      // is not lower than cutoffProb. The denominator of s is set to
+      // the log-sum of the kept counts
+  bool close(void);
+      // Writes the offsets, the denominators and the trailer
+
+  uint64_t numEntries(void)const;
+
+ protected:
+
+  std::ostream* outS;
+  std::vector<uint64_t> rowOffsets;
+  std::vector<float> denoms;
+  std::vector<unsigned char> denomFlags;
+  uint64_t nEntries;
+  WordIndex lastSrc;
+  WordIndex lastTrg;
+
+  bool writePadded(const void* data,
+                   size_t bytes);
+};
+
+#endif
@@ -34,6 +34,7 @@ LightSentenceHandler::LightSentenceHandler(void)
   nsPairsInFiles=0;
   countFileExists=false;
   currFileSentIdx=0;
+  binCorpusOpen=false;
 }
 
 //-------------------------
@@ -49,6 +50,10 @@ bool LightSentenceHandler::readSentencePairs(const char *srcFileName,
      // Fill first field of sentRange
  sentRange.first=0;
 
+     // Check if source file is a binary corpus
+ if(BinSentPairCorpus::isBinCorpus(srcFileName))
+   return readBinCorpus(srcFileName,sentRange);
+
      // Open source file
  if(awkSrc.open(srcFileName)==THOT_ERROR)
  {
@@ -117,6 +122,36 @@ bool LightSentenceHandler::readSentencePairs(const char *srcFileName,
  }
 }
 
+//-------------------------
+bool LightSentenceHandler::readBinCorpus(const char *binFileName,
+                                         std::pair<unsigned int,unsigned int>& sentRange)
+{
+  std::cerr<<"Reading sentence pairs from binary corpus: "<<binFileName<<std::endl;
+  if(binCorpus.open(binFileName)==THOT_ERROR)
+    return THOT_ERROR;
+  binCorpusOpen=true;
+  nsPairsInFiles=binCorpus.numSentPairs();
+
+      // Display warnings if sentences are empty
+  for(size_t n=0;n<nsPairsInFiles;++n)
+  {
+    unsigned int len;
+    binCorpus.srcSent(n,len);
+    if(len==0)
+      std::cerr<<"Warning: source sentence "<<n<<" is empty"<<std::endl;
+    binCorpus.trgSent(n,len);
+    if(len==0)
+      std::cerr<<"Warning: target sentence "<<n<<" is empty"<<std::endl;
+  }
+
+      // Print statistics
+  if(nsPairsInFiles>0)
+    std::cerr<<"#Sentence pairs in files: "<<nsPairsInFiles<<std::endl;
+
+  sentRange.second=nsPairsInFiles-1;
+  return THOT_OK;
+}
+
 //-------------------------
 void LightSentenceHandler::rewindFiles(void)
 {
@@ -198,6 +233,23 @@ int LightSentenceHandler::nthSentPairFromFiles(unsigned int n,
       // Check if entry is contained in files
   if(n>=nsPairsInFiles)
     return THOT_ERROR;
+
+      // Decode entry if stored in a binary corpus
+  if(binCorpusOpen)
+  {
+    const uint32_t* ids;
+    unsigned int len;
+    srcSentStr.clear();
+    ids=binCorpus.srcSent(n,len);
+    for(unsigned int i=0;i<len;++i)
+      srcSentStr.push_back(binCorpus.srcWordStr(ids[i]));
+    trgSentStr.clear();
+    ids=binCorpus.trgSent(n,len);
+    for(unsigned int i=0;i<len;++i)
+      trgSentStr.push_back(binCorpus.trgWordStr(ids[i]));
+    c=binCorpus.count(n);
+    return THOT_OK;
+  }
   
       // Find corresponding entries
   if(currFileSentIdx>n)
@@ -287,6 +339,12 @@ int LightSentenceHandler::getTrgSent(unsigned int n,
 int LightSentenceHandler::getCount(unsigned int n,
                                    Count& c)
 {
+  if(binCorpusOpen && n<nsPairsInFiles)
+  {
+    c=binCorpus.count(n);
+    return THOT_OK;
+  }
+
   std::vector<std::string> srcSentStr;
   std::vector<std::string> trgSentStr;
 
@@ -295,6 +353,46 @@ int LightSentenceHandler::getCount(unsigned int n,
   return ret;  
 }
 
+//-------------------------
+bool LightSentenceHandler::getSrcSentCorpusIds(unsigned int n,
+                                               const uint32_t*& ids,
+                                               unsigned int& len)
+{
+  if(binCorpusOpen && n<nsPairsInFiles)
+  {
+    ids=binCorpus.srcSent(n,len);
+    return true;
+  }
+  else
+    return false;
+}
+
+//-------------------------
+bool LightSentenceHandler::getTrgSentCorpusIds(unsigned int n,
+                                               const uint32_t*& ids,
+                                               unsigned int& len)
+{
+  if(binCorpusOpen && n<nsPairsInFiles)
+  {
+    ids=binCorpus.trgSent(n,len);
+    return true;
+  }
+  else
+    return false;
+}
+
+//-------------------------
+std::string LightSentenceHandler::corpusSrcWordStr(uint32_t id)
+{
+  return binCorpus.srcWordStr(id);
+}
+
+//-------------------------
+std::string LightSentenceHandler::corpusTrgWordStr(uint32_t id)
+{
+  return binCorpus.trgWordStr(id);
+}
+
 //-------------------------
 bool LightSentenceHandler::printSentPairs(const char *srcSentFile,
                                           const char *trgSentFile,
@@ -376,4 +474,6 @@ void LightSentenceHandler::clear(void)
   awkSrcTrgC.close();
   countFileExists=false;
   currFileSentIdx=0;
+  binCorpus.clear();
+  binCorpusOpen=false;
 }
@@ -20,7 +20,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  * @file LightSentenceHandler.h
  * 
  * @brief Defines the LightSentenceHandler class.  LightSentenceHandler
- * class allow to access a set of sentence pairs.
+ * class allow to access a set of sentence pairs. Sentence pairs can be
+ * read from text files or from a pre-encoded binary corpus (see
+ * BinSentPairCorpus class), which gives random access to the sentences.
  * 
  */
 
@@ -37,6 +39,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include <string.h>
 #include "BaseSentenceHandler.h"
+#include "BinSentPairCorpus.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -62,7 +65,9 @@ class LightSentenceHandler: public BaseSentenceHandler
                           const char *sentCountsFile,
                           std::pair<unsigned int,unsigned int>& sentRange);
        // NOTE: when function readSentencePairs() is invoked, previously
-       //       seen sentence pairs are removed
+       //       seen sentence pairs are removed. If srcFileName is a
+       //       binary corpus, trgFileName and sentCountsFile are
+       //       ignored
 
    void addSentPair(std::vector<std::string> srcSentStr,
                     std::vector<std::string> trgSentStr,
@@ -82,6 +87,19 @@ class LightSentenceHandler: public BaseSentenceHandler
    int getCount(unsigned int n,
                 Count& c);
 
+       // Functions to access the word ids of a binary corpus
+   bool getSrcSentCorpusIds(unsigned int n,
+                            const uint32_t*& ids,
+                            unsigned int& len);
+   bool getTrgSentCorpusIds(unsigned int n,
+                            const uint32_t*& ids,
+                            unsigned int& len);
+       // Return the ids of the n'th source and target sentences in
+       // the vocabularies of the binary corpus. Return false if the
+       // sentence pair is not stored in a binary corpus
+   std::string corpusSrcWordStr(uint32_t id);
+   std::string corpusTrgWordStr(uint32_t id);
+
        // Functions to print sentence pairs
    bool printSentPairs(const char *srcSentFile,
                        const char *trgSentFile,
@@ -95,6 +113,8 @@ class LightSentenceHandler: public BaseSentenceHandler
    AwkInputStream awkSrc;
    AwkInputStream awkTrg;
    AwkInputStream awkSrcTrgC;
+   BinSentPairCorpus binCorpus;
+   bool binCorpusOpen;
 
    bool countFileExists;
    size_t nsPairsInFiles;
@@ -103,6 +123,8 @@ class LightSentenceHandler: public BaseSentenceHandler
    std::vector<std::pair<std::vector<std::string>,std::vector<std::string> > > sentPairCont;
    std::vector<Count> sentPairCount;
 
+   bool readBinCorpus(const char *binFileName,
+                      std::pair<unsigned int,unsigned int>& sentRange);
    void rewindFiles(void);
    bool getNextLineFromFiles(void);
    int nthSentPairFromFiles(unsigned int n,
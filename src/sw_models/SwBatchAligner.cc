@@ -0,0 +1,195 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file SwBatchAligner.cc
+ *
+ * @brief Definitions file for SwBatchAligner.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "SwBatchAligner.h"
+#include <iostream>
+
+//--------------- SwBatchAligner class function definitions
+
+//-------------------------
+SwBatchAligner::SwBatchAligner(BaseSwAligModel<std::vector<Prob> >* _swAligModelPtr)
+{
+  swAligModelPtr=_swAligModelPtr;
+  incrHmmAligModelPtr=dynamic_cast<_incrHmmAligModel*>(swAligModelPtr);
+  numThreads=1;
+  cachedAligLogProbsVec.resize(numThreads);
+}
+
+//-------------------------
+void SwBatchAligner::setNumThreads(unsigned int _numThreads)
+{
+  if(_numThreads==0)
+    numThreads=1;
+  else
+    numThreads=_numThreads;
+  cachedAligLogProbsVec.resize(numThreads);
+}
+
+//-------------------------
+unsigned int SwBatchAligner::getNumThreads(void)const
+{
+  return numThreads;
+}
+
+//-------------------------
+void SwBatchAligner::obtainBestAlignments(const std::vector<std::vector<WordIndex> >& srcSentVec,
+                                          const std::vector<std::vector<WordIndex> >& trgSentVec,
+                                          std::vector<LgProb>& lgProbVec,
+                                          std::vector<WordAligMatrix>& waMatrixVec)
+{
+  waMatrixVec.clear();
+  waMatrixVec.resize(srcSentVec.size());
+  process(srcSentVec,trgSentVec,lgProbVec,&waMatrixVec,0);
+}
+
+//-------------------------
+void SwBatchAligner::calcLgProbs(const std::vector<std::vector<WordIndex> >& srcSentVec,
+                                 const std::vector<std::vector<WordIndex> >& trgSentVec,
+                                 std::vector<LgProb>& lgProbVec,
+                                 int verbose)
+{
+  process(srcSentVec,trgSentVec,lgProbVec,NULL,verbose);
+}
+
+//-------------------------
+void SwBatchAligner::process(const std::vector<std::vector<WordIndex> >& srcSentVec,
+                             const std::vector<std::vector<WordIndex> >& trgSentVec,
+                             std::vector<LgProb>& lgProbVec,
+                             std::vector<WordAligMatrix>* waMatrixVecPtr,
+                             int verbose)
+{
+  lgProbVec.clear();
+  lgProbVec.resize(srcSentVec.size());
+
+  if(numThreads==1 || srcSentVec.size()<2)
+  {
+    processRange(0,srcSentVec.size(),srcSentVec,trgSentVec,lgProbVec,waMatrixVecPtr,verbose,cachedAligLogProbsVec[0]);
+    return;
+  }
+
+      // Split sentence pairs among threads. Each thread writes the
+      // results of a contiguous chunk, so the output keeps the order of
+      // the input
+  std::vector<ThreadData> threadDataVec(numThreads);
+  std::vector<pthread_t> threadIds(numThreads);
+  std::vector<bool> launched(numThreads,false);
+  unsigned int sentPairsPerThread=srcSentVec.size()/numThreads;
+  unsigned int remainder=srcSentVec.size()%numThreads;
+  unsigned int begin=0;
+  for(unsigned int k=0;k<numThreads;++k)
+  {
+    threadDataVec[k].batchAlignerPtr=this;
+    threadDataVec[k].srcSentVecPtr=&srcSentVec;
+    threadDataVec[k].trgSentVecPtr=&trgSentVec;
+    threadDataVec[k].lgProbVecPtr=&lgProbVec;
+    threadDataVec[k].waMatrixVecPtr=waMatrixVecPtr;
+    threadDataVec[k].begin=begin;
+    threadDataVec[k].end=begin+sentPairsPerThread;
+    if(k<remainder)
+      ++threadDataVec[k].end;
+    threadDataVec[k].verbose=verbose;
+    threadDataVec[k].cachedAligLogProbsPtr=&cachedAligLogProbsVec[k];
+    begin=threadDataVec[k].end;
+    if(pthread_create(&threadIds[k],NULL,processThread,&threadDataVec[k])!=0)
+      std::cerr<<"Warning: alignment thread "<<k<<" could not be created, its sentence pairs will be processed by the calling thread"<<std::endl;
+    else
+      launched[k]=true;
+  }
+
+      // Process the chunks of the threads that could not be created
+  for(unsigned int k=0;k<numThreads;++k)
+  {
+    if(!launched[k])
+      processThread(&threadDataVec[k]);
+  }
+
+  for(unsigned int k=0;k<numThreads;++k)
+  {
+    if(launched[k])
+      pthread_join(threadIds[k],NULL);
+  }
+}
+
+//-------------------------
+void SwBatchAligner::processRange(unsigned int begin,
+                                  unsigned int end,
+                                  const std::vector<std::vector<WordIndex> >& srcSentVec,
+                                  const std::vector<std::vector<WordIndex> >& trgSentVec,
+                                  std::vector<LgProb>& lgProbVec,
+                                  std::vector<WordAligMatrix>* waMatrixVecPtr,
+                                  int verbose,
+                                  CachedHmmAligLgProb& cached_logap)
+{
+  for(unsigned int n=begin;n<end;++n)
+  {
+    if(waMatrixVecPtr)
+    {
+          // Obtain best alignment
+      if(incrHmmAligModelPtr)
+      {
+        lgProbVec[n]=incrHmmAligModelPtr->obtainBestAlignmentCached(srcSentVec[n],
+                                                                    trgSentVec[n],
+                                                                    cached_logap,
+                                                                    (*waMatrixVecPtr)[n]);
+      }
+      else
+      {
+        lgProbVec[n]=swAligModelPtr->obtainBestAlignment(srcSentVec[n],
+                                                         trgSentVec[n],
+                                                         (*waMatrixVecPtr)[n]);
+      }
+    }
+    else
+    {
+          // Obtain log-probability summing over all alignments
+      lgProbVec[n]=swAligModelPtr->calcLgProb(srcSentVec[n],
+                                              trgSentVec[n],
+                                              verbose);
+    }
+  }
+}
+
+//-------------------------
+void* SwBatchAligner::processThread(void* arg)
+{
+  ThreadData* threadDataPtr=(ThreadData*) arg;
+  threadDataPtr->batchAlignerPtr->processRange(threadDataPtr->begin,
+                                               threadDataPtr->end,
+                                               *threadDataPtr->srcSentVecPtr,
+                                               *threadDataPtr->trgSentVecPtr,
+                                               *threadDataPtr->lgProbVecPtr,
+                                               threadDataPtr->waMatrixVecPtr,
+                                               threadDataPtr->verbose,
+                                               *threadDataPtr->cachedAligLogProbsPtr);
+  return NULL;
+}
+
+//-------------------------
+void SwBatchAligner::clear(void)
+{
+  cachedAligLogProbsVec.clear();
+  cachedAligLogProbsVec.resize(numThreads);
+}
@@ -0,0 +1,121 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file SwBatchAligner.h
+ *
+ * @brief Defines the SwBatchAligner class, which obtains Viterbi
+ * alignments or log-probabilities for a batch of sentence pairs using a
+ * single word alignment model shared by a set of threads. The model is
+ * only read during the computation, and each thread has its own cache
+ * of HMM alignment log-probabilities. Results are returned in the same
+ * order as the input sentence pairs.
+ */
+
+#ifndef _SwBatchAligner_h
+#define _SwBatchAligner_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BaseSwAligModel.h"
+#include "_incrHmmAligModel.h"
+#include "CachedHmmAligLgProb.h"
+#include <WordAligMatrix.h>
+#include <pthread.h>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define SW_BATCH_ALIGNER_BLOCK_SIZE 10000
+
+//--------------- Classes --------------------------------------------
+
+//--------------- SwBatchAligner class
+
+class SwBatchAligner
+{
+ public:
+
+      // Constructor
+  SwBatchAligner(BaseSwAligModel<std::vector<Prob> >* _swAligModelPtr);
+
+      // Thread-related functions
+  void setNumThreads(unsigned int _numThreads);
+  unsigned int getNumThreads(void)const;
+
+      // Functions to process a batch of sentence pairs. Word indices
+      // must have been obtained in advance (see
+      // strVectorToSrcIndexVector()), since adding symbols to the
+      // vocabularies of the model cannot be done concurrently
+  void obtainBestAlignments(const std::vector<std::vector<WordIndex> >& srcSentVec,
+                            const std::vector<std::vector<WordIndex> >& trgSentVec,
+                            std::vector<LgProb>& lgProbVec,
+                            std::vector<WordAligMatrix>& waMatrixVec);
+  void calcLgProbs(const std::vector<std::vector<WordIndex> >& srcSentVec,
+                   const std::vector<std::vector<WordIndex> >& trgSentVec,
+                   std::vector<LgProb>& lgProbVec,
+                   int verbose=0);
+
+      // clear function
+  void clear(void);
+
+ protected:
+
+      // Data given to each thread
+  struct ThreadData
+  {
+    SwBatchAligner* batchAlignerPtr;
+    const std::vector<std::vector<WordIndex> >* srcSentVecPtr;
+    const std::vector<std::vector<WordIndex> >* trgSentVecPtr;
+    std::vector<LgProb>* lgProbVecPtr;
+    std::vector<WordAligMatrix>* waMatrixVecPtr;
+    unsigned int begin;
+    unsigned int end;
+    int verbose;
+    CachedHmmAligLgProb* cachedAligLogProbsPtr;
+  };
+
+  BaseSwAligModel<std::vector<Prob> >* swAligModelPtr;
+  _incrHmmAligModel* incrHmmAligModelPtr;
+  unsigned int numThreads;
+  std::vector<CachedHmmAligLgProb> cachedAligLogProbsVec;
+      // Cached alignment log-probabilities for HMM based models, one
+      // per thread. They are kept between calls since they only depend
+      // on the model parameters
+
+  void process(const std::vector<std::vector<WordIndex> >& srcSentVec,
+               const std::vector<std::vector<WordIndex> >& trgSentVec,
+               std::vector<LgProb>& lgProbVec,
+               std::vector<WordAligMatrix>* waMatrixVecPtr,
+               int verbose);
+  void processRange(unsigned int begin,
+                    unsigned int end,
+                    const std::vector<std::vector<WordIndex> >& srcSentVec,
+                    const std::vector<std::vector<WordIndex> >& trgSentVec,
+                    std::vector<LgProb>& lgProbVec,
+                    std::vector<WordAligMatrix>* waMatrixVecPtr,
+                    int verbose,
+                    CachedHmmAligLgProb& cached_logap);
+  static void* processThread(void* arg);
+};
+
+#endif
@@ -24,6 +24,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <iomanip>
 #include "IncrHmmAligModel.h"
+#include "SwBatchAligner.h"
 #include <casmacat/IAlignmentEngine.h>
 #include <casmacat/IPluginFactory.h>
 #include <casmacat/utils.h>
@@ -47,6 +48,14 @@ public:
                      const vector<string> &target,
                      vector< vector<float> > &alignments); 
 
+      // Aligns a batch of sentence pairs using numThreads threads
+      // that share the loaded model. The i'th alignment matrix
+      // corresponds to the i'th sentence pair
+  void alignBatch(const vector< vector<string> > &sources,
+                  const vector< vector<string> > &targets,
+                  unsigned int numThreads,
+                  vector< vector< vector<float> > > &alignments);
+
   virtual void update(const std::vector<std::string> &source,
                       const std::vector<std::string> &target) {}
 
@@ -50,6 +50,45 @@ void ThotIbm2Aligner::align(const vector<string> &source,
   }
 }
 
+//-------------------------
+void ThotIbm2Aligner::alignBatch(const vector< vector<string> > &sources,
+                                 const vector< vector<string> > &targets,
+                                 unsigned int numThreads,
+                                 vector< vector< vector<float> > > &alignments)
+{
+      // Obtain word indices, this cannot be done concurrently since new
+      // symbols are added to the vocabularies of the model
+  std::vector<std::vector<WordIndex> > srcIndexVec;
+  std::vector<std::vector<WordIndex> > trgIndexVec;
+  for (size_t n=0; n<sources.size(); ++n) {
+    srcIndexVec.push_back(aligModel.strVectorToSrcIndexVector(sources[n]));
+    trgIndexVec.push_back(aligModel.strVectorToTrgIndexVector(targets[n]));
+  }
+
+      // Obtain best alignments
+  SwBatchAligner swBatchAligner(&aligModel);
+  swBatchAligner.setNumThreads(numThreads);
+  std::vector<LgProb> lgProbVec;
+  std::vector<WordAligMatrix> waMatrixVec;
+  swBatchAligner.obtainBestAlignments(srcIndexVec,trgIndexVec,lgProbVec,waMatrixVec);
+
+  alignments.resize(sources.size());
+  for (size_t n=0; n<sources.size(); ++n) {
+    if (sources[n].size() == 0 || targets[n].size() == 0) {
+      LOG(INFO) << "WARNING: ThotIbm2Aligner received an empty source or target sentence!!" << std::endl << "WARNING: Returning empty alignment matrix!" << std::endl;
+      alignments[n].resize(0);
+      continue;
+    }
+    alignments[n].resize(sources[n].size());
+    for (size_t s=0; s<sources[n].size(); ++s) {
+      alignments[n][s].resize(targets[n].size());
+      for (size_t t=0; t<targets[n].size(); ++t) {
+        alignments[n][s][t] = waMatrixVec[n].getValue(s,t);
+      }
+    }
+  }
+}
+
 //-------------------------
 int ThotIbm2Aligner::init(char* filesPrefix)
 {
@@ -49,6 +49,14 @@ void _incrHmmAligModel::set_expval_maxnsize(unsigned int _expval_maxnsize)
   lanjm1ip_anji.set_maxnsize(_expval_maxnsize);
 }
 
+//-------------------------
+bool _incrHmmAligModel::set_expval_mmap_prefix(const char* prefFileName)
+{
+  std::string lanjiArenaFile=prefFileName;
+  lanjiArenaFile=lanjiArenaFile+".lanji_arena";
+  return lanji.set_mmap_file(lanjiArenaFile.c_str());
+}
+
 //-------------------------
 unsigned int _incrHmmAligModel::numSentPairs(void)
 {
@@ -151,9 +159,7 @@ void _incrHmmAligModel::clearInfoAboutSentRange(void)
       // Clear info about sentence range
   sentenceHandler.clear();
   lanji.clear();
-  lanji_aux.clear();
   lanjm1ip_anji.clear();
-  lanjm1ip_anji_aux.clear();
 }
 
 //-------------------------
@@ -270,7 +276,8 @@ double _incrHmmAligModel::cached_logaProb(PositionIndex prev_i,
                                           PositionIndex slen,
                                           PositionIndex i,
                                           const std::vector<WordIndex>& /*nsrcSent*/,
-                                          const std::vector<WordIndex>& /*trgSent*/)
+                                          const std::vector<WordIndex>& /*trgSent*/,
+                                          CachedHmmAligLgProb& cachedAligLogProbs)
 {
   double d=cachedAligLogProbs.get(prev_i,slen,i);
   if(d<CACHED_HMM_ALIG_LGPROB_VIT_INVALID_VAL)
@@ -337,6 +344,9 @@ std::vector<WordIndex> _incrHmmAligModel::getSrcSent(unsigned int n)
   std::vector<std::string> srcsStr;
   std::vector<WordIndex> result;
 
+  if(getSrcSentFromCorpusIds(n,result))
+    return result;
+
   sentenceHandler.getSrcSent(n,srcsStr);
   for(unsigned int i=0;i<srcsStr.size();++i)
   {
@@ -388,6 +398,9 @@ std::vector<WordIndex> _incrHmmAligModel::getTrgSent(unsigned int n)
   std::vector<std::string> trgsStr;
   std::vector<WordIndex> trgs;
 
+  if(getTrgSentFromCorpusIds(n,trgs))
+    return trgs;
+
   sentenceHandler.getTrgSent(n,trgsStr);
   for(unsigned int i=0;i<trgsStr.size();++i)
   {
@@ -535,57 +548,215 @@ void _incrHmmAligModel::initCachedLexicalLps(const std::vector<WordIndex>& nSrcS
   }
 }
 
+//-------------------------
+void _incrHmmAligModel::initFlatLgProbs(const std::vector<WordIndex>& nSrcSentIndexVector,
+                                        const std::vector<WordIndex>& trgSentIndexVector,
+                                        CachedHmmAligLgProb& cached_logap,
+                                        std::vector<double>& initAligLgProbs,
+                                        std::vector<double>& aligLgProbs,
+                                        std::vector<double>& lexLgProbs)
+{
+  PositionIndex slen=getSrcLen(nSrcSentIndexVector);
+  unsigned int nslen=nSrcSentIndexVector.size();
+  unsigned int tlen=trgSentIndexVector.size();
+
+      // Obtain alignment log-probs
+  initAligLgProbs.resize(nslen);
+  aligLgProbs.resize(nslen*nslen);
+  for(PositionIndex i=1;i<=nslen;++i)
+  {
+    if(!cached_logap.isDefined(0,slen,i))
+      cached_logap.set_boundary_check(0,slen,i,logaProb(0,slen,i));
+    initAligLgProbs[i-1]=cached_logap.get(0,slen,i);
+  }
+  for(PositionIndex ip=1;ip<=nslen;++ip)
+  {
+    for(PositionIndex i=1;i<=nslen;++i)
+    {
+      if(!cached_logap.isDefined(ip,slen,i))
+        cached_logap.set_boundary_check(ip,slen,i,logaProb(ip,slen,i));
+      aligLgProbs[(ip-1)*nslen+i-1]=cached_logap.get(ip,slen,i);
+    }
+  }
+  
+      // Obtain lexical log-probs
+  lexLgProbs.resize(tlen*nslen);
+  for(PositionIndex j=1;j<=tlen;++j)
+  {
+    for(PositionIndex i=1;i<=nslen;++i)
+    {
+      lexLgProbs[(j-1)*nslen+i-1]=logpts(nSrcSentIndexVector[i-1],trgSentIndexVector[j-1]);
+    }
+  }
+}
+
 //-------------------------
 void _incrHmmAligModel::calcNewLocalSuffStats(std::pair<unsigned int,unsigned int> sentPairRange,
                                               int verbosity)
 {
-      // Iterate over the training samples
-  for(unsigned int n=sentPairRange.first;n<=sentPairRange.second;++n)
+      // Determine block size. If the matrices of expected values have
+      // restricted size, the sentence pairs of a block must not share
+      // entries of the matrices
+  unsigned int blockSize=HMM_EM_THREAD_BLOCK_SIZE;
+  unsigned int maxnsize=lanji.get_maxnsize();
+  if(maxnsize>0 && maxnsize<blockSize)
+    blockSize=maxnsize;
+  maxnsize=lanjm1ip_anji.get_maxnsize();
+  if(maxnsize>0 && maxnsize<blockSize)
+    blockSize=maxnsize;
+
+  std::vector<EmScratch*> emScratchPtrVec(numThreads);
+  for(unsigned int k=0;k<numThreads;++k)
+    emScratchPtrVec[k]=new EmScratch;
+  EmSentPairProcessor<_incrHmmAligModel,EmSentPair,EmScratch> emProcessor(this,
+                                                                          &_incrHmmAligModel::calcNewLocalSuffStatsSentPair,
+                                                                          &_incrHmmAligModel::mergeEmScratch);
+
+  unsigned int first=sentPairRange.first;
+  while(first<=sentPairRange.second)
   {
-        // Init vars for n'th sample
-    std::vector<WordIndex> srcSent=getSrcSent(n);
-    std::vector<WordIndex> nsrcSent=extendWithNullWord(srcSent);
-    std::vector<WordIndex> trgSent=getTrgSent(n);
-
-        // Do not process sentence pair if sentences are empty or exceed the maximum length
-    if(sentenceLengthIsOk(srcSent) && sentenceLengthIsOk(trgSent))
+    unsigned int last=sentPairRange.second;
+    if(last-first>=blockSize)
+      last=first+blockSize-1;
+
+        // Read sentence pairs of the block. Entries for the expected
+        // values are initialized here, since this cannot be done
+        // concurrently
+    std::vector<EmSentPair> sentPairs;
+    for(unsigned int n=first;n<=last;++n)
     {
-      Count weight;
-      sentenceHandler.getCount(n,weight);
+      EmSentPair emSentPair;
+      emSentPair.n=n;
+      emSentPair.srcSent=getSrcSent(n);
+      emSentPair.trgSent=getTrgSent(n);
+      if(sentenceLengthIsOk(emSentPair.srcSent) && sentenceLengthIsOk(emSentPair.trgSent))
+      {
+        sentenceHandler.getCount(n,emSentPair.weight);
+        unsigned int mapped_n;
+        if(lanji.init_nth_entry(n,extendWithNullWord(emSentPair.srcSent).size(),emSentPair.trgSent.size(),mapped_n)==THOT_ERROR && lanji.get_maxnsize()>0)
+          std::cerr<<"Warning, training pair "<<n+1<<" discarded since its expected values could not be stored"<<std::endl;
+        else
+        {
+          lanjm1ip_anji.init_nth_entry(n,extendWithNullWordAlig(emSentPair.srcSent).size(),emSentPair.trgSent.size(),mapped_n);
+          sentPairs.push_back(emSentPair);
+        }
+      }
+      else
+      {
+        if(verbosity)
+        {
+          std::cerr<<"Warning, training pair "<<n+1<<" discarded due to sentence length (slen: "<<emSentPair.srcSent.size()<<" , tlen: "<<emSentPair.trgSent.size()<<")"<<std::endl;
+        }
+      }
+    }
 
-          // Initialize data structure to cache lexical log-probs
-      initCachedLexicalLps(nsrcSent,trgSent,cachedLexLogProbs);
+        // Calculate and add local sufficient statistics
+    emProcessor.process(sentPairs,emScratchPtrVec);
 
-          // Make room for data structure to cache alignment log-probs
-      cachedAligLogProbs.makeRoomGivenNSrcSentLen(nsrcSent.size());
+    if(last==sentPairRange.second)
+      break;
+    first=last+1;
+  }
 
-          // Calculate alpha and beta matrices
-      calcAlphaMatrix(n,nsrcSent,trgSent);
-      calcBetaMatrix(n,nsrcSent,trgSent);
+  for(unsigned int k=0;k<numThreads;++k)
+    delete emScratchPtrVec[k];
+}
 
-          // Calculate sufficient statistics for anji values
-      calc_lanji(n,nsrcSent,trgSent,weight);
+//-------------------------
+void _incrHmmAligModel::calcNewLocalSuffStatsSentPair(const EmSentPair& emSentPair,
+                                                      EmScratch& emScratch)
+{
+  unsigned int n=emSentPair.n;
+  const std::vector<WordIndex>& srcSent=emSentPair.srcSent;
+  const std::vector<WordIndex>& trgSent=emSentPair.trgSent;
+  const Count& weight=emSentPair.weight;
+  std::vector<WordIndex> nsrcSent=extendWithNullWord(srcSent);
 
-          // Calculate sufficient statistics for anjm1ip_anji values
-      calc_lanjm1ip_anji(n,extendWithNullWordAlig(srcSent),trgSent,weight);
+      // Make room for data structure to cache alignment log-probs
+  emScratch.cachedAligLogProbs.makeRoomGivenNSrcSentLen(nsrcSent.size());
+
+      // Obtain flat buffers of lexical and alignment log-probs
+  emScratch.nslen=nsrcSent.size();
+  initFlatLgProbs(nsrcSent,
+                  trgSent,
+                  emScratch.cachedAligLogProbs,
+                  emScratch.initAligLgProbs,
+                  emScratch.aligLgProbs,
+                  emScratch.lexLgProbs);
+
+      // Calculate alpha and beta matrices
+  calcAlphaMatrix(n,nsrcSent,trgSent,emScratch);
+  calcBetaMatrix(n,nsrcSent,trgSent,emScratch);
+
+      // Calculate sufficient statistics for anji values
+  calc_lanji(n,nsrcSent,trgSent,weight,emScratch);
 
-          // Clear cached alpha and beta values
-      alphaMatrix.clear();
-      betaMatrix.clear();
+      // Calculate sufficient statistics for anjm1ip_anji values
+  calc_lanjm1ip_anji(n,extendWithNullWordAlig(srcSent),trgSent,weight,emScratch);
 
-          // Clear cached lexical log prob
-      cachedLexLogProbs.clear();
+      // Clear cached alpha and beta values
+  emScratch.alphaMatrix.clear();
+  emScratch.betaMatrix.clear();
+}
+
+//-------------------------
+void _incrHmmAligModel::mergeEmScratch(EmScratch& emScratch)
+{
+      // Add lexical sufficient statistics
+  if(lexAuxVar.empty())
+  {
+    lexAuxVar.swap(emScratch.lexAuxVar);
+  }
+  else
+  {
+    while(lexAuxVar.size()<emScratch.lexAuxVar.size())
+    {
+      LexAuxVarElem lexAuxVarElem;
+      lexAuxVar.push_back(lexAuxVarElem);
     }
-    else
+    for(unsigned int s=0;s<emScratch.lexAuxVar.size();++s)
     {
-      if(verbosity)
+      for(LexAuxVarElem::iterator iter=emScratch.lexAuxVar[s].begin();iter!=emScratch.lexAuxVar[s].end();++iter)
       {
-        std::cerr<<"Warning, training pair "<<n+1<<" discarded due to sentence length (slen: "<<srcSent.size()<<" , tlen: "<<trgSent.size()<<")"<<std::endl;
+        LexAuxVarElem::iterator lexAuxVarElemIter=lexAuxVar[s].find(iter->first);
+        if(lexAuxVarElemIter!=lexAuxVar[s].end())
+        {
+          if(iter->second.first!=SMALL_LG_NUM)
+            lexAuxVarElemIter->second.first=MathFuncs::lns_sumlog_float(lexAuxVarElemIter->second.first,iter->second.first);
+          lexAuxVarElemIter->second.second=MathFuncs::lns_sumlog_float(lexAuxVarElemIter->second.second,iter->second.second);
+        }
+        else
+        {
+          lexAuxVar[s][iter->first]=iter->second;
+        }
       }
     }
+    emScratch.lexAuxVar.clear();
+  }
+
+      // Add alignment sufficient statistics
+  if(aligAuxVar.empty())
+  {
+    aligAuxVar.swap(emScratch.aligAuxVar);
+  }
+  else
+  {
+    for(AligAuxVar::iterator iter=emScratch.aligAuxVar.begin();iter!=emScratch.aligAuxVar.end();++iter)
+    {
+      AligAuxVar::iterator aligAuxVarIter=aligAuxVar.find(iter->first);
+      if(aligAuxVarIter!=aligAuxVar.end())
+      {
+        if(iter->second.first!=SMALL_LG_NUM)
+          aligAuxVarIter->second.first=MathFuncs::lns_sumlog_float(aligAuxVarIter->second.first,iter->second.first);
+        aligAuxVarIter->second.second=MathFuncs::lns_sumlog_float(aligAuxVarIter->second.second,iter->second.second);
+      }
+      else
+      {
+        aligAuxVar[iter->first]=iter->second;
+      }
+    }
+    emScratch.aligAuxVar.clear();
   }
-      // Clear cached alignment log probs
-  cachedAligLogProbs.clear();
 }
 
 //-------------------------
@@ -595,6 +766,8 @@ void _incrHmmAligModel::calcNewLocalSuffStatsVit(std::pair<unsigned int,unsigned
       // Define variable to cache alignment log probs
   CachedHmmAligLgProb cached_logap;
 
+  EmScratch emScratch;
+
       // Iterate over the training samples
   for(unsigned int n=sentPairRange.first;n<=sentPairRange.second;++n)
   {
@@ -619,10 +792,10 @@ void _incrHmmAligModel::calcNewLocalSuffStatsVit(std::pair<unsigned int,unsigned
       bestAligGivenVitMatricesRaw(vitMatrix,predMatrix,bestAlig);
 
           // Calculate sufficient statistics for anji values
-      calc_lanji_vit(n,nsrcSent,trgSent,bestAlig,weight);
+      calc_lanji_vit(n,nsrcSent,trgSent,bestAlig,weight,emScratch);
 
           // Calculate sufficient statistics for anjm1ip_anji values
-      calc_lanjm1ip_anji_vit(n,extendWithNullWordAlig(srcSent),trgSent,bestAlig,weight);
+      calc_lanjm1ip_anji_vit(n,extendWithNullWordAlig(srcSent),trgSent,bestAlig,weight,emScratch);
     }
     else
     {
@@ -632,43 +805,73 @@ void _incrHmmAligModel::calcNewLocalSuffStatsVit(std::pair<unsigned int,unsigned
       }
     }
   }
+      // Add local sufficient statistics
+  mergeEmScratch(emScratch);
 }
 
 //-------------------------
 void _incrHmmAligModel::calcAlphaMatrix(unsigned int /*n*/,
                                         const std::vector<WordIndex>& nsrcSent,
-                                        const std::vector<WordIndex>& trgSent)
-{
-      // Obtain slen
-  PositionIndex slen=getSrcLen(nsrcSent);
+                                        const std::vector<WordIndex>& trgSent,
+                                        EmScratch& emScratch)
+{
+  unsigned int nslen=nsrcSent.size();
+  unsigned int tlen=trgSent.size();
+
+      // Obtain probabilities from flat buffers of log-probs
+  HmmFbKernels::lgProbsToProbs(emScratch.initAligLgProbs,emScratch.initAligProbs);
+  HmmFbKernels::lgProbsToProbs(emScratch.aligLgProbs,emScratch.aligProbs);
+  HmmFbKernels::lgProbsToProbs(emScratch.lexLgProbs,emScratch.lexProbs);
+
+      // Execute scaled forward algorithm
+  emScratch.scaledAlpha.resize(tlen*nslen);
+  emScratch.fbScales.resize(tlen);
+  emScratch.scaledFb=HmmFbKernels::scaledForward(nslen,
+                                                 tlen,
+                                                 &emScratch.initAligProbs[0],
+                                                 &emScratch.aligProbs[0],
+                                                 &emScratch.lexProbs[0],
+                                                 &emScratch.scaledAlpha[0],
+                                                 &emScratch.fbScales[0]);
+  if(emScratch.scaledFb)
+  {
+        // Accumulate logarithms of scaling factors
+    emScratch.alphaLgScales.resize(tlen+1);
+    emScratch.alphaLgScales[0]=0;
+    for(PositionIndex j=1;j<=tlen;++j)
+      emScratch.alphaLgScales[j]=emScratch.alphaLgScales[j-1]+log(emScratch.fbScales[j-1]);
+    return;
+  }
+
+      // Scaled computation underflowed, use log-space computation
 
       // Initialize alphaMatrix
-  alphaMatrix.clear();
+  emScratch.alphaMatrix.clear();
   std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSent.size()+1,0.0);
-  alphaMatrix.insert(alphaMatrix.begin(),nsrcSent.size()+1,dVec);
+  dVec.insert(dVec.begin(),tlen+1,0.0);
+  emScratch.alphaMatrix.insert(emScratch.alphaMatrix.begin(),nslen+1,dVec);
 
       // Fill matrix
-  for(PositionIndex j=1;j<=trgSent.size();++j)
+  for(PositionIndex j=1;j<=tlen;++j)
   {
-    for(PositionIndex i=1;i<=nsrcSent.size();++i)
+    for(PositionIndex i=1;i<=nslen;++i)
     {
       if(j==1)
       {
-        alphaMatrix[i][j]=cached_logaProb(0,slen,i,nsrcSent,trgSent)+
-          cachedLexLogProbs[i][j];
+        emScratch.alphaMatrix[i][j]=emScratch.initAligLgProbs[i-1]+
+          emScratch.lexLgProbs[(j-1)*nslen+i-1];
       }
       else
       {
-        for(PositionIndex i_tilde=1;i_tilde<=nsrcSent.size();++i_tilde)
+        for(PositionIndex i_tilde=1;i_tilde<=nslen;++i_tilde)
         {
-          double lp=alphaMatrix[i_tilde][j-1]+
-            cached_logaProb(i_tilde,slen,i,nsrcSent,trgSent)+
-            cachedLexLogProbs[i][j];
+          double lp=emScratch.alphaMatrix[i_tilde][j-1]+
+            emScratch.aligLgProbs[(i_tilde-1)*nslen+i-1]+
+            emScratch.lexLgProbs[(j-1)*nslen+i-1];
           if(i_tilde==1)
-            alphaMatrix[i][j]=lp;
+            emScratch.alphaMatrix[i][j]=lp;
           else
-            alphaMatrix[i][j]=MathFuncs::lns_sumlog(lp,alphaMatrix[i][j]);
+            emScratch.alphaMatrix[i][j]=MathFuncs::lns_sumlog(lp,emScratch.alphaMatrix[i][j]);
         }
       }
     }
@@ -678,37 +881,58 @@ void _incrHmmAligModel::calcAlphaMatrix(unsigned int /*n*/,
 //-------------------------
 void _incrHmmAligModel::calcBetaMatrix(unsigned int /*n*/,
                                        const std::vector<WordIndex>& nsrcSent,
-                                       const std::vector<WordIndex>& trgSent)
+                                       const std::vector<WordIndex>& trgSent,
+                                       EmScratch& emScratch)
 {
-      // Obtain slen
-  PositionIndex slen=getSrcLen(nsrcSent);
+  unsigned int nslen=nsrcSent.size();
+  unsigned int tlen=trgSent.size();
+
+  if(emScratch.scaledFb)
+  {
+        // Execute scaled backward algorithm using the scaling factors
+        // of the forward algorithm
+    emScratch.scaledBeta.resize(tlen*nslen);
+    HmmFbKernels::scaledBackward(nslen,
+                                 tlen,
+                                 &emScratch.aligProbs[0],
+                                 &emScratch.lexProbs[0],
+                                 &emScratch.fbScales[0],
+                                 &emScratch.scaledBeta[0]);
+
+        // Accumulate logarithms of scaling factors
+    emScratch.betaLgScales.resize(tlen+1);
+    emScratch.betaLgScales[tlen]=0;
+    for(PositionIndex j=tlen-1;j>=1;--j)
+      emScratch.betaLgScales[j]=emScratch.betaLgScales[j+1]+log(emScratch.fbScales[j]);
+    return;
+  }
 
       // Initialize betaMatrix
-  betaMatrix.clear();
+  emScratch.betaMatrix.clear();
   std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSent.size()+1,0.0);
-  betaMatrix.insert(betaMatrix.begin(),nsrcSent.size()+1,dVec);
+  dVec.insert(dVec.begin(),tlen+1,0.0);
+  emScratch.betaMatrix.insert(emScratch.betaMatrix.begin(),nslen+1,dVec);
 
       // Fill matrix
-  for(PositionIndex j=trgSent.size();j>=1;--j)
+  for(PositionIndex j=tlen;j>=1;--j)
   {
-    for(PositionIndex i=1;i<=nsrcSent.size();++i)
+    for(PositionIndex i=1;i<=nslen;++i)
     {
-      if(j==trgSent.size())
+      if(j==tlen)
       {
-        betaMatrix[i][j]=log(1.0);
+        emScratch.betaMatrix[i][j]=log(1.0);
       }
       else
       {
-        for(PositionIndex i_tilde=1;i_tilde<=nsrcSent.size();++i_tilde)
+        for(PositionIndex i_tilde=1;i_tilde<=nslen;++i_tilde)
         {
-          double lp=betaMatrix[i_tilde][j+1]+
-            cached_logaProb(i,slen,i_tilde,nsrcSent,trgSent)+
-            cachedLexLogProbs[i_tilde][j+1];
+          double lp=emScratch.betaMatrix[i_tilde][j+1]+
+            emScratch.aligLgProbs[(i-1)*nslen+i_tilde-1]+
+            emScratch.lexLgProbs[j*nslen+i_tilde-1];
           if(i_tilde==1)
-            betaMatrix[i][j]=lp;
+            emScratch.betaMatrix[i][j]=lp;
           else
-            betaMatrix[i][j]=MathFuncs::lns_sumlog(lp,betaMatrix[i][j]);
+            emScratch.betaMatrix[i][j]=MathFuncs::lns_sumlog(lp,emScratch.betaMatrix[i][j]);
         }
       }
     }
@@ -719,7 +943,8 @@ void _incrHmmAligModel::calcBetaMatrix(unsigned int /*n*/,
 void _incrHmmAligModel::calc_lanji(unsigned int n,
                                    const std::vector<WordIndex>& nsrcSent,
                                    const std::vector<WordIndex>& trgSent,
-                                   const Count& weight)
+                                   const Count& weight,
+                                   EmScratch& emScratch)
 {
   PositionIndex slen=getSrcLen(nsrcSent);
 
@@ -729,7 +954,7 @@ void _incrHmmAligModel::calc_lanji(unsigned int n,
 
   unsigned int n_aux=1;
   unsigned int mapped_n_aux;
-  lanji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
+  emScratch.lanji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
 
   std::vector<double> numVec(nsrcSent.size()+1,0);
 
@@ -741,7 +966,7 @@ void _incrHmmAligModel::calc_lanji(unsigned int n,
     for(unsigned int i=1;i<=nsrcSent.size();++i)
     {
           // Obtain numerator
-      double d=calc_lanji_num(slen,i,j,nsrcSent,trgSent);
+      double d=calc_lanji_num(slen,i,j,nsrcSent,trgSent,emScratch);
 
           // Add contribution to sum
       if(sum_lanji_num_forall_s==INVALID_ANJI_VAL)
@@ -760,14 +985,14 @@ void _incrHmmAligModel::calc_lanji(unsigned int n,
       if(lanji_val>EXP_VAL_LOG_MAX) lanji_val=EXP_VAL_LOG_MAX;
       if(lanji_val<EXP_VAL_LOG_MIN) lanji_val=EXP_VAL_LOG_MIN;
           // Store expected value
-      lanji_aux.set_fast(mapped_n_aux,j,i,lanji_val);
+      emScratch.lanji_aux.set_fast(mapped_n_aux,j,i,lanji_val);
     }
   }
       // Gather lexical sufficient statistics
-  gatherLexSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight);
+  gatherLexSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight,emScratch);
 
       // clear lanji_aux data structure
-  lanji_aux.clear();
+  emScratch.lanji_aux.clear();
 }
 
 //-------------------------
@@ -775,7 +1000,8 @@ void _incrHmmAligModel::calc_lanji_vit(unsigned int n,
                                        const std::vector<WordIndex>& nsrcSent,
                                        const std::vector<WordIndex>& trgSent,
                                        const std::vector<PositionIndex>& bestAlig,
-                                       const Count& weight)
+                                       const Count& weight,
+                                       EmScratch& emScratch)
 {
         // Initialize data structures
   unsigned int mapped_n;
@@ -783,7 +1009,7 @@ void _incrHmmAligModel::calc_lanji_vit(unsigned int n,
 
   unsigned int n_aux=1;
   unsigned int mapped_n_aux;
-  lanji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
+  emScratch.lanji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
 
       // Calculate new estimation of lanji
   for(unsigned int j=1;j<=trgSent.size();++j)
@@ -796,16 +1022,16 @@ void _incrHmmAligModel::calc_lanji_vit(unsigned int n,
             // Obtain expected value
         double lanji_val=0;
             // Store expected value
-        lanji_aux.set_fast(mapped_n_aux,j,i,lanji_val);
+        emScratch.lanji_aux.set_fast(mapped_n_aux,j,i,lanji_val);
       }
     }
   }
 
       // Gather lexical sufficient statistics
-  gatherLexSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight);
+  gatherLexSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight,emScratch);
 
       // clear lanji_aux data structure
-  lanji_aux.clear();
+  emScratch.lanji_aux.clear();
 }
 
 //-------------------------
@@ -813,7 +1039,8 @@ void _incrHmmAligModel::gatherLexSuffStats(unsigned int mapped_n,
                                            unsigned int mapped_n_aux,
                                            const std::vector<WordIndex>& nsrcSent,
                                            const std::vector<WordIndex>& trgSent,
-                                           const Count& weight)
+                                           const Count& weight,
+                                           EmScratch& emScratch)
 {
       // Gather lexical sufficient statistics
   for(unsigned int j=1;j<=trgSent.size();++j)
@@ -821,10 +1048,10 @@ void _incrHmmAligModel::gatherLexSuffStats(unsigned int mapped_n,
     for(unsigned int i=1;i<=nsrcSent.size();++i)
     {
           // Reestimate lexical parameters
-      fillEmAuxVarsLex(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight);
+      fillEmAuxVarsLex(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight,emScratch);
 
           // Update lanji
-      lanji.set_fast(mapped_n,j,i,lanji_aux.get_invlogp(mapped_n_aux,j,i));
+      lanji.set_fast(mapped_n,j,i,emScratch.lanji_aux.get_invlogp(mapped_n_aux,j,i));
     }
   }
 }
@@ -836,7 +1063,8 @@ void _incrHmmAligModel::fillEmAuxVarsLex(unsigned int mapped_n,
                                          PositionIndex j,
                                          const std::vector<WordIndex>& nsrcSent,
                                          const std::vector<WordIndex>& trgSent,
-                                         const Count& weight)
+                                         const Count& weight,
+                                         EmScratch& emScratch)
 {
       // Init vars
   float curr_lanji=lanji.get_fast(mapped_n,j,i);
@@ -848,7 +1076,7 @@ void _incrHmmAligModel::fillEmAuxVarsLex(unsigned int mapped_n,
       weighted_curr_lanji=SMALL_LG_NUM;
   }
 
-  float weighted_new_lanji=(float)log((float)weight)+lanji_aux.get_invlogp_fast(mapped_n_aux,j,i);
+  float weighted_new_lanji=(float)log((float)weight)+emScratch.lanji_aux.get_invlogp_fast(mapped_n_aux,j,i);
   if(weighted_new_lanji<SMALL_LG_NUM)
     weighted_new_lanji=SMALL_LG_NUM;
 
@@ -856,14 +1084,14 @@ void _incrHmmAligModel::fillEmAuxVarsLex(unsigned int mapped_n,
   WordIndex t=trgSent[j-1];
 
       // Store contributions
-  while(lexAuxVar.size()<=s)
+  while(emScratch.lexAuxVar.size()<=s)
   {
     LexAuxVarElem lexAuxVarElem;
-    lexAuxVar.push_back(lexAuxVarElem);
+    emScratch.lexAuxVar.push_back(lexAuxVarElem);
   }
 
-  LexAuxVarElem::iterator lexAuxVarElemIter=lexAuxVar[s].find(t);
-  if(lexAuxVarElemIter!=lexAuxVar[s].end())
+  LexAuxVarElem::iterator lexAuxVarElemIter=emScratch.lexAuxVar[s].find(t);
+  if(lexAuxVarElemIter!=emScratch.lexAuxVar[s].end())
   {
     if(weighted_curr_lanji!=SMALL_LG_NUM)
       lexAuxVarElemIter->second.first=MathFuncs::lns_sumlog_float(lexAuxVarElemIter->second.first,weighted_curr_lanji);
@@ -871,7 +1099,7 @@ void _incrHmmAligModel::fillEmAuxVarsLex(unsigned int mapped_n,
   }
   else
   {
-    lexAuxVar[s][t]=std::make_pair(weighted_curr_lanji,weighted_new_lanji);
+    emScratch.lexAuxVar[s][t]=std::make_pair(weighted_curr_lanji,weighted_new_lanji);
   }
 }
 
@@ -879,7 +1107,8 @@ void _incrHmmAligModel::fillEmAuxVarsLex(unsigned int mapped_n,
 void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
                                            const std::vector<WordIndex>& nsrcSent,
                                            const std::vector<WordIndex>& trgSent,
-                                           const Count& weight)
+                                           const Count& weight,
+                                           EmScratch& emScratch)
 {
   PositionIndex slen=getSrcLen(nsrcSent);
 
@@ -889,7 +1118,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
 
   unsigned int n_aux=1;
   unsigned int mapped_n_aux;
-  lanjm1ip_anji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
+  emScratch.lanjm1ip_anji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
 
   std::vector<double> numVec(nsrcSent.size()+1,0);
   std::vector<std::vector<double> > numVecVec(nsrcSent.size()+1,numVec);
@@ -913,10 +1142,10 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
         if(nullAlig)
         {
           if(isFirstNullAligPar(0,slen,i))
-            d=calc_lanjm1ip_anji_num_je1(slen,i,nsrcSent,trgSent);
+            d=calc_lanjm1ip_anji_num_je1(slen,i,nsrcSent,trgSent,emScratch);
           else d=numVecVec[slen+1][0];
         }
-        else d=calc_lanjm1ip_anji_num_je1(slen,i,nsrcSent,trgSent);
+        else d=calc_lanjm1ip_anji_num_je1(slen,i,nsrcSent,trgSent,emScratch);
             // Add contribution to sum
         if(sum_lanjm1ip_anji_num_forall_i_ip==INVALID_ANJM1IP_ANJI_VAL)
           sum_lanjm1ip_anji_num_forall_i_ip=d;
@@ -940,7 +1169,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
           }
           else
           {
-            d=calc_lanjm1ip_anji_num_jg1(ip,slen,i,j,nsrcSent,trgSent);
+            d=calc_lanjm1ip_anji_num_jg1(ip,slen,i,j,nsrcSent,trgSent,emScratch);
           }
               // Add contribution to sum
           if(sum_lanjm1ip_anji_num_forall_i_ip==INVALID_ANJM1IP_ANJI_VAL)
@@ -964,7 +1193,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
         if(lanjm1ip_anji_val>EXP_VAL_LOG_MAX) lanjm1ip_anji_val=EXP_VAL_LOG_MAX;
         if(lanjm1ip_anji_val<EXP_VAL_LOG_MIN) lanjm1ip_anji_val=EXP_VAL_LOG_MIN;
             // Store expected value
-        lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,0,lanjm1ip_anji_val);
+        emScratch.lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,0,lanjm1ip_anji_val);
       }
       else
       {
@@ -979,17 +1208,17 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
                 // Smooth expected value
             if(lanjm1ip_anji_val>EXP_VAL_LOG_MAX) lanjm1ip_anji_val=EXP_VAL_LOG_MAX;
             if(lanjm1ip_anji_val<EXP_VAL_LOG_MIN) lanjm1ip_anji_val=EXP_VAL_LOG_MIN;
-            lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,ip,lanjm1ip_anji_val);
+            emScratch.lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,ip,lanjm1ip_anji_val);
           }
         }
       }
     }
   }
       // Gather alignment sufficient statistics
-  gatherAligSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight);
+  gatherAligSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight,emScratch);
 
       // clear lanjm1ip_anji_aux data structure
-  lanjm1ip_anji_aux.clear();
+  emScratch.lanjm1ip_anji_aux.clear();
 }
 
 //-------------------------
@@ -997,7 +1226,8 @@ void _incrHmmAligModel::calc_lanjm1ip_anji_vit(unsigned int n,
                                                const std::vector<WordIndex>& nsrcSent,
                                                const std::vector<WordIndex>& trgSent,
                                                const std::vector<PositionIndex>& bestAlig,
-                                               const Count& weight)
+                                               const Count& weight,
+                                               EmScratch& emScratch)
 {
   PositionIndex slen=getSrcLen(nsrcSent);
 
@@ -1007,7 +1237,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji_vit(unsigned int n,
 
   unsigned int n_aux=1;
   unsigned int mapped_n_aux;
-  lanjm1ip_anji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
+  emScratch.lanjm1ip_anji_aux.init_nth_entry(n_aux,nsrcSent.size(),trgSent.size(),mapped_n_aux);
 
       // Calculate new estimation of lanjm1ip_anji
   for(unsigned int j=1;j<=trgSent.size();++j)
@@ -1020,7 +1250,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji_vit(unsigned int n,
         {
           double lanjm1ip_anji_val=0;
               // Store expected value
-          lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,0,lanjm1ip_anji_val);
+          emScratch.lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,0,lanjm1ip_anji_val);
         }
       }
       else
@@ -1033,7 +1263,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji_vit(unsigned int n,
           {
             double lanjm1ip_anji_val=0;
                 // Store expected value
-            lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,ip,lanjm1ip_anji_val);
+            emScratch.lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,ip,lanjm1ip_anji_val);
           }
         }
       }
@@ -1041,10 +1271,10 @@ void _incrHmmAligModel::calc_lanjm1ip_anji_vit(unsigned int n,
   }
 
       // Gather alignment sufficient statistics
-  gatherAligSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight);
+  gatherAligSuffStats(mapped_n,mapped_n_aux,nsrcSent,trgSent,weight,emScratch);
 
       // clear lanjm1ip_anji_aux data structure
-  lanjm1ip_anji_aux.clear();
+  emScratch.lanjm1ip_anji_aux.clear();
 }
 
 //-------------------------
@@ -1052,7 +1282,8 @@ void _incrHmmAligModel::gatherAligSuffStats(unsigned int mapped_n,
                                             unsigned int mapped_n_aux,
                                             const std::vector<WordIndex>& nsrcSent,
                                             const std::vector<WordIndex>& trgSent,
-                                            const Count& weight)
+                                            const Count& weight,
+                                            EmScratch& emScratch)
 {
   PositionIndex slen=getSrcLen(nsrcSent);
 
@@ -1064,10 +1295,10 @@ void _incrHmmAligModel::gatherAligSuffStats(unsigned int mapped_n,
       if(j==1)
       {
             // Reestimate alignment parameters
-        fillEmAuxVarsAlig(mapped_n,mapped_n_aux,slen,0,i,j,weight);
+        fillEmAuxVarsAlig(mapped_n,mapped_n_aux,slen,0,i,j,weight,emScratch);
 
             // Update lanjm1ip_anji
-        lanjm1ip_anji.set_fast(mapped_n,j,i,0,lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,0));
+        lanjm1ip_anji.set_fast(mapped_n,j,i,0,emScratch.lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,0));
       }
       else
       {
@@ -1078,9 +1309,9 @@ void _incrHmmAligModel::gatherAligSuffStats(unsigned int mapped_n,
           if(validAlig)
           {
                 // Reestimate alignment parameters
-            fillEmAuxVarsAlig(mapped_n,mapped_n_aux,slen,ip,i,j,weight);
+            fillEmAuxVarsAlig(mapped_n,mapped_n_aux,slen,ip,i,j,weight,emScratch);
                 // Update lanjm1ip_anji
-            lanjm1ip_anji.set_fast(mapped_n,j,i,ip,lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,ip));
+            lanjm1ip_anji.set_fast(mapped_n,j,i,ip,emScratch.lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,ip));
           }
         }
       }
@@ -1095,7 +1326,8 @@ void _incrHmmAligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
                                           PositionIndex ip,
                                           PositionIndex i,
                                           PositionIndex j,
-                                          const Count& weight)
+                                          const Count& weight,
+                                          EmScratch& emScratch)
 {
       // Init vars
   float curr_lanjm1ip_anji=lanjm1ip_anji.get_fast(mapped_n,j,i,ip);
@@ -1107,7 +1339,7 @@ void _incrHmmAligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
       weighted_curr_lanjm1ip_anji=SMALL_LG_NUM;
   }
 
-  float weighted_new_lanjm1ip_anji=(float)log((float)weight)+lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,ip);
+  float weighted_new_lanjm1ip_anji=(float)log((float)weight)+emScratch.lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,ip);
   if(weighted_new_lanjm1ip_anji<SMALL_LG_NUM)
     weighted_new_lanjm1ip_anji=SMALL_LG_NUM;
 
@@ -1117,8 +1349,8 @@ void _incrHmmAligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
   asHmm.slen=slen;
 
       // Gather local suff. statistics
-  AligAuxVar::iterator aligAuxVarIter=aligAuxVar.find(std::make_pair(asHmm,i));
-  if(aligAuxVarIter!=aligAuxVar.end())
+  AligAuxVar::iterator aligAuxVarIter=emScratch.aligAuxVar.find(std::make_pair(asHmm,i));
+  if(aligAuxVarIter!=emScratch.aligAuxVar.end())
   {
     if(weighted_curr_lanjm1ip_anji!=SMALL_LG_NUM)
       aligAuxVarIter->second.first=MathFuncs::lns_sumlog_float(aligAuxVarIter->second.first,weighted_curr_lanjm1ip_anji);
@@ -1126,7 +1358,7 @@ void _incrHmmAligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
   }
   else
   {
-    aligAuxVar[std::make_pair(asHmm,i)]=std::make_pair(weighted_curr_lanjm1ip_anji,weighted_new_lanjm1ip_anji);
+    emScratch.aligAuxVar[std::make_pair(asHmm,i)]=std::make_pair(weighted_curr_lanjm1ip_anji,weighted_new_lanjm1ip_anji);
   }
 }
 
@@ -1154,9 +1386,10 @@ double _incrHmmAligModel::calc_lanji_num(PositionIndex slen,
                                          PositionIndex i,
                                          PositionIndex j,
                                          const std::vector<WordIndex>& nsrcSent,
-                                         const std::vector<WordIndex>& trgSent)
+                                         const std::vector<WordIndex>& trgSent,
+                                         const EmScratch& emScratch)
 {
-  double result=log_alpha(slen,i,j,nsrcSent,trgSent)+log_beta(slen,i,j,nsrcSent,trgSent);
+  double result=log_alpha(slen,i,j,nsrcSent,trgSent,emScratch)+log_beta(slen,i,j,nsrcSent,trgSent,emScratch);
   if(result<SMALL_LG_NUM) result=SMALL_LG_NUM;
   return result;
 }
@@ -1165,11 +1398,12 @@ double _incrHmmAligModel::calc_lanji_num(PositionIndex slen,
 double _incrHmmAligModel::calc_lanjm1ip_anji_num_je1(PositionIndex slen,
                                                      PositionIndex i,
                                                      const std::vector<WordIndex>& nsrcSent,
-                                                     const std::vector<WordIndex>& trgSent)
+                                                     const std::vector<WordIndex>& trgSent,
+                                                     EmScratch& emScratch)
 {
-  double result=cached_logaProb(0,slen,i,nsrcSent,trgSent)+
-    cachedLexLogProbs[i][1]+
-    log_beta(slen,i,1,nsrcSent,trgSent);
+  double result=emScratch.initAligLgProbs[i-1]+
+    emScratch.lexLgProbs[i-1]+
+    log_beta(slen,i,1,nsrcSent,trgSent,emScratch);
   if(result<SMALL_LG_NUM) result=SMALL_LG_NUM;
   return result;
 }
@@ -1180,12 +1414,14 @@ double _incrHmmAligModel::calc_lanjm1ip_anji_num_jg1(PositionIndex ip,
                                                      PositionIndex i,
                                                      PositionIndex j,
                                                      const std::vector<WordIndex>& nsrcSent,
-                                                     const std::vector<WordIndex>& trgSent)
-{
-  double result=log_alpha(slen,ip,j-1,nsrcSent,trgSent)+
-    cached_logaProb(ip,slen,i,nsrcSent,trgSent)+
-    cachedLexLogProbs[i][j]+
-    log_beta(slen,i,j,nsrcSent,trgSent);
+                                                     const std::vector<WordIndex>& trgSent,
+                                                     EmScratch& emScratch)
+{
+  unsigned int nslen=emScratch.nslen;
+  double result=log_alpha(slen,ip,j-1,nsrcSent,trgSent,emScratch)+
+    emScratch.aligLgProbs[(ip-1)*nslen+i-1]+
+    emScratch.lexLgProbs[(j-1)*nslen+i-1]+
+    log_beta(slen,i,j,nsrcSent,trgSent,emScratch);
   if(result<SMALL_LG_NUM) result=SMALL_LG_NUM;
   return result;
 }
@@ -1258,9 +1494,13 @@ double _incrHmmAligModel::log_alpha(PositionIndex /*slen*/,
                                     PositionIndex i,
                                     PositionIndex j,
                                     const std::vector<WordIndex>& /*nsrcSent*/,
-                                    const std::vector<WordIndex>& /*trgSent*/)
+                                    const std::vector<WordIndex>& /*trgSent*/,
+                                    const EmScratch& emScratch)
 {
-  return alphaMatrix[i][j];
+  if(emScratch.scaledFb)
+    return log(emScratch.scaledAlpha[(j-1)*emScratch.nslen+i-1])+emScratch.alphaLgScales[j];
+  else
+    return emScratch.alphaMatrix[i][j];
 }
 
 //-------------------------
@@ -1268,9 +1508,13 @@ double _incrHmmAligModel::log_beta(PositionIndex /*slen*/,
                                    PositionIndex i,
                                    PositionIndex j,
                                    const std::vector<WordIndex>& /*nsrcSent*/,
-                                   const std::vector<WordIndex>& /*trgSent*/)
+                                   const std::vector<WordIndex>& /*trgSent*/,
+                                   const EmScratch& emScratch)
 {
-  return betaMatrix[i][j];
+  if(emScratch.scaledFb)
+    return log(emScratch.scaledBeta[(j-1)*emScratch.nslen+i-1])+emScratch.betaLgScales[j];
+  else
+    return emScratch.betaMatrix[i][j];
 }
 
 //-------------------------
@@ -1455,8 +1699,8 @@ void _incrHmmAligModel::viterbiAlgorithmCached(const std::vector<WordIndex>& nSr
                                                std::vector<std::vector<double> >& vitMatrix,
                                                std::vector<std::vector<PositionIndex> >& predMatrix)
 {
-      // Obtain slen
-  PositionIndex slen=getSrcLen(nSrcSentIndexVector);
+  unsigned int nslen=nSrcSentIndexVector.size();
+  unsigned int tlen=trgSentIndexVector.size();
 
       // Clear matrices
   vitMatrix.clear();
@@ -1464,51 +1708,34 @@ void _incrHmmAligModel::viterbiAlgorithmCached(const std::vector<WordIndex>& nSr
 
       // Make room for matrices
   std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSentIndexVector.size()+1,SMALL_LG_NUM);
-  vitMatrix.insert(vitMatrix.begin(),nSrcSentIndexVector.size()+1,dVec);
+  dVec.insert(dVec.begin(),tlen+1,SMALL_LG_NUM);
+  vitMatrix.insert(vitMatrix.begin(),nslen+1,dVec);
 
   std::vector<PositionIndex> pidxVec;
-  pidxVec.insert(pidxVec.begin(),trgSentIndexVector.size()+1,0);
-  predMatrix.insert(predMatrix.begin(),nSrcSentIndexVector.size()+1,pidxVec);
+  pidxVec.insert(pidxVec.begin(),tlen+1,0);
+  predMatrix.insert(predMatrix.begin(),nslen+1,pidxVec);
+
+  if(nslen==0 || tlen==0)
+    return;
+  
+      // Obtain flat buffers of lexical and alignment log-probs
+  std::vector<double> initAligLgProbs;
+  std::vector<double> aligLgProbs;
+  std::vector<double> lexLgProbs;
+  initFlatLgProbs(nSrcSentIndexVector,trgSentIndexVector,cached_logap,initAligLgProbs,aligLgProbs,lexLgProbs);
 
-      // Initialize data structure to cache lexical log-probs
-  std::vector<std::vector<double> > cached_logpts;
-  initCachedLexicalLps(nSrcSentIndexVector,trgSentIndexVector,cached_logpts);
+      // Execute Viterbi algorithm
+  std::vector<double> vit(tlen*nslen);
+  std::vector<PositionIndex> pred(tlen*nslen);
+  HmmFbKernels::viterbi(nslen,tlen,&initAligLgProbs[0],&aligLgProbs[0],&lexLgProbs[0],&vit[0],&pred[0]);
 
       // Fill matrices
-  for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
+  for(PositionIndex j=1;j<=tlen;++j)
   {
-    for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
+    for(PositionIndex i=1;i<=nslen;++i)
     {
-      if(j==1)
-      {
-            // Update cached alignment log-probs if required
-        if(!cached_logap.isDefined(0,slen,i))
-          cached_logap.set_boundary_check(0,slen,i,logaProb(0,slen,i));
-
-            // Update matrices
-        vitMatrix[i][j]=cached_logap.get(0,slen,i)+cached_logpts[i][j];
-        predMatrix[i][j]=0;
-      }
-      else
-      {
-        for(PositionIndex i_tilde=1;i_tilde<=nSrcSentIndexVector.size();++i_tilde)
-        {
-              // Update cached alignment log-probs if required
-          if(!cached_logap.isDefined(i_tilde,slen,i))
-            cached_logap.set_boundary_check(i_tilde,slen,i,logaProb(i_tilde,slen,i));
-
-              // Update matrices
-          double lp=vitMatrix[i_tilde][j-1]+
-                    cached_logap.get(i_tilde,slen,i)+
-                    cached_logpts[i][j];
-          if(lp>vitMatrix[i][j])
-          {
-            vitMatrix[i][j]=lp;
-            predMatrix[i][j]=i_tilde;
-          }
-        }
-      }
+      vitMatrix[i][j]=vit[(j-1)*nslen+i-1];
+      predMatrix[i][j]=pred[(j-1)*nslen+i-1];
     }
   }
 }
@@ -1619,58 +1846,89 @@ double _incrHmmAligModel::forwardAlgorithm(const std::vector<WordIndex>& nSrcSen
                                            const std::vector<WordIndex>& trgSentIndexVector,
                                            int verbose)
 {
-      // Obtain slen
-  PositionIndex slen=getSrcLen(nSrcSentIndexVector);
+  unsigned int nslen=nSrcSentIndexVector.size();
+  unsigned int tlen=trgSentIndexVector.size();
+
+      // Obtain flat buffers of lexical and alignment log-probs
+  CachedHmmAligLgProb cached_logap;
+  std::vector<double> initAligLgProbs;
+  std::vector<double> aligLgProbs;
+  std::vector<double> lexLgProbs;
+  initFlatLgProbs(nSrcSentIndexVector,trgSentIndexVector,cached_logap,initAligLgProbs,aligLgProbs,lexLgProbs);
 
-  
       // Make room for matrix
   std::vector<std::vector<double> > forwardMatrix;
   std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSentIndexVector.size()+1,0.0);
-  forwardMatrix.insert(forwardMatrix.begin(),nSrcSentIndexVector.size()+1,dVec);
-
-      // Initialize data structure to cache lexical log-probs
-  std::vector<std::vector<double> > cached_logpts;
-  initCachedLexicalLps(nSrcSentIndexVector,trgSentIndexVector,cached_logpts);
-
-      // Fill matrix
-  for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
+  dVec.insert(dVec.begin(),tlen+1,0.0);
+  forwardMatrix.insert(forwardMatrix.begin(),nslen+1,dVec);
+
+      // Execute scaled forward algorithm
+  std::vector<double> initAligProbs;
+  std::vector<double> aligProbs;
+  std::vector<double> lexProbs;
+  HmmFbKernels::lgProbsToProbs(initAligLgProbs,initAligProbs);
+  HmmFbKernels::lgProbsToProbs(aligLgProbs,aligProbs);
+  HmmFbKernels::lgProbsToProbs(lexLgProbs,lexProbs);
+  std::vector<double> scaledAlpha(tlen*nslen);
+  std::vector<double> scales(tlen);
+
+  double lp;
+  if(HmmFbKernels::scaledForward(nslen,tlen,&initAligProbs[0],&aligProbs[0],&lexProbs[0],&scaledAlpha[0],&scales[0]))
   {
-    for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
+    lp=HmmFbKernels::lgProbGivenScales(tlen,&scales[0]);
+
+        // Obtain log-space values if required
+    if(verbose>1)
     {
-      if(j==1)
+      double lgScale=0;
+      for(PositionIndex j=1;j<=tlen;++j)
       {
-        forwardMatrix[i][j]=logaProb(0,slen,i)+cached_logpts[i][j];
+        lgScale+=log(scales[j-1]);
+        for(PositionIndex i=1;i<=nslen;++i)
+          forwardMatrix[i][j]=log(scaledAlpha[(j-1)*nslen+i-1])+lgScale;
       }
-      else
+    }
+  }
+  else
+  {
+        // Scaled computation underflowed, use log-space computation
+    for(PositionIndex j=1;j<=tlen;++j)
+    {
+      for(PositionIndex i=1;i<=nslen;++i)
       {
-        for(PositionIndex i_tilde=1;i_tilde<=nSrcSentIndexVector.size();++i_tilde)
+        if(j==1)
         {
-          double lp=forwardMatrix[i_tilde][j-1]+
-            (double)logaProb(i_tilde,slen,i)+
-            cached_logpts[i][j];
-          if(i_tilde==1)
-            forwardMatrix[i][j]=lp;
-          else
-            forwardMatrix[i][j]=MathFuncs::lns_sumlog(lp,forwardMatrix[i][j]);
+          forwardMatrix[i][j]=initAligLgProbs[i-1]+lexLgProbs[i-1];
+        }
+        else
+        {
+          for(PositionIndex i_tilde=1;i_tilde<=nslen;++i_tilde)
+          {
+            double d=forwardMatrix[i_tilde][j-1]+
+              aligLgProbs[(i_tilde-1)*nslen+i-1]+
+              lexLgProbs[(j-1)*nslen+i-1];
+            if(i_tilde==1)
+              forwardMatrix[i][j]=d;
+            else
+              forwardMatrix[i][j]=MathFuncs::lns_sumlog(d,forwardMatrix[i][j]);
+          }
         }
       }
     }
-  }
 
-      // Obtain lgProb from forward matrix
-  double lp=lgProbGivenForwardMatrix(forwardMatrix);
+        // Obtain lgProb from forward matrix
+    lp=lgProbGivenForwardMatrix(forwardMatrix);
+  }
 
       // Print verbose info
   if(verbose>1)
   {
-        // Clear cached alpha and beta values
-    for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
+    for(PositionIndex j=1;j<=tlen;++j)
     {
-      for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
+      for(PositionIndex i=1;i<=nslen;++i)
       {
         std::cerr<<"i="<<i<<",j="<<j<<" "<<forwardMatrix[i][j];
-        if(i<nSrcSentIndexVector.size()) std::cerr<<" ; ";
+        if(i<nslen) std::cerr<<" ; ";
       }
       std::cerr<<std::endl;
     }
@@ -2008,11 +2266,7 @@ void _incrHmmAligModel::clear(void)
 {
   _swAligModel<std::vector<Prob> >::clear();
   lanji.clear();
-  lanji_aux.clear();
   lanjm1ip_anji.clear();
-  lanjm1ip_anji_aux.clear();
-  alphaMatrix.clear();
-  betaMatrix.clear();
   incrLexTable->clear();
   incrHmmAligTable.clear();
   sentLengthModel.clear();
@@ -42,11 +42,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "HmmAligInfo.h"
 #include "CachedHmmAligLgProb.h"
 #include "DoubleMatrix.h"
+#include "HmmFbKernels.h"
 #include "_incrLexTable.h"
 #include "IncrHmmAligTable.h"
 #include "ashPidxPairHashF.h"
 #include "LexAuxVar.h"
 #include <MathFuncs.h>
+#include "EmSentPairProcessor.h"
 
 #if __GNUC__>2
 #include <ext/hash_map>
@@ -61,6 +63,7 @@ using __gnu_cxx::hash_map;
 #define EXP_VAL_LOG_MIN                   -9
 #define DEFAULT_ALIG_SMOOTH_INTERP_FACTOR  0.3
 #define DEFAULT_LEX_SMOOTH_INTERP_FACTOR   0.1
+#define HMM_EM_THREAD_BLOCK_SIZE           10000
 
 //--------------- typedefs -------------------------------------------
 
@@ -82,6 +85,7 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
    _incrHmmAligModel();
 
    void set_expval_maxnsize(unsigned int _expval_maxnsize);
+   bool set_expval_mmap_prefix(const char* prefFileName);
        // Function to set a maximum size for the matrices of expected
        // values (by default the size is not restricted)
 
@@ -203,24 +207,59 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
 
   protected:
 
+   typedef hash_map<std::pair<aSourceHmm,PositionIndex>,std::pair<float,float>,ashPidxPairHashF> AligAuxVar;
+
+       // Scratch data structures and local sufficient statistics used
+       // to compute the expected values for a set of sentence pairs
+       // (each thread of the E-step works with its own instance)
+   struct EmScratch
+   {
+     anjiMatrix lanji_aux;
+     anjm1ip_anjiMatrix lanjm1ip_anji_aux;
+     std::vector<std::vector<double> > alphaMatrix;
+     std::vector<std::vector<double> > betaMatrix;
+     CachedHmmAligLgProb cachedAligLogProbs;
+     unsigned int nslen;
+     std::vector<double> initAligLgProbs;
+     std::vector<double> aligLgProbs;
+     std::vector<double> lexLgProbs;
+         // Flat row-major log-probabilities for the current sentence
+         // pair, nslen is the length of the source sentence extended
+         // with null words (see HmmFbKernels.h)
+     std::vector<double> initAligProbs;
+     std::vector<double> aligProbs;
+     std::vector<double> lexProbs;
+     std::vector<double> scaledAlpha;
+     std::vector<double> scaledBeta;
+     std::vector<double> fbScales;
+     std::vector<double> alphaLgScales;
+     std::vector<double> betaLgScales;
+     bool scaledFb;
+         // Scaled forward-backward matrices. If scaledFb is false, the
+         // scaled computation underflowed and alphaMatrix and
+         // betaMatrix store log-space values instead
+     LexAuxVar lexAuxVar;
+     AligAuxVar aligAuxVar;
+   };
+
+       // Sentence pair to be processed by the E-step
+   struct EmSentPair
+   {
+     unsigned int n;
+     std::vector<WordIndex> srcSent;
+     std::vector<WordIndex> trgSent;
+     Count weight;
+   };
+
    anjiMatrix lanji;
-   anjiMatrix lanji_aux;
    anjm1ip_anjiMatrix lanjm1ip_anji;
-   anjm1ip_anjiMatrix lanjm1ip_anji_aux;
-   std::vector<std::vector<double> > alphaMatrix;
-   std::vector<std::vector<double> > betaMatrix;
        // Data structures for manipulating expected values
 
    std::string lexNumDenFileExtension;
        // Extensions for input files for loading
 
    LexAuxVar lexAuxVar;
-   std::vector<std::vector<double> > cachedLexLogProbs;
-       // EM algorithm auxiliary variables
-
-   typedef hash_map<std::pair<aSourceHmm,PositionIndex>,std::pair<float,float>,ashPidxPairHashF> AligAuxVar;
    AligAuxVar aligAuxVar;
-   CachedHmmAligLgProb cachedAligLogProbs;
        // EM algorithm auxiliary variables
 
    _incrLexTable* incrLexTable;
@@ -265,6 +304,15 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
    void initCachedLexicalLps(const std::vector<WordIndex>& nSrcSentIndexVector,
                              const std::vector<WordIndex>& trgSentIndexVector,
                              std::vector<std::vector<double> >& cachedLps);
+   void initFlatLgProbs(const std::vector<WordIndex>& nSrcSentIndexVector,
+                        const std::vector<WordIndex>& trgSentIndexVector,
+                        CachedHmmAligLgProb& cached_logap,
+                        std::vector<double>& initAligLgProbs,
+                        std::vector<double>& aligLgProbs,
+                        std::vector<double>& lexLgProbs);
+       // Fills flat row-major buffers with the alignment log-probs for
+       // the first target position, the alignment log-probs for the
+       // remaining ones and the lexical log-probs (see HmmFbKernels.h)
    double unsmoothed_logpts(WordIndex s,
                             WordIndex t);
        // Returns log(p(t|s)) without smoothing
@@ -275,7 +323,8 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
                           PositionIndex slen,
                           PositionIndex i,
                           const std::vector<WordIndex>& nsrcSent,
-                          const std::vector<WordIndex>& trgSent);
+                          const std::vector<WordIndex>& trgSent,
+                          CachedHmmAligLgProb& cachedAligLogProbs);
    void nullAligSpecialPar(unsigned int ip,
                            unsigned int slen,
                            aSourceHmm& asHmm,
@@ -328,39 +377,53 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
    // EM-related functions
    void calcNewLocalSuffStats(std::pair<unsigned int,unsigned int> sentPairRange,
                               int verbosity=0);
+       // The sentence pairs are processed in blocks using numThreads
+       // threads (see EmSentPairProcessor.h)
+   void calcNewLocalSuffStatsSentPair(const EmSentPair& emSentPair,
+                                      EmScratch& emScratch);
+   void mergeEmScratch(EmScratch& emScratch);
+       // Adds the local sufficient statistics stored in emScratch to
+       // lexAuxVar and aligAuxVar
    void calcNewLocalSuffStatsVit(std::pair<unsigned int,unsigned int> sentPairRange,
                                  int verbosity=0);
    void calcAlphaMatrix(unsigned int n,
                         const std::vector<WordIndex>& nsrcSent,
-                        const std::vector<WordIndex>& trgSent);
+                        const std::vector<WordIndex>& trgSent,
+                        EmScratch& emScratch);
    void calcBetaMatrix(unsigned int n,
                        const std::vector<WordIndex>& nsrcSent,
-                       const std::vector<WordIndex>& trgSent);
+                       const std::vector<WordIndex>& trgSent,
+                       EmScratch& emScratch);
    void calc_lanji(unsigned int n,
                    const std::vector<WordIndex>& nsrcSent,
                    const std::vector<WordIndex>& trgSent,
-                   const Count& weight);
+                   const Count& weight,
+                   EmScratch& emScratch);
    void calc_lanji_vit(unsigned int n,
                        const std::vector<WordIndex>& nsrcSent,
                        const std::vector<WordIndex>& trgSent,
                        const std::vector<PositionIndex>& bestAlig,
-                       const Count& weight);
+                       const Count& weight,
+                       EmScratch& emScratch);
    void fillEmAuxVarsLex(unsigned int mapped_n,
                          unsigned int mapped_n_aux,
                          PositionIndex i,
                          PositionIndex j,
                          const std::vector<WordIndex>& nsrcSent,
                          const std::vector<WordIndex>& trgSent,
-                         const Count& weight);
+                         const Count& weight,
+                         EmScratch& emScratch);
    void calc_lanjm1ip_anji(unsigned int n,
                            const std::vector<WordIndex>& nsrcSent,
                            const std::vector<WordIndex>& trgSent,
-                           const Count& weight);
+                           const Count& weight,
+                           EmScratch& emScratch);
    void calc_lanjm1ip_anji_vit(unsigned int n,
                                const std::vector<WordIndex>& nsrcSent,
                                const std::vector<WordIndex>& trgSent,
                                const std::vector<PositionIndex>& bestAlig,
-                               const Count& weight);
+                               const Count& weight,
+                               EmScratch& emScratch);
    bool isFirstNullAligPar(PositionIndex ip,
                            unsigned int slen,
                            PositionIndex i);
@@ -368,34 +431,40 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
                          PositionIndex i,
                          PositionIndex j,
                          const std::vector<WordIndex>& nsrcSent,
-                         const std::vector<WordIndex>& trgSent);
+                         const std::vector<WordIndex>& trgSent,
+                         const EmScratch& emScratch);
    double calc_lanjm1ip_anji_num_je1(PositionIndex slen,
                                      PositionIndex i,
                                      const std::vector<WordIndex>& nsrcSent,
-                                     const std::vector<WordIndex>& trgSent);
+                                     const std::vector<WordIndex>& trgSent,
+                                     EmScratch& emScratch);
    double calc_lanjm1ip_anji_num_jg1(PositionIndex ip,
                                      PositionIndex slen,
                                      PositionIndex i,
                                      PositionIndex j,
                                      const std::vector<WordIndex>& nsrcSent,
-                                     const std::vector<WordIndex>& trgSent);
+                                     const std::vector<WordIndex>& trgSent,
+                                     EmScratch& emScratch);
    void gatherLexSuffStats(unsigned int mapped_n,
                            unsigned int mapped_n_aux,
                            const std::vector<WordIndex>& nsrcSent,
                            const std::vector<WordIndex>& trgSent,
-                           const Count& weight);
+                           const Count& weight,
+                           EmScratch& emScratch);
    void gatherAligSuffStats(unsigned int mapped_n,
                             unsigned int mapped_n_aux,
                             const std::vector<WordIndex>& nsrcSent,
                             const std::vector<WordIndex>& trgSent,
-                            const Count& weight);
+                            const Count& weight,
+                            EmScratch& emScratch);
    void fillEmAuxVarsAlig(unsigned int mapped_n,
                           unsigned int mapped_n_aux,
                           PositionIndex slen,
                           PositionIndex ip,
                           PositionIndex i,
                           PositionIndex j,
-                          const Count& weight);
+                          const Count& weight,
+                          EmScratch& emScratch);
    void getHmmAligInfo(PositionIndex ip,
                        unsigned int slen,
                        PositionIndex i,
@@ -413,12 +482,14 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
                     PositionIndex i,
                     PositionIndex j,
                     const std::vector<WordIndex>& nsrcSent,
-                    const std::vector<WordIndex>& trgSent);
+                    const std::vector<WordIndex>& trgSent,
+                    const EmScratch& emScratch);
    double log_beta(PositionIndex slen,
                    PositionIndex i,
                    PositionIndex j,
                    const std::vector<WordIndex>& nsrcSent,
-                   const std::vector<WordIndex>& trgSent);
+                   const std::vector<WordIndex>& trgSent,
+                   const EmScratch& emScratch);
    void updateParsLex(void);
    void updateParsAlig(void);
    virtual float obtainLogNewSuffStat(float lcurrSuffStat,
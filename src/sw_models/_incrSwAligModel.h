@@ -57,17 +57,48 @@ class _incrSwAligModel: public _swAligModel<PPINFO>
 
   typedef typename _swAligModel<PPINFO>::PpInfo PpInfo;
 
+      // Constructor
+  _incrSwAligModel(void);
+
   virtual void set_expval_maxnsize(unsigned int _anji_maxnsize)=0;
       // Function to set a maximum size for the vector of expected
       // values anji (by default the size is not restricted)
+  virtual bool set_expval_mmap_prefix(const char* prefFileName);
+      // Stores the matrix of expected values in memory-mapped files
+      // with the given prefix instead of main memory
 
   virtual void efficientBatchTrainingForRange(std::pair<unsigned int,unsigned int> sentPairRange,
                                               int verbosity=0);
   void efficientBatchTrainingForAllSents(int verbosity=0);
+
+  void setNumThreads(unsigned int _numThreads);
+      // Sets the number of threads used to compute the expected
+      // values of the EM algorithm (1 by default). The value is
+      // ignored by models without multi-threaded training
+  unsigned int getNumThreads(void)const;
+
+ protected:
+
+  unsigned int numThreads;
 };
 
 //--------------- _incrSwAligModel class method definitions
 
+//-------------------------
+template<class PPINFO>
+_incrSwAligModel<PPINFO>::_incrSwAligModel(void)
+{
+  numThreads=1;
+}
+
+//-------------------------
+template<class PPINFO>
+bool _incrSwAligModel<PPINFO>::set_expval_mmap_prefix(const char* /*prefFileName*/)
+{
+  std::cerr<<"Warning: memory-mapped expected values not implemented for this class.\n";
+  return THOT_ERROR;
+}
+
 //-------------------------
 template<class PPINFO>
 void _incrSwAligModel<PPINFO>::efficientBatchTrainingForRange(std::pair<unsigned int,unsigned int> /*sentPairRange*/,
@@ -83,6 +114,23 @@ void _incrSwAligModel<PPINFO>::efficientBatchTrainingForAllSents(int verbosity/*
   efficientBatchTrainingForRange(std::make_pair(0,this->numSentPairs()-1),verbosity);
 }
 
+//-------------------------
+template<class PPINFO>
+void _incrSwAligModel<PPINFO>::setNumThreads(unsigned int _numThreads)
+{
+  if(_numThreads==0)
+    numThreads=1;
+  else
+    numThreads=_numThreads;
+}
+
+//-------------------------
+template<class PPINFO>
+unsigned int _incrSwAligModel<PPINFO>::getNumThreads(void)const
+{
+  return numThreads;
+}
+
 //-------------------------
 
 #endif
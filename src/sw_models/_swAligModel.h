@@ -122,6 +122,21 @@ class _swAligModel: public BaseSwAligModel<PPINFO>
 	SingleWordVocab swVocab;
 
     LightSentenceHandler sentenceHandler;
+
+    std::vector<WordIndex> corpusSrcWidxMap;
+    std::vector<WordIndex> corpusTrgWidxMap;
+        // Word indices of the words of the vocabularies of the binary
+        // corpus, UNK_WORD is used for words that are not mapped yet
+
+    bool getSrcSentFromCorpusIds(unsigned int n,
+                                 std::vector<WordIndex>& srcSent);
+    bool getTrgSentFromCorpusIds(unsigned int n,
+                                 std::vector<WordIndex>& trgSent);
+        // Obtain the word indices of the n'th source and target
+        // sentences from the ids stored in the binary corpus, adding
+        // new symbols to the vocabulary. Return false if the sentence
+        // pair is not stored in a binary corpus
+    void clearCorpusWidxMaps(void);
 };
 
 //--------------- _swAligModel class method definitions
@@ -139,6 +154,7 @@ bool _swAligModel<PPINFO>::readSentencePairs(const char *srcFileName,
                                              const char *sentCountsFile,
                                              std::pair<unsigned int,unsigned int>& sentRange)
 {
+  clearCorpusWidxMaps();
   return sentenceHandler.readSentencePairs(srcFileName,trgFileName,sentCountsFile,sentRange);
 }
 
@@ -173,6 +189,7 @@ int _swAligModel<PPINFO>::nthSentPair(unsigned int n,
 template<class PPINFO>
 bool _swAligModel<PPINFO>::loadGIZASrcVocab(const char *srcInputVocabFileName)
 {
+ clearCorpusWidxMaps();
  return swVocab.loadGIZASrcVocab(srcInputVocabFileName);
 }
 
@@ -180,6 +197,7 @@ bool _swAligModel<PPINFO>::loadGIZASrcVocab(const char *srcInputVocabFileName)
 template<class PPINFO>
 bool _swAligModel<PPINFO>::loadGIZATrgVocab(const char *trgInputVocabFileName)
 {
+ clearCorpusWidxMaps();
  return swVocab.loadGIZATrgVocab(trgInputVocabFileName);
 }
 
@@ -295,6 +313,75 @@ void _swAligModel<PPINFO>::clear(void)
 {
  swVocab.clear();
  sentenceHandler.clear();
+ clearCorpusWidxMaps();
+}
+
+//-------------------------
+template<class PPINFO>
+bool _swAligModel<PPINFO>::getSrcSentFromCorpusIds(unsigned int n,
+                                                   std::vector<WordIndex>& srcSent)
+{
+  const uint32_t* ids;
+  unsigned int len;
+  if(!sentenceHandler.getSrcSentCorpusIds(n,ids,len))
+    return false;
+
+  srcSent.resize(len);
+  for(unsigned int i=0;i<len;++i)
+  {
+    if(corpusSrcWidxMap.size()<=ids[i])
+      corpusSrcWidxMap.resize(ids[i]+1,UNK_WORD);
+    WordIndex widx=corpusSrcWidxMap[ids[i]];
+    if(widx==UNK_WORD)
+    {
+          // Map word using its string (new symbols are added in the
+          // same order as when reading text files)
+      std::string wordStr=sentenceHandler.corpusSrcWordStr(ids[i]);
+      widx=stringToSrcWordIndex(wordStr);
+      if(widx==UNK_WORD)
+        widx=addSrcSymbol(wordStr);
+      corpusSrcWidxMap[ids[i]]=widx;
+    }
+    srcSent[i]=widx;
+  }
+  return true;
+}
+
+//-------------------------
+template<class PPINFO>
+bool _swAligModel<PPINFO>::getTrgSentFromCorpusIds(unsigned int n,
+                                                   std::vector<WordIndex>& trgSent)
+{
+  const uint32_t* ids;
+  unsigned int len;
+  if(!sentenceHandler.getTrgSentCorpusIds(n,ids,len))
+    return false;
+
+  trgSent.resize(len);
+  for(unsigned int i=0;i<len;++i)
+  {
+    if(corpusTrgWidxMap.size()<=ids[i])
+      corpusTrgWidxMap.resize(ids[i]+1,UNK_WORD);
+    WordIndex widx=corpusTrgWidxMap[ids[i]];
+    if(widx==UNK_WORD)
+    {
+      std::string wordStr=sentenceHandler.corpusTrgWordStr(ids[i]);
+      widx=stringToTrgWordIndex(wordStr);
+      if(widx==UNK_WORD)
+        widx=addTrgSymbol(wordStr);
+      corpusTrgWidxMap[ids[i]]=widx;
+    }
+    trgSent[i]=widx;
+  }
+  return true;
+}
+
+//-------------------------
+template<class PPINFO>
+void _swAligModel<PPINFO>::clearCorpusWidxMaps(void)
+{
+  corpusSrcWidxMap.clear();
+  corpusTrgWidxMap.clear();
 }
 
 //-------------------------
@@ -25,6 +25,12 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "anjiMatrix.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 //--------------- Global variables -----------------------------------
 
@@ -34,9 +40,25 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants
 
+#define ANJI_MIN_ARENA_CAPACITY  65536
+#define ANJI_MIN_COMPACT_WASTE 1048576
 
 //--------------- Classes --------------------------------------------
 
+//--------------- AnjiEntryOffsetSortCriterion class
+
+class AnjiEntryOffsetSortCriterion
+{
+ public:
+  AnjiEntryOffsetSortCriterion(const std::vector<size_t>& _offsets):offsets(_offsets){}
+  bool operator()(unsigned int a,
+                  unsigned int b)const
+    {
+      return offsets[a]<offsets[b];
+    }
+ private:
+  const std::vector<size_t>& offsets;
+};
 
 //--------------- anjiMatrix class function definitions
 
@@ -45,6 +67,54 @@ anjiMatrix::anjiMatrix(void)
 {
   anji_maxnsize=UNRESTRICTED_ANJI_SIZE;
   anji_pointer=0;
+  arena=NULL;
+  arenaSize=0;
+  arenaCapacity=0;
+  arenaWaste=0;
+  mmapFd=-1;
+  mapAddr=NULL;
+}
+
+//-------------------------
+anjiMatrix::anjiMatrix(const anjiMatrix& am)
+{
+  arena=NULL;
+  arenaSize=0;
+  arenaCapacity=0;
+  arenaWaste=0;
+  mmapFd=-1;
+  mapAddr=NULL;
+  copy(am);
+}
+
+//-------------------------
+anjiMatrix& anjiMatrix::operator=(const anjiMatrix& am)
+{
+  if(this!=&am)
+  {
+    releaseArena();
+    copy(am);
+  }
+  return *this;
+}
+
+//-------------------------
+void anjiMatrix::copy(const anjiMatrix& am)
+{
+      // Copies are always stored in memory
+  anji_maxnsize=am.anji_maxnsize;
+  anji_pointer=am.anji_pointer;
+  anji=am.anji;
+  np_to_n_vector=am.np_to_n_vector;
+  n_to_np_vector=am.n_to_np_vector;
+  if(am.arenaSize>0)
+  {
+    heapArena.assign(am.arena,am.arena+am.arenaSize);
+    arena=&heapArena[0];
+    arenaCapacity=heapArena.size();
+  }
+  arenaSize=am.arenaSize;
+  arenaWaste=am.arenaWaste;
 }
 
 //-------------------------
@@ -58,20 +128,12 @@ bool anjiMatrix::init_nth_entry(unsigned int n,
         // Obtain value of mapped_n
     map_n_in_matrix(n,mapped_n);
 
-        // Check if it is required to grow in the dimension of n
-    if(anji.size()<=mapped_n)
-    {
-      anji.resize(mapped_n+1);
-    }
-
         // Check if entry has enough room
     if(resizeIsRequired(mapped_n,nslen,tlen))
     {
-      anji[mapped_n].clear();
-
           // Initialize data structure for entry
-      std::vector<float> floatVec(nslen+1,INVALID_ANJI_VAL);
-      anji[mapped_n].resize(tlen+1,floatVec);
+      if(allocEntry(mapped_n,tlen+1,nslen+1,false)==THOT_ERROR)
+        return THOT_ERROR;
     }
 
     return THOT_OK;
@@ -80,6 +142,190 @@ bool anjiMatrix::init_nth_entry(unsigned int n,
     return THOT_ERROR;
 }
 
+//-------------------------
+bool anjiMatrix::allocEntry(unsigned int mapped_n,
+                            unsigned int nrows,
+                            unsigned int ncols,
+                            bool keepValues)
+{
+      // Check if it is required to grow in the dimension of n
+  if(anji.size()<=mapped_n)
+    anji.resize(mapped_n+1);
+
+  AnjiEntry oldEntry=anji[mapped_n];
+  AnjiEntry& entry=anji[mapped_n];
+  size_t required=(size_t)nrows*ncols;
+
+  if(required>entry.capacity)
+  {
+        // Entry does not fit in its current location, move it to the
+        // end of the arena
+    if(reserveArena(arenaSize+required)==THOT_ERROR)
+      return THOT_ERROR;
+    arenaWaste+=entry.capacity;
+    entry.offset=arenaSize;
+    entry.capacity=required;
+    arenaSize+=required;
+  }
+  entry.nrows=nrows;
+  entry.ncols=ncols;
+
+  if(keepValues && oldEntry.nrows*oldEntry.ncols>0)
+  {
+        // Copy old values to the new layout. Old values are buffered
+        // since the entry may keep its location
+    std::vector<float> oldValues(arena+oldEntry.offset,
+                                 arena+oldEntry.offset+oldEntry.nrows*oldEntry.ncols);
+    std::fill(arena+entry.offset,arena+entry.offset+required,(float)INVALID_ANJI_VAL);
+    for(unsigned int j=0;j<oldEntry.nrows;++j)
+    {
+      memcpy(arena+entry.offset+(size_t)j*ncols,
+             &oldValues[(size_t)j*oldEntry.ncols],
+             oldEntry.ncols*sizeof(float));
+    }
+  }
+  else
+    std::fill(arena+entry.offset,arena+entry.offset+required,(float)INVALID_ANJI_VAL);
+
+      // Compact arena if too much space is wasted
+  if(arenaWaste>=ANJI_MIN_COMPACT_WASTE && arenaWaste*2>arenaSize)
+    compactArena();
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool anjiMatrix::reserveArena(size_t capacity)
+{
+  if(capacity<=arenaCapacity)
+    return THOT_OK;
+
+      // Grow capacity geometrically
+  size_t newCapacity=std::max(capacity,std::max((size_t)ANJI_MIN_ARENA_CAPACITY,2*arenaCapacity));
+  if(mapAddr!=NULL)
+  {
+        // Grow file and map it again. The old mapping is only
+        // released once the new one is available, so the stored values
+        // are kept if the file cannot be mapped. Since the mapping is
+        // shared, the new one already contains the values written
+        // through the old one
+    if(ftruncate(mmapFd,newCapacity*sizeof(float))!=0)
+    {
+      std::cerr<<"Error while growing file "<<mmapFileName<<std::endl;
+      return THOT_ERROR;
+    }
+    void* addr=mmap(NULL,newCapacity*sizeof(float),PROT_READ|PROT_WRITE,MAP_SHARED,mmapFd,0);
+    if(addr==MAP_FAILED)
+    {
+      std::cerr<<"Error while mapping file "<<mmapFileName<<std::endl;
+      return THOT_ERROR;
+    }
+    munmap(mapAddr,arenaCapacity*sizeof(float));
+    mapAddr=addr;
+    arena=(float*) addr;
+  }
+  else
+  {
+    heapArena.resize(newCapacity);
+    arena=&heapArena[0];
+  }
+  arenaCapacity=newCapacity;
+  return THOT_OK;
+}
+
+//-------------------------
+void anjiMatrix::compactArena(void)
+{
+      // Sort entries by offset
+  std::vector<size_t> offsets(anji.size());
+  std::vector<unsigned int> entryIdxVec;
+  for(unsigned int np=0;np<anji.size();++np)
+  {
+    offsets[np]=anji[np].offset;
+    if(anji[np].capacity>0)
+      entryIdxVec.push_back(np);
+  }
+  std::sort(entryIdxVec.begin(),entryIdxVec.end(),AnjiEntryOffsetSortCriterion(offsets));
+
+      // Move entries to the beginning of the arena, entries never move
+      // towards higher offsets
+  size_t newSize=0;
+  for(unsigned int k=0;k<entryIdxVec.size();++k)
+  {
+    AnjiEntry& entry=anji[entryIdxVec[k]];
+    if(entry.offset!=newSize)
+      memmove(arena+newSize,arena+entry.offset,entry.capacity*sizeof(float));
+    entry.offset=newSize;
+    newSize+=entry.capacity;
+  }
+  arenaSize=newSize;
+  arenaWaste=0;
+}
+
+//-------------------------
+bool anjiMatrix::set_mmap_file(const char* fileName)
+{
+      // Create file
+  int fd=open(fileName,O_RDWR|O_CREAT|O_TRUNC,0644);
+  if(fd<0)
+  {
+    std::cerr<<"Error while creating file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  size_t newCapacity=std::max(arenaSize,(size_t)ANJI_MIN_ARENA_CAPACITY);
+  if(ftruncate(fd,newCapacity*sizeof(float))!=0)
+  {
+    std::cerr<<"Error while growing file "<<fileName<<std::endl;
+    close(fd);
+    remove(fileName);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,newCapacity*sizeof(float),PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping file "<<fileName<<std::endl;
+    close(fd);
+    remove(fileName);
+    return THOT_ERROR;
+  }
+
+      // Move current values to the file
+  if(arenaSize>0)
+    memcpy(addr,arena,arenaSize*sizeof(float));
+  size_t currArenaSize=arenaSize;
+  size_t currArenaWaste=arenaWaste;
+  releaseArena();
+  mmapFileName=fileName;
+  mmapFd=fd;
+  mapAddr=addr;
+  arena=(float*) addr;
+  arenaSize=currArenaSize;
+  arenaCapacity=newCapacity;
+  arenaWaste=currArenaWaste;
+
+  return THOT_OK;
+}
+
+//-------------------------
+void anjiMatrix::releaseArena(void)
+{
+  if(mapAddr!=NULL)
+  {
+    munmap(mapAddr,arenaCapacity*sizeof(float));
+    close(mmapFd);
+    remove(mmapFileName.c_str());
+    mapAddr=NULL;
+    mmapFd=-1;
+    mmapFileName.clear();
+  }
+  std::vector<float> emptyVec;
+  heapArena.swap(emptyVec);
+  arena=NULL;
+  arenaSize=0;
+  arenaCapacity=0;
+  arenaWaste=0;
+}
+
 //-------------------------
 bool anjiMatrix::resizeIsRequired(unsigned int mapped_n,
                                   PositionIndex nslen,
@@ -88,10 +334,10 @@ bool anjiMatrix::resizeIsRequired(unsigned int mapped_n,
   if(anji.size()<=mapped_n)
     return true;
 
-  if(anji[mapped_n].size()<=tlen)
+  if(anji[mapped_n].nrows<=tlen)
     return true;
 
-  if(anji[mapped_n][0].size()<=nslen)
+  if(anji[mapped_n].ncols<=nslen)
     return true;
 
   return false;
@@ -105,10 +351,8 @@ bool anjiMatrix::reset_entries(void)
         // Reset values
     for(unsigned int n=0;n<anji.size();++n)
     {
-      for(unsigned int j=0;j<anji[n].size();++j)
-      {
-        std::fill(anji[n][j].begin(),anji[n][j].end(),INVALID_ANJI_VAL);
-      }
+      float* values=arena+anji[n].offset;
+      std::fill(values,values+(size_t)anji[n].nrows*anji[n].ncols,(float)INVALID_ANJI_VAL);
     }
 
     return THOT_OK;
@@ -139,14 +383,17 @@ unsigned int anjiMatrix::n_size(void)
 //-------------------------
 unsigned int anjiMatrix::nj_size(unsigned int n)
 {
-  return anji[n].size();
+  return anji[n].nrows;
 }
 
 //-------------------------
 unsigned int anjiMatrix::nji_size(unsigned int n,
                                   unsigned int j)
 {
-  return anji[n][j].size();
+  if(j<anji[n].nrows)
+    return anji[n].ncols;
+  else
+    return 0;
 }
 
 //-------------------------
@@ -187,25 +434,108 @@ bool anjiMatrix::load_anji_values(const char* anjiFile)
   }
   else
   {
-        // Read register
-    bool end=false;
-    while(!end)
+        // Check file format
+    char magic[ANJI_BIN_MAGIC_LEN];
+    uint32_t version=0;
+    if(!inF.read(magic,ANJI_BIN_MAGIC_LEN) || strncmp(magic,ANJI_BIN_MAGIC,ANJI_BIN_MAGIC_LEN)!=0
+       || !inF.read((char*)&version,sizeof(uint32_t)) || version!=ANJI_BIN_VERSION)
+    {
+          // Load file in legacy format (one record per value)
+      inF.clear();
+      inF.seekg(0,std::ios::beg);
+      return load_legacy_anji_values(inF);
+    }
+
+        // Read dimensions of the entries
+    uint64_t numEntries;
+    inF.read((char*)&numEntries,sizeof(uint64_t));
+    std::vector<uint32_t> dims(2*numEntries);
+    if(numEntries>0)
+      inF.read((char*)&dims[0],dims.size()*sizeof(uint32_t));
+    if(!inF)
+    {
+      std::cerr<<"Error, file with anji values "<<anjiFile<<" is truncated"<<std::endl;
+      return THOT_ERROR;
+    }
+    size_t totalSize=0;
+    anji.resize(numEntries);
+    for(unsigned int np=0;np<numEntries;++np)
+    {
+      anji[np].offset=totalSize;
+      anji[np].nrows=dims[2*np];
+      anji[np].ncols=dims[2*np+1];
+      anji[np].capacity=(size_t)anji[np].nrows*anji[np].ncols;
+      totalSize+=anji[np].capacity;
+    }
+
+        // Read values in a single operation
+    if(reserveArena(totalSize)==THOT_ERROR)
+      return THOT_ERROR;
+    arenaSize=totalSize;
+    if(totalSize>0 && !inF.read((char*)arena,totalSize*sizeof(float)))
+    {
+      std::cerr<<"Error, file with anji values "<<anjiFile<<" is truncated"<<std::endl;
+      return THOT_ERROR;
+    }
+    return THOT_OK;
+  }
+}
+
+//-------------------------
+bool anjiMatrix::load_legacy_anji_values(std::ifstream& inF)
+{
+      // Read registers. Registers are grouped by n, so the values of
+      // each entry are buffered and stored once the entry is complete
+  std::vector<std::pair<std::pair<unsigned int,unsigned int>,float> > entryValues;
+  unsigned int curr_n=0;
+  bool end=false;
+  while(!end)
+  {
+    unsigned int n;
+    unsigned int j;
+    unsigned int i;
+    float f;
+    end=!inF.read((char*)&n,sizeof(unsigned int));
+    if(!end)
     {
-      unsigned int n;
-      unsigned int j;
-      unsigned int i;
-      float f;
-      if(inF.read((char*)&n,sizeof(unsigned int)))
+      inF.read((char*)&j,sizeof(unsigned int));
+      inF.read((char*)&i,sizeof(unsigned int));
+      inF.read((char*)&f,sizeof(float));
+    }
+
+    if((end || n!=curr_n) && !entryValues.empty())
+    {
+          // Store values of previous entry
+      unsigned int nrows=0;
+      unsigned int ncols=0;
+      for(unsigned int k=0;k<entryValues.size();++k)
       {
-        inF.read((char*)&j,sizeof(unsigned int));
-        inF.read((char*)&i,sizeof(unsigned int));
-        inF.read((char*)&f,sizeof(float));
-        set(n,j,i,f);
+        nrows=std::max(nrows,entryValues[k].first.first+1);
+        ncols=std::max(ncols,entryValues[k].first.second+1);
       }
-      else end=true;
+      unsigned int np;
+      map_n_in_matrix(curr_n,np);
+      if(resizeIsRequired(np,ncols-1,nrows-1))
+      {
+        if(np<anji.size())
+        {
+          nrows=std::max(nrows,anji[np].nrows);
+          ncols=std::max(ncols,anji[np].ncols);
+        }
+        if(allocEntry(np,nrows,ncols,true)==THOT_ERROR)
+          return THOT_ERROR;
+      }
+      for(unsigned int k=0;k<entryValues.size();++k)
+        set_fast(np,entryValues[k].first.first,entryValues[k].first.second,entryValues[k].second);
+      entryValues.clear();
+    }
+    if(!end)
+    {
+      curr_n=n;
+      entryValues.push_back(std::make_pair(std::make_pair(j,i),f));
     }
-    return THOT_OK;
   }
+  return THOT_OK;
 }
 
 //-------------------------
@@ -275,19 +605,37 @@ bool anjiMatrix::print_anji_values(const char* anjiFile)
   }
   else
   {    
-        // print file with anji values
-    for(unsigned int n=0;n<anji.size();++n)
+        // Print header
+    char magic[ANJI_BIN_MAGIC_LEN];
+    memset(magic,0,ANJI_BIN_MAGIC_LEN);
+    strncpy(magic,ANJI_BIN_MAGIC,ANJI_BIN_MAGIC_LEN-1);
+    uint32_t version=ANJI_BIN_VERSION;
+    uint64_t numEntries=anji.size();
+    outF.write(magic,ANJI_BIN_MAGIC_LEN);
+    outF.write((char*)&version,sizeof(uint32_t));
+    outF.write((char*)&numEntries,sizeof(uint64_t));
+
+        // Print dimensions of the entries
+    std::vector<uint32_t> dims(2*numEntries);
+    for(unsigned int np=0;np<numEntries;++np)
     {
-      for(unsigned int j=0;j<anji[n].size();++j)
-      {
-        for(unsigned int i=0;i<anji[n][j].size();++i)
-        {
-          outF.write((char*)&n,sizeof(unsigned int));
-          outF.write((char*)&j,sizeof(unsigned int));
-          outF.write((char*)&i,sizeof(unsigned int));
-          outF.write((char*)&anji[n][j][i],sizeof(float));
-        }
-      }
+      dims[2*np]=anji[np].nrows;
+      dims[2*np+1]=anji[np].ncols;
+    }
+    if(numEntries>0)
+      outF.write((char*)&dims[0],dims.size()*sizeof(uint32_t));
+
+        // Print values of each entry
+    for(unsigned int np=0;np<numEntries;++np)
+    {
+      size_t entrySize=(size_t)anji[np].nrows*anji[np].ncols;
+      if(entrySize>0)
+        outF.write((char*)(arena+anji[np].offset),entrySize*sizeof(float));
+    }
+    if(!outF)
+    {
+      std::cerr<<"Error while printing anji file."<<std::endl;
+      return THOT_ERROR;
     }
     return THOT_OK;
   }
@@ -320,7 +668,7 @@ bool anjiMatrix::print_maxnsize_data(const char* maxnsizeDataFile)
 }
 
 //-------------------------   
-void anjiMatrix::set(unsigned int n,
+bool anjiMatrix::set(unsigned int n,
                      unsigned int j,
                      unsigned int i,
                      float f)
@@ -330,28 +678,24 @@ void anjiMatrix::set(unsigned int n,
     unsigned int np;
     map_n_in_matrix(n,np);
   
-        // Grow in the dimension of np if necessary
-    while(anji.size()<=np)
+        // Grow entry if necessary
+    if(resizeIsRequired(np,i,j))
     {
-      std::vector<std::vector<float> > aji;
-      anji.push_back(aji);
-    }
-
-        // Grow in the dimension of j if necessary
-    while(anji[np].size()<=j)
-    {
-      std::vector<float> ai;
-      anji[np].push_back(ai);
+      unsigned int nrows=j+1;
+      unsigned int ncols=i+1;
+      if(np<anji.size())
+      {
+        nrows=std::max(nrows,anji[np].nrows);
+        ncols=std::max(ncols,anji[np].ncols);
+      }
+      if(allocEntry(np,nrows,ncols,true)==THOT_ERROR)
+        return THOT_ERROR;
     }
 
-        // Grow in the dimension of i if necessary
-    while(anji[np][j].size()<=i)
-    {
-      anji[np][j].push_back(INVALID_ANJI_VAL);
-    }
         // Set value
-    anji[np][j][i]=f;
+    set_fast(np,j,i,f);
   }
+  return THOT_OK;
 }
 
 //-------------------------   
@@ -361,7 +705,10 @@ void anjiMatrix::set_fast(unsigned int mapped_n,
                           float f)
 {
   if(anji_maxnsize>0)
-    anji[mapped_n][j][i]=f;
+  {
+    const AnjiEntry& entry=anji[mapped_n];
+    arena[entry.offset+j*entry.ncols+i]=f;
+  }
 }
 
 //-------------------------   
@@ -375,10 +722,10 @@ float anjiMatrix::get(unsigned int n,
   
       // Check boundaries
   if(anji.size()<=np) return INVALID_ANJI_VAL;
-  if(anji[np].size()<=j) return INVALID_ANJI_VAL;
-  if(anji[np][j].size()<=i) return INVALID_ANJI_VAL;
+  if(anji[np].nrows<=j) return INVALID_ANJI_VAL;
+  if(anji[np].ncols<=i) return INVALID_ANJI_VAL;
       // anji[np][j][i] is defined
-  return anji[np][j][i];
+  return get_fast(np,j,i);
 }
 
 //-------------------------   
@@ -387,7 +734,10 @@ float anjiMatrix::get_fast(unsigned int mapped_n,
                            unsigned int i)
 {
   if(anji_maxnsize>0)
-    return anji[mapped_n][j][i];
+  {
+    const AnjiEntry& entry=anji[mapped_n];
+    return arena[entry.offset+j*entry.ncols+i];
+  }
   else
     return INVALID_ANJI_VAL;
 }
@@ -486,8 +836,10 @@ void anjiMatrix::map_n_in_matrix(unsigned int n,
 
             // Update old n to np correspondence
         update_n_to_np_vector(pbui.second,std::make_pair(false,0));
-            // Clear anji entry for old index
-        anji[np].clear();
+            // Clear anji entry for old index, its room in the arena
+            // is reused by the new sample
+        anji[np].nrows=0;
+        anji[np].ncols=0;
       }
       
           // Update np to n mapping
@@ -550,4 +902,19 @@ void anjiMatrix::clear(void)
   anji.clear();
   np_to_n_vector.clear();
   n_to_np_vector.clear();
+
+      // Release memory, a memory-mapped file is kept
+  if(mapAddr!=NULL)
+  {
+    arenaSize=0;
+    arenaWaste=0;
+  }
+  else
+    releaseArena();
+}
+
+//-------------------------
+anjiMatrix::~anjiMatrix()
+{
+  releaseArena();
 }
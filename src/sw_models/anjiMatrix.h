@@ -22,6 +22,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  * @brief Defines the anjiMatrix class.  anjiMatrix class stores
  * expected values used in the estimation of IBM 1 and IBM 2 statistical
  * alignment model.
+ *
+ * The values of each sample are stored as a dense (j,i) block in a
+ * single flat arena of floats, which can optionally be backed by a
+ * memory-mapped file.
  * 
  */
 
@@ -36,8 +40,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <AwkInputStream.h>
 #include <vector>
+#include <string>
 #include <utility>
 #include <limits.h>
+#include <stdint.h>
 #include <StatModelDefs.h>
 #include <MathDefs.h>
 
@@ -46,6 +52,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define INVALID_ANJI_VAL             99
 #define UNRESTRICTED_ANJI_SIZE UINT_MAX
 
+#define ANJI_BIN_MAGIC         "thot_anji_bin"
+#define ANJI_BIN_MAGIC_LEN     16
+#define ANJI_BIN_VERSION        1
+
 //--------------- typedefs -------------------------------------------
 
 
@@ -59,8 +69,10 @@ class anjiMatrix
 {
   public:
 
-      // Constructor
+      // Constructors and assignment operator
    anjiMatrix(void);
+   anjiMatrix(const anjiMatrix& am);
+   anjiMatrix& operator=(const anjiMatrix& am);
 
        // Functions to initialize entries
    bool init_nth_entry(unsigned int n,
@@ -76,7 +88,7 @@ class anjiMatrix
    unsigned int nj_size(unsigned int n);
    unsigned int nji_size(unsigned int n,
                          unsigned int j);
-   void set(unsigned int n,
+   bool set(unsigned int n,
             unsigned int j,
             unsigned int i,
             float f);
@@ -109,16 +121,46 @@ class anjiMatrix
        // print function
    bool print(const char* prefFileName);
 
+       // Function to store the arena in a memory-mapped file
+   bool set_mmap_file(const char* fileName);
+       // Moves the stored values to the file given by fileName, which
+       // is created (or truncated) and removed when the matrix is
+       // destroyed. The values are not lost when the matrix is saved
+       // with print() and loaded again
+
        // clear() function
    void clear(void);
+
+       // Destructor
+   ~anjiMatrix();
    
   protected:
+
+       // Location and dimensions of the values of a sample in the
+       // arena. Value (j,i) is stored in position offset+j*ncols+i
+   struct AnjiEntry
+   {
+     size_t offset;
+     size_t capacity;
+     unsigned int nrows;
+     unsigned int ncols;
+     AnjiEntry(){offset=0;capacity=0;nrows=0;ncols=0;}
+   };
    
    unsigned int anji_maxnsize;
    unsigned int anji_pointer;
-   std::vector<std::vector<std::vector<float> > > anji;
+   std::vector<AnjiEntry> anji;
+   float* arena;
        // Use simple precission floating-point numbers for expected
        // values
+   size_t arenaSize;
+   size_t arenaCapacity;
+   size_t arenaWaste;
+       // Number of arena positions that are not used by any entry
+   std::vector<float> heapArena;
+   std::string mmapFileName;
+   int mmapFd;
+   void* mapAddr;
    std::vector<std::pair<bool,unsigned int> > np_to_n_vector;
        // For each index of anji stores if it is already used and the
        // real index of the sample
@@ -127,6 +169,18 @@ class anjiMatrix
        // corresponding index
        
        // Auxiliary functions
+   void copy(const anjiMatrix& am);
+   bool allocEntry(unsigned int mapped_n,
+                   unsigned int nrows,
+                   unsigned int ncols,
+                   bool keepValues);
+       // Sets the dimensions of the given entry, values are
+       // initialized to INVALID_ANJI_VAL unless keepValues is true.
+       // Returns THOT_ERROR (leaving the entry unchanged) if there is
+       // no room for the entry
+   bool reserveArena(size_t capacity);
+   void compactArena(void);
+   void releaseArena(void);
    bool resizeIsRequired(unsigned int mapped_n,
                          PositionIndex nslen,
                          PositionIndex tlen);
@@ -145,6 +199,7 @@ class anjiMatrix
 
        // Functions to load and print anji matrices
    bool load_anji_values(const char* anjiFile);   
+   bool load_legacy_anji_values(std::ifstream& inF);
    bool print_anji_values(const char* anjiFile);
 
        // Functions to load and print maximum size data
@@ -0,0 +1,454 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_hmm_fb.cc
+ *
+ * @brief Micro-benchmark for the forward, backward and Viterbi kernels
+ * of HMM-based alignment models. Random HMMs are generated and the
+ * kernels defined in HmmFbKernels.h are compared with the log-space
+ * computation over nested vectors, both in terms of accuracy and
+ * speed.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "HmmFbKernels.h"
+#include "CachedHmmAligLgProb.h"
+#include "MathFuncs.h"
+#include "ErrorDefs.h"
+#include "ctimer.h"
+#include "options.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Type definitions -----------------------------------
+
+struct BenchHmm
+{
+  unsigned int nslen;
+  unsigned int tlen;
+  std::vector<double> initAligLgProbs;
+  std::vector<double> aligLgProbs;
+  std::vector<double> lexLgProbs;
+};
+
+//--------------- Function Declarations ------------------------------
+
+void genRandomHmm(unsigned int nslen,
+                  unsigned int tlen,
+                  BenchHmm& hmm);
+void refForwardBackward(const BenchHmm& hmm,
+                        CachedHmmAligLgProb& cached_logap,
+                        std::vector<std::vector<double> >& cached_logpts,
+                        std::vector<std::vector<double> >& alphaMatrix,
+                        std::vector<std::vector<double> >& betaMatrix);
+void refViterbi(const BenchHmm& hmm,
+                CachedHmmAligLgProb& cached_logap,
+                std::vector<std::vector<double> >& cached_logpts,
+                std::vector<std::vector<double> >& vitMatrix,
+                std::vector<std::vector<PositionIndex> >& predMatrix);
+void initRefCaches(const BenchHmm& hmm,
+                   CachedHmmAligLgProb& cached_logap,
+                   std::vector<std::vector<double> >& cached_logpts);
+bool scaledForwardBackward(const BenchHmm& hmm,
+                           std::vector<double>& scaledAlpha,
+                           std::vector<double>& scaledBeta,
+                           std::vector<double>& scales);
+void kernelViterbi(const BenchHmm& hmm,
+                   std::vector<double>& vit,
+                   std::vector<PositionIndex>& pred);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Global variables -----------------------------------
+
+unsigned int nslen=40;
+unsigned int tlen=20;
+unsigned int numHmms=100;
+unsigned int seed=31415;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_ERROR)
+    return THOT_ERROR;
+
+  srand(seed);
+  std::vector<BenchHmm> hmms(numHmms);
+  for(unsigned int k=0;k<numHmms;++k)
+    genRandomHmm(nslen,tlen,hmms[k]);
+
+  double elapsed_ant,elapsed,ucpu,scpu;
+
+      // Check accuracy
+  double maxAlphaDiff=0;
+  double maxBetaDiff=0;
+  double maxLpDiff=0;
+  double maxVitDiff=0;
+  unsigned int numPredDiffs=0;
+  unsigned int numUnderflows=0;
+  for(unsigned int k=0;k<numHmms;++k)
+  {
+    CachedHmmAligLgProb cached_logap;
+    std::vector<std::vector<double> > cached_logpts;
+    std::vector<std::vector<double> > alphaMatrix;
+    std::vector<std::vector<double> > betaMatrix;
+    std::vector<std::vector<double> > vitMatrix;
+    std::vector<std::vector<PositionIndex> > predMatrix;
+    refForwardBackward(hmms[k],cached_logap,cached_logpts,alphaMatrix,betaMatrix);
+    refViterbi(hmms[k],cached_logap,cached_logpts,vitMatrix,predMatrix);
+
+    std::vector<double> scaledAlpha;
+    std::vector<double> scaledBeta;
+    std::vector<double> scales;
+    std::vector<double> vit;
+    std::vector<PositionIndex> pred;
+    if(!scaledForwardBackward(hmms[k],scaledAlpha,scaledBeta,scales))
+    {
+      ++numUnderflows;
+      continue;
+    }
+    kernelViterbi(hmms[k],vit,pred);
+
+        // Compare log-space values
+    std::vector<double> alphaLgScales(tlen+1,0);
+    for(unsigned int j=1;j<=tlen;++j)
+      alphaLgScales[j]=alphaLgScales[j-1]+log(scales[j-1]);
+    std::vector<double> betaLgScales(tlen+1,0);
+    for(unsigned int j=tlen-1;j>=1;--j)
+      betaLgScales[j]=betaLgScales[j+1]+log(scales[j]);
+
+    for(unsigned int j=1;j<=tlen;++j)
+    {
+      for(unsigned int i=1;i<=nslen;++i)
+      {
+        double la=log(scaledAlpha[(j-1)*nslen+i-1])+alphaLgScales[j];
+        double lb=log(scaledBeta[(j-1)*nslen+i-1])+betaLgScales[j];
+        if(fabs(la-alphaMatrix[i][j])>maxAlphaDiff)
+          maxAlphaDiff=fabs(la-alphaMatrix[i][j]);
+        if(fabs(lb-betaMatrix[i][j])>maxBetaDiff)
+          maxBetaDiff=fabs(lb-betaMatrix[i][j]);
+        if(fabs(vit[(j-1)*nslen+i-1]-vitMatrix[i][j])>maxVitDiff)
+          maxVitDiff=fabs(vit[(j-1)*nslen+i-1]-vitMatrix[i][j]);
+        if(pred[(j-1)*nslen+i-1]!=predMatrix[i][j])
+          ++numPredDiffs;
+      }
+    }
+    double refLp=alphaMatrix[1][tlen];
+    for(unsigned int i=2;i<=nslen;++i)
+      refLp=MathFuncs::lns_sumlog(refLp,alphaMatrix[i][tlen]);
+    double lp=HmmFbKernels::lgProbGivenScales(tlen,&scales[0]);
+    if(fabs(lp-refLp)>maxLpDiff)
+      maxLpDiff=fabs(lp-refLp);
+  }
+  printf("HMMs: %u ; nslen: %u ; tlen: %u\n",numHmms,nslen,tlen);
+  printf("Max. abs. difference (log-alpha): %g\n",maxAlphaDiff);
+  printf("Max. abs. difference (log-beta): %g\n",maxBetaDiff);
+  printf("Max. abs. difference (log-likelihood): %g\n",maxLpDiff);
+  printf("Max. abs. difference (Viterbi): %g\n",maxVitDiff);
+  printf("Different Viterbi predecessors: %u\n",numPredDiffs);
+  printf("Underflows: %u\n",numUnderflows);
+
+      // Measure time of log-space computation
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int k=0;k<numHmms;++k)
+  {
+    CachedHmmAligLgProb cached_logap;
+    std::vector<std::vector<double> > cached_logpts;
+    std::vector<std::vector<double> > alphaMatrix;
+    std::vector<std::vector<double> > betaMatrix;
+    refForwardBackward(hmms[k],cached_logap,cached_logpts,alphaMatrix,betaMatrix);
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  double refFbTime=elapsed-elapsed_ant;
+
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int k=0;k<numHmms;++k)
+  {
+    CachedHmmAligLgProb cached_logap;
+    std::vector<std::vector<double> > cached_logpts;
+    std::vector<std::vector<double> > vitMatrix;
+    std::vector<std::vector<PositionIndex> > predMatrix;
+    initRefCaches(hmms[k],cached_logap,cached_logpts);
+    refViterbi(hmms[k],cached_logap,cached_logpts,vitMatrix,predMatrix);
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  double refVitTime=elapsed-elapsed_ant;
+
+      // Measure time of kernels
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int k=0;k<numHmms;++k)
+  {
+    std::vector<double> scaledAlpha;
+    std::vector<double> scaledBeta;
+    std::vector<double> scales;
+    scaledForwardBackward(hmms[k],scaledAlpha,scaledBeta,scales);
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  double kernelFbTime=elapsed-elapsed_ant;
+
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int k=0;k<numHmms;++k)
+  {
+    std::vector<double> vit;
+    std::vector<PositionIndex> pred;
+    kernelViterbi(hmms[k],vit,pred);
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  double kernelVitTime=elapsed-elapsed_ant;
+
+  printf("Forward-backward time per HMM (log-space / scaled): %g / %g ms\n",1000*refFbTime/numHmms,1000*kernelFbTime/numHmms);
+  printf("Viterbi time per HMM (nested / flat): %g / %g ms\n",1000*refVitTime/numHmms,1000*kernelVitTime/numHmms);
+
+  return THOT_OK;
+}
+
+//---------------
+void genRandomHmm(unsigned int nslen,
+                  unsigned int tlen,
+                  BenchHmm& hmm)
+{
+  hmm.nslen=nslen;
+  hmm.tlen=tlen;
+
+      // Generate alignment probabilities, each row is normalized
+  std::vector<double> probs(nslen);
+  hmm.initAligLgProbs.resize(nslen);
+  hmm.aligLgProbs.resize(nslen*nslen);
+  for(unsigned int ip=0;ip<=nslen;++ip)
+  {
+    double sum=0;
+    for(unsigned int i=0;i<nslen;++i)
+    {
+      probs[i]=0.001+(double)rand()/RAND_MAX;
+      sum+=probs[i];
+    }
+    for(unsigned int i=0;i<nslen;++i)
+    {
+      if(ip==0)
+        hmm.initAligLgProbs[i]=log(probs[i]/sum);
+      else
+        hmm.aligLgProbs[(ip-1)*nslen+i]=log(probs[i]/sum);
+    }
+  }
+
+      // Generate lexical probabilities
+  hmm.lexLgProbs.resize(tlen*nslen);
+  for(unsigned int k=0;k<tlen*nslen;++k)
+    hmm.lexLgProbs[k]=log(0.0001+(double)rand()/RAND_MAX);
+}
+
+//---------------
+void initRefCaches(const BenchHmm& hmm,
+                   CachedHmmAligLgProb& cached_logap,
+                   std::vector<std::vector<double> >& cached_logpts)
+{
+      // Fill nested data structures used by the log-space computation
+  cached_logap.makeRoomGivenNSrcSentLen(hmm.nslen);
+  for(unsigned int i=1;i<=hmm.nslen;++i)
+  {
+    cached_logap.set(0,hmm.nslen,i,hmm.initAligLgProbs[i-1]);
+    for(unsigned int ip=1;ip<=hmm.nslen;++ip)
+      cached_logap.set(ip,hmm.nslen,i,hmm.aligLgProbs[(ip-1)*hmm.nslen+i-1]);
+  }
+
+  std::vector<double> dVec(hmm.tlen+1,SMALL_LG_NUM);
+  cached_logpts.assign(hmm.nslen+1,dVec);
+  for(unsigned int j=1;j<=hmm.tlen;++j)
+    for(unsigned int i=1;i<=hmm.nslen;++i)
+      cached_logpts[i][j]=hmm.lexLgProbs[(j-1)*hmm.nslen+i-1];
+}
+
+//---------------
+void refForwardBackward(const BenchHmm& hmm,
+                        CachedHmmAligLgProb& cached_logap,
+                        std::vector<std::vector<double> >& cached_logpts,
+                        std::vector<std::vector<double> >& alphaMatrix,
+                        std::vector<std::vector<double> >& betaMatrix)
+{
+  unsigned int slen=hmm.nslen;
+  initRefCaches(hmm,cached_logap,cached_logpts);
+
+      // Forward matrix
+  std::vector<double> dVec(hmm.tlen+1,0.0);
+  alphaMatrix.assign(hmm.nslen+1,dVec);
+  for(PositionIndex j=1;j<=hmm.tlen;++j)
+  {
+    for(PositionIndex i=1;i<=hmm.nslen;++i)
+    {
+      if(j==1)
+      {
+        alphaMatrix[i][j]=cached_logap.get(0,slen,i)+cached_logpts[i][j];
+      }
+      else
+      {
+        for(PositionIndex i_tilde=1;i_tilde<=hmm.nslen;++i_tilde)
+        {
+          double lp=alphaMatrix[i_tilde][j-1]+cached_logap.get(i_tilde,slen,i)+cached_logpts[i][j];
+          if(i_tilde==1)
+            alphaMatrix[i][j]=lp;
+          else
+            alphaMatrix[i][j]=MathFuncs::lns_sumlog(lp,alphaMatrix[i][j]);
+        }
+      }
+    }
+  }
+
+      // Backward matrix
+  betaMatrix.assign(hmm.nslen+1,dVec);
+  for(PositionIndex j=hmm.tlen;j>=1;--j)
+  {
+    for(PositionIndex i=1;i<=hmm.nslen;++i)
+    {
+      if(j==hmm.tlen)
+      {
+        betaMatrix[i][j]=log(1.0);
+      }
+      else
+      {
+        for(PositionIndex i_tilde=1;i_tilde<=hmm.nslen;++i_tilde)
+        {
+          double lp=betaMatrix[i_tilde][j+1]+cached_logap.get(i,slen,i_tilde)+cached_logpts[i_tilde][j+1];
+          if(i_tilde==1)
+            betaMatrix[i][j]=lp;
+          else
+            betaMatrix[i][j]=MathFuncs::lns_sumlog(lp,betaMatrix[i][j]);
+        }
+      }
+    }
+  }
+}
+
+//---------------
+void refViterbi(const BenchHmm& hmm,
+                CachedHmmAligLgProb& cached_logap,
+                std::vector<std::vector<double> >& cached_logpts,
+                std::vector<std::vector<double> >& vitMatrix,
+                std::vector<std::vector<PositionIndex> >& predMatrix)
+{
+  unsigned int slen=hmm.nslen;
+  std::vector<double> dVec(hmm.tlen+1,SMALL_LG_NUM);
+  vitMatrix.assign(hmm.nslen+1,dVec);
+  std::vector<PositionIndex> pidxVec(hmm.tlen+1,0);
+  predMatrix.assign(hmm.nslen+1,pidxVec);
+
+  for(PositionIndex j=1;j<=hmm.tlen;++j)
+  {
+    for(PositionIndex i=1;i<=hmm.nslen;++i)
+    {
+      if(j==1)
+      {
+        vitMatrix[i][j]=cached_logap.get(0,slen,i)+cached_logpts[i][j];
+        predMatrix[i][j]=0;
+      }
+      else
+      {
+        for(PositionIndex i_tilde=1;i_tilde<=hmm.nslen;++i_tilde)
+        {
+          double lp=vitMatrix[i_tilde][j-1]+cached_logap.get(i_tilde,slen,i)+cached_logpts[i][j];
+          if(lp>vitMatrix[i][j])
+          {
+            vitMatrix[i][j]=lp;
+            predMatrix[i][j]=i_tilde;
+          }
+        }
+      }
+    }
+  }
+}
+
+//---------------
+bool scaledForwardBackward(const BenchHmm& hmm,
+                           std::vector<double>& scaledAlpha,
+                           std::vector<double>& scaledBeta,
+                           std::vector<double>& scales)
+{
+  std::vector<double> initAligProbs;
+  std::vector<double> aligProbs;
+  std::vector<double> lexProbs;
+  HmmFbKernels::lgProbsToProbs(hmm.initAligLgProbs,initAligProbs);
+  HmmFbKernels::lgProbsToProbs(hmm.aligLgProbs,aligProbs);
+  HmmFbKernels::lgProbsToProbs(hmm.lexLgProbs,lexProbs);
+
+  scaledAlpha.resize(hmm.tlen*hmm.nslen);
+  scaledBeta.resize(hmm.tlen*hmm.nslen);
+  scales.resize(hmm.tlen);
+  if(!HmmFbKernels::scaledForward(hmm.nslen,hmm.tlen,&initAligProbs[0],&aligProbs[0],&lexProbs[0],&scaledAlpha[0],&scales[0]))
+    return false;
+  HmmFbKernels::scaledBackward(hmm.nslen,hmm.tlen,&aligProbs[0],&lexProbs[0],&scales[0],&scaledBeta[0]);
+  return true;
+}
+
+//---------------
+void kernelViterbi(const BenchHmm& hmm,
+                   std::vector<double>& vit,
+                   std::vector<PositionIndex>& pred)
+{
+  vit.resize(hmm.tlen*hmm.nslen);
+  pred.resize(hmm.tlen*hmm.nslen);
+  HmmFbKernels::viterbi(hmm.nslen,hmm.tlen,&hmm.initAligLgProbs[0],&hmm.aligLgProbs[0],&hmm.lexLgProbs[0],&vit[0],&pred[0]);
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+  readUnsignedInt(argc,argv, "-I", &nslen);
+  readUnsignedInt(argc,argv, "-J", &tlen);
+  readUnsignedInt(argc,argv, "-n", &numHmms);
+  readUnsignedInt(argc,argv, "-s", &seed);
+  if(nslen==0 || tlen==0 || numHmms==0)
+  {
+    std::cerr<<"Error: -I, -J and -n values must be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_bench_hmm_fb [-I <int>] [-J <int>] [-n <int>] [-s <int>]\n");
+  printf("                         [--help]\n\n");
+  printf("-I <int>                 Number of HMM states, i.e. length of the source\n");
+  printf("                         sentence extended with null words (40 by default).\n\n");
+  printf("-J <int>                 Length of the target sentence (20 by default).\n\n");
+  printf("-n <int>                 Number of random HMMs (100 by default).\n\n");
+  printf("-s <int>                 Seed for the random number generator (31415 by\n");
+  printf("                         default).\n\n");
+  printf("--help                   Display this help and exit.\n\n");
+}
+
+//--------------------------------
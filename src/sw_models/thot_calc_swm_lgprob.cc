@@ -30,7 +30,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include "IncrHmmAligModel.h"
-#include "CachedHmmAligLgProb.h"
+#include "SwBatchAligner.h"
 #include "BaseSwAligModel.h"
 #include <WordAligMatrix.h>
 #include <printAligFuncs.h>
@@ -79,6 +79,7 @@ std::string trgSent;
 std::string alig;
 int max_opt;
 int alig_given;
+unsigned int numThreads;
 int verbosity;
 
 //--------------- Function Definitions --------------------------------
@@ -324,12 +325,17 @@ int processSentPairFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
  AwkInputStream awk;
  std::vector<std::string> srcSentVec;
  std::vector<std::string> trgSentVec;
- LgProb lp;
 
-     // Define variables required to speed up generation of best
-     // alignments for HMM alignment models
- CachedHmmAligLgProb cached_logap;
- IncrHmmAligModel* incrHmmAligModelPtr=dynamic_cast<IncrHmmAligModel*>(swAligModelPtr);
+     // Define variables required to process the sentence pairs in
+     // blocks using multiple threads. The batch aligner keeps the
+     // cached alignment log-probabilities for HMM alignment models
+ SwBatchAligner swBatchAligner(swAligModelPtr);
+ swBatchAligner.setNumThreads(numThreads);
+ std::vector<std::vector<std::string> > blockSrcSentVec;
+ std::vector<std::vector<std::string> > blockTrgSentVec;
+ std::vector<std::string> blockLineVec;
+ std::vector<std::vector<WordIndex> > blockSrcIndexVec;
+ std::vector<std::vector<WordIndex> > blockTrgIndexVec;
  
  if(strcmp(sentPairFile,"-")==0)
  {
@@ -350,56 +356,72 @@ int processSentPairFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
  if(ret==THOT_ERROR) return THOT_ERROR;
 
      // Process input
- while(awk.getln())
+ bool endOfInput=false;
+ while(!endOfInput)
  {
-       // Extract source and target phrases
-   unsigned int i=1; 
-   srcSentVec.clear();
-   while(i<=awk.NF && strcmp("|||",awk.dollar(i).c_str())!=0)	
+       // Read block of sentence pairs
+   blockSrcSentVec.clear();
+   blockTrgSentVec.clear();
+   blockLineVec.clear();
+   blockSrcIndexVec.clear();
+   blockTrgIndexVec.clear();
+   while(blockSrcSentVec.size()<SW_BATCH_ALIGNER_BLOCK_SIZE)
    {
-     srcSentVec.push_back(awk.dollar(i)); 
+     if(!awk.getln())
+     {
+       endOfInput=true;
+       break;
+     }
+     
+         // Extract source and target phrases
+     unsigned int i=1; 
+     srcSentVec.clear();
+     while(i<=awk.NF && strcmp("|||",awk.dollar(i).c_str())!=0)	
+     {
+       srcSentVec.push_back(awk.dollar(i)); 
+       ++i;
+     }
      ++i;
-   }
-   ++i;
-   trgSentVec.clear();
-   while(i<=awk.NF && strcmp("|||",awk.dollar(i).c_str())!=0)	
-   {
-     trgSentVec.push_back(awk.dollar(i));			   
-     ++i; 
+     trgSentVec.clear();
+     while(i<=awk.NF && strcmp("|||",awk.dollar(i).c_str())!=0)	
+     {
+       trgSentVec.push_back(awk.dollar(i));			   
+       ++i; 
+     }
+
+         // Obtain word indices, this cannot be done concurrently since
+         // new symbols are added to the vocabularies
+     blockSrcIndexVec.push_back(swAligModelPtr->strVectorToSrcIndexVector(srcSentVec));
+     blockTrgIndexVec.push_back(swAligModelPtr->strVectorToTrgIndexVector(trgSentVec));
+     blockSrcSentVec.push_back(srcSentVec);
+     blockTrgSentVec.push_back(trgSentVec);
+     if(!max_opt)
+       blockLineVec.push_back(awk.dollar(0));
    }
 
+   std::vector<LgProb> lgProbVec;
    if(max_opt)
    {
          // -max option was given
-     WordAligMatrix waMatrix;
+     std::vector<WordAligMatrix> waMatrixVec;
 
-         // Obtain best alignment
-     if(incrHmmAligModelPtr)
-     {
-       lp=incrHmmAligModelPtr->obtainBestAlignmentVecStrCached(srcSentVec,
-                                                               trgSentVec,
-                                                               cached_logap,
-                                                               waMatrix);
-     }
-     else
+         // Obtain best alignments
+     swBatchAligner.obtainBestAlignments(blockSrcIndexVec,blockTrgIndexVec,lgProbVec,waMatrixVec);
+
+         // Print alignments in GIZA format
+     for(unsigned int n=0;n<lgProbVec.size();++n)
      {
-       lp=swAligModelPtr->obtainBestAlignmentVecStr(srcSentVec,
-                                                    trgSentVec,
-                                                    waMatrix);
+       char header[256];
+       sprintf(header,"# Alignment probability= %f",(double)lgProbVec[n]);
+       printAlignmentInGIZAFormat(std::cout,swAligModelPtr->addNullWordToStrVec(blockSrcSentVec[n]),blockTrgSentVec[n],waMatrixVec[n],header);
      }
-     
-         // Print alignment in GIZA format
-     char header[256];
-     sprintf(header,"# Alignment probability= %f",(double)lp);
-     printAlignmentInGIZAFormat(std::cout,swAligModelPtr->addNullWordToStrVec(srcSentVec),trgSentVec,waMatrix,header);
    }
    else
    {
          // -max option was not given
-     lp=swAligModelPtr->calcLgProbVecStr(srcSentVec,
-                                         trgSentVec,
-                                         verbosity);
-     std::cout<<awk.dollar(0)<<" ||| "<<lp<<std::endl;
+     swBatchAligner.calcLgProbs(blockSrcIndexVec,blockTrgIndexVec,lgProbVec,verbosity);
+     for(unsigned int n=0;n<lgProbVec.size();++n)
+       std::cout<<blockLineVec[n]<<" ||| "<<lgProbVec[n]<<std::endl;
    }
  }
  
@@ -488,6 +510,20 @@ int TakeParameters(int argc,char *argv[])
    max_opt=1;
  }
 
+     /* Verify -nt option */
+ numThreads=1;
+ int nt;
+ err=readInt(argc,argv,"-nt",&nt);
+ if(err!=-1)
+ {
+   if(nt<=0)
+   {
+     std::cerr<<"Error: value of -nt parameter must be greater than zero"<<std::endl;
+     return THOT_ERROR;
+   }
+   numThreads=nt;
+ }
+
      /* Verify -v option */
  verbosity=0;
  err=readOption(argc,argv,"-v");
@@ -513,7 +549,8 @@ void printUsage(void)
  std::cerr<<"Usage: thot_calc_swm_lgprob -sw <string>\n";
  std::cerr<<"                            {-ss <string> -ts <string>\n";
  std::cerr<<"                            [-a <string>] [-max] | -F <string>\n";
- std::cerr<<"                            | -P <string> [-max]} [-v|-v1] \n";
+ std::cerr<<"                            | -P <string> [-max] [-nt <int>]}\n";
+ std::cerr<<"                            [-v|-v1] \n";
  std::cerr<<"                            [--help]\n\n";
  std::cerr<<"-sw <string>                Prefix of the single-word model files\n";
  std::cerr<<"                            to load\n\n";
@@ -529,6 +566,9 @@ void printUsage(void)
  std::cerr<<"-P <string>                 File with sentence pairs without alignment.\n";
  std::cerr<<"                            If <string>=\"-\" then stdin is read.\n";
  std::cerr<<"                            Format: src ||| trg\n\n";
+ std::cerr<<"-nt <int>                   Number of threads used to process the\n";
+ std::cerr<<"                            sentence pairs given with -P (1 by default).\n";
+ std::cerr<<"                            Output is written in input order\n\n";
  std::cerr<<"-v | -v1                    Verbose mode\n\n";
  std::cerr<<"--help                      Display this help and exit\n\n";
 }
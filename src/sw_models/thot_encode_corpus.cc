@@ -0,0 +1,135 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_encode_corpus.cc
+ *
+ * @brief Encodes a parallel corpus given as text files into the binary
+ * format defined by the BinSentPairCorpus class. The resulting file can
+ * be given to thot_gen_sw_model using the -s option.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BinSentPairCorpus.h"
+#include "ErrorDefs.h"
+#include "options.h"
+#include <stdio.h>
+#include <iostream>
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Function Declarations ------------------------------
+
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+void version(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string srcFileName;
+std::string trgFileName;
+std::string countsFileName;
+std::string outFileName;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_ERROR)
+    return THOT_ERROR;
+
+  std::cerr<<"Encoding corpus given by files "<<srcFileName<<" and "<<trgFileName<<" into "<<outFileName<<std::endl;
+  if(BinSentPairCorpus::encode(srcFileName.c_str(),trgFileName.c_str(),countsFileName.c_str(),outFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Print statistics
+  BinSentPairCorpus binCorpus;
+  if(binCorpus.open(outFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+  std::cerr<<"#Sentence pairs: "<<binCorpus.numSentPairs()<<std::endl;
+  std::cerr<<"Source vocabulary size: "<<binCorpus.srcVocabSize()<<std::endl;
+  std::cerr<<"Target vocabulary size: "<<binCorpus.trgVocabSize()<<std::endl;
+
+  return THOT_OK;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  if(argc==1 || readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+  if(readOption(argc,argv,"--version")!=-1)
+  {
+    version();
+    return THOT_ERROR;
+  }
+
+  if(readSTLstring(argc,argv,"-s",&srcFileName)==-1)
+  {
+    std::cerr<<"Error: -s parameter not given!"<<std::endl;
+    return THOT_ERROR;
+  }
+  if(readSTLstring(argc,argv,"-t",&trgFileName)==-1)
+  {
+    std::cerr<<"Error: -t parameter not given!"<<std::endl;
+    return THOT_ERROR;
+  }
+  if(readSTLstring(argc,argv,"-o",&outFileName)==-1)
+  {
+    std::cerr<<"Error: -o parameter not given!"<<std::endl;
+    return THOT_ERROR;
+  }
+  readSTLstring(argc,argv,"-c",&countsFileName);
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_encode_corpus -s <string> -t <string> [-c <string>]\n");
+  printf("                          -o <string> [--help] [--version]\n\n");
+  printf("-s <string>               File with source sentences.\n\n");
+  printf("-t <string>               File with target sentences.\n\n");
+  printf("-c <string>               File with sentence pair counts (all counts are\n");
+  printf("                          equal to one by default).\n\n");
+  printf("-o <string>               Output file for the binary corpus.\n\n");
+  printf("--help                    Display this help and exit.\n\n");
+  printf("--version                 Output version information and exit.\n\n");
+}
+
+//---------------
+void version(void)
+{
+  std::cerr<<"thot_encode_corpus is part of the thot package"<<std::endl;
+  std::cerr<<"thot version "<<THOT_VERSION<<std::endl;
+  std::cerr<<"thot is GNU software written by Daniel Ortiz"<<std::endl;
+}
+
+//--------------------------------
@@ -31,6 +31,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include "options.h"
 #include "SwDefs.h"
+#include "LexCsrTableReader.h"
+#include "LexCsrTableWriter.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -39,7 +41,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Function Declarations ------------------------------
 
-int readTableRecord(std::ifstream& inF,
+int readTableRecord(LexCsrTableReader& reader,
                     WordIndex& s,
                     WordIndex& t,
                     float& numer,
@@ -64,10 +66,10 @@ int main(int argc,char *argv[])
   if(TakeParameters(argc,argv)==THOT_OK)
   {
         // Try to open file with lexical table  
-    std::ifstream lexTableInF (ilextableFileName.c_str(), std::ios::in | std::ios::binary);
-    if (!lexTableInF)
+    LexCsrTableReader lexTableReader;
+    if(lexTableReader.open(ilextableFileName.c_str())==THOT_ERROR)
     {
-      std::cerr<<"Error in file with incremental lexical table, file "<<ilextableFileName<<" does not exist.\n";
+      std::cerr<<"Error in file with incremental lexical table, file "<<ilextableFileName<<" could not be opened.\n";
       return THOT_ERROR;    
     }
 
@@ -87,6 +89,11 @@ int main(int argc,char *argv[])
     float numer;
     float denom;
 
+        // Open output table
+    LexCsrTableWriter writer;
+    if(writer.open(std::cout)==THOT_ERROR)
+      return THOT_ERROR;
+
         // Read first record of file with filtering info
     int ret=readFiltInfoRecord(filtInfoInf,sFilt,tFilt);
     if(ret==NO_RECORDS_LEFT)
@@ -95,7 +102,7 @@ int main(int argc,char *argv[])
     while(!end)
     {
           // Read field of table
-      int ret=readTableRecord(lexTableInF,s,t,numer,denom);
+      int ret=readTableRecord(lexTableReader,s,t,numer,denom);
       if(ret==NO_RECORDS_LEFT)
         end=true;
       else
@@ -103,10 +110,9 @@ int main(int argc,char *argv[])
         if(s==sFilt && t==tFilt)
         {
 //          printf("%d %d %g %g\n",s,t,numer,denom);
-          std::cout.write((char*)&s,sizeof(WordIndex));
-          std::cout.write((char*)&t,sizeof(WordIndex));
-          std::cout.write((char*)&numer,sizeof(float));
-          std::cout.write((char*)&denom,sizeof(float));
+          if(writer.addEntry(s,t,numer)==THOT_ERROR)
+            return THOT_ERROR;
+          writer.setDenom(s,denom);
 
           int ret=readFiltInfoRecord(filtInfoInf,sFilt,tFilt);
           if(ret==NO_RECORDS_LEFT)
@@ -116,10 +122,10 @@ int main(int argc,char *argv[])
     }
 
         // Close input files
-    lexTableInF.close();
+    lexTableReader.close();
     filtInfoInf.close();      
     
-    return THOT_OK;
+    return writer.close();
   }
   else return THOT_ERROR;
 }
@@ -138,19 +144,14 @@ int readFiltInfoRecord(std::ifstream& inF,
 }
 
 //--------------- readTableRecord function
-int readTableRecord(std::ifstream& inF,
+int readTableRecord(LexCsrTableReader& reader,
                     WordIndex& s,
                     WordIndex& t,
                     float& numer,
                     float& denom)
 {
-  if(inF.read((char*)&s,sizeof(WordIndex)))
-  {
-    inF.read((char*)&t,sizeof(WordIndex));
-    inF.read((char*)&numer,sizeof(float));
-    inF.read((char*)&denom,sizeof(float));
+  if(reader.getNextRecord(s,t,numer,denom))
     return RECORD_READ;
-  }
   else return NO_RECORDS_LEFT;
 }
 
@@ -30,6 +30,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include "options.h"
 #include "SwDefs.h"
+#include "LexCsrTableReader.h"
 
 //--------------- Function Declarations ------------------------------
 
@@ -49,10 +50,10 @@ int main(int argc,char *argv[])
   if(TakeParameters(argc,argv)==THOT_OK)
   {
         // Try to open file  
-    std::ifstream inF (lexTableFileName.c_str(), std::ios::in | std::ios::binary);
-    if (!inF)
+    LexCsrTableReader reader;
+    if(reader.open(lexTableFileName.c_str())==THOT_ERROR)
     {
-      std::cerr<<"Error in file with incremental lexical table, file "<<lexTableFileName<<" does not exist.\n";
+      std::cerr<<"Error in file with incremental lexical table, file "<<lexTableFileName<<" could not be opened.\n";
       return THOT_ERROR;    
     }
     else
@@ -66,12 +67,8 @@ int main(int argc,char *argv[])
         WordIndex t;
         float numer;
         float denom;
-        if(inF.read((char*)&s,sizeof(WordIndex)))
+        if(reader.getNextRecord(s,t,numer,denom))
         {
-          inF.read((char*)&t,sizeof(WordIndex));
-          inF.read((char*)&numer,sizeof(float));
-          inF.read((char*)&denom,sizeof(float));
-
 //                     printf("%d %d\n",s,t);
           std::cout.write((char*)&s,sizeof(WordIndex));
           std::cout.write((char*)&t,sizeof(WordIndex));
@@ -79,7 +76,7 @@ int main(int argc,char *argv[])
         else end=true;
       }
           // Close input file
-      inF.close();      
+      reader.close();      
 
       return THOT_OK;
     }
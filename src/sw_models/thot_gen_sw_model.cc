@@ -35,6 +35,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "_incrSwAligModel.h"
 #include "BaseStepwiseAligModel.h"
 #include "BaseSwAligModel.h"
+#include "BinSentPairCorpus.h"
 #include "thot_gen_sw_model_pars.h"
 #include "DynClassFileHandler.h"
 #include "SimpleDynClassLoader.h"
@@ -173,6 +174,20 @@ int processParameters(thot_gen_sw_model_pars pars)
     if(pars.r_given)
     {
       _incrSwAligModelPtr->set_expval_maxnsize(pars.r);
+    }
+
+        // Set number of threads for the EM algorithm
+    _incrSwAligModelPtr->setNumThreads(pars.nt);
+
+        // Store matrix of expected values in memory-mapped files
+    if(pars.ma_given)
+    {
+      int ret=_incrSwAligModelPtr->set_expval_mmap_prefix(pars.ma_str.c_str());
+      if(ret==THOT_ERROR)
+      {
+        release_swm(true);
+        return THOT_ERROR;
+      }
     }
   }
 
@@ -236,13 +251,36 @@ int processParameters(thot_gen_sw_model_pars pars)
       }
     }
 #endif
+        // Encode training files into a binary corpus (if not given),
+        // so that EM iterations can access sentence pairs randomly
+        // without tokenizing the text files again
+    std::string srcFileName=pars.s_str;
+    std::string binCorpusFileName;
+    if(!BinSentPairCorpus::isBinCorpus(pars.s_str.c_str()))
+    {
+      binCorpusFileName=pars.o_str+".bincorpus";
+      std::cerr<<"Encoding training files into binary corpus "<<binCorpusFileName<<std::endl;
+      if(BinSentPairCorpus::encode(pars.s_str.c_str(),pars.t_str.c_str(),"",binCorpusFileName.c_str())==THOT_OK)
+        srcFileName=binCorpusFileName;
+      else
+      {
+        std::cerr<<"Warning: training files could not be encoded, text files will be used instead"<<std::endl;
+        binCorpusFileName.clear();
+      }
+    }
+    
         // Read sentence pairs
     std::string srctrgcFileName="";
     std::pair<unsigned int,unsigned int> pui;
-    int ret=swAligModelPtr->readSentencePairs(pars.s_str.c_str(),
+    int ret=swAligModelPtr->readSentencePairs(srcFileName.c_str(),
                                               pars.t_str.c_str(),
                                               srctrgcFileName.c_str(),
                                               pui);
+
+        // Remove temporary binary corpus (it remains mapped while it is
+        // in use)
+    if(!binCorpusFileName.empty())
+      remove(binCorpusFileName.c_str());
     if(ret==THOT_ERROR)
     {
       release_swm(true);
@@ -685,6 +723,23 @@ int takeParameters(int argc,
       }
     }
 
+        // -nt parameter
+    if(argv_stl[i]=="-nt" && !matched)
+    {
+      pars.nt_given=true;
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -nt parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.nt=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
             // -lf parameter
     if(argv_stl[i]=="-lf" && !matched)
     {
@@ -719,6 +774,23 @@ int takeParameters(int argc,
       }
     }
 
+        // -ma parameter
+    if(argv_stl[i]=="-ma" && !matched)
+    {
+      pars.ma_given=true;
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -ma parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.ma_str=argv_stl[i+1];
+        ++matched;
+        ++i;
+      }
+    }
+
         // -o parameter
     if(argv_stl[i]=="-o" && !matched)
     {
@@ -772,7 +844,7 @@ int checkParameters(thot_gen_sw_model_pars& pars)
       return THOT_ERROR;
     }
 
-    if(!pars.t_given)
+    if(!pars.t_given && !BinSentPairCorpus::isBinCorpus(pars.s_str.c_str()))
     {
       std::cerr<<"Error: -t parameter not given!"<<std::endl;
       return THOT_ERROR;
@@ -832,6 +904,12 @@ int checkParameters(thot_gen_sw_model_pars& pars)
     std::cerr<<"Error: parameter -in cannot be used without -i parameter"<<std::endl;
     return THOT_ERROR;
   }
+
+  if(pars.nt_given && pars.nt==0)
+  {
+    std::cerr<<"Error: value of -nt parameter must be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
   
       // Check invalid options when using non-incremental sw models
   if(init_swm(false)==THOT_ERROR)
@@ -883,6 +961,10 @@ void printParameters(thot_gen_sw_model_pars pars)
     std::cerr<<"-lf: "<<pars.lf_val<<std::endl;
   if(pars.af_given)
     std::cerr<<"-af: "<<pars.af_val<<std::endl;
+  if(pars.nt_given)
+    std::cerr<<"-nt: "<<pars.nt<<std::endl;
+  if(pars.ma_given)
+    std::cerr<<"-ma: "<<pars.ma_str<<std::endl;
   std::cerr<<"Output files prefix: "<<pars.o_str<<std::endl;
   std::cerr<<"-v: "<<pars.v_given<<std::endl;
   std::cerr<<"-v1: "<<pars.v1_given<<std::endl;
@@ -896,9 +978,12 @@ void printUsage(void)
   std::cerr<<"                      [-eb | -mb <int> [-lr <int> [<float1>...<floatn>] ] \n";
   std::cerr<<"                      | -i [-c] [-r <int> [-in]] ]\n";
   std::cerr<<"                      [-np <float>] [-lf <float>] [-af <float>]\n";
+  std::cerr<<"                      [-nt <int>] [-ma <string>]\n";
   std::cerr<<"                      -o <string>\n";
   std::cerr<<"                      [-v|-v1] [--help] [--version]\n\n";
-  std::cerr<<"-s <string>           File with source training sentences.\n";
+  std::cerr<<"-s <string>           File with source training sentences or binary\n";
+  std::cerr<<"                      corpus generated with thot_encode_corpus (the -t\n";
+  std::cerr<<"                      option is not required in this case).\n";
   std::cerr<<"-t <string>           File with target training sentences.\n";
   std::cerr<<"-l <string>           Prefix of the model files to be loaded.\n";
   std::cerr<<"-n <int>              Number of EM iterations.\n";
@@ -932,6 +1017,14 @@ void printUsage(void)
   std::cerr<<"                      with fixed p0 probability).\n";
   std::cerr<<"                      NOTE: this option has no effect when combined with\n";
   std::cerr<<"                      the -l option.\n";
+  std::cerr<<"-nt <int>             Number of threads used to compute the expected\n";
+  std::cerr<<"                      values of the EM algorithm (1 by default, only\n";
+  std::cerr<<"                      available for IBM 1, IBM 2 and HMM-based\n";
+  std::cerr<<"                      alignment models).\n";
+  std::cerr<<"-ma <string>          Store the matrix of expected values in\n";
+  std::cerr<<"                      memory-mapped files with prefix <string>\n";
+  std::cerr<<"                      (only available for IBM 1, IBM 2 and HMM-based\n";
+  std::cerr<<"                      alignment models).\n";
   std::cerr<<"-o <string>           Set prefix for output files.\n";
   std::cerr<<"-v | -v1              Verbose modes.\n";
   std::cerr<<"--help                Display this help and exit.\n";
@@ -57,6 +57,10 @@ struct thot_gen_sw_model_pars
   float af_val;
   bool np_given;
   float np_val;
+  bool nt_given;
+  unsigned int nt;
+  bool ma_given;
+  std::string ma_str;
   bool o_given;
   std::string o_str;
   bool v_given;
@@ -85,6 +89,9 @@ struct thot_gen_sw_model_pars
       lf_given=false;
       af_given=false;
       np_given=false;
+      nt_given=false;
+      nt=1;
+      ma_given=false;
       o_given=false;
       v_given=false;
       v1_given=false;      
@@ -20,7 +20,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  * @file thot_merge_bin_ihmmatable.cc
  * 
  * @brief Merges counts given in a set of sorted incremental hmm
- * alignment tables.
+ * alignment tables. The tables are merged in one pass by means of a
+ * k-way merge, keeping only the entries of the current source in
+ * memory.
  */
 
 //--------------- Include files --------------------------------------
@@ -30,7 +32,6 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <fstream>
 #include <vector>
 #include <queue>
-#include <set>
 #include "options.h"
 #include "SwDefs.h"
 #include "aSourceHmm.h"
@@ -40,6 +41,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #define RECORD_READ     0
 #define NO_RECORDS_LEFT 1
+#define INPUT_BUFFER_SIZE 1048576
 
 //--------------- Type definitions -----------------------------------
 
@@ -72,8 +74,6 @@ struct SortBySrcAndTrg
 
 typedef std::priority_queue<Entry,std::vector<Entry>,SortBySrcAndTrg> MergePrQueue;
 
-typedef std::set<unsigned int> ChunkSet;
-
 //--------------- Function Declarations ------------------------------
 
 int openFiles(void);
@@ -81,7 +81,7 @@ void initPrQueue(MergePrQueue& entryPrQueue);
 int getNextEntry(MergePrQueue& entryPrQueue,
                  Entry& entry);
 void printCounts(aSourceHmm firstSrc,
-                 const std::vector<WordIndex>& trgWordVec,
+                 const std::vector<PositionIndex>& trgPosVec,
                  float lcSrc,
                  const std::vector<float>& lcSrcTrgVec);
 void clear();
@@ -98,7 +98,7 @@ void printDesc(void);
 
 std::vector<std::string> fileNameVec;
 std::vector<std::ifstream*> ifstreamPtrVec;
-std::vector<bool> eofFlagVec;
+std::vector<std::vector<char> > inputBufferVec;
 
 //--------------- Function Definitions -------------------------------
 
@@ -119,64 +119,57 @@ int main(int argc,char *argv[])
     initPrQueue(entryPrQueue);
     
         // while loop
-    bool end=false;
     bool first_entry=true;
     aSourceHmm firstSrc;
     float lcSrc=SMALL_LG_NUM;
     std::vector<PositionIndex> trgPosVec;
     std::vector<float> lcSrcTrgVec;
-    ChunkSet chunkSet;
+        // Number of the last source for which the denominator of each
+        // chunk was added
+    std::vector<unsigned int> chunkSrcNumVec(fileNameVec.size(),0);
+    unsigned int srcNum=0;
     
-    while(!end)
+    Entry entry;
+    while(getNextEntry(entryPrQueue,entry)==RECORD_READ)
     {
-      Entry entry;
-      ret=getNextEntry(entryPrQueue,entry);
-      if(ret==RECORD_READ)
-      {
 //        printf("** %d %d %d %g %g %g\n",entry.asHmm.prev_i,entry.asHmm.slen,entry.i,entry.numer,entry.denom,exp(entry.numer-entry.denom));
 
-            // Verify if it is the first entry of the table
-        if(first_entry==true)
-        {
-          firstSrc=entry.asHmm;
-          first_entry=false;
-          trgPosVec.push_back(entry.i);
-          lcSrcTrgVec.push_back(entry.numer);
-        }
-        else
-        {
-              // A new source pair has appeared?
-          if(!(firstSrc==entry.asHmm))
-          {
-                // Print counts
-            printCounts(firstSrc,trgPosVec,lcSrc,lcSrcTrgVec);
-
-                // Reset variables
-            firstSrc=entry.asHmm;
-            chunkSet.clear();
-            trgPosVec.clear();
-            lcSrcTrgVec.clear();
-            trgPosVec.push_back(entry.i);
-            lcSrcTrgVec.push_back(entry.numer);
-            lcSrc=SMALL_LG_NUM;
-          }
-          else
-          {
-            trgPosVec.push_back(entry.i);
-            lcSrcTrgVec.push_back(entry.numer);
-          }
-        }
-        ChunkSet::const_iterator csConstIter=chunkSet.find(entry.id);
-        if(csConstIter==chunkSet.end()) 
-        {
-          chunkSet.insert(entry.id);
-          lcSrc=MathFuncs::lns_sumlog(lcSrc,entry.denom);
-        }
+          // A new source has appeared?
+      if(first_entry || !(firstSrc==entry.asHmm))
+      {
+            // Print counts
+        if(!first_entry)
+          printCounts(firstSrc,trgPosVec,lcSrc,lcSrcTrgVec);
+
+            // Reset variables
+        first_entry=false;
+        firstSrc=entry.asHmm;
+        trgPosVec.clear();
+        lcSrcTrgVec.clear();
+        lcSrc=SMALL_LG_NUM;
+        ++srcNum;
+      }
+
+          // Accumulate count of target position (entries of the same
+          // pair coming from different chunks are consecutive)
+      if(!trgPosVec.empty() && trgPosVec.back()==entry.i)
+        lcSrcTrgVec.back()=MathFuncs::lns_sumlog(lcSrcTrgVec.back(),entry.numer);
+      else
+      {
+        trgPosVec.push_back(entry.i);
+        lcSrcTrgVec.push_back(entry.numer);
+      }
+
+          // Accumulate denominator once per chunk
+      if(chunkSrcNumVec[entry.id]!=srcNum)
+      {
+        chunkSrcNumVec[entry.id]=srcNum;
+        lcSrc=MathFuncs::lns_sumlog(lcSrc,entry.denom);
       }
-      else end=true;
     }
         // Print last group of counts
-    printCounts(firstSrc,trgPosVec,lcSrc,lcSrcTrgVec);
+    if(!first_entry)
+      printCounts(firstSrc,trgPosVec,lcSrc,lcSrcTrgVec);
 
         // Close files and release pointers
     clear();
@@ -191,18 +184,18 @@ int openFiles(void)
 {
   for(unsigned int i=0;i<fileNameVec.size();++i)
   {
-        // Create file stream
+        // Create file stream (records are small, so a large buffer is
+        // used to reduce the number of reads)
     std::ifstream* ifstreamPtr=new std::ifstream;
     ifstreamPtrVec.push_back(ifstreamPtr);
+    inputBufferVec.push_back(std::vector<char>(INPUT_BUFFER_SIZE));
+    ifstreamPtrVec[i]->rdbuf()->pubsetbuf(&inputBufferVec[i][0],INPUT_BUFFER_SIZE);
     ifstreamPtrVec[i]->open(fileNameVec[i].c_str(), std::ios::in | std::ios::binary);
     if(! *ifstreamPtrVec[i])
     {
       std::cerr<<"Error in file with incremental lexical table, file "<<fileNameVec[i]<<" does not exist.\n";
       return THOT_ERROR;    
     }
-    
-        // Create flag for file
-    eofFlagVec.push_back(false);
   }
   
   return THOT_OK;
@@ -220,10 +213,6 @@ void initPrQueue(MergePrQueue& entryPrQueue)
       entry.id=i;
       entryPrQueue.push(entry);
     }
-    else
-    {
-      eofFlagVec[i]=true;
-    }
   }
 }
 
@@ -245,11 +234,6 @@ int getNextEntry(MergePrQueue& entryPrQueue,
       nextEntry.id=entry.id;
       entryPrQueue.push(nextEntry);
     }
-    else
-    {
-      eofFlagVec[entry.id]=true;
-    }
-            // Print entry
     return RECORD_READ;
   }
   else
@@ -258,41 +242,19 @@ int getNextEntry(MergePrQueue& entryPrQueue,
 
 //--------------- printCounts() function
 void printCounts(aSourceHmm firstSrc,
-                 const std::vector<WordIndex>& trgPosVec,
+                 const std::vector<PositionIndex>& trgPosVec,
                  float lcSrc,
                  const std::vector<float>& lcSrcTrgVec)
 {
-  PositionIndex firstTrg=trgPosVec[0];
-  float glcSrcTrg=lcSrcTrgVec[0];
-  for(unsigned int n=1;n<trgPosVec.size();++n)
+  for(unsigned int n=0;n<trgPosVec.size();++n)
   {
-    if(firstTrg==trgPosVec[n])
-    {
-          // Accumulate count of target phrase for additional chunk
-      glcSrcTrg=MathFuncs::lns_sumlog(glcSrcTrg,lcSrcTrgVec[n]);
-    }
-    else
-    {
-          // Print count for current target phrase
-//      printf("%d %d %d %g %g\n",firstSrc.prev_i,firstSrc.slen,firstTrg,glcSrcTrg,lcSrc);
-      std::cout.write((char*)&firstSrc.prev_i,sizeof(PositionIndex));
-      std::cout.write((char*)&firstSrc.slen,sizeof(PositionIndex));
-      std::cout.write((char*)&firstTrg,sizeof(PositionIndex));
-      std::cout.write((char*)&glcSrcTrg,sizeof(float));
-      std::cout.write((char*)&lcSrc,sizeof(float));            
- 
-          // Initialize variables for next target phrase
-      firstTrg=trgPosVec[n];
-      glcSrcTrg=lcSrcTrgVec[n];
-    }
+//    printf("%d %d %d %g %g\n",firstSrc.prev_i,firstSrc.slen,trgPosVec[n],lcSrcTrgVec[n],lcSrc);
+    std::cout.write((char*)&firstSrc.prev_i,sizeof(PositionIndex));
+    std::cout.write((char*)&firstSrc.slen,sizeof(PositionIndex));
+    std::cout.write((char*)&trgPosVec[n],sizeof(PositionIndex));
+    std::cout.write((char*)&lcSrcTrgVec[n],sizeof(float));
+    std::cout.write((char*)&lcSrc,sizeof(float));
   }
-      // Print last target phrase
-//  printf("%d %d %d %g %g\n",firstSrc.prev_i,firstSrc.slen,firstTrg,glcSrcTrg,lcSrc);
-  std::cout.write((char*)&firstSrc.prev_i,sizeof(PositionIndex));
-  std::cout.write((char*)&firstSrc.slen,sizeof(PositionIndex));
-  std::cout.write((char*)&firstTrg,sizeof(PositionIndex));
-  std::cout.write((char*)&glcSrcTrg,sizeof(float));
-  std::cout.write((char*)&lcSrc,sizeof(float));            
 }
 
 //--------------- clear() function
@@ -303,6 +265,7 @@ void clear(void)
     ifstreamPtrVec[i]->close();
     delete ifstreamPtrVec[i];
   }
+  ifstreamPtrVec.clear();
 }
 
 //--------------- readTableRecord() function
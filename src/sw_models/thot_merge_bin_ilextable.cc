@@ -20,19 +20,24 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  * @file thot_merge_bin_ilextable.cc
  * 
  * @brief Merges counts given in a set of sorted incremental lexical
- * tables.
+ * tables. The tables are merged in one pass by means of a k-way merge,
+ * keeping only the entries of the current source word in memory. The
+ * merged table can optionally be pruned in the same pass.
  */
 
 //--------------- Include files --------------------------------------
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <vector>
 #include <queue>
-#include <set>
+#include <stdlib.h>
 #include "options.h"
 #include "SwDefs.h"
+#include "LexCsrTableReader.h"
+#include "LexCsrTableWriter.h"
 #include <MathFuncs.h>
 
 //--------------- Constants ------------------------------------------
@@ -68,20 +73,18 @@ struct SortBySrcAndTrg
 
 typedef std::priority_queue<Entry,std::vector<Entry>,SortBySrcAndTrg> MergePrQueue;
 
-typedef std::set<unsigned int> ChunkSet;
-
 //--------------- Function Declarations ------------------------------
 
 int openFiles(void);
 void initPrQueue(MergePrQueue& entryPrQueue);
 int getNextEntry(MergePrQueue& entryPrQueue,
                  Entry& entry);
-void printCounts(WordIndex firstSrc,
-                 const std::vector<WordIndex>& trgWordVec,
-                 float lcSrc,
-                 const std::vector<float>& lcSrcTrgVec);
+int printCounts(WordIndex firstSrc,
+                const std::vector<WordIndex>& trgWordVec,
+                float lcSrc,
+                const std::vector<float>& lcSrcTrgVec);
 void clear();
-int readTableRecord(std::ifstream& inF,
+int readTableRecord(LexCsrTableReader& reader,
                     WordIndex& s,
                     WordIndex& t,
                     float& numer,
@@ -93,8 +96,11 @@ void printDesc(void);
 //--------------- Global variables -----------------------------------
 
 std::vector<std::string> fileNameVec;
-std::vector<std::ifstream*> ifstreamPtrVec;
-std::vector<bool> eofFlagVec;
+std::vector<LexCsrTableReader*> readerPtrVec;
+LexCsrTableWriter writer;
+bool prune;
+unsigned int n_val;
+float c_val;
 
 //--------------- Function Definitions -------------------------------
 
@@ -106,7 +112,17 @@ int main(int argc,char *argv[])
         // Open files
     int ret=openFiles();
     if(ret==THOT_ERROR)
+    {
+      clear();
+      return THOT_ERROR;
+    }
+
+        // Open output table
+    if(writer.open(std::cout)==THOT_ERROR)
+    {
+      clear();
       return THOT_ERROR;
+    }
     
         // Process entries contained in the set of files...
 
@@ -115,69 +131,68 @@ int main(int argc,char *argv[])
     initPrQueue(entryPrQueue);
     
         // while loop
-    bool end=false;
     bool first_entry=true;
     WordIndex firstSrc=0;
     float lcSrc=SMALL_LG_NUM;
     std::vector<WordIndex> trgWordVec;
     std::vector<float> lcSrcTrgVec;
-    ChunkSet chunkSet;
+        // Number of the last source word for which the denominator of
+        // each chunk was added
+    std::vector<unsigned int> chunkSrcNumVec(fileNameVec.size(),0);
+    unsigned int srcNum=0;
     
-    while(!end)
+    Entry entry;
+    while(getNextEntry(entryPrQueue,entry)==RECORD_READ)
     {
-      Entry entry;
-      ret=getNextEntry(entryPrQueue,entry);
-      if(ret==RECORD_READ)
-      {
-//        printf("** %d %d %g %g %g\n",entry.s,entry.t,entry.numer,entry.denom,exp(entry.numer-entry.denom));
+//      printf("** %d %d %g %g %g\n",entry.s,entry.t,entry.numer,entry.denom,exp(entry.numer-entry.denom));
 
-            // Verify if it is the first entry of the table
-        if(first_entry==1)
-        {
-          firstSrc=entry.s;
-          first_entry=false;
-          trgWordVec.push_back(entry.t);
-          lcSrcTrgVec.push_back(entry.numer);
-        }
-        else
-        {
-              // A new source word has appeared?
-          if(firstSrc!=entry.s)
-          {
-                // Print counts
-            printCounts(firstSrc,trgWordVec,lcSrc,lcSrcTrgVec);
-
-                // Reset variables
-            firstSrc=entry.s;
-            chunkSet.clear();
-            trgWordVec.clear();
-            lcSrcTrgVec.clear();
-            trgWordVec.push_back(entry.t);
-            lcSrcTrgVec.push_back(entry.numer);
-            lcSrc=SMALL_LG_NUM;
-          }
-          else
-          {
-            trgWordVec.push_back(entry.t);
-            lcSrcTrgVec.push_back(entry.numer);
-          }
-        }
-        ChunkSet::const_iterator csConstIter=chunkSet.find(entry.id);
-        if(csConstIter==chunkSet.end()) 
+          // A new source word has appeared?
+      if(first_entry || firstSrc!=entry.s)
+      {
+            // Print counts
+        if(!first_entry && printCounts(firstSrc,trgWordVec,lcSrc,lcSrcTrgVec)==THOT_ERROR)
         {
-          chunkSet.insert(entry.id);
-          lcSrc=MathFuncs::lns_sumlog(lcSrc,entry.denom);
+          clear();
+          return THOT_ERROR;
         }
+
+            // Reset variables
+        first_entry=false;
+        firstSrc=entry.s;
+        trgWordVec.clear();
+        lcSrcTrgVec.clear();
+        lcSrc=SMALL_LG_NUM;
+        ++srcNum;
+      }
+
+          // Accumulate count of target word (entries of the same pair
+          // coming from different chunks are consecutive)
+      if(!trgWordVec.empty() && trgWordVec.back()==entry.t)
+        lcSrcTrgVec.back()=MathFuncs::lns_sumlog(lcSrcTrgVec.back(),entry.numer);
+      else
+      {
+        trgWordVec.push_back(entry.t);
+        lcSrcTrgVec.push_back(entry.numer);
+      }
+
+          // Accumulate denominator once per chunk
+      if(chunkSrcNumVec[entry.id]!=srcNum)
+      {
+        chunkSrcNumVec[entry.id]=srcNum;
+        lcSrc=MathFuncs::lns_sumlog(lcSrc,entry.denom);
       }
-      else end=true;
     }
         // Print last group of counts
-    printCounts(firstSrc,trgWordVec,lcSrc,lcSrcTrgVec);
+    if(!first_entry && printCounts(firstSrc,trgWordVec,lcSrc,lcSrcTrgVec)==THOT_ERROR)
+    {
+      clear();
+      return THOT_ERROR;
+    }
 
         // Close files and release pointers
     clear();
 
-    return THOT_OK;
+    return writer.close();
   }
   else return THOT_ERROR;
 }
@@ -187,18 +202,14 @@ int openFiles(void)
 {
   for(unsigned int i=0;i<fileNameVec.size();++i)
   {
-        // Create file stream
-    std::ifstream* ifstreamPtr=new std::ifstream;
-    ifstreamPtrVec.push_back(ifstreamPtr);
-    ifstreamPtrVec[i]->open(fileNameVec[i].c_str(), std::ios::in | std::ios::binary);
-    if(! *ifstreamPtrVec[i])
+        // Create table reader
+    LexCsrTableReader* readerPtr=new LexCsrTableReader;
+    readerPtrVec.push_back(readerPtr);
+    if(readerPtrVec[i]->open(fileNameVec[i].c_str())==THOT_ERROR)
     {
-      std::cerr<<"Error in file with incremental lexical table, file "<<fileNameVec[i]<<" does not exist.\n";
+      std::cerr<<"Error in file with incremental lexical table, file "<<fileNameVec[i]<<" could not be opened.\n";
       return THOT_ERROR;    
     }
-    
-        // Create flag for file
-    eofFlagVec.push_back(false);
   }
   
   return THOT_OK;
@@ -207,19 +218,15 @@ int openFiles(void)
 //--------------- initPrQueue() function
 void initPrQueue(MergePrQueue& entryPrQueue)
 {
-  for(unsigned int i=0;i<ifstreamPtrVec.size();++i)
+  for(unsigned int i=0;i<readerPtrVec.size();++i)
   {
     Entry entry;
-    int ret=readTableRecord(*ifstreamPtrVec[i],entry.s,entry.t,entry.numer,entry.denom);
+    int ret=readTableRecord(*readerPtrVec[i],entry.s,entry.t,entry.numer,entry.denom);
     if(ret==RECORD_READ)
     {
       entry.id=i;
       entryPrQueue.push(entry);
     }
-    else
-    {
-      eofFlagVec[i]=true;
-    }
   }
 }
 
@@ -235,17 +242,12 @@ int getNextEntry(MergePrQueue& entryPrQueue,
     entryPrQueue.pop();
         // Push next entry of corresponding file if there exists
     Entry nextEntry;
-    int ret=readTableRecord(*ifstreamPtrVec[entry.id],nextEntry.s,nextEntry.t,nextEntry.numer,nextEntry.denom);
+    int ret=readTableRecord(*readerPtrVec[entry.id],nextEntry.s,nextEntry.t,nextEntry.numer,nextEntry.denom);
     if(ret==RECORD_READ)
     {
       nextEntry.id=entry.id;
       entryPrQueue.push(nextEntry);
     }
-    else
-    {
-      eofFlagVec[entry.id]=true;
-    }
-            // Print entry
     return RECORD_READ;
   }
   else
@@ -253,66 +255,46 @@ int getNextEntry(MergePrQueue& entryPrQueue,
 }
 
 //--------------- printCounts() function
-void printCounts(WordIndex firstSrc,
-                 const std::vector<WordIndex>& trgWordVec,
-                 float lcSrc,
-                 const std::vector<float>& lcSrcTrgVec)
+int printCounts(WordIndex firstSrc,
+                const std::vector<WordIndex>& trgWordVec,
+                float lcSrc,
+                const std::vector<float>& lcSrcTrgVec)
 {
-  WordIndex firstTrg=trgWordVec[0];
-  float glcSrcTrg=lcSrcTrgVec[0];
-  for(unsigned int n=1;n<trgWordVec.size();++n)
+  if(prune)
+    return writer.addPrunedEntries(firstSrc,trgWordVec,lcSrcTrgVec,n_val,c_val);
+  else
   {
-    if(firstTrg==trgWordVec[n])
+    for(unsigned int n=0;n<trgWordVec.size();++n)
     {
-          // Accumulate count of target phrase for additional chunk
-      glcSrcTrg=MathFuncs::lns_sumlog(glcSrcTrg,lcSrcTrgVec[n]);
-    }
-    else
-    {
-          // Print count for current target phrase
-//      printf("%d %d %g %g\n",firstSrc,firstTrg,glcSrcTrg,lcSrc);
-      std::cout.write((char*)&firstSrc,sizeof(WordIndex));
-      std::cout.write((char*)&firstTrg,sizeof(WordIndex));
-      std::cout.write((char*)&glcSrcTrg,sizeof(float));
-      std::cout.write((char*)&lcSrc,sizeof(float));
- 
-          // Initialize variables for next target phrase
-      firstTrg=trgWordVec[n];
-      glcSrcTrg=lcSrcTrgVec[n];
+//      printf("%d %d %g %g\n",firstSrc,trgWordVec[n],lcSrcTrgVec[n],lcSrc);
+      if(writer.addEntry(firstSrc,trgWordVec[n],lcSrcTrgVec[n])==THOT_ERROR)
+        return THOT_ERROR;
     }
+    writer.setDenom(firstSrc,lcSrc);
+    return THOT_OK;
   }
-      // Print last target phrase
-//  printf("%d %d %g %g\n",firstSrc,firstTrg,glcSrcTrg,lcSrc);
-  std::cout.write((char*)&firstSrc,sizeof(WordIndex));
-  std::cout.write((char*)&firstTrg,sizeof(WordIndex));
-  std::cout.write((char*)&glcSrcTrg,sizeof(float));
-  std::cout.write((char*)&lcSrc,sizeof(float));
 }
 
 //--------------- clear() function
 void clear(void)
 {
-  for(unsigned int i=0;i<ifstreamPtrVec.size();++i)
+  for(unsigned int i=0;i<readerPtrVec.size();++i)
   {
-    ifstreamPtrVec[i]->close();
-    delete ifstreamPtrVec[i];
+    readerPtrVec[i]->close();
+    delete readerPtrVec[i];
   }
+  readerPtrVec.clear();
 }
 
 //--------------- readTableRecord() function
-int readTableRecord(std::ifstream& inF,
+int readTableRecord(LexCsrTableReader& reader,
                     WordIndex& s,
                     WordIndex& t,
                     float& numer,
                     float& denom)
 {
-  if(inF.read((char*)&s,sizeof(WordIndex)))
-  {
-    inF.read((char*)&t,sizeof(WordIndex));
-    inF.read((char*)&numer,sizeof(float));
-    inF.read((char*)&denom,sizeof(float));
+  if(reader.getNextRecord(s,t,numer,denom))
     return RECORD_READ;
-  }
   else return NO_RECORDS_LEFT;
 }
 
@@ -335,11 +317,34 @@ int TakeParameters(int argc,char *argv[])
    return THOT_ERROR;
  }
 
-     /* Takes the table file names */
+     /* Takes the pruning parameters and the table file names */
+ prune=false;
+ n_val=0;
+ c_val=0;
  for(int i=1;i<argc;++i)
  {
-   std::string fileName=argv[i];
-   fileNameVec.push_back(fileName);
+   std::string arg=argv[i];
+   if(arg=="-n" || arg=="-c")
+   {
+     if(i+1==argc)
+     {
+       std::cerr<<"Error: no value given for "<<arg<<" option"<<std::endl;
+       return THOT_ERROR;
+     }
+     if(arg=="-n")
+       n_val=atoi(argv[i+1]);
+     else
+       c_val=atof(argv[i+1]);
+     prune=true;
+     ++i;
+   }
+   else
+     fileNameVec.push_back(arg);
+ }
+ if(fileNameVec.empty())
+ {
+   printUsage();
+   return THOT_ERROR;
  }
 
  return THOT_OK;  
@@ -350,14 +355,23 @@ void printDesc(void)
 {
   printf("thot_merge_bin_ilextable written by Daniel Ortiz\n");
   printf("A tool to merge the counts of a set of sorted incremental lexical tables\n");
+  printf("NOTE: the merged table is printed in CSR format\n");
   printf("type \"thot_merge_bin_ilextable --help\" to get usage information.\n");
 }
 
 //--------------- printUsage() function
 void printUsage(void)
 {
-  printf("Usage: thot_merge_bin_ilextable <sorted_ilextable_1> [<sorted_ilextable_2> ...]\n");
+  printf("Usage: thot_merge_bin_ilextable [-n <int>] [-c <float>]\n");
+  printf("                                <sorted_ilextable_1> [<sorted_ilextable_2> ...]\n");
   printf("                                [--help]\n\n");
+  printf("-n <int>                   Prune the merged table keeping the given maximum\n");
+  printf("                           number of translations per word.\n");
+  printf("-c <float>                 Prune the merged table using the given cut-off\n");
+  printf("                           probability.\n");
+  printf("                           NOTE: if -n or -c are given, the merged table is\n");
+  printf("                           pruned and renormalized as by\n");
+  printf("                           thot_prune_bin_ilextable.\n");
   printf("--help                     Display this help and exit.\n\n");
 }
 
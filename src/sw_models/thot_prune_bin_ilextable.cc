@@ -32,42 +32,21 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <iomanip>
 #include <fstream>
 #include "SwDefs.h"
+#include "LexCsrTableReader.h"
+#include "LexCsrTableWriter.h"
 
 //--------------- Function Declarations ------------------------------
 
-void printCounts(WordIndex firstSrc,
-                 std::vector<WordIndex> trgWordVec,
-                 float lcSrc,
-                 std::vector<float> lcSrcTrgVec);
 int TakeParameters(int argc,char *argv[]);
 void printUsage(void);
 void printDesc(void);
 
-//--------------- Type definitions -----------------------------------
-
-struct TrgWordLogCount
-{
-  WordIndex trgWidx;
-  float lcSrcTrg;
-};
-
-struct SortByLogCount
-{
-  bool operator() (const TrgWordLogCount& a,
-                   const TrgWordLogCount& b)const
-    {
-      if(b.lcSrcTrg<a.lcSrcTrg) return 1;
-      if(a.lcSrcTrg<b.lcSrcTrg) return 0;
-
-      return 0;
-    }
-};
-  
 //--------------- Global variables -----------------------------------
 
 std::string ilextableFileName;
 unsigned int n_val;
 float c_val;
+LexCsrTableWriter writer;
 
 //--------------- Function Definitions -------------------------------
 
@@ -77,10 +56,10 @@ int main(int argc,char *argv[])
   if(TakeParameters(argc,argv)==THOT_OK)
   {
         // Try to open file  
-    std::ifstream inF (ilextableFileName.c_str(), std::ios::in | std::ios::binary);
-    if (!inF)
+    LexCsrTableReader reader;
+    if(reader.open(ilextableFileName.c_str())==THOT_ERROR)
     {
-      std::cerr<<"Error in file with incremental lexical table, file "<<ilextableFileName<<" does not exist.\n";
+      std::cerr<<"Error in file with incremental lexical table, file "<<ilextableFileName<<" could not be opened.\n";
       return THOT_ERROR;    
     }
     else
@@ -89,9 +68,12 @@ int main(int argc,char *argv[])
       bool end=false;
       bool first_entry=true;
       WordIndex firstSrc=0;
-      float lcSrc=SMALL_LG_NUM;
       std::vector<WordIndex> trgWordVec;
       std::vector<float> lcSrcTrgVec;
+
+          // Open output table
+      if(writer.open(std::cout)==THOT_ERROR)
+        return THOT_ERROR;
       
       while(!end)
       {
@@ -100,14 +82,8 @@ int main(int argc,char *argv[])
         float numer;
         float denom;
         
-        if(inF.read((char*)&src,sizeof(WordIndex)))
-        {
-              // Read fields
-          inF.read((char*)&trg,sizeof(WordIndex));
-          inF.read((char*)&numer,sizeof(float));
-          inF.read((char*)&denom,sizeof(float));
-        }
-        else break;
+        if(!reader.getNextRecord(src,trg,numer,denom))
+          break;
 
             // verify if it is the first entry of the table
         if(first_entry==1)
@@ -116,7 +92,6 @@ int main(int argc,char *argv[])
           first_entry=false;
           trgWordVec.push_back(trg);
           lcSrcTrgVec.push_back(numer);
-          lcSrc=numer;
         }
         else
         {
@@ -124,7 +99,8 @@ int main(int argc,char *argv[])
           if(firstSrc!=src)
           {
                 // print counts
-            printCounts(firstSrc,trgWordVec,lcSrc,lcSrcTrgVec);
+            if(writer.addPrunedEntries(firstSrc,trgWordVec,lcSrcTrgVec,n_val,c_val)==THOT_ERROR)
+              return THOT_ERROR;
 
                 // reset variables
             firstSrc=src;
@@ -132,68 +108,24 @@ int main(int argc,char *argv[])
             lcSrcTrgVec.clear();
             trgWordVec.push_back(trg);
             lcSrcTrgVec.push_back(numer);
-            lcSrc=numer;
           }
           else
           {
             trgWordVec.push_back(trg);
             lcSrcTrgVec.push_back(numer);
-            lcSrc=MathFuncs::lns_sumlog(lcSrc,lcSrcTrgVec.back());
           }
         }
       }
           // print last group of counts
-      printCounts(firstSrc,trgWordVec,lcSrc,lcSrcTrgVec);
+      if(!first_entry && writer.addPrunedEntries(firstSrc,trgWordVec,lcSrcTrgVec,n_val,c_val)==THOT_ERROR)
+        return THOT_ERROR;
 
-      return THOT_OK;
+      return writer.close();
     }  
   }
   else return THOT_ERROR;
 }
 
-//--------------- printCounts() function
-void printCounts(WordIndex firstSrc,
-                 std::vector<WordIndex> trgWordVec,
-                 float lcSrc,
-                 std::vector<float> lcSrcTrgVec)
-{
-      // Sort counts for source word
-  std::vector<TrgWordLogCount> trgWordLogCountVec;
-
-  for(unsigned int n=0;n<trgWordVec.size();++n)
-  {
-    TrgWordLogCount trgWordLogCount;
-    trgWordLogCount.trgWidx=trgWordVec[n];
-    trgWordLogCount.lcSrcTrg=lcSrcTrgVec[n];
-    trgWordLogCountVec.push_back(trgWordLogCount);
-  }
-  std::sort(trgWordLogCountVec.begin(),trgWordLogCountVec.end(),SortByLogCount());
-      
-      // Determine number of counts to print
-  float newLcSrc=SMALL_LG_NUM;
-  unsigned int numFiltTrgWords=0;
-  
-  for(unsigned int n=0;n<trgWordLogCountVec.size();++n)
-  {
-    float prob=exp(trgWordLogCountVec[n].lcSrcTrg-lcSrc);
-    if((numFiltTrgWords<n_val || n_val<=0) && prob>=c_val) 
-    {
-      newLcSrc=MathFuncs::lns_sumlog(newLcSrc,trgWordLogCountVec[n].lcSrcTrg);
-      ++numFiltTrgWords;
-    }
-    else break;
-  }
-      // Print counts
-  for(unsigned int n=0;n<numFiltTrgWords;++n)
-  {
-//    printf("%d %d %g %g %g\n",firstSrc,trgWordLogCountVec[n].trgWidx,trgWordLogCountVec[n].lcSrcTrg,newLcSrc,exp(trgWordLogCountVec[n].lcSrcTrg-newLcSrc));
-    std::cout.write((char*)&firstSrc,sizeof(WordIndex));
-    std::cout.write((char*)&trgWordLogCountVec[n].trgWidx,sizeof(WordIndex));
-    std::cout.write((char*)&trgWordLogCountVec[n].lcSrcTrg,sizeof(float));
-    std::cout.write((char*)&newLcSrc,sizeof(float));
-  }
-}
-
 //--------------- TakeParameters() function
 int TakeParameters(int argc,char *argv[])
 {
@@ -246,6 +178,7 @@ void printDesc(void)
   printf("thot_prune_bin_ilextable written by Daniel Ortiz\n");
   printf("A tool to prune sorted binary tables with lexical parameters\n");
   printf("NOTE: this tool renormalizes the lexical parameters\n");
+  printf("NOTE: the pruned table is printed in CSR format\n");
   printf("type \"thot_prune_bin_ilextable --help\" to get usage information.\n");
 }
 
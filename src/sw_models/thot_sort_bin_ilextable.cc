@@ -32,6 +32,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <limits>
 #include "options.h"
 #include "SwDefs.h"
+#include "LexCsrTableReader.h"
+#include "LexCsrTableWriter.h"
 //#include <stxxl.h>
 
 //--------------- Constants ------------------------------------------
@@ -97,10 +99,10 @@ int main(int argc,char *argv[])
   if(TakeParameters(argc,argv)==THOT_OK)
   {
         // Try to open file  
-    std::ifstream inF (ilextableFileName.c_str(), std::ios::in | std::ios::binary);
-    if (!inF)
+    LexCsrTableReader reader;
+    if(reader.open(ilextableFileName.c_str())==THOT_ERROR)
     {
-      std::cerr<<"Error in file with incremental lexical table, file "<<ilextableFileName<<" does not exist.\n";
+      std::cerr<<"Error in file with incremental lexical table, file "<<ilextableFileName<<" could not be opened.\n";
       return THOT_ERROR;    
     }
     else
@@ -108,41 +110,31 @@ int main(int argc,char *argv[])
           // Read registers
       std::vector<Entry> entryVec;
 //      stxxl::vector<Entry> entryVec;
-      bool end=false;
-      while(!end)
-      {
-            // Read fields of entry
-        Entry entry;
-        if(inF.read((char*)&entry.s,sizeof(WordIndex)))
-        {
-          inF.read((char*)&entry.t,sizeof(WordIndex));
-          inF.read((char*)&entry.numer,sizeof(float));
-          inF.read((char*)&entry.denom,sizeof(float));
-
-          entryVec.push_back(entry);
-        }
-        else end=true;
-      }
+      Entry entry;
+      while(reader.getNextRecord(entry.s,entry.t,entry.numer,entry.denom))
+        entryVec.push_back(entry);
 
           // Close input file
-      inF.close();
+      reader.close();
         
           // Sort registers
       std::sort(entryVec.begin(),entryVec.end(),SortBySrcAndTrg());
 //      const unsigned M = 128*1024*1024;
 //      stxxl::sort(entryVec.begin(),entryVec.end(),SortBySrcAndTrg(),M);
       
-          // Print registers
+          // Print registers in CSR format
+      LexCsrTableWriter writer;
+      if(writer.open(std::cout)==THOT_ERROR)
+        return THOT_ERROR;
       for(unsigned int i=0;i<entryVec.size();++i)
       {
 //        printf("%d %d %g %g\n",entryVec[i].s,entryVec[i].t,entryVec[i].numer,entryVec[i].denom);
-        std::cout.write((char*)&entryVec[i].s,sizeof(WordIndex));
-        std::cout.write((char*)&entryVec[i].t,sizeof(WordIndex));
-        std::cout.write((char*)&entryVec[i].numer,sizeof(float));
-        std::cout.write((char*)&entryVec[i].denom,sizeof(float));
+        if(writer.addEntry(entryVec[i].s,entryVec[i].t,entryVec[i].numer)==THOT_ERROR)
+          return THOT_ERROR;
+        writer.setDenom(entryVec[i].s,entryVec[i].denom);
       }
       
-      return THOT_OK;
+      return writer.close();
     }
   }
   else return THOT_ERROR;
@@ -183,6 +175,7 @@ void printDesc(void)
 {
   printf("thot_sort_bin_ilextable written by Daniel Ortiz\n");
   printf("A tool to sort binary tables with lexical parameters\n");
+  printf("NOTE: the sorted table is printed in CSR format\n");
   printf("type \"thot_sort_bin_ilextable --help\" to get usage information.\n");
 }
 
@@ -0,0 +1,169 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file EditDistForStrTest.cc
+ * 
+ * @brief Definitions file for EditDistForStrTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "EditDistForStrTest.h"
+#include <stdlib.h>
+#include <math.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( EditDistForStrTest );
+
+//--------------- EditDistForStrTest class functions
+//
+
+//---------------------------------------
+void EditDistForStrTest::setUp()
+{
+  editDist = new EditDistForStr();
+  srand(31415);
+}
+
+//---------------------------------------
+void EditDistForStrTest::tearDown()
+{
+  delete editDist;
+}
+
+//---------------------------------------
+std::string EditDistForStrTest::genRandomWord(unsigned int len,
+                                              unsigned int alphabetSize)
+{
+  std::string word;
+  for(unsigned int j=0;j<len;++j)
+    word.push_back('a'+rand()%alphabetSize);
+  return word;
+}
+
+//---------------------------------------
+void EditDistForStrTest::checkOpCosts(const std::string& x,
+                                      const std::string& y)
+{
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( (double) editDist->calculateEditDist(x,y),
+                                (double) editDist->calculateEditDistOpCost(x,y),
+                                0.0001 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( (double) editDist->calculateEditDistPrefix(x,y),
+                                (double) editDist->calculateEditDistPrefixOpCost(x,y),
+                                0.0001 );
+}
+
+//---------------------------------------
+void EditDistForStrTest::testRandomWordPairs()
+{
+      // Small alphabets produce many matches between the words
+  for(unsigned int n=0;n<2000;++n)
+  {
+    unsigned int alphabetSize=2+rand()%25;
+    std::string x=genRandomWord(rand()%20,alphabetSize);
+    std::string y=genRandomWord(1+rand()%20,alphabetSize);
+    checkOpCosts(x,y);
+  }
+}
+
+//---------------------------------------
+void EditDistForStrTest::testBitParallelMaxLen()
+{
+      // Words around EDIT_DIST_BIT_PARALLEL_MAX_LEN characters, the
+      // longer ones are processed without the bit-vector algorithm
+  for(unsigned int len=EDIT_DIST_BIT_PARALLEL_MAX_LEN-1;len<=EDIT_DIST_BIT_PARALLEL_MAX_LEN+1;++len)
+  {
+    for(unsigned int n=0;n<50;++n)
+    {
+      std::string y=genRandomWord(len,4);
+      std::string x=genRandomWord(len-5+rand()%11,4);
+      checkOpCosts(x,y);
+      checkOpCosts(y,y);
+    }
+  }
+
+      // The last character of y is stored in the highest bit
+  std::string y(EDIT_DIST_BIT_PARALLEL_MAX_LEN,'a');
+  y[EDIT_DIST_BIT_PARALLEL_MAX_LEN-1]='b';
+  checkOpCosts("b",y);
+  checkOpCosts(y+"ccc",y);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, (double) editDist->calculateEditDistPrefixOpCost(y+"ccc",y), 0.0001 );
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, (double) editDist->calculateEditDistOpCost(y+"ccc",y), 0.0001 );
+}
+
+//---------------------------------------
+void EditDistForStrTest::testMultibyteStrings()
+{
+      // Bytes greater than 127 must be treated as the rest of the
+      // characters
+  const char* words[]={"canción","camión","niño","nino","größe","grosse",
+                       "мариночка","марина","áéíóúûü","aeiouuu",""};
+  for(unsigned int i=0;words[i][0]!='\0';++i)
+  {
+    for(unsigned int j=0;words[j][0]!='\0';++j)
+      checkOpCosts(words[i],words[j]);
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, (double) editDist->calculateEditDistOpCost("niño","nino"), 0.0001 );
+}
+
+//---------------------------------------
+void EditDistForStrTest::testNonUnitCosts()
+{
+  editDist->setErrorModel(0,1,1.5,1);
+  for(unsigned int n=0;n<500;++n)
+  {
+    std::string x=genRandomWord(rand()%20,4);
+    std::string y=genRandomWord(1+rand()%20,4);
+    checkOpCosts(x,y);
+  }
+}
+
+//---------------------------------------
+void EditDistForStrTest::testNonZeroHitCost()
+{
+      // Costs of the error correcting model used in interactive
+      // translation with its default parameters (hit probability
+      // equal to 0.8 and 128 characters with the same insertion,
+      // substitution and deletion factors)
+  double errorProb=(1-0.8)/(128+127+1);
+  editDist->setErrorModel(-log(0.8),-log(errorProb),-log(errorProb),-log(errorProb));
+  for(unsigned int n=0;n<500;++n)
+  {
+    unsigned int alphabetSize=2+rand()%25;
+    std::string x=genRandomWord(rand()%20,alphabetSize);
+    std::string y=genRandomWord(1+rand()%20,alphabetSize);
+    checkOpCosts(x,y);
+    checkOpCosts(y,y);
+  }
+  for(unsigned int n=0;n<20;++n)
+  {
+    std::string y=genRandomWord(EDIT_DIST_BIT_PARALLEL_MAX_LEN-10+rand()%21,4);
+    std::string x=genRandomWord(y.size()-5+rand()%11,4);
+    checkOpCosts(x,y);
+  }
+
+      // Different costs for each operation
+  editDist->setErrorModel(0.5,2,3,1.5);
+  for(unsigned int n=0;n<500;++n)
+  {
+    std::string x=genRandomWord(rand()%20,4);
+    std::string y=genRandomWord(1+rand()%20,4);
+    checkOpCosts(x,y);
+  }
+}
@@ -0,0 +1,77 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file EditDistForStrTest.h
+ *
+ * @brief Declares the EditDistForStrTest class implementing unit tests
+ * for the EditDistForStr class.
+ */
+
+#ifndef _EditDistForStrTest_h
+#define _EditDistForStrTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "error_correction/EditDistForStr.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+//--------------- EditDistForStrTest class
+
+/**
+ * @brief Class implementing tests for EditDistForStr. The edit
+ * distances obtained without storing the distance matrix (by means of
+ * the bit-vector algorithm when the costs are unitary) are compared
+ * with those obtained by filling the whole matrix.
+ */
+
+class EditDistForStrTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( EditDistForStrTest );
+    CPPUNIT_TEST( testRandomWordPairs );
+    CPPUNIT_TEST( testBitParallelMaxLen );
+    CPPUNIT_TEST( testMultibyteStrings );
+    CPPUNIT_TEST( testNonUnitCosts );
+    CPPUNIT_TEST( testNonZeroHitCost );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        EditDistForStr* editDist;
+
+        std::string genRandomWord(unsigned int len,
+                                  unsigned int alphabetSize);
+        void checkOpCosts(const std::string& x,
+                          const std::string& y);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testRandomWordPairs();
+        void testBitParallelMaxLen();
+        void testMultibyteStrings();
+        void testNonUnitCosts();
+        void testNonZeroHitCost();
+};
+
+#endif
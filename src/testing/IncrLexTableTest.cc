@@ -25,6 +25,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "IncrLexTableTest.h"
+#include <stdio.h>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION( IncrLexTableTest );
@@ -42,3 +43,46 @@ void IncrLexTableTest::tearDown()
 {
   delete tab;
 }
+
+//---------------------------------------
+void IncrLexTableTest::testPrintLoadCsr()
+{
+#ifndef THOT_ENABLE_LOAD_PRINT_TEXTPARS
+    bool found;
+    std::string fileName = "IncrLexTableTest.lexnd";
+
+    tab->clear();
+
+    // Fill structure with data given in no particular order
+    tab->setLexNumDen(7, 3, 0.5, 1.5);
+    tab->setLexNumDen(2, 3, 2.2, 3.3);
+    tab->setLexNumDen(7, 1, 0.7, 1.5);
+    tab->setLexNumDen(2, 9, 4.4, 3.3);
+    tab->setLexDenom(11, 6.6);
+
+    // Print table in CSR format and load it again
+    CPPUNIT_ASSERT( tab->print(fileName.c_str()) == THOT_OK );
+    CPPUNIT_ASSERT( LexCsrTableReader::isCsrTable(fileName.c_str()) );
+    tab->clear();
+    CPPUNIT_ASSERT( tab->load(fileName.c_str()) == THOT_OK );
+    remove(fileName.c_str());
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, tab->getLexNumer(7, 3, found), EPSILON);
+    CPPUNIT_ASSERT( found );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.2, tab->getLexNumer(2, 3, found), EPSILON);
+    CPPUNIT_ASSERT( found );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.7, tab->getLexNumer(7, 1, found), EPSILON);
+    CPPUNIT_ASSERT( found );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.4, tab->getLexNumer(2, 9, found), EPSILON);
+    CPPUNIT_ASSERT( found );
+    tab->getLexNumer(7, 9, found);
+    CPPUNIT_ASSERT( !found );
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.3, tab->getLexDenom(2, found), EPSILON);
+    CPPUNIT_ASSERT( found );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(6.6, tab->getLexDenom(11, found), EPSILON);
+    CPPUNIT_ASSERT( found );
+    tab->getLexDenom(5, found);
+    CPPUNIT_ASSERT( !found );
+#endif
+}
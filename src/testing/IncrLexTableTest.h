@@ -56,12 +56,15 @@ class IncrLexTableTest: public _incrLexTableTest
     CPPUNIT_TEST( testGetSetLexNumer );
     CPPUNIT_TEST( testGetTransForTarget );
     CPPUNIT_TEST( testSetLexNumerDenom );
+    CPPUNIT_TEST( testPrintLoadCsr );
     CPPUNIT_TEST_SUITE_END();
 
     public:
         void setUp();
         void tearDown();
 
+        void testPrintLoadCsr();
+
 };
 
 #endif
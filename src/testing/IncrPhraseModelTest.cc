@@ -0,0 +1,190 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file IncrPhraseModelTest.cc
+ * 
+ * @brief Definitions file for IncrPhraseModelTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "IncrPhraseModelTest.h"
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sstream>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( IncrPhraseModelTest );
+
+//--------------- IncrPhraseModelTest class functions
+//
+
+//---------------------------------------
+void IncrPhraseModelTest::setUp()
+{
+  model = new IncrPhraseModel();
+  prefix = "IncrPhraseModelTest";
+
+  srcPhrases.clear();
+  trgPhrases.clear();
+  counts.clear();
+  srcPhrases.push_back(strToVec("la casa"));
+  trgPhrases.push_back(strToVec("the house"));
+  counts.push_back(3);
+  srcPhrases.push_back(strToVec("la casa"));
+  trgPhrases.push_back(strToVec("house"));
+  counts.push_back(1.5);
+  srcPhrases.push_back(strToVec("casa"));
+  trgPhrases.push_back(strToVec("house"));
+  counts.push_back(2);
+  srcPhrases.push_back(strToVec("verde"));
+  trgPhrases.push_back(strToVec("green"));
+  counts.push_back(0.25);
+  srcPhrases.push_back(strToVec("la casa verde"));
+  trgPhrases.push_back(strToVec("the green house"));
+  counts.push_back(1);
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::tearDown()
+{
+  removeModelFiles();
+  delete model;
+}
+
+//---------------------------------------
+std::vector<std::string> IncrPhraseModelTest::strToVec(const std::string& str)
+{
+  std::vector<std::string> strVec;
+  std::istringstream iss(str);
+  std::string word;
+  while(iss>>word)
+    strVec.push_back(word);
+  return strVec;
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::fillModel(void)
+{
+  for(unsigned int i=0;i<srcPhrases.size();++i)
+    model->strIncrCountsOfEntry(srcPhrases[i],trgPhrases[i],counts[i]);
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::checkCounts(IncrPhraseModel& loadedModel)
+{
+  for(unsigned int i=0;i<srcPhrases.size();++i)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((double)model->cHSrcHTrg(srcPhrases[i],trgPhrases[i]),
+                                 (double)loadedModel.cHSrcHTrg(srcPhrases[i],trgPhrases[i]),
+                                 0.0001);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((double)model->cHSrc(srcPhrases[i]),
+                                 (double)loadedModel.cHSrc(srcPhrases[i]),
+                                 0.0001);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((double)model->cHTrg(trgPhrases[i]),
+                                 (double)loadedModel.cHTrg(trgPhrases[i]),
+                                 0.0001);
+  }
+
+      // Phrase pairs not present in the model
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0,(double)loadedModel.cHSrcHTrg(strToVec("casa"),strToVec("green")),0.0001);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0,(double)loadedModel.cHSrcHTrg(strToVec("verde"),strToVec("the house")),0.0001);
+}
+
+//---------------------------------------
+bool IncrPhraseModelTest::fileExists(const std::string& fileName)
+{
+  struct stat fileStat;
+  return stat(fileName.c_str(),&fileStat)==0;
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::removeModelFiles(void)
+{
+  remove((prefix+".ttable").c_str());
+  remove((prefix+".ttable.bin").c_str());
+  remove((prefix+".seglentable").c_str());
+  remove((prefix+".seglentable.bin").c_str());
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::testPrintWritesBinSnapshots()
+{
+  fillModel();
+
+      // Binary snapshots are printed by default
+  CPPUNIT_ASSERT( model->print(prefix.c_str()) == THOT_OK );
+  CPPUNIT_ASSERT( fileExists(prefix+".ttable") );
+  CPPUNIT_ASSERT( fileExists(prefix+".ttable.bin") );
+  CPPUNIT_ASSERT( fileExists(prefix+".seglentable") );
+  CPPUNIT_ASSERT( fileExists(prefix+".seglentable.bin") );
+  removeModelFiles();
+
+      // Disable binary snapshots
+  model->setPrintBinSnapshots(false);
+  CPPUNIT_ASSERT( model->print(prefix.c_str()) == THOT_OK );
+  CPPUNIT_ASSERT( fileExists(prefix+".ttable") );
+  CPPUNIT_ASSERT( !fileExists(prefix+".ttable.bin") );
+  CPPUNIT_ASSERT( !fileExists(prefix+".seglentable.bin") );
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::testPrintLoadBinSnapshots()
+{
+  fillModel();
+  CPPUNIT_ASSERT( model->print(prefix.c_str()) == THOT_OK );
+
+      // Load the model in a new one whose vocabularies already
+      // contain other words, so that the stored word indices have to
+      // be remapped
+  IncrPhraseModel loadedModel;
+  loadedModel.strIncrCountsOfEntry(strToVec("el perro"),strToVec("the dog"),1);
+  CPPUNIT_ASSERT( loadedModel.load(prefix.c_str()) == THOT_OK );
+  checkCounts(loadedModel);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0,(double)loadedModel.cHSrcHTrg(strToVec("el perro"),strToVec("the dog")),0.0001);
+}
+
+//---------------------------------------
+void IncrPhraseModelTest::testBinAndTextLoadMatch()
+{
+  fillModel();
+  CPPUNIT_ASSERT( model->print(prefix.c_str()) == THOT_OK );
+
+      // Load model using the binary snapshots
+  IncrPhraseModel binModel;
+  CPPUNIT_ASSERT( binModel.load(prefix.c_str()) == THOT_OK );
+
+      // Load model using the plain text files
+  remove((prefix+".ttable.bin").c_str());
+  remove((prefix+".seglentable.bin").c_str());
+  IncrPhraseModel textModel;
+  CPPUNIT_ASSERT( textModel.load(prefix.c_str()) == THOT_OK );
+
+  checkCounts(binModel);
+  checkCounts(textModel);
+  for(unsigned int tlen=1;tlen<=5;++tlen)
+  {
+    for(unsigned int k=1;k<=tlen;++k)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL((double)textModel.pk_tlen(tlen,k),
+                                   (double)binModel.pk_tlen(tlen,k),
+                                   0.0001);
+    }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file IncrPhraseModelTest.h
+ *
+ * @brief Declares the IncrPhraseModelTest class implementing unit tests
+ * for the printing and loading functions of the IncrPhraseModel class.
+ */
+
+#ifndef _IncrPhraseModelTest_h
+#define _IncrPhraseModelTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "phrase_models/IncrPhraseModel.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+//--------------- IncrPhraseModelTest class
+
+/**
+ * @brief Class implementing tests for IncrPhraseModel. The models
+ * loaded from the binary snapshots written by print() are compared
+ * with those loaded from the plain text files.
+ */
+
+class IncrPhraseModelTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( IncrPhraseModelTest );
+    CPPUNIT_TEST( testPrintWritesBinSnapshots );
+    CPPUNIT_TEST( testPrintLoadBinSnapshots );
+    CPPUNIT_TEST( testBinAndTextLoadMatch );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        IncrPhraseModel* model;
+        std::string prefix;
+        std::vector<std::vector<std::string> > srcPhrases;
+        std::vector<std::vector<std::string> > trgPhrases;
+        std::vector<Count> counts;
+
+        std::vector<std::string> strToVec(const std::string& str);
+        void fillModel(void);
+        void checkCounts(IncrPhraseModel& loadedModel);
+        bool fileExists(const std::string& fileName);
+        void removeModelFiles(void);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testPrintWritesBinSnapshots();
+        void testPrintLoadBinSnapshots();
+        void testBinAndTextLoadMatch();
+};
+
+#endif
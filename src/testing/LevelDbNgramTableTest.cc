@@ -262,6 +262,32 @@ void LevelDbNgramTableTest::testIncrCountsOfEntryLog()
     CPPUNIT_ASSERT_DOUBLES_EQUAL(17.0, tab->cSrcTrg(s, t2).get_c_st(), EPSILON);
 }
 
+//---------------------------------------
+void LevelDbNgramTableTest::testUpdateBatch()
+{
+    std::vector<WordIndex> s = getVector("Narie lake");
+    WordIndex t = 140991;
+    LogCount c = LogCount(log(2));
+
+    tab->clear();
+    tab->beginUpdateBatch();
+    tab->incrCountsOfEntryLog(s, t, c);
+    tab->incrCountsOfEntryLog(s, t, c);
+
+    // Pending updates are visible before committing
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, tab->cSrcTrg(s, t).get_c_st(), EPSILON);
+    CPPUNIT_ASSERT_EQUAL((size_t) 0, tab->size());
+
+    CPPUNIT_ASSERT( tab->commitUpdateBatch() == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL((size_t) 1, tab->size());
+
+    // Committed values are stored in binary format
+    bool result = tab->load(getDbName().c_str());
+    CPPUNIT_ASSERT( result == THOT_OK );
+    CPPUNIT_ASSERT( tab->hasBinaryValues() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, tab->cSrcTrg(s, t).get_c_st(), EPSILON);
+}
+
 //---------------------------------------
 void LevelDbNgramTableTest::testGetEntriesForTarget()
 {
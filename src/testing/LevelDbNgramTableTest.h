@@ -62,6 +62,7 @@ class LevelDbNgramTableTest: public CppUnit::TestFixture
         CPPUNIT_TEST( testKeyVectorConversion );
         CPPUNIT_TEST( testAddTableEntry );
         CPPUNIT_TEST( testIncrCountsOfEntryLog );
+        CPPUNIT_TEST( testUpdateBatch );
         CPPUNIT_TEST( testStoreAndRestoreSrcInfo );
         CPPUNIT_TEST( testGetEntriesForTarget );
         CPPUNIT_TEST( testRetrievingSubphrase );
@@ -95,6 +96,7 @@ class LevelDbNgramTableTest: public CppUnit::TestFixture
         void testStoreFloatValues();
         void testAddTableEntry();
         void testIncrCountsOfEntryLog();
+        void testUpdateBatch();
         void testStoreAndRestoreSrcInfo();
         void testGetEntriesForTarget();
         void testRetrievingSubphrase();
@@ -0,0 +1,188 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgHandlerTest.cc
+ * 
+ * @brief Definitions file for WgHandlerTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WgHandlerTest.h"
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( WgHandlerTest );
+
+//--------------- WgHandlerTest class functions
+//
+
+//---------------------------------------
+void WgHandlerTest::setUp()
+{
+  wgHandler = new WgHandler();
+}
+
+//---------------------------------------
+void WgHandlerTest::tearDown()
+{
+  delete wgHandler;
+  remove(WGH_TEST_FILE);
+}
+
+//---------------------------------------
+std::vector<std::string> WgHandlerTest::sentence(unsigned int n)
+{
+  std::vector<std::string> strVec;
+  strVec.push_back("sentence");
+  std::ostringstream number;
+  number<<n;
+  strVec.push_back(number.str());
+  return strVec;
+}
+
+//---------------------------------------
+std::string WgHandlerTest::wgPath(unsigned int n)
+{
+  std::ostringstream path;
+  path<<"/tmp/wgs/"<<n<<".wgb";
+  return path.str();
+}
+
+//---------------------------------------
+void* WgHandlerTest::addAndRemoveEntries(void* wgHandlerPtr)
+{
+  WgHandler* wgh=(WgHandler*) wgHandlerPtr;
+  for(unsigned int n=0;n<WGH_TEST_NUM_ENTRIES;++n)
+  {
+    wgh->addEntry(sentence(n),wgPath(n));
+    if(n%2==1)
+      wgh->removeEntry(sentence(n));
+  }
+  return NULL;
+}
+
+//---------------------------------------
+void WgHandlerTest::testAddEntry()
+{
+  CPPUNIT_ASSERT( wgHandler->empty() );
+  wgHandler->addEntry(sentence(0),wgPath(0));
+  wgHandler->addEntry(sentence(1),wgPath(1));
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, wgHandler->size() );
+
+  bool found;
+  std::string path=wgHandler->pathAssociatedToSentence(sentence(1),found);
+  CPPUNIT_ASSERT( found );
+  CPPUNIT_ASSERT( path==wgPath(1) );
+  wgHandler->pathAssociatedToSentence(sentence(2),found);
+  CPPUNIT_ASSERT( !found );
+
+      // Adding an entry for the same sentence replaces its path
+  wgHandler->addEntry(sentence(1),wgPath(2));
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, wgHandler->size() );
+  path=wgHandler->pathAssociatedToSentence(sentence(1),found);
+  CPPUNIT_ASSERT( found );
+  CPPUNIT_ASSERT( path==wgPath(2) );
+}
+
+//---------------------------------------
+void WgHandlerTest::testRemoveEntry()
+{
+  for(unsigned int n=0;n<3;++n)
+    wgHandler->addEntry(sentence(n),wgPath(n));
+
+  bool found;
+  wgHandler->removeEntry(sentence(1));
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, wgHandler->size() );
+  wgHandler->pathAssociatedToSentence(sentence(1),found);
+  CPPUNIT_ASSERT( !found );
+  std::string path=wgHandler->pathAssociatedToSentence(sentence(2),found);
+  CPPUNIT_ASSERT( found );
+  CPPUNIT_ASSERT( path==wgPath(2) );
+
+      // Removing a sentence that is not stored has no effect
+  wgHandler->removeEntry(sentence(1));
+  wgHandler->removeEntry(sentence(5));
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, wgHandler->size() );
+
+  wgHandler->removeEntry(sentence(0));
+  wgHandler->removeEntry(sentence(2));
+  CPPUNIT_ASSERT( wgHandler->empty() );
+}
+
+//---------------------------------------
+void WgHandlerTest::testLoadAndAddEntry()
+{
+  std::ofstream outF(WGH_TEST_FILE);
+  outF<<"sentence 0 ||| "<<wgPath(0)<<std::endl;
+  outF<<"sentence 1 ||| "<<wgPath(1)<<std::endl;
+  outF.close();
+  CPPUNIT_ASSERT( wgHandler->load(WGH_TEST_FILE)==THOT_OK );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, wgHandler->size() );
+
+      // Entries can be added to and removed from the loaded ones
+  wgHandler->addEntry(sentence(2),wgPath(2));
+  wgHandler->removeEntry(sentence(0));
+  bool found;
+  wgHandler->pathAssociatedToSentence(sentence(0),found);
+  CPPUNIT_ASSERT( !found );
+  std::string path=wgHandler->pathAssociatedToSentence(sentence(1),found);
+  CPPUNIT_ASSERT( found );
+  CPPUNIT_ASSERT( path==wgPath(1) );
+  path=wgHandler->pathAssociatedToSentence(sentence(2),found);
+  CPPUNIT_ASSERT( found );
+  CPPUNIT_ASSERT( path==wgPath(2) );
+
+      // The printed entries can be loaded again
+  CPPUNIT_ASSERT( wgHandler->print(WGH_TEST_FILE)==THOT_OK );
+  WgHandler loadedWgHandler;
+  CPPUNIT_ASSERT( loadedWgHandler.load(WGH_TEST_FILE)==THOT_OK );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, loadedWgHandler.size() );
+  path=loadedWgHandler.pathAssociatedToSentence(sentence(2),found);
+  CPPUNIT_ASSERT( found );
+  CPPUNIT_ASSERT( path==wgPath(2) );
+}
+
+//---------------------------------------
+void WgHandlerTest::testConcurrentAccess()
+{
+      // Add and remove entries while the handler is queried
+  pthread_t tid;
+  CPPUNIT_ASSERT( pthread_create(&tid,NULL,addAndRemoveEntries,(void*) wgHandler)==0 );
+  for(unsigned int i=0;i<WGH_TEST_NUM_ENTRIES;++i)
+  {
+    bool found;
+    std::string path=wgHandler->pathAssociatedToSentence(sentence(i),found);
+    if(found)
+      CPPUNIT_ASSERT( path==wgPath(i) );
+  }
+  pthread_join(tid,NULL);
+
+      // Only the entries with even numbers remain
+  CPPUNIT_ASSERT_EQUAL( (size_t) WGH_TEST_NUM_ENTRIES/2, wgHandler->size() );
+  for(unsigned int n=0;n<WGH_TEST_NUM_ENTRIES;++n)
+  {
+    bool found;
+    wgHandler->pathAssociatedToSentence(sentence(n),found);
+    CPPUNIT_ASSERT( found==(n%2==0) );
+  }
+}
@@ -0,0 +1,79 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgHandlerTest.h
+ *
+ * @brief Declares the WgHandlerTest class implementing unit tests for
+ * the WgHandler class.
+ */
+
+#ifndef _WgHandlerTest_h
+#define _WgHandlerTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "error_correction/WgHandler.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define WGH_TEST_FILE        "WgHandlerTest.txt"
+#define WGH_TEST_NUM_ENTRIES 1000
+
+//--------------- WgHandlerTest class
+
+/**
+ * @brief Class implementing tests for WgHandler. Entries are added and
+ * removed both from a single thread and while the handler is queried
+ * from other threads.
+ */
+
+class WgHandlerTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( WgHandlerTest );
+    CPPUNIT_TEST( testAddEntry );
+    CPPUNIT_TEST( testRemoveEntry );
+    CPPUNIT_TEST( testLoadAndAddEntry );
+    CPPUNIT_TEST( testConcurrentAccess );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        WgHandler* wgHandler;
+
+        static std::vector<std::string> sentence(unsigned int n);
+        static std::string wgPath(unsigned int n);
+        static void* addAndRemoveEntries(void* wgHandlerPtr);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testAddEntry();
+        void testRemoveEntry();
+        void testLoadAndAddEntry();
+        void testConcurrentAccess();
+};
+
+#endif
@@ -0,0 +1,262 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgPrecompQueueTest.cc
+ * 
+ * @brief Definitions file for WgPrecompQueueTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WgPrecompQueueTest.h"
+#include <sstream>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( WgPrecompQueueTest );
+
+//--------------- WgPrecompQueueTest class functions
+//
+
+//---------------------------------------
+void WgPrecompQueueTest::setUp()
+{
+  queue = new WgPrecompQueue();
+  queue->setMaxStoredWgs(3);
+  numWgFilesCreated=0;
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::tearDown()
+{
+  delete queue;
+}
+
+//---------------------------------------
+std::string WgPrecompQueueTest::sentence(unsigned int n)
+{
+  std::ostringstream sent;
+  sent<<"sentence number "<<n;
+  return sent.str();
+}
+
+//---------------------------------------
+bool WgPrecompQueueTest::translateNextSent(std::string& sent,
+                                           std::vector<WgPrecompSentFile>& removedWgs)
+{
+  removedWgs.clear();
+  if(!queue->nextPendingSent(sent))
+    return false;
+
+  std::ostringstream wgFile;
+  wgFile<<numWgFilesCreated<<".wgb";
+  ++numWgFilesCreated;
+  queue->store(sent,wgFile.str(),removedWgs);
+  return true;
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::testRequest()
+{
+  CPPUNIT_ASSERT( queue->request(sentence(0)) );
+  CPPUNIT_ASSERT( queue->request(sentence(1)) );
+  CPPUNIT_ASSERT( !queue->request(sentence(0)) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, queue->numPendingSents() );
+
+      // Sentences are translated in the order in which they were
+      // requested, stored sentences are not requested again
+  std::string sent;
+  std::vector<WgPrecompSentFile> removedWgs;
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(0) );
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(1) );
+  CPPUNIT_ASSERT( !translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( !queue->request(sentence(1)) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, queue->numStoredWgs() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 0, queue->numPendingSents() );
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::testQueueIsBounded()
+{
+  for(unsigned int n=0;n<5;++n)
+    queue->request(sentence(n));
+
+      // No sentence is obtained while the maximum number of word graphs
+      // that have not been served are stored
+  std::string sent;
+  std::vector<WgPrecompSentFile> removedWgs;
+  for(unsigned int n=0;n<3;++n)
+  {
+    CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+    CPPUNIT_ASSERT( removedWgs.empty() );
+  }
+  CPPUNIT_ASSERT( !queue->pendingSentAvailable() );
+  CPPUNIT_ASSERT( !translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 3, queue->numStoredWgs() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, queue->numPendingSents() );
+
+      // Sentences being translated are also taken into account
+  queue->markServed(sentence(0));
+  CPPUNIT_ASSERT( queue->nextPendingSent(sent) );
+  CPPUNIT_ASSERT( sent==sentence(3) );
+  CPPUNIT_ASSERT( !queue->pendingSentAvailable() );
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::testOnlyServedWgsAreRemoved()
+{
+  for(unsigned int n=0;n<5;++n)
+    queue->request(sentence(n));
+  std::string sent;
+  std::vector<WgPrecompSentFile> removedWgs;
+  for(unsigned int n=0;n<3;++n)
+    translateNextSent(sent,removedWgs);
+
+      // The word graph of the served sentence is removed, even if it is
+      // not the oldest one
+  queue->markServed(sentence(1));
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(3) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 1, removedWgs.size() );
+  CPPUNIT_ASSERT( removedWgs[0].first==sentence(1) );
+  CPPUNIT_ASSERT( removedWgs[0].second=="1.wgb" );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 3, queue->numStoredWgs() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 3, queue->numUnservedWgs() );
+  CPPUNIT_ASSERT( !translateNextSent(sent,removedWgs) );
+
+      // Served sentences whose word graph is still stored are not
+      // removed until room is needed
+  queue->markServed(sentence(0));
+  queue->markServed(sentence(2));
+  CPPUNIT_ASSERT_EQUAL( (size_t) 3, queue->numStoredWgs() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 1, queue->numUnservedWgs() );
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(4) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 1, removedWgs.size() );
+  CPPUNIT_ASSERT( removedWgs[0].first==sentence(0) );
+
+      // The removed sentences can be requested again
+  CPPUNIT_ASSERT( queue->request(sentence(1)) );
+  CPPUNIT_ASSERT( queue->request(sentence(0)) );
+  CPPUNIT_ASSERT( !queue->request(sentence(2)) );
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::testServedPendingSent()
+{
+  for(unsigned int n=0;n<3;++n)
+    queue->request(sentence(n));
+
+      // Served sentences are not translated
+  queue->markServed(sentence(0));
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, queue->numPendingSents() );
+  std::string sent;
+  std::vector<WgPrecompSentFile> removedWgs;
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(1) );
+  CPPUNIT_ASSERT( queue->request(sentence(0)) );
+
+      // A sentence served while being translated can be removed as soon
+      // as its word graph is stored
+  CPPUNIT_ASSERT( queue->nextPendingSent(sent) );
+  CPPUNIT_ASSERT( sent==sentence(2) );
+  queue->markServed(sentence(2));
+  queue->store(sent,"2.wgb",removedWgs);
+  CPPUNIT_ASSERT_EQUAL( (size_t) 2, queue->numStoredWgs() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 1, queue->numUnservedWgs() );
+
+      // Sentences that were not requested are ignored
+  queue->markServed(sentence(10));
+  CPPUNIT_ASSERT( queue->request(sentence(10)) );
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::testRequeueUnserved()
+{
+  queue->setMaxStoredWgs(10);
+  for(unsigned int n=0;n<6;++n)
+    queue->request(sentence(n));
+  std::string sent;
+  std::vector<WgPrecompSentFile> removedWgs;
+  for(unsigned int n=0;n<4;++n)
+    translateNextSent(sent,removedWgs);
+  queue->markServed(sentence(0));
+
+      // Only the next sentences to be served are queued again, ahead of
+      // the sentences that have not been translated
+  CPPUNIT_ASSERT_EQUAL( 2u, queue->requeueUnserved(2) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 4, queue->numPendingSents() );
+  CPPUNIT_ASSERT_EQUAL( 0u, queue->requeueUnserved(1) );
+
+      // The new word graphs replace the stored ones
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(1) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 1, removedWgs.size() );
+  CPPUNIT_ASSERT( removedWgs[0].first==sentence(1) );
+  CPPUNIT_ASSERT( removedWgs[0].second=="1.wgb" );
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(2) );
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(4) );
+  CPPUNIT_ASSERT( removedWgs.empty() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 5, queue->numStoredWgs() );
+
+      // Stored word graphs can be replaced even if the maximum number
+      // has been reached
+  queue->setMaxStoredWgs(4);
+  CPPUNIT_ASSERT_EQUAL( 2u, queue->requeueUnserved(2) );
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(1) );
+  CPPUNIT_ASSERT( translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT( sent==sentence(2) );
+  CPPUNIT_ASSERT( !translateNextSent(sent,removedWgs) );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 5, queue->numStoredWgs() );
+
+      // Clear the queue
+  queue->clear(removedWgs);
+  CPPUNIT_ASSERT_EQUAL( (size_t) 5, removedWgs.size() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 0, queue->numStoredWgs() );
+  CPPUNIT_ASSERT_EQUAL( (size_t) 0, queue->numPendingSents() );
+  CPPUNIT_ASSERT( queue->request(sentence(1)) );
+}
+
+//---------------------------------------
+void WgPrecompQueueTest::testCancel()
+{
+  queue->request(sentence(0));
+  queue->request(sentence(1));
+  std::string sent;
+  std::vector<WgPrecompSentFile> removedWgs;
+  translateNextSent(sent,removedWgs);
+
+      // A sentence whose translation failed can be requested again
+  CPPUNIT_ASSERT( queue->nextPendingSent(sent) );
+  queue->cancel(sent);
+  CPPUNIT_ASSERT( queue->request(sentence(1)) );
+
+      // The word graph previously stored is kept if the translation of
+      // a sentence queued again fails
+  CPPUNIT_ASSERT_EQUAL( 1u, queue->requeueUnserved(1) );
+  CPPUNIT_ASSERT( queue->nextPendingSent(sent) );
+  CPPUNIT_ASSERT( sent==sentence(0) );
+  queue->cancel(sent);
+  CPPUNIT_ASSERT_EQUAL( (size_t) 1, queue->numStoredWgs() );
+  CPPUNIT_ASSERT( !queue->request(sentence(0)) );
+}
@@ -0,0 +1,78 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgPrecompQueueTest.h
+ *
+ * @brief Declares the WgPrecompQueueTest class implementing unit tests
+ * for the WgPrecompQueue class.
+ */
+
+#ifndef _WgPrecompQueueTest_h
+#define _WgPrecompQueueTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "stack_dec/WgPrecompQueue.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+//--------------- WgPrecompQueueTest class
+
+/**
+ * @brief Class implementing tests for WgPrecompQueue. The sentences
+ * are translated and stored in the order in which the background
+ * worker of the decoder does it.
+ */
+
+class WgPrecompQueueTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( WgPrecompQueueTest );
+    CPPUNIT_TEST( testRequest );
+    CPPUNIT_TEST( testQueueIsBounded );
+    CPPUNIT_TEST( testOnlyServedWgsAreRemoved );
+    CPPUNIT_TEST( testServedPendingSent );
+    CPPUNIT_TEST( testRequeueUnserved );
+    CPPUNIT_TEST( testCancel );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        WgPrecompQueue* queue;
+        unsigned int numWgFilesCreated;
+
+        std::string sentence(unsigned int n);
+        bool translateNextSent(std::string& sent,
+                               std::vector<WgPrecompSentFile>& removedWgs);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testRequest();
+        void testQueueIsBounded();
+        void testOnlyServedWgsAreRemoved();
+        void testServedPendingSent();
+        void testRequeueUnserved();
+        void testCancel();
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgProcessorForAnlpTest.cc
+ * 
+ * @brief Definitions file for WgProcessorForAnlpTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WgProcessorForAnlpTest.h"
+#include <stdlib.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( WgProcessorForAnlpTest );
+
+//--------------- WgProcessorForAnlpTest class functions
+//
+
+//---------------------------------------
+void WgProcessorForAnlpTest::setUp()
+{
+  wg = new WordGraph();
+  ecm = new PfsmEcmForWg();
+  srand(31415);
+  buildWordGraph();
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::tearDown()
+{
+  delete ecm;
+  delete wg;
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::buildWordGraph(void)
+{
+  const char* vocab[]={"the","house","is","green","a","small","big","car","red","dog","cat","runs"};
+  unsigned int vocabSize=12;
+
+      // The word graph is composed of WGP_TEST_WG_NUM_LEVELS levels of
+      // WGP_TEST_WG_WIDTH states, so the arcs of each level are
+      // processed in parallel. Arcs are added in topological order
+  HypStateIndex finalState=1+WGP_TEST_WG_NUM_LEVELS*WGP_TEST_WG_WIDTH;
+  for(unsigned int l=0;l<=WGP_TEST_WG_NUM_LEVELS;++l)
+  {
+    for(unsigned int k=0;k<WGP_TEST_WG_WIDTH;++k)
+    {
+      HypStateIndex predState=(l==0)?INITIAL_STATE:1+(l-1)*WGP_TEST_WG_WIDTH+k;
+      unsigned int numSuccStates=1+rand()%3;
+      if(l==0 || l==WGP_TEST_WG_NUM_LEVELS)
+        numSuccStates=1;
+      for(unsigned int s=0;s<numSuccStates;++s)
+      {
+        HypStateIndex succState;
+        if(l==WGP_TEST_WG_NUM_LEVELS)
+          succState=finalState;
+        else
+          succState=1+l*WGP_TEST_WG_WIDTH+((s==0)?k:rand()%WGP_TEST_WG_WIDTH);
+        std::vector<std::string> words;
+        words.push_back(vocab[rand()%vocabSize]);
+        if(rand()%2)
+          words.push_back(vocab[rand()%vocabSize]);
+        wg->addArc(predState,succState,words,-(Score)(rand()%1000)/100);
+      }
+    }
+  }
+  wg->addFinalState(finalState);
+}
+
+//---------------------------------------
+std::vector<std::string> WgProcessorForAnlpTest::getPrefixSequence(void)
+{
+      // Sequence of prefixes obtained when typing, including
+      // backspaces, deleted words and words typed again
+  std::vector<std::string> prefixes;
+  prefixes.push_back("t");
+  prefixes.push_back("th");
+  prefixes.push_back("the");
+  prefixes.push_back("the ");
+  prefixes.push_back("the c");
+  prefixes.push_back("the ca");
+  prefixes.push_back("the car");
+  prefixes.push_back("the car ");
+  prefixes.push_back("the car i");
+  prefixes.push_back("the car is");
+  prefixes.push_back("the car i");
+  prefixes.push_back("the car ");
+  prefixes.push_back("the car");
+  prefixes.push_back("the ca");
+  prefixes.push_back("the cat");
+  prefixes.push_back("the cat ");
+  prefixes.push_back("the cat runs");
+  prefixes.push_back("the cat runs ");
+  prefixes.push_back("the ");
+  prefixes.push_back("the cat runs ");
+  prefixes.push_back("the cat runs big");
+  prefixes.push_back("the cat runs big red");
+  prefixes.push_back("the dog");
+  prefixes.push_back("the cat runs big red");
+  prefixes.push_back("a");
+  prefixes.push_back("a small house is green ");
+  return prefixes;
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::initWgProcessor(WgProcessorForAnlp<PfsmEcmForWg>& wgp,
+                                             unsigned int maxCheckpoints,
+                                             unsigned int numThreads)
+{
+  wgp.link_ecm_wg(ecm);
+  wgp.link_wg(wg);
+  wgp.set_wgw(1);
+  wgp.set_ecmw(1);
+  wgp.setMaxCheckpoints(maxCheckpoints);
+  wgp.setNumThreads(numThreads);
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::checkEqualCorrections(const NbestCorrections& nbCorr1,
+                                                   const NbestCorrections& nbCorr2)
+{
+  CPPUNIT_ASSERT_EQUAL( nbCorr1.size(), nbCorr2.size() );
+  NbestCorrections::const_iterator iter1=nbCorr1.begin();
+  NbestCorrections::const_iterator iter2=nbCorr2.begin();
+  for(;iter1!=nbCorr1.end();++iter1,++iter2)
+  {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(iter1->first,iter2->first,0.0001);
+    CPPUNIT_ASSERT( iter1->second == iter2->second );
+  }
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::compareWithSerialSweep(unsigned int maxCheckpoints,
+                                                    unsigned int numThreads)
+{
+  WgProcessorForAnlp<PfsmEcmForWg> wgp;
+  initWgProcessor(wgp,maxCheckpoints,numThreads);
+  WgProcessorForAnlp<PfsmEcmForWg> serialWgp;
+  initWgProcessor(serialWgp,0,1);
+
+  RejectedWordsSet rejectedWords;
+  std::vector<std::string> prefixes=getPrefixSequence();
+  for(unsigned int k=0;k<prefixes.size();++k)
+  {
+    NbestCorrections nbCorr=wgp.correct(prefixes[k],WGP_TEST_NBEST,rejectedWords);
+    NbestCorrections serialNbCorr=serialWgp.correct(prefixes[k],WGP_TEST_NBEST,rejectedWords);
+    CPPUNIT_ASSERT( !nbCorr.empty() );
+    checkEqualCorrections(nbCorr,serialNbCorr);
+  }
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::testCheckpointsMatchSerialSweep()
+{
+  compareWithSerialSweep(WGP_DEFAULT_MAX_CHECKPOINTS,1);
+  compareWithSerialSweep(2,1);
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::testParallelSweepMatchesSerialSweep()
+{
+  compareWithSerialSweep(WGP_DEFAULT_MAX_CHECKPOINTS,4);
+  compareWithSerialSweep(2,3);
+}
@@ -0,0 +1,86 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgProcessorForAnlpTest.h
+ *
+ * @brief Declares the WgProcessorForAnlpTest class implementing unit
+ * tests for the WgProcessorForAnlp class.
+ */
+
+#ifndef _WgProcessorForAnlpTest_h
+#define _WgProcessorForAnlpTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "error_correction/WgProcessorForAnlp.h"
+#include "error_correction/PfsmEcmForWg.h"
+#include "error_correction/WordGraph.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define WGP_TEST_WG_WIDTH      100
+#define WGP_TEST_WG_NUM_LEVELS  25
+#define WGP_TEST_NBEST          10
+
+//--------------- WgProcessorForAnlpTest class
+
+/**
+ * @brief Class implementing tests for WgProcessorForAnlp. The
+ * corrections obtained for a sequence of prefixes (including
+ * backspaces) using checkpoints and parallel arc sweeps are compared
+ * with those obtained by the serial sweep without checkpoints.
+ */
+
+class WgProcessorForAnlpTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( WgProcessorForAnlpTest );
+    CPPUNIT_TEST( testCheckpointsMatchSerialSweep );
+    CPPUNIT_TEST( testParallelSweepMatchesSerialSweep );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        WordGraph* wg;
+        PfsmEcmForWg* ecm;
+
+        void buildWordGraph(void);
+        std::vector<std::string> getPrefixSequence(void);
+        void initWgProcessor(WgProcessorForAnlp<PfsmEcmForWg>& wgp,
+                             unsigned int maxCheckpoints,
+                             unsigned int numThreads);
+        void checkEqualCorrections(const NbestCorrections& nbCorr1,
+                                   const NbestCorrections& nbCorr2);
+        void compareWithSerialSweep(unsigned int maxCheckpoints,
+                                    unsigned int numThreads);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testCheckpointsMatchSerialSweep();
+        void testParallelSweepMatchesSerialSweep();
+};
+
+#endif
@@ -0,0 +1,291 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphTest.cc
+ * 
+ * @brief Definitions file for WordGraphTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WordGraphTest.h"
+#include <stdio.h>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( WordGraphTest );
+
+//--------------- WordGraphTest class functions
+//
+
+//---------------------------------------
+void WordGraphTest::setUp()
+{
+  wg = new WordGraph();
+}
+
+//---------------------------------------
+void WordGraphTest::tearDown()
+{
+  remove(WG_TEST_TEXT_FILE);
+  remove(WG_TEST_BIN_FILE);
+  delete wg;
+}
+
+//---------------------------------------
+std::vector<std::string> WordGraphTest::strToVec(const std::string& str)
+{
+  std::vector<std::string> strVec;
+  std::istringstream iss(str);
+  std::string word;
+  while(iss>>word)
+    strVec.push_back(word);
+  return strVec;
+}
+
+//---------------------------------------
+void WordGraphTest::getCompWeightVec(float lmWeight,
+                                     float tmWeight,
+                                     std::vector<std::pair<std::string,float> >& compWeights)
+{
+  compWeights.clear();
+  compWeights.push_back(std::make_pair(std::string("lmw"),lmWeight));
+  compWeights.push_back(std::make_pair(std::string("tmw"),tmWeight));
+}
+
+//---------------------------------------
+void WordGraphTest::buildWordGraph(void)
+{
+  std::vector<std::pair<std::string,float> > compWeights;
+  getCompWeightVec(0.5,2,compWeights);
+  wg->setCompWeights(compWeights);
+
+      // Arcs are added in topological order. Arc scores are the
+      // weighted sum of their (unweighted) score components
+  std::vector<Score> scrVec(2);
+  scrVec[0]=-1.5; scrVec[1]=-0.25;
+  wg->addArcWithScrComps(0,1,strToVec("the"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  scrVec[0]=-2; scrVec[1]=-0.75;
+  wg->addArcWithScrComps(0,2,strToVec("the house"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  scrVec[0]=-1.25; scrVec[1]=-0.5;
+  wg->addArcWithScrComps(1,2,strToVec("house"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  scrVec[0]=-3; scrVec[1]=-1;
+  wg->addArcWithScrComps(1,3,strToVec("home"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  scrVec[0]=-0.5; scrVec[1]=-0.125;
+  wg->addArcWithScrComps(2,4,strToVec("is green"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  scrVec[0]=-4; scrVec[1]=-2;
+  wg->addArcWithScrComps(2,5,strToVec("green"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  scrVec[0]=-1; scrVec[1]=-1;
+  wg->addArcWithScrComps(3,4,strToVec("is green"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+
+      // States 4 and 5 are final, state 6 is a dead end
+  scrVec[0]=-0.25; scrVec[1]=-0.25;
+  wg->addArcWithScrComps(4,6,strToVec("dead end"),0.5*scrVec[0]+2*scrVec[1],scrVec);
+  wg->addFinalState(4);
+  wg->addFinalState(5);
+}
+
+//---------------------------------------
+void WordGraphTest::printAndLoad(bool printOnlyUsefulStates,
+                                 WordGraph& textWg,
+                                 WordGraph& binWg)
+{
+  CPPUNIT_ASSERT( wg->print(WG_TEST_TEXT_FILE,printOnlyUsefulStates) == THOT_OK );
+  CPPUNIT_ASSERT( wg->printBin(WG_TEST_BIN_FILE,printOnlyUsefulStates) == THOT_OK );
+  CPPUNIT_ASSERT( textWg.load(WG_TEST_TEXT_FILE) == THOT_OK );
+  CPPUNIT_ASSERT( binWg.load(WG_TEST_BIN_FILE) == THOT_OK );
+}
+
+//---------------------------------------
+void WordGraphTest::checkEqualWordGraphs(const WordGraph& wg1,
+                                         const WordGraph& wg2)
+{
+      // Check component weights
+  std::vector<std::pair<std::string,float> > compWeights1;
+  std::vector<std::pair<std::string,float> > compWeights2;
+  wg1.getCompWeights(compWeights1);
+  wg2.getCompWeights(compWeights2);
+  CPPUNIT_ASSERT_EQUAL( compWeights1.size(), compWeights2.size() );
+  for(unsigned int i=0;i<compWeights1.size();++i)
+  {
+    CPPUNIT_ASSERT( compWeights1[i].first == compWeights2[i].first );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(compWeights1[i].second,compWeights2[i].second,0.0001);
+  }
+
+      // Check final states
+  CPPUNIT_ASSERT( wg1.getFinalStateSet() == wg2.getFinalStateSet() );
+
+      // Check arcs
+  CPPUNIT_ASSERT_EQUAL( wg1.numArcs(), wg2.numArcs() );
+  for(WordGraphArcId arcId=0;arcId<wg1.numArcs();++arcId)
+  {
+    WordGraphArc arc1=wg1.wordGraphArcId2WordGraphArc(arcId);
+    WordGraphArc arc2=wg2.wordGraphArcId2WordGraphArc(arcId);
+    CPPUNIT_ASSERT_EQUAL( arc1.predStateIndex, arc2.predStateIndex );
+    CPPUNIT_ASSERT_EQUAL( arc1.succStateIndex, arc2.succStateIndex );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(arc1.arcScore,arc2.arcScore,0.0001);
+    CPPUNIT_ASSERT( arc1.words == arc2.words );
+  }
+}
+
+//---------------------------------------
+void WordGraphTest::testPrintLoadBin()
+{
+  buildWordGraph();
+
+  WordGraph textWg;
+  WordGraph binWg;
+  printAndLoad(false,textWg,binWg);
+  CPPUNIT_ASSERT_EQUAL( wg->numArcs(), binWg.numArcs() );
+  checkEqualWordGraphs(*wg,binWg);
+  checkEqualWordGraphs(textWg,binWg);
+
+      // Changing the weights rescores the arcs given their score
+      // components, which must have been also loaded
+  std::vector<std::pair<std::string,float> > compWeights;
+  getCompWeightVec(1,0.5,compWeights);
+  wg->setCompWeights(compWeights);
+  textWg.setCompWeights(compWeights);
+  binWg.setCompWeights(compWeights);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.5-0.5*0.25,binWg.wordGraphArcId2WordGraphArc(0).arcScore,0.0001);
+  checkEqualWordGraphs(*wg,binWg);
+  checkEqualWordGraphs(textWg,binWg);
+}
+
+//---------------------------------------
+void WordGraphTest::testPrintLoadBinUsefulStates()
+{
+  buildWordGraph();
+
+      // The arc to the dead end state is not printed
+  WordGraph textWg;
+  WordGraph binWg;
+  printAndLoad(true,textWg,binWg);
+  CPPUNIT_ASSERT_EQUAL( wg->numArcs()-1, binWg.numArcs() );
+  checkEqualWordGraphs(textWg,binWg);
+
+  std::vector<std::pair<std::string,float> > compWeights;
+  getCompWeightVec(1,0.5,compWeights);
+  textWg.setCompWeights(compWeights);
+  binWg.setCompWeights(compWeights);
+  checkEqualWordGraphs(textWg,binWg);
+}
+
+//---------------------------------------
+void WordGraphTest::buildWordGraphWithTies(void)
+{
+      // Many paths have the same score. State 4 is final but has
+      // successors, paths end when they reach a final state
+  std::vector<Score> scrVec(1);
+  scrVec[0]=-1; wg->addArcWithScrComps(0,1,strToVec("a"),-1,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(0,2,strToVec("b"),-1,scrVec);
+  scrVec[0]=-2; wg->addArcWithScrComps(0,3,strToVec("c"),-2,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(1,4,strToVec("d"),-1,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(2,4,strToVec("e"),-1,scrVec);
+  scrVec[0]=-2; wg->addArcWithScrComps(1,5,strToVec("f"),-2,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(2,5,strToVec("g h"),-1,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(3,5,strToVec("i"),-1,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(4,6,strToVec("j"),-1,scrVec);
+  scrVec[0]=0; wg->addArcWithScrComps(5,6,strToVec("k"),0,scrVec);
+  scrVec[0]=-1; wg->addArcWithScrComps(5,7,strToVec("l"),-1,scrVec);
+  scrVec[0]=-2; wg->addArcWithScrComps(3,7,strToVec("m"),-2,scrVec);
+  wg->addFinalState(4);
+  wg->addFinalState(6);
+  wg->addFinalState(7);
+}
+
+//---------------------------------------
+void WordGraphTest::enumeratePaths(HypStateIndex hypStateIndex,
+                                   Score score,
+                                   std::string str,
+                                   std::vector<std::pair<Score,std::string> >& paths)
+{
+  if(wg->stateIsFinal(hypStateIndex))
+  {
+    paths.push_back(std::make_pair(score,str));
+    return;
+  }
+
+  std::vector<WordGraphArc> wgArcs;
+  wg->getArcsToSuccStates(hypStateIndex,wgArcs);
+  for(unsigned int i=0;i<wgArcs.size();++i)
+  {
+    std::string newStr=str;
+    for(unsigned int k=0;k<wgArcs[i].words.size();++k)
+    {
+      if(!newStr.empty())
+        newStr+=" ";
+      newStr+=wgArcs[i].words[k];
+    }
+    enumeratePaths(wgArcs[i].succStateIndex,score+wgArcs[i].arcScore,newStr,paths);
+  }
+}
+
+//---------------------------------------
+void WordGraphTest::testNbestListWithTies()
+{
+  buildWordGraphWithTies();
+
+      // Obtain all the paths sorted by score
+  std::vector<std::pair<Score,std::string> > paths;
+  enumeratePaths(INITIAL_STATE,0,"",paths);
+  std::stable_sort(paths.begin(),paths.end(),std::greater<std::pair<Score,std::string> >());
+  CPPUNIT_ASSERT_EQUAL( (size_t)9, paths.size() );
+
+  for(unsigned int len=1;len<=paths.size()+2;++len)
+  {
+    std::vector<std::pair<Score,std::string> > nblist;
+    std::vector<NbSearchHighLevelHyp> highLevelHypList;
+    std::vector<std::vector<Score> > scoreCompsVec;
+    wg->obtainNbestList(len,nblist,highLevelHypList,scoreCompsVec);
+    CPPUNIT_ASSERT_EQUAL( std::min((size_t)len,paths.size()), nblist.size() );
+    CPPUNIT_ASSERT_EQUAL( nblist.size(), highLevelHypList.size() );
+    CPPUNIT_ASSERT_EQUAL( nblist.size(), scoreCompsVec.size() );
+
+    for(unsigned int k=0;k<nblist.size();++k)
+    {
+          // Scores are sorted and equal to those of the k-th best path
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(paths[k].first,nblist[k].first,0.0001);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(nblist[k].first,scoreCompsVec[k][0],0.0001);
+
+          // Paths with the same score may be given in any order, but
+          // each path is given once
+      bool found=false;
+      for(unsigned int p=0;p<paths.size();++p)
+      {
+        if(paths[p].second==nblist[k].second)
+        {
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(paths[p].first,nblist[k].first,0.0001);
+          found=true;
+        }
+      }
+      CPPUNIT_ASSERT( found );
+      for(unsigned int l=0;l<k;++l)
+        CPPUNIT_ASSERT( nblist[l].second != nblist[k].second );
+
+          // The high level hypothesis goes from the initial state to a
+          // final state
+      CPPUNIT_ASSERT( !highLevelHypList[k].empty() );
+      CPPUNIT_ASSERT_EQUAL( (HypStateIndex)INITIAL_STATE, highLevelHypList[k].front().predStateIndex );
+      CPPUNIT_ASSERT( wg->stateIsFinal(highLevelHypList[k].back().succStateIndex) );
+    }
+  }
+}
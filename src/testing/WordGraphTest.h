@@ -0,0 +1,90 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordGraphTest.h
+ *
+ * @brief Declares the WordGraphTest class implementing unit tests for
+ * the WordGraph class.
+ */
+
+#ifndef _WordGraphTest_h
+#define _WordGraphTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "error_correction/WordGraph.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define WG_TEST_TEXT_FILE "WordGraphTest.wg"
+#define WG_TEST_BIN_FILE  "WordGraphTest.wgb"
+
+//--------------- WordGraphTest class
+
+/**
+ * @brief Class implementing tests for WordGraph. The word graphs
+ * loaded from files in binary format are compared with those loaded
+ * from files in text format, and the n-best lists are compared with
+ * the list of all the paths of the word graph.
+ */
+
+class WordGraphTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( WordGraphTest );
+    CPPUNIT_TEST( testPrintLoadBin );
+    CPPUNIT_TEST( testPrintLoadBinUsefulStates );
+    CPPUNIT_TEST( testNbestListWithTies );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        WordGraph* wg;
+
+        std::vector<std::string> strToVec(const std::string& str);
+        void buildWordGraph(void);
+        void getCompWeightVec(float lmWeight,
+                              float tmWeight,
+                              std::vector<std::pair<std::string,float> >& compWeights);
+        void printAndLoad(bool printOnlyUsefulStates,
+                          WordGraph& textWg,
+                          WordGraph& binWg);
+        void checkEqualWordGraphs(const WordGraph& wg1,
+                                  const WordGraph& wg2);
+        void buildWordGraphWithTies(void);
+        void enumeratePaths(HypStateIndex hypStateIndex,
+                            Score score,
+                            std::string str,
+                            std::vector<std::pair<Score,std::string> >& paths);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testPrintLoadBin();
+        void testPrintLoadBinUsefulStates();
+        void testNbestListWithTies();
+};
+
+#endif
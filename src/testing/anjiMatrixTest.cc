@@ -0,0 +1,142 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file anjiMatrixTest.cc
+ * 
+ * @brief Definitions file for anjiMatrixTest.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "anjiMatrixTest.h"
+#include <sys/stat.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( anjiMatrixTest );
+
+//--------------- anjiMatrixTest class functions
+//
+
+//---------------------------------------
+void anjiMatrixTest::setUp()
+{
+  anji = new anjiMatrix();
+}
+
+//---------------------------------------
+void anjiMatrixTest::tearDown()
+{
+  delete anji;
+}
+
+//---------------------------------------
+unsigned int anjiMatrixTest::entrySize(unsigned int n)
+{
+      // Sentence lengths between 10 and 29, 300 entries require more
+      // than 65536 values (the initial capacity of the arena)
+  return 10+(n*7)%20;
+}
+
+//---------------------------------------
+float anjiMatrixTest::entryValue(unsigned int n,
+                                 unsigned int j,
+                                 unsigned int i)
+{
+  return (float)(n*10000+j*100+i)/1000000;
+}
+
+//---------------------------------------
+void anjiMatrixTest::fillEntries(void)
+{
+      // Each entry is filled before creating the next one, so the
+      // values are stored before the arena grows
+  for(unsigned int n=0;n<ANJI_TEST_NUM_ENTRIES;++n)
+  {
+    unsigned int mapped_n;
+    unsigned int size=entrySize(n);
+    CPPUNIT_ASSERT( anji->init_nth_entry(n,size,size+1,mapped_n) == THOT_OK );
+    for(unsigned int j=0;j<=size+1;++j)
+      for(unsigned int i=0;i<=size;++i)
+        anji->set_fast(mapped_n,j,i,entryValue(n,j,i));
+  }
+}
+
+//---------------------------------------
+void anjiMatrixTest::checkEntries(void)
+{
+  CPPUNIT_ASSERT_EQUAL( (unsigned int)ANJI_TEST_NUM_ENTRIES, anji->n_size() );
+  for(unsigned int n=0;n<ANJI_TEST_NUM_ENTRIES;++n)
+  {
+    unsigned int size=entrySize(n);
+    for(unsigned int j=0;j<=size+1;++j)
+      for(unsigned int i=0;i<=size;++i)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(entryValue(n,j,i),anji->get(n,j,i),0.000001);
+  }
+}
+
+//---------------------------------------
+void anjiMatrixTest::testGrowHeapArena()
+{
+  fillEntries();
+  checkEntries();
+}
+
+//---------------------------------------
+void anjiMatrixTest::testGrowMmapArena()
+{
+  CPPUNIT_ASSERT( anji->set_mmap_file(ANJI_TEST_MMAP_FILE) == THOT_OK );
+  fillEntries();
+  checkEntries();
+
+      // The file is removed when the matrix is destroyed
+  delete anji;
+  anji = new anjiMatrix();
+  struct stat fileStat;
+  CPPUNIT_ASSERT( stat(ANJI_TEST_MMAP_FILE,&fileStat) != 0 );
+}
+
+//---------------------------------------
+void anjiMatrixTest::testGrowEntries()
+{
+  CPPUNIT_ASSERT( anji->set_mmap_file(ANJI_TEST_MMAP_FILE) == THOT_OK );
+  fillEntries();
+
+      // Enlarge the first entries, which are moved to the end of the
+      // arena and reinitialized
+  unsigned int numGrown=10;
+  for(unsigned int n=0;n<numGrown;++n)
+  {
+    unsigned int mapped_n;
+    CPPUNIT_ASSERT( anji->init_nth_entry(n,100,100,mapped_n) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL( 101u, anji->nj_size(mapped_n) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(INVALID_ANJI_VAL,anji->get(n,100,100),0.000001);
+    anji->set_fast(mapped_n,100,100,entryValue(n,100,100));
+  }
+
+      // The values of the entries that were not enlarged are kept
+  for(unsigned int n=numGrown;n<ANJI_TEST_NUM_ENTRIES;++n)
+  {
+    unsigned int size=entrySize(n);
+    for(unsigned int j=0;j<=size+1;++j)
+      for(unsigned int i=0;i<=size;++i)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(entryValue(n,j,i),anji->get(n,j,i),0.000001);
+  }
+  for(unsigned int n=0;n<numGrown;++n)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(entryValue(n,100,100),anji->get(n,100,100),0.000001);
+}
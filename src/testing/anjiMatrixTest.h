@@ -0,0 +1,78 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file anjiMatrixTest.h
+ *
+ * @brief Declares the anjiMatrixTest class implementing unit tests for
+ * the anjiMatrix class.
+ */
+
+#ifndef _anjiMatrixTest_h
+#define _anjiMatrixTest_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "sw_models/anjiMatrix.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+//--------------- Constants ------------------------------------------
+
+#define ANJI_TEST_NUM_ENTRIES 300
+#define ANJI_TEST_MMAP_FILE   "anjiMatrixTest.mmap"
+
+//--------------- anjiMatrixTest class
+
+/**
+ * @brief Class implementing tests for anjiMatrix. The values stored
+ * in the matrix are checked after growing its arena past its initial
+ * capacity, both in memory and in a memory-mapped file.
+ */
+
+class anjiMatrixTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( anjiMatrixTest );
+    CPPUNIT_TEST( testGrowHeapArena );
+    CPPUNIT_TEST( testGrowMmapArena );
+    CPPUNIT_TEST( testGrowEntries );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        anjiMatrix* anji;
+
+        unsigned int entrySize(unsigned int n);
+        float entryValue(unsigned int n,
+                         unsigned int j,
+                         unsigned int i);
+        void fillEntries(void);
+        void checkEntries(void);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testGrowHeapArena();
+        void testGrowMmapArena();
+        void testGrowEntries();
+};
+
+#endif
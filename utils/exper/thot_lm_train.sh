@@ -201,7 +201,10 @@ estimate_thotlm()
     nl=`$WC -l $corpus | $AWK '{printf"%s",$1}'`
 
     # Estimate n-gram model parameters
-    if [ $nl -gt 0 ]; then
+    if [ $nl -gt 0 -a ${qs_given} -eq 0 ]; then
+        ${bindir}/thot_count_ngrams -c $corpus -n ${n_val} ${unk_opt} \
+                 -nt ${pr_val} -tdir $tdir -o $prefix || return 1
+    elif [ $nl -gt 0 ]; then
         ${bindir}/thot_pbs_get_ngram_counts -pr ${pr_val} \
                  -c $corpus -o $prefix -n ${n_val} -f ${fragm_size} ${unk_opt} \
                  ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} || return 1
@@ -235,34 +238,40 @@ remove_prev_ldb_files()
 ########
 estimate_ldb()
 {
-    # Determine output directory of native thot language model
-    thotlm_prefix=$outd/${outsubdir}/trg.thotlm
-
-    # Obtain number of lines for input file
-    nl=`$WC -l $corpus | $AWK '{printf"%s",$1}'`
-
-    # Estimate n-gram model parameters
-    if [ $nl -gt 0 ]; then
-        ${bindir}/thot_pbs_get_ngram_counts -pr ${pr_val} \
-                 -c $corpus -o ${thotlm_prefix} -n ${n_val} -f ${fragm_size} ${unk_opt} \
-                 ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} || return 1
-    else
-        ${bindir}/thot_get_ngram_counts -c $corpus \
-                 -n ${n_val} > ${thotlm_prefix} || return 1
-    fi
-
     # Determine output directory information
     prefix=$outd/${outsubdir}/trg.lm
     relative_prefix=${outsubdir}/trg.lm
 
     # Remove previously existing ldb files
     remove_prev_ldb_files
-    
-    # Create leveldb model
-    cat ${thotlm_prefix} | ${bindir}/thot_ngram_to_leveldb -o $prefix 2> ${prefix}.ldb_err || return 1
 
-    # Remove native thot language model files
-    rm ${thotlm_prefix}*
+    # Obtain number of lines for input file
+    nl=`$WC -l $corpus | $AWK '{printf"%s",$1}'`
+
+    if [ $nl -gt 0 -a ${qs_given} -eq 0 ]; then
+        # Store n-gram counts directly in the leveldb model
+        ${bindir}/thot_count_ngrams -c $corpus -n ${n_val} ${unk_opt} \
+                 -nt ${pr_val} -tdir $tdir -ldb -o $prefix || return 1
+    else
+        # Determine output directory of native thot language model
+        thotlm_prefix=$outd/${outsubdir}/trg.thotlm
+
+        # Estimate n-gram model parameters
+        if [ $nl -gt 0 ]; then
+            ${bindir}/thot_pbs_get_ngram_counts -pr ${pr_val} \
+                     -c $corpus -o ${thotlm_prefix} -n ${n_val} -f ${fragm_size} ${unk_opt} \
+                     ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} || return 1
+        else
+            ${bindir}/thot_get_ngram_counts -c $corpus \
+                     -n ${n_val} > ${thotlm_prefix} || return 1
+        fi
+
+        # Create leveldb model
+        cat ${thotlm_prefix} | ${bindir}/thot_ngram_to_leveldb -o $prefix 2> ${prefix}.ldb_err || return 1
+
+        # Remove native thot language model files
+        rm ${thotlm_prefix}*
+    fi
 }
 
 ########
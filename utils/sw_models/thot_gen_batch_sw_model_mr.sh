@@ -284,8 +284,16 @@ merge_lex_counts_text()
 
 merge_lex_counts_bin()
 {
-    # Merge lex sorted counts
-    ${bindir}/thot_merge_bin_ilextable ${curr_tables_dir}/lex_counts_* > ${curr_tables_dir}/merged_lex_counts || return 1
+    # Merge lex sorted counts (at the last iteration, the lexical table
+    # is also pruned in the same pass if required)
+    local prune_opts=""
+    if [ $n -eq ${niters} ]; then
+        if [ ${npr_val} -ne 0 -o ${cpr_val} != "0" ]; then
+            prune_opts="-n ${npr_val} -c ${cpr_val}"
+            lex_table_pruned=1
+        fi
+    fi
+    ${bindir}/thot_merge_bin_ilextable ${prune_opts} ${curr_tables_dir}/lex_counts_* > ${curr_tables_dir}/merged_lex_counts || return 1
 
     # Delete lex sorted counts
     rm ${curr_tables_dir}/lex_counts_*
@@ -435,7 +443,7 @@ create_filtered_model()
     filter_lex_table || return 1
 
     # Copy current alignment file
-    if [ ${chunk_id} -eq 1 -a ${alig_ext} != "none" ]; then 
+    if [ ${alig_ext} != "none" ]; then 
         cp ${curr_tables_dir}/merged_alig_counts ${filtered_model_dir}/model.${alig_ext}
     fi
 }
@@ -494,6 +502,9 @@ generate_final_model()
     # Prune lexical table
     if [ ${npr_val} -eq 0 -a ${cpr_val} = "0" ]; then
         cp ${curr_tables_dir}/merged_lex_counts ${output}.${lex_ext}
+    elif [ ${lex_table_pruned} -eq 1 ]; then
+        # Lexical table was pruned when merging counts
+        cp ${curr_tables_dir}/merged_lex_counts ${output}.${lex_ext}
     else
         # Prune lexical table
         echo "++ [Map-Reduce] Pruning lexical table..." >> $TMP/log
@@ -518,6 +529,7 @@ npr_given=0
 npr_val=0
 cpr_given=0
 cpr_val=0
+lex_table_pruned=0
 niters=1
 lf_given=0
 af_given=0
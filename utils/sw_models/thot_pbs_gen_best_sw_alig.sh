@@ -21,7 +21,7 @@ usage()
 {
     echo "thot_pbs_gen_best_sw_alig -pr <int> -sw <string>"
     echo "                      -s <string> -t <string> -o <string>"
-    echo "                      [-shu] [-qs <string>]"
+    echo "                      [-nt <int>] [-shu] [-qs <string>]"
     echo "                      [-tdir <string>] [-sdir <string>]"
     echo "                      [--sync-dep] [-debug] [--help] [--version]"
     echo ""
@@ -36,6 +36,8 @@ usage()
     echo "                     using pbs clusters)."
     echo "-o <string>        : Output prefix (give absolute path when"
     echo "                     using pbs clusters)."
+    echo "-nt <int>          : Number of threads used by each processor to align its"
+    echo "                     chunk sharing a single copy of the model (1 by default)."
     echo "-shu               : Shuffle input files before splitting them."
     echo "-qs <string>       : Specific options to be given to the qsub command"
     echo "                     (example: -qs \"-l pmem=1gb\")."
@@ -366,7 +368,7 @@ proc_chunk()
 
     ${bindir}/thot_format_corpus_csl ${chunks_dir}/${src_chunk} ${chunks_dir}/${trg_chunk} \
         2>> ${aligs_per_chunk_dir}/${chunk}_bestal.log | \
-        ${bindir}/thot_calc_swm_lgprob -sw ${sw_val} -P - -max \
+        ${bindir}/thot_calc_swm_lgprob -sw ${sw_val} -P - -max -nt ${nt_val} \
         2>> ${aligs_per_chunk_dir}/${chunk}_bestal.log > ${aligs_per_chunk_dir}/${chunk}_bestal ; ${PIPE_FAIL} || \
         { echo "Error while executing proc_chunk for ${chunk}" >> $SDIR/log ; return 1; }
 
@@ -449,6 +451,7 @@ report_errors()
 # main
 pr_given=0
 sw_given=0
+nt_val=1
 shu_given=0
 qs_given=0
 sdir=$HOME
@@ -515,6 +518,11 @@ while [ $# -ne 0 ]; do
                 o_given=0
             fi
             ;;
+        "-nt") shift
+            if [ $# -ne 0 ]; then
+                nt_val=$1
+            fi
+            ;;
         "-qs") shift
             if [ $# -ne 0 ]; then
                 qs_opts=$1